@@ -0,0 +1,144 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSAppendObjectWriterTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+    TOSAppendObjectInput *_writerInput;
+}
+
+@end
+
+@implementation TOSAppendObjectWriterTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+    _writerInput = [TOSAppendObjectInput new];
+    _writerInput.tosBucket = @"local-bucket";
+    _writerInput.tosKey = @"append";
+}
+
+- (void)tearDown {
+    [_server stop];
+    [super tearDown];
+}
+
+- (void)testAPI_appendObjectWriter {
+    NSData *record = [TOSTestUtil randomDataWithLength:128];
+    int count = 200;
+    TOSAppendObjectWriter *writer = [[TOSAppendObjectWriter alloc] initWithClient:_client input:_writerInput];
+    writer.bufferSize = 4 * 1024;
+    writer.flushInterval = 0.01;
+    NSMutableData *expected = [NSMutableData data];
+    for (int i = 0; i < count; i++) {
+        NSError *error = nil;
+        XCTAssertTrue([writer write:record error:&error], @"%@", error);
+        [expected appendData:record];
+    }
+    TOSTask *task = [writer close];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual((int64_t)expected.length, writer.nextAppendOffset);
+    XCTAssertEqualObjects(expected, [_server objectForKey:@"append"]);
+    XCTAssertEqual([TOSUtil crc64ecma:0 buffer:(void *)expected.bytes length:expected.length], writer.hashCrc64ecma);
+    XCTAssertLessThan(writer.appendCount, count);
+
+    NSError *error = nil;
+    XCTAssertFalse([writer write:record error:&error]);
+    XCTAssertEqualObjects(@"tos: append writer is closed", error.userInfo[TOSErrorMessageTOKEN]);
+}
+
+- (void)testAPI_appendObjectWriterRequestSizeLimit {
+    // 一次写入的大块数据按bufferSize拆成多次追加
+    NSData *data = [TOSTestUtil randomDataWithLength:100 * 1024];
+    TOSAppendObjectWriter *writer = [[TOSAppendObjectWriter alloc] initWithClient:_client input:_writerInput];
+    writer.bufferSize = 16 * 1024;
+    writer.flushInterval = 0;
+    XCTAssertTrue([writer write:data error:nil]);
+    TOSTask *task = [writer close];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(7, writer.appendCount);
+    XCTAssertEqualObjects(data, [_server objectForKey:@"append"]);
+}
+
+- (void)testAPI_appendObjectWriterBackpressure {
+    // 服务端延迟响应，在途追加期间缓冲超过maxBufferedBytes时write等待
+    _server.latency = 0.3;
+    TOSAppendObjectWriter *writer = [[TOSAppendObjectWriter alloc] initWithClient:_client input:_writerInput];
+    writer.bufferSize = 4 * 1024;
+    writer.maxBufferedBytes = 8 * 1024;
+    writer.flushInterval = 0;
+    NSData *data = [TOSTestUtil randomDataWithLength:12 * 1024 + 1];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    XCTAssertTrue([writer write:[data subdataWithRange:NSMakeRange(0, 4 * 1024)] error:nil]);
+    XCTAssertTrue([writer write:[data subdataWithRange:NSMakeRange(4 * 1024, 8 * 1024)] error:nil]);
+    XCTAssertLessThan(CFAbsoluteTimeGetCurrent() - start, 0.2);
+    XCTAssertTrue([writer write:[data subdataWithRange:NSMakeRange(12 * 1024, 1)] error:nil]);
+    XCTAssertGreaterThanOrEqual(CFAbsoluteTimeGetCurrent() - start, 0.2);
+    TOSTask *task = [writer close];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(data, [_server objectForKey:@"append"]);
+}
+
+- (void)testAPI_appendObjectWriterCRCMismatch {
+    _server.responseHeadersHandler = ^(NSString *method, NSString *key, NSDictionary<NSString *, NSString *> *query, NSMutableDictionary<NSString *, NSString *> *headers) {
+        if (query[@"append"]) {
+            headers[@"x-tos-hash-crc64ecma"] = @"1";
+        }
+    };
+    TOSAppendObjectWriter *writer = [[TOSAppendObjectWriter alloc] initWithClient:_client input:_writerInput];
+    XCTAssertTrue([writer write:[TOSTestUtil randomDataWithLength:1024] error:nil]);
+    TOSTask *task = [writer flush];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(@"tos: crc of appended object mismatch", task.error.userInfo[TOSErrorMessageTOKEN]);
+    NSError *error = nil;
+    XCTAssertFalse([writer write:[TOSTestUtil randomDataWithLength:1024] error:&error]);
+    XCTAssertEqualObjects(task.error, error);
+}
+
+- (void)testAPI_appendObjectWriterResumeWithoutCRC {
+    NSData *head = [TOSTestUtil randomDataWithLength:1024];
+    TOSAppendObjectInput *input = [TOSAppendObjectInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"append";
+    input.tosContent = head;
+    [[_client appendObject:input] waitUntilFinished];
+
+    // 续写已有对象且未提供起始CRC时不校验，hashCrc64ecma保持为0
+    _writerInput.tosOffset = (int64_t)head.length;
+    TOSAppendObjectWriter *writer = [[TOSAppendObjectWriter alloc] initWithClient:_client input:_writerInput];
+    NSData *tail = [TOSTestUtil randomDataWithLength:1024];
+    XCTAssertTrue([writer write:tail error:nil]);
+    TOSTask *task = [writer close];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(2048, writer.nextAppendOffset);
+    XCTAssertEqual(0, writer.hashCrc64ecma);
+    NSMutableData *expected = [head mutableCopy];
+    [expected appendData:tail];
+    XCTAssertEqualObjects(expected, [_server objectForKey:@"append"]);
+}
+
+@end
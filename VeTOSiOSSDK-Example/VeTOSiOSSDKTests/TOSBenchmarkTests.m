@@ -0,0 +1,1180 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSLocalServer.h"
+#import "TOSNetworkSimulator.h"
+#import <libkern/OSAtomic.h>
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+
+// CPU热点路径及基于TOSLocalServer的端到端基准测试，不访问外部网络
+// 端到端用例的服务端延迟(ms)、带宽(字节/秒)和错误率分别由TOS_BENCHMARK_LATENCY_MS、TOS_BENCHMARK_BANDWIDTH和TOS_BENCHMARK_ERROR_RATE配置
+// 结果以JSON写入环境变量TOS_BENCHMARK_OUTPUT指定的文件，默认为tmp/tos-benchmark.json，
+// TOS_BENCHMARK_REVISION标记版本，便于不同版本间对比
+
+static const int TOSBenchmarkRounds = 5;
+
+static NSMutableArray<NSDictionary *> *TOSBenchmarkResults;
+
+static uint64_t TOSBenchmarkPeakResidentSize(void) {
+    struct mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size_max;
+}
+
+static volatile int64_t TOSBenchmarkTaskAllocations;
+
+// 统计TOSTask分配次数
+@implementation TOSTask (TOSBenchmark)
+
++ (instancetype)allocWithZone:(struct _NSZone *)zone {
+    OSAtomicIncrement64(&TOSBenchmarkTaskAllocations);
+    return [super allocWithZone:zone];
+}
+
+@end
+
+// 仅实现返回TOSTask的拦截接口，使请求走异步拦截流程，用于与同步快速路径对比
+@interface TOSBenchmarkAsyncInterceptor : NSObject <TOSNetworkingRequestInterceptor>
+@end
+
+@implementation TOSBenchmarkAsyncInterceptor
+
+- (TOSTask *)interceptRequest:(NSMutableURLRequest *)request {
+    return [TOSTask taskWithResult:nil];
+}
+
+@end
+
+@interface TOSBenchmarkTests : XCTestCase
+
+@end
+
+@implementation TOSBenchmarkTests
+
++ (void)setUp {
+    TOSBenchmarkResults = [NSMutableArray array];
+}
+
++ (void)tearDown {
+    NSDictionary *environment = [[NSProcessInfo processInfo] environment];
+    NSDictionary *report = @{
+        @"suite": @"VeTOSiOSSDK",
+        @"revision": environment[@"TOS_BENCHMARK_REVISION"] ?: @"unknown",
+        @"timestamp": @((int64_t)[[NSDate date] timeIntervalSince1970]),
+        @"results": TOSBenchmarkResults,
+    };
+    NSData *json = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:nil];
+    NSString *path = environment[@"TOS_BENCHMARK_OUTPUT"];
+    if (path.length == 0) {
+        path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-benchmark.json"];
+    }
+    [json writeToFile:path atomically:YES];
+    NSLog(@"benchmark results written to %@\n%@", path, [[NSString alloc] initWithData:json encoding:NSUTF8StringEncoding]);
+}
+
+// 多轮计时取中位数，bytesPerOp非0时同时记录吞吐
+- (void)benchmark:(NSString *)name iterations:(int)iterations bytesPerOp:(uint64_t)bytesPerOp block:(void (^)(void))block {
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+
+    for (int i = 0; i < iterations / 10 + 1; i++) {
+        @autoreleasepool {
+            block();
+        }
+    }
+
+    NSMutableArray<NSNumber *> *rounds = [NSMutableArray arrayWithCapacity:TOSBenchmarkRounds];
+    for (int r = 0; r < TOSBenchmarkRounds; r++) {
+        uint64_t start = mach_absolute_time();
+        for (int i = 0; i < iterations; i++) {
+            @autoreleasepool {
+                block();
+            }
+        }
+        uint64_t elapsed = (mach_absolute_time() - start) * timebase.numer / timebase.denom;
+        [rounds addObject:@((double)elapsed / iterations)];
+    }
+    [rounds sortUsingSelector:@selector(compare:)];
+    double median = [rounds[TOSBenchmarkRounds / 2] doubleValue];
+
+    NSMutableDictionary *result = [NSMutableDictionary dictionary];
+    result[@"name"] = name;
+    result[@"iterations"] = @(iterations);
+    result[@"rounds"] = @(TOSBenchmarkRounds);
+    result[@"ns_per_op"] = @(median);
+    result[@"ns_per_op_min"] = rounds.firstObject;
+    result[@"ns_per_op_max"] = rounds.lastObject;
+    if (bytesPerOp > 0) {
+        result[@"bytes_per_op"] = @(bytesPerOp);
+        result[@"mb_per_sec"] = @(bytesPerOp / median * 1e9 / 1024 / 1024);
+    }
+    @synchronized (TOSBenchmarkResults) {
+        [TOSBenchmarkResults addObject:result];
+    }
+    NSLog(@"%@: %.1fns/op", name, median);
+}
+
+- (NSData *)randomDataWithLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    arc4random_buf(data.mutableBytes, length);
+    return data;
+}
+
+- (TOSSignV4 *)signer {
+    TOSCredential *credential = [[TOSCredential alloc] initWithAccessKey:@"AKLTbenchmarkaccesskey" secretKey:@"benchmarksecretkeybenchmarksecretkey"];
+    return [[TOSSignV4 alloc] initWithCredential:credential withRegion:@"cn-beijing"];
+}
+
+- (NSHTTPURLResponse *)responseWithHeaders:(NSDictionary *)headers {
+    NSURL *url = [NSURL URLWithString:@"https://bucket.tos-cn-beijing.volces.com/object"];
+    return [[NSHTTPURLResponse alloc] initWithURL:url statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:headers];
+}
+
+- (NSDictionary *)objectResponseHeaders {
+    return @{
+        @"Content-Length": @"4096",
+        @"Content-Type": @"application/octet-stream",
+        @"ETag": @"\"d41d8cd98f00b204e9800998ecf8427e\"",
+        @"Last-Modified": @"Mon, 14 Aug 2023 15:33:09 GMT",
+        @"x-tos-request-id": @"674c5f3b2d1e0a9c8b7f6e5d",
+        @"x-tos-id-2": @"674c5f3b2d1e0a9c8b7f6e5d-a0b1c2d3",
+        @"x-tos-version-id": @"null",
+        @"x-tos-object-type": @"Normal",
+        @"x-tos-storage-class": @"STANDARD",
+        @"x-tos-hash-crc64ecma": @"10846346227587417366",
+        @"x-tos-meta-owner": @"benchmark",
+        @"x-tos-meta-purpose": @"test",
+    };
+}
+
+#pragma mark - SignV4
+
+- (void)testBenchmarkSignRequestV4 {
+    TOSSignV4 *signer = [self signer];
+    NSURL *url = [NSURL URLWithString:@"https://bucket.tos-cn-beijing.volces.com/dir/%E4%B8%AD%E6%96%87/object.txt?partNumber=3&uploadId=abcdef0123456789"];
+    [self benchmark:@"signTOSRequestV4" iterations:2000 bytesPerOp:0 block:^{
+        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+        request.HTTPMethod = @"PUT";
+        [request setValue:@"application/octet-stream" forHTTPHeaderField:@"Content-Type"];
+        [request setValue:@"benchmark" forHTTPHeaderField:@"x-tos-meta-owner"];
+        XCTAssertNotNil([signer signTOSRequestV4:request]);
+    }];
+}
+
+- (void)testBenchmarkPreSignedURL {
+    TOSSignV4 *signer = [self signer];
+    NSURL *url = [NSURL URLWithString:@"https://bucket.tos-cn-beijing.volces.com/dir/object.txt"];
+    TOSPreSignedURLInput *input = [TOSPreSignedURLInput new];
+    input.tosHttpMethod = TOSHTTPMethodTypeGet;
+    input.tosBucket = @"bucket";
+    input.tosKey = @"dir/object.txt";
+    input.tosExpires = 3600;
+    input.tosHeader = @{@"x-tos-meta-owner": @"benchmark"};
+    input.tosQuery = @{@"response-content-type": @"text/plain"};
+    [self benchmark:@"preSignedURL" iterations:2000 bytesPerOp:0 block:^{
+        NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+        request.HTTPMethod = TOSHTTPMethodTypeGet;
+        XCTAssertNotNil([signer preSignedURL:request withInput:input]);
+    }];
+}
+
+#pragma mark - URL编码
+
+- (void)testBenchmarkURLEncoders {
+    NSString *key = @"dir/子目录/object name with spaces & symbols=+?#!.txt";
+    [self benchmark:@"TOSUtil.encodeURL" iterations:20000 bytesPerOp:0 block:^{
+        [TOSUtil encodeURL:key];
+    }];
+    [self benchmark:@"TOSUtil.URLEncode" iterations:20000 bytesPerOp:0 block:^{
+        [TOSUtil URLEncode:key];
+    }];
+    [self benchmark:@"TOSUtil.URLEncodingPath" iterations:20000 bytesPerOp:0 block:^{
+        [TOSUtil URLEncodingPath:key];
+    }];
+}
+
+#pragma mark - CRC64 / MD5
+
+- (void)testBenchmarkCRC64 {
+    NSData *data = [self randomDataWithLength:1024 * 1024];
+    [self benchmark:@"aos_crc64.1MiB" iterations:50 bytesPerOp:data.length block:^{
+        [TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length];
+    }];
+
+    uint64_t crc1 = [TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length / 2];
+    uint64_t crc2 = [TOSUtil crc64ecma:0 buffer:(uint8_t *)data.bytes + data.length / 2 length:data.length / 2];
+    XCTAssertEqual([TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length],
+                   [TOSUtil crc64ForCombineCRC1:crc1 CRC2:crc2 length:data.length / 2]);
+    [self benchmark:@"aos_crc64_combine" iterations:20000 bytesPerOp:0 block:^{
+        [TOSUtil crc64ForCombineCRC1:crc1 CRC2:crc2 length:5 * 1024 * 1024];
+    }];
+}
+
+- (void)testBenchmarkMD5 {
+    NSData *data = [self randomDataWithLength:1024 * 1024];
+    [self benchmark:@"dataMD5.1MiB" iterations:50 bytesPerOp:data.length block:^{
+        [TOSUtil dataMD5String:data];
+    }];
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-benchmark-md5"];
+    NSMutableData *fileData = [NSMutableData data];
+    for (int i = 0; i < 8; i++) {
+        [fileData appendData:data];
+    }
+    [fileData writeToFile:path atomically:YES];
+    [self benchmark:@"fileMD5.8MiB" iterations:5 bytesPerOp:fileData.length block:^{
+        [TOSUtil fileMD5:path];
+    }];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+#pragma mark - 响应解析
+
+- (void)testBenchmarkParseListObjects {
+    NSMutableArray *contents = [NSMutableArray array];
+    for (int i = 0; i < 1000; i++) {
+        [contents addObject:@{
+            @"Key": [NSString stringWithFormat:@"dir/object-%04d.txt", i],
+            @"LastModified": @"2023-08-14T15:33:09.000Z",
+            @"ETag": @"\"d41d8cd98f00b204e9800998ecf8427e\"",
+            @"Size": @(4096 + i),
+            @"Owner": @{@"ID": @"2100000000", @"DisplayName": @"2100000000"},
+            @"StorageClass": @"STANDARD",
+            @"HashCrc64ecma": @"10846346227587417366",
+        }];
+    }
+    NSDictionary *body = @{
+        @"Name": @"bucket",
+        @"Prefix": @"dir/",
+        @"Marker": @"",
+        @"MaxKeys": @1000,
+        @"IsTruncated": @YES,
+        @"NextMarker": @"dir/object-0999.txt",
+        @"Contents": contents,
+    };
+    NSData *bodyData = [NSJSONSerialization dataWithJSONObject:body options:0 error:nil];
+    NSHTTPURLResponse *response = [self responseWithHeaders:@{
+        @"Content-Type": @"application/json",
+        @"Content-Length": [NSString stringWithFormat:@"%lu", (unsigned long)bodyData.length],
+        @"x-tos-request-id": @"674c5f3b2d1e0a9c8b7f6e5d",
+    }];
+    [self benchmark:@"buildOutputObject.ListObjects.1000" iterations:50 bytesPerOp:bodyData.length block:^{
+        TOSNetworkingResponseParser *parser = [[TOSNetworkingResponseParser alloc] initWithOperationType:TOSOperationTypeListObjects];
+        [parser consumeNetworkingResponse:response];
+        [parser consumeNetworkingResponseBody:bodyData];
+        TOSListObjectsOutput *output = [parser buildOutputObject:nil];
+        XCTAssertEqual(1000, output.tosContents.count);
+    }];
+}
+
+- (void)testBenchmarkParseHeadObject {
+    NSHTTPURLResponse *response = [self responseWithHeaders:[self objectResponseHeaders]];
+    [self benchmark:@"buildOutputObject.HeadObject" iterations:5000 bytesPerOp:0 block:^{
+        TOSNetworkingResponseParser *parser = [[TOSNetworkingResponseParser alloc] initWithOperationType:TOSOperationTypeHeadObject];
+        [parser consumeNetworkingResponse:response];
+        TOSHeadObjectOutput *output = [parser buildOutputObject:nil];
+        XCTAssertNotNil(output.tosETag);
+    }];
+}
+
+- (void)testBenchmarkParseGetObject {
+    NSHTTPURLResponse *response = [self responseWithHeaders:[self objectResponseHeaders]];
+    NSData *body = [self randomDataWithLength:4096];
+    [self benchmark:@"buildOutputObject.GetObject.4KiB" iterations:5000 bytesPerOp:body.length block:^{
+        TOSNetworkingResponseParser *parser = [[TOSNetworkingResponseParser alloc] initWithOperationType:TOSOperationTypeGetObject];
+        [parser consumeNetworkingResponse:response];
+        [parser consumeNetworkingResponseBody:body];
+        TOSGetObjectOutput *output = [parser buildOutputObject:nil];
+        XCTAssertEqual(body.length, output.tosContent.length);
+    }];
+}
+
+#pragma mark - 端到端
+
+- (TOSLocalServer *)startLocalServer {
+    NSDictionary *environment = [[NSProcessInfo processInfo] environment];
+    TOSLocalServer *server = [TOSLocalServer new];
+    server.latency = [environment[@"TOS_BENCHMARK_LATENCY_MS"] doubleValue] / 1000;
+    server.bandwidth = strtoull([environment[@"TOS_BENCHMARK_BANDWIDTH"] ?: @"0" UTF8String], NULL, 10);
+    server.errorRate = [environment[@"TOS_BENCHMARK_ERROR_RATE"] doubleValue];
+    NSError *error = nil;
+    XCTAssertTrue([server start:&error], @"%@", error);
+    return server;
+}
+
+- (TOSClient *)clientWithEndpoint:(NSString *)URLString protocolClasses:(NSArray<Class> *)protocolClasses {
+    TOSCredential *credential = [[TOSCredential alloc] initWithAccessKey:@"AKLTbenchmarkaccesskey" secretKey:@"benchmarksecretkeybenchmarksecretkey"];
+    TOSEndpoint *endpoint = [[TOSEndpoint alloc] initWithURLString:URLString withRegion:@"cn-beijing" isCustomDomain:YES];
+    TOSClientConfiguration *config = [[TOSClientConfiguration alloc] initWithEndpoint:endpoint credential:credential];
+    config.protocolClasses = protocolClasses;
+    return [[TOSClient alloc] initWithConfiguration:config];
+}
+
+- (TOSClient *)clientWithServer:(TOSLocalServer *)server {
+    return [self clientWithEndpoint:server.endpoint protocolClasses:nil];
+}
+
+- (TOSClient *)clientWithSimulator:(TOSNetworkSimulator *)simulator {
+    return [self clientWithEndpoint:simulator.endpoint protocolClasses:@[[TOSNetworkSimulator protocolClass]]];
+}
+
+// 峰值RSS为进程级累计值，记录的是该用例结束时的进程峰值
+- (NSMutableDictionary *)recordEndToEnd:(NSString *)name server:(TOSLocalServer *)server requestsBefore:(int64_t)requestsBefore bytes:(uint64_t)bytes start:(CFAbsoluteTime)start {
+    double seconds = CFAbsoluteTimeGetCurrent() - start;
+    int64_t requests = server.requestCount - requestsBefore;
+    NSMutableDictionary *result = [NSMutableDictionary dictionary];
+    result[@"name"] = name;
+    result[@"seconds"] = @(seconds);
+    result[@"requests"] = @(requests);
+    result[@"requests_per_sec"] = @(requests / seconds);
+    result[@"peak_rss_bytes"] = @(TOSBenchmarkPeakResidentSize());
+    result[@"server_latency_ms"] = @(server.latency * 1000);
+    result[@"server_bandwidth"] = @(server.bandwidth);
+    result[@"server_error_rate"] = @(server.errorRate);
+    result[@"injected_errors"] = @(server.injectedErrorCount);
+    if (bytes > 0) {
+        result[@"bytes"] = @(bytes);
+        result[@"mb_per_sec"] = @(bytes / seconds / 1024 / 1024);
+    }
+    @synchronized (TOSBenchmarkResults) {
+        [TOSBenchmarkResults addObject:result];
+    }
+    NSLog(@"%@: %.2fs, %lld requests", name, seconds, requests);
+    return result;
+}
+
+- (void)testBenchmarkEndToEndPutGetObject {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:1024 * 1024];
+    int count = 64;
+
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (int i = 0; i < count; i++) {
+        TOSPutObjectInput *put = [TOSPutObjectInput new];
+        put.tosBucket = @"local-bucket";
+        put.tosKey = [NSString stringWithFormat:@"put-get/%d", i];
+        put.tosContent = data;
+        TOSTask *task = [client putObject:put];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+    }
+    [self recordEndToEnd:@"e2e.putObject.1MiB" server:server requestsBefore:requestsBefore bytes:(uint64_t)data.length * count start:start];
+
+    requestsBefore = server.requestCount;
+    start = CFAbsoluteTimeGetCurrent();
+    for (int i = 0; i < count; i++) {
+        TOSGetObjectInput *get = [TOSGetObjectInput new];
+        get.tosBucket = @"local-bucket";
+        get.tosKey = [NSString stringWithFormat:@"put-get/%d", i];
+        TOSTask *task = [client getObject:get];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        XCTAssertEqualObjects(data, ((TOSGetObjectOutput *)task.result).tosContent);
+    }
+    [self recordEndToEnd:@"e2e.getObject.1MiB" server:server requestsBefore:requestsBefore bytes:(uint64_t)data.length * count start:start];
+    [server stop];
+}
+
+- (void)testBenchmarkEndToEndUploadFile {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:64 * 1024 * 1024];
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-benchmark-upload"];
+    [data writeToFile:path atomically:YES];
+
+    TOSUploadFileInput *input = [TOSUploadFileInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"upload-file";
+    input.tosFilePath = path;
+    input.tosPartSize = 8 * 1024 * 1024;
+    input.tosTaskNum = 4;
+
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    TOSTask *task = [client uploadFile:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    [self recordEndToEnd:@"e2e.uploadFile.64MiB" server:server requestsBefore:requestsBefore bytes:data.length start:start];
+    XCTAssertEqualObjects(data, [server objectForKey:@"upload-file"]);
+
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    [server stop];
+}
+
+- (void)testBenchmarkEndToEndGetObjectToFile {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:64 * 1024 * 1024];
+    [server putObject:data forKey:@"get-to-file"];
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-benchmark-download"];
+
+    TOSGetObjectToFileInput *input = [TOSGetObjectToFileInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"get-to-file";
+    input.tosFilePath = path;
+
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    TOSTask *task = [client getObjectToFile:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    [self recordEndToEnd:@"e2e.getObjectToFile.64MiB" server:server requestsBefore:requestsBefore bytes:data.length start:start];
+    XCTAssertEqualObjects(data, [NSData dataWithContentsOfFile:path]);
+
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    [server stop];
+}
+
+- (void)testBenchmarkEndToEndListObjects {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:128];
+    int count = 5000;
+    for (int i = 0; i < count; i++) {
+        [server putObject:data forKey:[NSString stringWithFormat:@"list/%05d", i]];
+    }
+
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    NSUInteger listed = 0;
+    NSString *marker = nil;
+    while (YES) {
+        TOSListObjectsInput *input = [TOSListObjectsInput new];
+        input.tosBucket = @"local-bucket";
+        input.tosPrefix = @"list/";
+        input.tosMaxKeys = 100;
+        input.tosMarker = marker;
+        TOSTask *task = [client listObjects:input];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        TOSListObjectsOutput *output = task.result;
+        listed += output.tosContents.count;
+        if (!output.tosIsTruncated || task.error) {
+            break;
+        }
+        marker = output.tosNextMarker;
+    }
+    [self recordEndToEnd:@"e2e.listObjects.5000" server:server requestsBefore:requestsBefore bytes:0 start:start];
+    XCTAssertEqual(count, listed);
+
+    requestsBefore = server.requestCount;
+    start = CFAbsoluteTimeGetCurrent();
+    for (int i = 0; i < 1000; i++) {
+        TOSHeadObjectInput *input = [TOSHeadObjectInput new];
+        input.tosBucket = @"local-bucket";
+        input.tosKey = [NSString stringWithFormat:@"list/%05d", i];
+        TOSTask *task = [client headObject:input];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+    }
+    [self recordEndToEnd:@"e2e.headObject" server:server requestsBefore:requestsBefore bytes:0 start:start];
+    [server stop];
+}
+
+// 按前缀流式删除：边列举边以1000个一批并发DeleteMultiObjects，功能用例见TOSDeleteObjectsTests
+- (void)testBenchmarkEndToEndDeleteObjectsByPrefix {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:16];
+    int count = 20000;
+    for (int i = 0; i < count; i++) {
+        [server putObject:data forKey:[NSString stringWithFormat:@"bulk/%05d", i]];
+    }
+
+    TOSDeleteObjectsByPrefixInput *input = [TOSDeleteObjectsByPrefixInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosPrefix = @"bulk/";
+    input.tosTaskNum = 4;
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    TOSTask *task = [client deleteObjectsByPrefix:input];
+    [task waitUntilFinished];
+    NSMutableDictionary *result = [self recordEndToEnd:@"e2e.deleteObjectsByPrefix.20000" server:server requestsBefore:requestsBefore bytes:0 start:start];
+    result[@"objects_per_sec"] = @([task.result tosObjectsPerSecond]);
+    [server stop];
+}
+
+// 40MB对象按5MB分段并发复制，功能用例见TOSCopyFileTests
+- (void)testBenchmarkEndToEndCopyFile {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:40 * 1024 * 1024];
+    [server putObject:data forKey:@"copy/src"];
+
+    TOSCopyFileInput *input = [TOSCopyFileInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"copy/dst";
+    input.tosSrcBucket = @"local-bucket";
+    input.tosSrcKey = @"copy/src";
+    input.tosPartSize = 5 * 1024 * 1024;
+    input.tosTaskNum = 4;
+    input.tosCopyThreshold = 8 * 1024 * 1024;
+    input.tosEnableCheckpoint = YES;
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    TOSTask *task = [client copyFile:input];
+    [task waitUntilFinished];
+    [self recordEndToEnd:@"e2e.copyFile.40MiB" server:server requestsBefore:requestsBefore bytes:data.length start:start];
+    [server stop];
+}
+
+// 100个对象各headObject 20轮，除首轮外均由元数据缓存返回，功能用例见TOSHeadObjectCacheTests
+- (void)testBenchmarkEndToEndHeadObjectCache {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    TOSObjectMetadataCache *cache = [[TOSObjectMetadataCache alloc] initWithMaxEntryCount:1000 maxBytes:1024 * 1024 ttl:3600];
+    client.clientConfiguration.objectMetadataCache = cache;
+    int keyCount = 100;
+    int rounds = 20;
+    for (int i = 0; i < keyCount; i++) {
+        [server putObject:[self randomDataWithLength:16] forKey:[NSString stringWithFormat:@"head/%03d", i]];
+    }
+
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < keyCount; i++) {
+            TOSHeadObjectInput *input = [TOSHeadObjectInput new];
+            input.tosBucket = @"local-bucket";
+            input.tosKey = [NSString stringWithFormat:@"head/%03d", i];
+            TOSTask *task = [client headObject:input];
+            [task waitUntilFinished];
+            XCTAssertNil(task.error);
+        }
+    }
+    NSMutableDictionary *result = [self recordEndToEnd:@"e2e.headObject.cached" server:server requestsBefore:requestsBefore bytes:0 start:start];
+    result[@"hits"] = @(cache.hitCount);
+    result[@"misses"] = @(cache.missCount);
+    client.clientConfiguration.objectMetadataCache = nil;
+    [server stop];
+}
+
+// 同一对象分别经网络、经磁盘缓存并以304校验、经磁盘缓存不校验读取，比较单次getObject延迟，功能用例见TOSObjectDiskCacheTests
+- (void)testBenchmarkEndToEndGetObjectDiskCache {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-benchmark-disk-cache"];
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+    TOSObjectDiskCache *cache = [[TOSObjectDiskCache alloc] initWithDirectory:directory maxBytes:64 * 1024 * 1024 segmentSize:256 * 1024];
+    NSData *data = [self randomDataWithLength:4 * 1024 * 1024];
+    [server putObject:data forKey:@"disk-cache"];
+    int count = 50;
+    int64_t rangeLength = 64 * 1024;
+
+    NSArray<NSString *> *modes = @[@"network", @"revalidated", @"fresh"];
+    for (NSString *mode in modes) {
+        client.clientConfiguration.objectDiskCache = [mode isEqualToString:@"network"] ? nil : cache;
+        cache.revalidationInterval = [mode isEqualToString:@"fresh"] ? 3600 : 0;
+        if (client.clientConfiguration.objectDiskCache && cache.totalBytes == 0) {
+            // 预热：完整下载一次，写入全部分段
+            TOSGetObjectInput *warmup = [TOSGetObjectInput new];
+            warmup.tosBucket = @"local-bucket";
+            warmup.tosKey = @"disk-cache";
+            [[client getObject:warmup] waitUntilFinished];
+        }
+        [cache resetStatistics];
+        int64_t requestsBefore = server.requestCount;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < count; i++) {
+            TOSGetObjectInput *input = [TOSGetObjectInput new];
+            input.tosBucket = @"local-bucket";
+            input.tosKey = @"disk-cache";
+            input.tosRangeStart = (i * 37 % 60) * rangeLength + 1000;
+            input.tosRangeEnd = input.tosRangeStart + rangeLength - 1;
+            TOSTask *task = [client getObject:input];
+            [task waitUntilFinished];
+            XCTAssertNil(task.error);
+        }
+        NSString *name = [NSString stringWithFormat:@"e2e.getObject.diskCache.%@.64KiB", mode];
+        NSMutableDictionary *result = [self recordEndToEnd:name server:server requestsBefore:requestsBefore bytes:(uint64_t)rangeLength * count start:start];
+        result[@"us_per_get"] = @(([result[@"seconds"] doubleValue]) * 1e6 / count);
+        result[@"hits"] = @(cache.hitCount);
+        result[@"misses"] = @(cache.missCount);
+    }
+
+    client.clientConfiguration.objectDiskCache = nil;
+    [cache removeAllObjects];
+    [server stop];
+}
+
+// 连续读取和随机读取分别比较逐次区间getObject与TOSObjectReader，功能用例见TOSObjectReaderTests
+- (void)testBenchmarkEndToEndObjectReader {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:16 * 1024 * 1024];
+    [server putObject:data forKey:@"reader"];
+    TOSGetObjectInput *readerInput = [TOSGetObjectInput new];
+    readerInput.tosBucket = @"local-bucket";
+    readerInput.tosKey = @"reader";
+
+    NSUInteger chunk = 64 * 1024;
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger offset = 0; offset < data.length; offset += chunk) {
+        TOSGetObjectInput *input = [TOSGetObjectInput new];
+        input.tosBucket = @"local-bucket";
+        input.tosKey = @"reader";
+        input.tosRangeStart = offset;
+        input.tosRangeEnd = offset + chunk - 1;
+        TOSTask *task = [client getObject:input];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+    }
+    [self recordEndToEnd:@"e2e.objectReader.sequential.naive.64KiB" server:server requestsBefore:requestsBefore bytes:data.length start:start];
+
+    TOSObjectReader *reader = [[TOSObjectReader alloc] initWithClient:client input:readerInput];
+    requestsBefore = server.requestCount;
+    start = CFAbsoluteTimeGetCurrent();
+    while (YES) {
+        TOSTask *task = [reader readLength:chunk];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        if ([task.result length] == 0) {
+            break;
+        }
+    }
+    NSMutableDictionary *result = [self recordEndToEnd:@"e2e.objectReader.sequential.reader.64KiB" server:server requestsBefore:requestsBefore bytes:data.length start:start];
+    result[@"block_hits"] = @(reader.blockHitCount);
+    result[@"block_misses"] = @(reader.blockMissCount);
+    [reader close];
+
+    // 随机读取：固定的伪随机偏移，两种方式读取相同的位置
+    int count = 200;
+    NSUInteger readLength = 4 * 1024;
+    NSMutableArray<NSNumber *> *offsets = [NSMutableArray arrayWithCapacity:count];
+    for (int i = 0; i < count; i++) {
+        [offsets addObject:@((uint64_t)i * 2654435761u % (data.length - readLength))];
+    }
+    requestsBefore = server.requestCount;
+    start = CFAbsoluteTimeGetCurrent();
+    for (NSNumber *offset in offsets) {
+        TOSGetObjectInput *input = [TOSGetObjectInput new];
+        input.tosBucket = @"local-bucket";
+        input.tosKey = @"reader";
+        input.tosRangeStart = offset.longLongValue;
+        input.tosRangeEnd = offset.longLongValue + readLength - 1;
+        TOSTask *task = [client getObject:input];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+    }
+    [self recordEndToEnd:@"e2e.objectReader.random.naive.4KiB" server:server requestsBefore:requestsBefore bytes:(uint64_t)readLength * count start:start];
+
+    reader = [[TOSObjectReader alloc] initWithClient:client input:readerInput];
+    reader.blockSize = 16 * 1024;
+    requestsBefore = server.requestCount;
+    start = CFAbsoluteTimeGetCurrent();
+    for (NSNumber *offset in offsets) {
+        TOSTask *task = [reader readAtOffset:offset.longLongValue length:readLength];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+    }
+    result = [self recordEndToEnd:@"e2e.objectReader.random.reader.4KiB" server:server requestsBefore:requestsBefore bytes:(uint64_t)readLength * count start:start];
+    result[@"block_hits"] = @(reader.blockHitCount);
+    result[@"block_misses"] = @(reader.blockMissCount);
+    [reader close];
+    [server stop];
+}
+
+// 模拟列存文件读取：尾部元数据加8组列块，每组8个相距4KB的区间，比较逐个区间下载与合并后的批量区间下载，功能用例见TOSGetObjectRangesTests
+- (void)testBenchmarkEndToEndGetObjectRanges {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:32 * 1024 * 1024];
+    [server putObject:data forKey:@"ranges"];
+    int64_t rangeLength = 8 * 1024;
+    NSMutableArray<TOSGetObjectRange *> *ranges = [NSMutableArray array];
+    for (int g = 0; g < 8; g++) {
+        for (int i = 0; i < 8; i++) {
+            TOSGetObjectRange *range = [TOSGetObjectRange new];
+            range.tosRangeStart = (int64_t)g * 4 * 1024 * 1024 + i * (rangeLength + 4 * 1024);
+            range.tosRangeEnd = range.tosRangeStart + rangeLength - 1;
+            [ranges addObject:range];
+        }
+    }
+    TOSGetObjectRange *footer = [TOSGetObjectRange new];
+    footer.tosRangeStart = data.length - 64 * 1024;
+    footer.tosRangeEnd = data.length + 1024; // 超出对象末尾的部分被截断
+    [ranges addObject:footer];
+    uint64_t bytes = (uint64_t)rangeLength * 64 + 64 * 1024;
+
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (TOSGetObjectRange *range in ranges) {
+        TOSGetObjectInput *input = [TOSGetObjectInput new];
+        input.tosBucket = @"local-bucket";
+        input.tosKey = @"ranges";
+        input.tosRangeStart = range.tosRangeStart;
+        input.tosRangeEnd = range.tosRangeEnd;
+        TOSTask *task = [client getObject:input];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+    }
+    [self recordEndToEnd:@"e2e.getObjectRanges.naive" server:server requestsBefore:requestsBefore bytes:bytes start:start];
+
+    TOSGetObjectRangesInput *input = [TOSGetObjectRangesInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"ranges";
+    input.tosRanges = ranges;
+    requestsBefore = server.requestCount;
+    start = CFAbsoluteTimeGetCurrent();
+    TOSTask *task = [client getObjectRanges:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    NSMutableDictionary *result = [self recordEndToEnd:@"e2e.getObjectRanges.coalesced" server:server requestsBefore:requestsBefore bytes:bytes start:start];
+    TOSGetObjectRangesOutput *output = task.result;
+    result[@"merged_requests"] = @(output.tosRequestCount);
+    [server stop];
+}
+
+// 流式写入：分段并发上传与一次putObject整体上传比较，功能用例见TOSObjectWriterTests
+- (void)testBenchmarkEndToEndObjectWriter {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:48 * 1024 * 1024];
+    NSUInteger chunk = 64 * 1024;
+
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    TOSPutObjectInput *put = [TOSPutObjectInput new];
+    put.tosBucket = @"local-bucket";
+    put.tosKey = @"writer/put";
+    put.tosContent = data;
+    TOSTask *task = [client putObject:put];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    [self recordEndToEnd:@"e2e.objectWriter.putObject" server:server requestsBefore:requestsBefore bytes:data.length start:start];
+
+    TOSCreateMultipartUploadInput *writerInput = [TOSCreateMultipartUploadInput new];
+    writerInput.tosBucket = @"local-bucket";
+    writerInput.tosKey = @"writer/multipart";
+    TOSObjectWriter *writer = [[TOSObjectWriter alloc] initWithClient:client input:writerInput];
+    writer.partSize = 5 * 1024 * 1024;
+    writer.taskNum = 3;
+    requestsBefore = server.requestCount;
+    start = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger offset = 0; offset < data.length; offset += chunk) {
+        [writer write:[data subdataWithRange:NSMakeRange(offset, MIN(chunk, data.length - offset))] error:nil];
+    }
+    task = [writer close];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    NSMutableDictionary *result = [self recordEndToEnd:@"e2e.objectWriter.multipart.5MiB" server:server requestsBefore:requestsBefore bytes:data.length start:start];
+    result[@"parts"] = @(writer.partCount);
+    [server stop];
+}
+
+// 新建Client后的首批小对象GET承担建连耗时，预热后复用已建立的连接；服务端为每个新连接附加50ms模拟握手，功能用例见TOSPrewarmTests
+- (void)testBenchmarkEndToEndPrewarm {
+    TOSLocalServer *server = [self startLocalServer];
+    server.connectionLatency = 0.05;
+    [server putObject:[self randomDataWithLength:4 * 1024] forKey:@"prewarm/small"];
+    int trials = 10;
+    int burst = 4;
+    for (int warm = 0; warm < 2; warm++) {
+        NSMutableArray<NSNumber *> *latencies = [NSMutableArray array];
+        int64_t connectionsBefore = server.connectionCount;
+        int64_t requestsBefore = server.requestCount;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (int t = 0; t < trials; t++) {
+            TOSClient *client = [self clientWithServer:server];
+            if (warm) {
+                TOSPrewarmInput *input = [TOSPrewarmInput new];
+                input.tosKey = @"prewarm/small";
+                input.tosConnectionCount = burst;
+                TOSTask *task = [client prewarm:input];
+                [task waitUntilFinished];
+                XCTAssertNil(task.error);
+            }
+            NSMutableArray<TOSTask *> *tasks = [NSMutableArray arrayWithCapacity:burst];
+            for (int i = 0; i < burst; i++) {
+                TOSGetObjectInput *get = [TOSGetObjectInput new];
+                get.tosBucket = @"local-bucket";
+                get.tosKey = @"prewarm/small";
+                CFAbsoluteTime begin = CFAbsoluteTimeGetCurrent();
+                [tasks addObject:[[client getObject:get] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+                    XCTAssertNil(task.error);
+                    @synchronized (latencies) {
+                        [latencies addObject:@(CFAbsoluteTimeGetCurrent() - begin)];
+                    }
+                    return nil;
+                }]];
+            }
+            [[TOSTask taskForCompletionOfAllTasks:tasks] waitUntilFinished];
+        }
+        NSMutableDictionary *result = [self recordEndToEnd:(warm ? @"e2e.prewarm.warm.4KiB" : @"e2e.prewarm.cold.4KiB") server:server requestsBefore:requestsBefore bytes:0 start:start];
+        NSArray<NSNumber *> *sorted = [latencies sortedArrayUsingSelector:@selector(compare:)];
+        result[@"p50_ms"] = @(sorted[sorted.count / 2].doubleValue * 1000);
+        result[@"p99_ms"] = @(sorted[MIN(sorted.count - 1, (NSUInteger)(sorted.count * 0.99))].doubleValue * 1000);
+        result[@"connections"] = @(server.connectionCount - connectionsBefore);
+        result[@"connection_latency_ms"] = @(server.connectionLatency * 1000);
+    }
+    [server stop];
+}
+
+// 每个租户一个Client：比较各自创建传输、延迟创建传输和共享传输时100个Client的创建耗时与服务端接受的连接数，功能用例见TOSSharedTransportTests
+- (void)testBenchmarkEndToEndSharedTransport {
+    TOSLocalServer *server = [self startLocalServer];
+    [server putObject:[self randomDataWithLength:4 * 1024] forKey:@"transport/small"];
+    int clientCount = 100;
+    NSArray<NSString *> *modes = @[@"isolated", @"lazy", @"shared"];
+    for (NSUInteger mode = 0; mode < modes.count; mode++) {
+        NSMutableArray<TOSClientConfiguration *> *configs = [NSMutableArray arrayWithCapacity:clientCount];
+        for (int i = 0; i < clientCount; i++) {
+            // 各Client使用自己的凭证签名
+            TOSCredential *credential = [[TOSCredential alloc] initWithAccessKey:[NSString stringWithFormat:@"AKLTbenchmarktenant%d", i] secretKey:@"benchmarksecretkeybenchmarksecretkey"];
+            TOSEndpoint *endpoint = [[TOSEndpoint alloc] initWithURLString:server.endpoint withRegion:@"cn-beijing" isCustomDomain:YES];
+            [configs addObject:[[TOSClientConfiguration alloc] initWithEndpoint:endpoint credential:credential]];
+        }
+        TOSNetworkingTransport *transport = nil;
+        if (mode == 2) {
+            transport = [[TOSNetworkingTransport alloc] initWithConfiguration:configs[0]];
+        }
+        NSMutableArray<TOSClient *> *clients = [NSMutableArray arrayWithCapacity:clientCount];
+        CFAbsoluteTime createStart = CFAbsoluteTimeGetCurrent();
+        for (TOSClientConfiguration *config in configs) {
+            config.lazyTransport = mode == 1;
+            config.transport = transport;
+            [clients addObject:[[TOSClient alloc] initWithConfiguration:config]];
+        }
+        double createSeconds = CFAbsoluteTimeGetCurrent() - createStart;
+
+        int64_t connectionsBefore = server.connectionCount;
+        int64_t requestsBefore = server.requestCount;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (TOSClient *client in clients) {
+            TOSGetObjectInput *get = [TOSGetObjectInput new];
+            get.tosBucket = @"local-bucket";
+            get.tosKey = @"transport/small";
+            TOSTask *task = [client getObject:get];
+            [task waitUntilFinished];
+            XCTAssertNil(task.error);
+        }
+        NSString *name = [NSString stringWithFormat:@"e2e.transport.%@.100clients", modes[mode]];
+        NSMutableDictionary *result = [self recordEndToEnd:name server:server requestsBefore:requestsBefore bytes:0 start:start];
+        result[@"connections"] = @(server.connectionCount - connectionsBefore);
+        result[@"create_us_per_client"] = @(createSeconds * 1e6 / clientCount);
+        [clients removeAllObjects];
+        [transport invalidate];
+    }
+    [server stop];
+}
+
+- (void)testBenchmarkEndToEndAppendObject {
+    TOSLocalServer *server = [self startLocalServer];
+    TOSClient *client = [self clientWithServer:server];
+    NSData *data = [self randomDataWithLength:256 * 1024];
+    int count = 64;
+
+    int64_t requestsBefore = server.requestCount;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    int64_t offset = 0;
+    for (int i = 0; i < count; i++) {
+        TOSAppendObjectInput *input = [TOSAppendObjectInput new];
+        input.tosBucket = @"local-bucket";
+        input.tosKey = @"append";
+        input.tosOffset = offset;
+        input.tosContent = data;
+        TOSTask *task = [client appendObject:input];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        offset = ((TOSAppendObjectOutput *)task.result).tosNextAppendOffset;
+    }
+    [self recordEndToEnd:@"e2e.appendObject.256KiB" server:server requestsBefore:requestsBefore bytes:(uint64_t)data.length * count start:start];
+    [server stop];
+}
+
+#pragma mark - 网络模拟
+
+// 相同seed下脚本化错误按请求序号精确命中
+- (void)testSimulatedErrorBurst {
+    TOSNetworkSimulator *simulator = [[TOSNetworkSimulator alloc] initWithBackend:[TOSLocalServer new] seed:1];
+    [simulator addBurstWithStatusCode:503 fromRequest:1 count:2 retryAfter:0];
+    [simulator addBurstWithStatusCode:429 fromRequest:3 count:1 retryAfter:1];
+    TOSClient *client = [self clientWithSimulator:simulator];
+
+    NSMutableArray<NSNumber *> *statusCodes = [NSMutableArray array];
+    for (int i = 0; i < 5; i++) {
+        TOSPutObjectInput *put = [TOSPutObjectInput new];
+        put.tosBucket = @"local-bucket";
+        put.tosKey = [NSString stringWithFormat:@"burst/%d", i];
+        put.tosContent = [self randomDataWithLength:1024];
+        TOSTask *task = [client putObject:put];
+        [task waitUntilFinished];
+        if (task.error) {
+            XCTAssertEqualObjects(TOSServerErrorDomain, task.error.domain);
+            [statusCodes addObject:@(task.error.code)];
+        } else {
+            [statusCodes addObject:@(((TOSOutput *)task.result).tosStatusCode)];
+        }
+    }
+    NSArray *expected = @[@200, @503, @503, @429, @200];
+    XCTAssertEqualObjects(expected, statusCodes);
+    XCTAssertEqual(5, simulator.requestCount);
+    XCTAssertEqual(3, simulator.scriptedErrorCount);
+    XCTAssertNotNil([simulator.backend objectForKey:@"burst/4"]);
+    XCTAssertNil([simulator.backend objectForKey:@"burst/1"]);
+}
+
+// 取消uploadFile后在传的分片应被立即中断，而不是传完当前分片
+- (void)testSimulatedCancelAbortsInFlightParts {
+    NSData *data = [self randomDataWithLength:20 * 1024 * 1024];
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-simulated-cancel"];
+    [data writeToFile:path atomically:YES];
+
+    TOSNetworkSimulator *simulator = [[TOSNetworkSimulator alloc] initWithBackend:[TOSLocalServer new] seed:1];
+    simulator.rtt = 0.05;
+    simulator.bandwidth = 1024 * 1024; // 每个分片约需5秒
+    TOSClient *client = [self clientWithSimulator:simulator];
+
+    TOSUploadFileInput *input = [TOSUploadFileInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"simulated-cancel";
+    input.tosFilePath = path;
+    input.tosPartSize = 5 * 1024 * 1024;
+    input.tosTaskNum = 4;
+
+    TOSTask *task = [client uploadFile:input];
+    [NSThread sleepForTimeInterval:0.5];
+    XCTAssertFalse(task.completed);
+    CFAbsoluteTime cancelTime = CFAbsoluteTimeGetCurrent();
+    input.isCancelled = YES;
+    [task waitUntilFinished];
+    double seconds = CFAbsoluteTimeGetCurrent() - cancelTime;
+
+    XCTAssertNotNil(task.error);
+    XCTAssertLessThan(seconds, 1.0);
+    XCTAssertNil([simulator.backend objectForKey:@"simulated-cancel"]);
+    NSLog(@"uploadFile cancelled in %.3fs", seconds);
+    [simulator invalidate];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+// 固定RTT、单连接带宽和连接上限下比较不同分片并发数的uploadFile吞吐
+- (void)testBenchmarkSimulatedUploadFileConcurrency {
+    NSData *data = [self randomDataWithLength:40 * 1024 * 1024];
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-benchmark-simulated-upload"];
+    [data writeToFile:path atomically:YES];
+
+    for (NSNumber *taskNum in @[@1, @2, @4, @8]) {
+        TOSNetworkSimulator *simulator = [[TOSNetworkSimulator alloc] initWithBackend:[TOSLocalServer new] seed:42];
+        simulator.rtt = 0.03;
+        simulator.bandwidth = 16 * 1024 * 1024;
+        simulator.serverLatency = 0.01;
+        simulator.latencySigma = 0.5;
+        simulator.tailProbability = 0.05;
+        simulator.tailLatency = 0.2;
+        simulator.maxConnections = 6;
+        TOSClient *client = [self clientWithSimulator:simulator];
+
+        TOSUploadFileInput *input = [TOSUploadFileInput new];
+        input.tosBucket = @"local-bucket";
+        input.tosKey = @"simulated-upload";
+        input.tosFilePath = path;
+        input.tosPartSize = 5 * 1024 * 1024;
+        input.tosTaskNum = [taskNum intValue];
+
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        TOSTask *task = [client uploadFile:input];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        double seconds = CFAbsoluteTimeGetCurrent() - start;
+        XCTAssertEqualObjects(data, [simulator.backend objectForKey:@"simulated-upload"]);
+
+        NSDictionary *result = @{
+            @"name": [NSString stringWithFormat:@"simulated.uploadFile.40MiB.task%@", taskNum],
+            @"seconds": @(seconds),
+            @"requests": @(simulator.requestCount),
+            @"mb_per_sec": @(data.length / seconds / 1024 / 1024),
+            @"max_active_connections": @(simulator.maxActiveConnections),
+        };
+        @synchronized (TOSBenchmarkResults) {
+            [TOSBenchmarkResults addObject:result];
+        }
+        NSLog(@"%@: %.2fs", result[@"name"], seconds);
+        [simulator invalidate];
+    }
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+// 小请求的单次延迟与TOSTask分配数，对比同步拦截快速路径与异步拦截流程
+- (void)testBenchmarkSmallRequestPipeline {
+    TOSNetworkSimulator *simulator = [[TOSNetworkSimulator alloc] initWithBackend:[TOSLocalServer new] seed:1];
+    [simulator.backend putObject:[self randomDataWithLength:16] forKey:@"small"];
+    TOSClient *client = [self clientWithSimulator:simulator];
+    NSArray<id<TOSNetworkingRequestInterceptor>> *interceptors = client.clientConfiguration.requestInterceptors;
+    int count = 2000;
+
+    for (NSString *mode in @[@"sync", @"async"]) {
+        if ([mode isEqualToString:@"async"]) {
+            client.clientConfiguration.requestInterceptors = [interceptors arrayByAddingObject:[TOSBenchmarkAsyncInterceptor new]];
+        }
+        TOSHeadObjectInput *input = [TOSHeadObjectInput new];
+        input.tosBucket = @"local-bucket";
+        input.tosKey = @"small";
+        [[client headObject:input] waitUntilFinished];
+
+        int64_t allocationsBefore = TOSBenchmarkTaskAllocations;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < count; i++) {
+            @autoreleasepool {
+                TOSTask *task = [client headObject:input];
+                [task waitUntilFinished];
+                XCTAssertNil(task.error);
+            }
+        }
+        double seconds = CFAbsoluteTimeGetCurrent() - start;
+        NSDictionary *result = @{
+            @"name": [NSString stringWithFormat:@"pipeline.headObject.%@", mode],
+            @"requests": @(count),
+            @"us_per_request": @(seconds * 1e6 / count),
+            @"task_allocations_per_request": @((double)(TOSBenchmarkTaskAllocations - allocationsBefore) / count),
+        };
+        @synchronized (TOSBenchmarkResults) {
+            [TOSBenchmarkResults addObject:result];
+        }
+        NSLog(@"%@: %.1fus, %.1f tasks/request", result[@"name"], [result[@"us_per_request"] doubleValue], [result[@"task_allocations_per_request"] doubleValue]);
+    }
+    client.clientConfiguration.requestInterceptors = interceptors;
+    [simulator invalidate];
+}
+
+// 逐条appendObject与TOSAppendObjectWriter合并写入的记录吞吐对比
+- (void)testBenchmarkSimulatedAppendObjectWriter {
+    TOSNetworkSimulator *simulator = [[TOSNetworkSimulator alloc] initWithBackend:[TOSLocalServer new] seed:1];
+    simulator.rtt = 0.002;
+    simulator.serverLatency = 0.001;
+    TOSClient *client = [self clientWithSimulator:simulator];
+    NSData *record = [self randomDataWithLength:128];
+    int count = 1000;
+
+    for (NSString *mode in @[@"naive", @"writer"]) {
+        NSString *key = [NSString stringWithFormat:@"append-%@", mode];
+        int64_t requestsBefore = simulator.requestCount;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        if ([mode isEqualToString:@"naive"]) {
+            int64_t offset = 0;
+            for (int i = 0; i < count; i++) {
+                TOSAppendObjectInput *input = [TOSAppendObjectInput new];
+                input.tosBucket = @"local-bucket";
+                input.tosKey = key;
+                input.tosOffset = offset;
+                input.tosContent = record;
+                input.tosContentLength = (int64_t)record.length;
+                TOSTask *task = [client appendObject:input];
+                [task waitUntilFinished];
+                XCTAssertNil(task.error);
+                offset = ((TOSAppendObjectOutput *)task.result).tosNextAppendOffset;
+            }
+        } else {
+            TOSAppendObjectInput *input = [TOSAppendObjectInput new];
+            input.tosBucket = @"local-bucket";
+            input.tosKey = key;
+            TOSAppendObjectWriter *writer = [[TOSAppendObjectWriter alloc] initWithClient:client input:input];
+            writer.bufferSize = 16 * 1024;
+            writer.flushInterval = 0.01;
+            for (int i = 0; i < count; i++) {
+                [writer write:record error:nil];
+            }
+            TOSTask *task = [writer close];
+            [task waitUntilFinished];
+            XCTAssertNil(task.error);
+        }
+        double seconds = CFAbsoluteTimeGetCurrent() - start;
+        NSDictionary *result = @{
+            @"name": [NSString stringWithFormat:@"append.records.%@", mode],
+            @"records": @(count),
+            @"requests": @(simulator.requestCount - requestsBefore),
+            @"records_per_sec": @(count / seconds),
+        };
+        @synchronized (TOSBenchmarkResults) {
+            [TOSBenchmarkResults addObject:result];
+        }
+        NSLog(@"%@: %.0f records/s, %@ requests", result[@"name"], [result[@"records_per_sec"] doubleValue], result[@"requests"]);
+    }
+    [simulator invalidate];
+}
+
+#pragma mark - TOSTask
+
+- (void)runBenchmarkThread:(dispatch_block_t)block {
+    block();
+}
+
+// 64个线程并发完成1M个TOSTask，同时读取同一个已完成任务的状态，并由taskForCompletionOfAllTasks:汇总
+- (void)testBenchmarkTaskContention {
+    const NSUInteger threadCount = 64;
+    const NSUInteger taskCount = 1000000;
+    NSMutableArray<TOSTaskCompletionSource *> *sources = [NSMutableArray arrayWithCapacity:taskCount];
+    NSMutableArray<TOSTask *> *tasks = [NSMutableArray arrayWithCapacity:taskCount];
+    for (NSUInteger i = 0; i < taskCount; i++) {
+        TOSTaskCompletionSource *source = [TOSTaskCompletionSource taskCompletionSource];
+        [sources addObject:source];
+        [tasks addObject:source.task];
+    }
+    TOSTask *all = [TOSTask taskForCompletionOfAllTasks:tasks];
+    TOSTask *shared = [TOSTask taskWithResult:@YES];
+
+    dispatch_semaphore_t start = dispatch_semaphore_create(0);
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger t = 0; t < threadCount; t++) {
+        dispatch_group_enter(group);
+        dispatch_block_t block = ^{
+            dispatch_semaphore_wait(start, DISPATCH_TIME_FOREVER);
+            for (NSUInteger i = t; i < taskCount; i += threadCount) {
+                if (!shared.completed || shared.result == nil) {
+                    break;
+                }
+                [sources[i] setResult:@(i)];
+            }
+            dispatch_group_leave(group);
+        };
+        [[[NSThread alloc] initWithTarget:self selector:@selector(runBenchmarkThread:) object:block] start];
+    }
+
+    CFAbsoluteTime begin = CFAbsoluteTimeGetCurrent();
+    for (NSUInteger t = 0; t < threadCount; t++) {
+        dispatch_semaphore_signal(start);
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    [all waitUntilFinished];
+    double seconds = CFAbsoluteTimeGetCurrent() - begin;
+
+    XCTAssertTrue(all.completed);
+    XCTAssertNil(all.error);
+    XCTAssertFalse(all.cancelled);
+
+    NSDictionary *result = @{
+        @"name": @"task.contention",
+        @"threads": @(threadCount),
+        @"tasks": @(taskCount),
+        @"ns_per_task": @(seconds * 1e9 / taskCount),
+        @"tasks_per_sec": @(taskCount / seconds),
+    };
+    @synchronized (TOSBenchmarkResults) {
+        [TOSBenchmarkResults addObject:result];
+    }
+    NSLog(@"%@: %.1fns/task, %.0f tasks/s", result[@"name"], [result[@"ns_per_task"] doubleValue], [result[@"tasks_per_sec"] doubleValue]);
+}
+
+@end
@@ -0,0 +1,158 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSCopyFileTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+    NSData *_data;
+    NSString *_checkpointFile;
+}
+
+@end
+
+@implementation TOSCopyFileTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+    // 5MB分段时共4个分段
+    _data = [TOSTestUtil randomDataWithLength:20 * 1024 * 1024];
+    [_server putObject:_data forKey:@"copy/src"];
+    _checkpointFile = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-copy-file-tests.copy"];
+    [[NSFileManager defaultManager] removeItemAtPath:_checkpointFile error:nil];
+}
+
+- (void)tearDown {
+    [_server stop];
+    [[NSFileManager defaultManager] removeItemAtPath:_checkpointFile error:nil];
+    [super tearDown];
+}
+
+- (TOSCopyFileInput *)copyFileInput {
+    TOSCopyFileInput *input = [TOSCopyFileInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"copy/dst";
+    input.tosSrcBucket = @"local-bucket";
+    input.tosSrcKey = @"copy/src";
+    input.tosPartSize = 5 * 1024 * 1024;
+    input.tosTaskNum = 1;
+    input.tosCopyThreshold = 8 * 1024 * 1024;
+    input.tosEnableCheckpoint = YES;
+    input.tosCheckpointFile = _checkpointFile;
+    return input;
+}
+
+- (void)testAPI_copyFile {
+    TOSCopyFileInput *input = [self copyFileInput];
+    input.tosTaskNum = 3;
+    int64_t requestsBefore = _server.requestCount;
+    TOSTask *task = [_client copyFile:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    TOSCopyFileOutput *output = task.result;
+    XCTAssertEqual(4, output.tosPartCount);
+    XCTAssertNotNil(output.tosUploadID);
+    XCTAssertEqual([TOSUtil crc64ecma:0 buffer:(void *)_data.bytes length:_data.length], output.tosHashCrc64ecma);
+    XCTAssertEqualObjects(_data, [_server objectForKey:@"copy/dst"]);
+    // HEAD + 创建 + 4个分段 + 合并
+    XCTAssertEqual(7, _server.requestCount - requestsBefore);
+    XCTAssertEqual(0, _server.uploadCount);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:_checkpointFile]);
+}
+
+- (void)testAPI_copyFileSmallObject {
+    // 不超过阈值时使用CopyObject
+    TOSCopyFileInput *input = [self copyFileInput];
+    input.tosKey = @"copy/small";
+    input.tosCopyThreshold = 64 * 1024 * 1024;
+    int64_t requestsBefore = _server.requestCount;
+    TOSTask *task = [_client copyFile:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(0, [task.result tosPartCount]);
+    XCTAssertNil([task.result tosUploadID]);
+    XCTAssertEqual([TOSUtil crc64ecma:0 buffer:(void *)_data.bytes length:_data.length], [task.result tosHashCrc64ecma]);
+    XCTAssertEqualObjects(_data, [_server objectForKey:@"copy/small"]);
+    XCTAssertEqual(2, _server.requestCount - requestsBefore);
+    XCTAssertEqual(0, _server.uploadCount);
+}
+
+- (void)testAPI_copyFileResumeFromCheckpoint {
+    // 复制第2个分段时取消，保留CheckPoint和分段任务
+    TOSCopyFileInput *input = [self copyFileInput];
+    _server.responseHeadersHandler = ^(NSString *method, NSString *key, NSDictionary<NSString *, NSString *> *query, NSMutableDictionary<NSString *, NSString *> *headers) {
+        if ([method isEqualToString:@"PUT"] && [query[@"partNumber"] isEqualToString:@"2"]) {
+            [input cancel];
+        }
+    };
+    TOSTask *task = [_client copyFile:input];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqual(1, _server.uploadCount);
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:_checkpointFile]);
+    XCTAssertNil([_server objectForKey:@"copy/dst"]);
+    
+    // 重试时沿用分段任务，只复制未完成的分段
+    NSMutableArray<NSString *> *copiedParts = [NSMutableArray array];
+    __block BOOL created = NO;
+    _server.responseHeadersHandler = ^(NSString *method, NSString *key, NSDictionary<NSString *, NSString *> *query, NSMutableDictionary<NSString *, NSString *> *headers) {
+        @synchronized (copiedParts) {
+            if ([method isEqualToString:@"PUT"] && query[@"partNumber"]) {
+                [copiedParts addObject:query[@"partNumber"]];
+            } else if ([method isEqualToString:@"POST"] && query[@"uploads"]) {
+                created = YES;
+            }
+        }
+    };
+    task = [_client copyFile:[self copyFileInput]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertFalse(created);
+    XCTAssertFalse([copiedParts containsObject:@"1"]);
+    XCTAssertTrue([copiedParts containsObject:@"4"]);
+    XCTAssertEqual(4, [task.result tosPartCount]);
+    XCTAssertEqual([TOSUtil crc64ecma:0 buffer:(void *)_data.bytes length:_data.length], [task.result tosHashCrc64ecma]);
+    XCTAssertEqualObjects(_data, [_server objectForKey:@"copy/dst"]);
+    XCTAssertEqual(0, _server.uploadCount);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:_checkpointFile]);
+}
+
+- (void)testAPI_copyFileSourceChanged {
+    // 第1个分段复制完成后源对象被覆盖，后续分段返回412，取消分段任务并删除CheckPoint
+    NSData *other = [TOSTestUtil randomDataWithLength:_data.length];
+    __weak TOSLocalServer *server = _server;
+    _server.responseHeadersHandler = ^(NSString *method, NSString *key, NSDictionary<NSString *, NSString *> *query, NSMutableDictionary<NSString *, NSString *> *headers) {
+        if ([method isEqualToString:@"PUT"] && [query[@"partNumber"] isEqualToString:@"1"]) {
+            [server putObject:other forKey:@"copy/src"];
+        }
+    };
+    TOSTask *task = [_client copyFile:[self copyFileInput]];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqualObjects(TOSServerErrorDomain, task.error.domain);
+    XCTAssertEqual(412, task.error.code);
+    XCTAssertEqual(0, _server.uploadCount);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:_checkpointFile]);
+    XCTAssertNil([_server objectForKey:@"copy/dst"]);
+}
+
+@end
@@ -0,0 +1,228 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+// 读出指定个数的对象后取消删除请求，模拟删除过程中用户取消
+@interface TOSCancellingEnumerator : NSEnumerator<TOSObjectTobeDeleted *>
+{
+    NSEnumerator<TOSObjectTobeDeleted *> *_enumerator;
+    __weak TOSInput *_input;
+    NSUInteger _cancelAfter;
+    NSUInteger _count;
+}
+
+- (instancetype)initWithObjects:(NSArray<TOSObjectTobeDeleted *> *)objects input:(TOSInput *)input cancelAfter:(NSUInteger)cancelAfter;
+
+@end
+
+@implementation TOSCancellingEnumerator
+
+- (instancetype)initWithObjects:(NSArray<TOSObjectTobeDeleted *> *)objects input:(TOSInput *)input cancelAfter:(NSUInteger)cancelAfter {
+    if (self = [super init]) {
+        _enumerator = objects.objectEnumerator;
+        _input = input;
+        _cancelAfter = cancelAfter;
+    }
+    return self;
+}
+
+- (TOSObjectTobeDeleted *)nextObject {
+    if (++_count > _cancelAfter) {
+        [_input cancel];
+    }
+    return [_enumerator nextObject];
+}
+
+@end
+
+@interface TOSDeleteObjectsTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+    NSData *_data;
+}
+
+@end
+
+@implementation TOSDeleteObjectsTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+    _data = [TOSTestUtil randomDataWithLength:16];
+}
+
+- (void)tearDown {
+    [_server stop];
+    [super tearDown];
+}
+
+- (NSArray<TOSObjectTobeDeleted *> *)putObjectsWithPrefix:(NSString *)prefix count:(int)count {
+    NSMutableArray<TOSObjectTobeDeleted *> *objects = [NSMutableArray array];
+    for (int i = 0; i < count; i++) {
+        NSString *key = [NSString stringWithFormat:@"%@%05d", prefix, i];
+        [_server putObject:_data forKey:key];
+        TOSObjectTobeDeleted *object = [TOSObjectTobeDeleted new];
+        object.tosKey = key;
+        [objects addObject:object];
+    }
+    return objects;
+}
+
+- (void)testAPI_deleteObjectsByPrefix {
+    [self putObjectsWithPrefix:@"bulk/" count:2500];
+    [_server putObject:_data forKey:@"keep/0"];
+    [_server putObject:_data forKey:@"bulk"];
+    
+    TOSDeleteObjectsByPrefixInput *input = [TOSDeleteObjectsByPrefixInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosPrefix = @"bulk/";
+    TOSTask *task = [_client deleteObjectsByPrefix:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    TOSDeleteObjectsOutput *output = task.result;
+    XCTAssertEqual(2500, output.tosDeletedCount);
+    XCTAssertEqual(0, output.tosErrors.count);
+    // 默认每批1000个
+    XCTAssertEqual(3, output.tosRequestCount);
+    XCTAssertNil([_server objectForKey:@"bulk/00000"]);
+    XCTAssertNil([_server objectForKey:@"bulk/02499"]);
+    // 前缀之外的对象保留
+    XCTAssertNotNil([_server objectForKey:@"keep/0"]);
+    XCTAssertNotNil([_server objectForKey:@"bulk"]);
+    
+    // 已无匹配对象时不发起删除请求
+    task = [_client deleteObjectsByPrefix:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(0, [task.result tosDeletedCount]);
+    XCTAssertEqual(0, [task.result tosRequestCount]);
+}
+
+- (void)testAPI_deleteObjectsByPrefixBatchSize {
+    [self putObjectsWithPrefix:@"bulk/" count:2500];
+    
+    // 每页列举1000个，按400个一批凑满后发起
+    TOSDeleteObjectsByPrefixInput *input = [TOSDeleteObjectsByPrefixInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosPrefix = @"bulk/";
+    input.tosBatchSize = 400;
+    input.tosTaskNum = 2;
+    TOSTask *task = [_client deleteObjectsByPrefix:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(2500, [task.result tosDeletedCount]);
+    XCTAssertEqual(7, [task.result tosRequestCount]);
+    XCTAssertNil([_server objectForKey:@"bulk/01234"]);
+    
+    // 超过1000时按1000处理
+    [self putObjectsWithPrefix:@"bulk/" count:1500];
+    input.tosBatchSize = 5000;
+    task = [_client deleteObjectsByPrefix:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(1500, [task.result tosDeletedCount]);
+    XCTAssertEqual(2, [task.result tosRequestCount]);
+}
+
+- (void)testAPI_deleteObjectsWithEnumerator {
+    NSArray<TOSObjectTobeDeleted *> *objects = [self putObjectsWithPrefix:@"enum/" count:2500];
+    [_server putObject:_data forKey:@"keep/0"];
+    
+    TOSDeleteObjectsInput *input = [TOSDeleteObjectsInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosObjectEnumerator = objects.objectEnumerator;
+    input.tosBatchSize = 400;
+    int64_t requestsBefore = _server.requestCount;
+    TOSTask *task = [_client deleteObjects:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(2500, [task.result tosDeletedCount]);
+    XCTAssertEqual(7, [task.result tosRequestCount]);
+    XCTAssertEqual(7, _server.requestCount - requestsBefore);
+    XCTAssertNil([_server objectForKey:@"enum/00000"]);
+    XCTAssertNil([_server objectForKey:@"enum/02499"]);
+    XCTAssertNotNil([_server objectForKey:@"keep/0"]);
+    
+    // 不存在的对象同样计为删除成功
+    input.tosObjectEnumerator = objects.objectEnumerator;
+    task = [_client deleteObjects:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(2500, [task.result tosDeletedCount]);
+    
+    input.tosObjectEnumerator = nil;
+    task = [_client deleteObjects:input];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqualObjects(TOSClientErrorDomain, task.error.domain);
+}
+
+- (void)testAPI_deleteObjectsCancel {
+    NSArray<TOSObjectTobeDeleted *> *objects = [self putObjectsWithPrefix:@"cancel/" count:5000];
+    _server.latency = 0.05;
+    
+    TOSDeleteObjectsInput *input = [TOSDeleteObjectsInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosBatchSize = 100;
+    input.tosTaskNum = 1;
+    // 读出第3批时取消，后续批次不再发起
+    input.tosObjectEnumerator = [[TOSCancellingEnumerator alloc] initWithObjects:objects input:input cancelAfter:250];
+    int64_t requestsBefore = _server.requestCount;
+    TOSTask *task = [_client deleteObjects:input];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    XCTAssertNil(task.result);
+    XCTAssertLessThanOrEqual(_server.requestCount - requestsBefore, 3);
+    XCTAssertNotNil([_server objectForKey:@"cancel/04999"]);
+}
+
+- (void)testAPI_deleteObjectsByPrefixListError {
+    [self putObjectsWithPrefix:@"bulk/" count:10];
+    _server.errorRate = 1;
+    
+    TOSDeleteObjectsByPrefixInput *input = [TOSDeleteObjectsByPrefixInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosPrefix = @"bulk/";
+    TOSTask *task = [_client deleteObjectsByPrefix:input];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqualObjects(TOSServerErrorDomain, task.error.domain);
+    XCTAssertEqual(503, task.error.code);
+    XCTAssertNotNil([_server objectForKey:@"bulk/00000"]);
+}
+
+- (void)testAPI_deleteObjectsRequestError {
+    NSArray<TOSObjectTobeDeleted *> *objects = [self putObjectsWithPrefix:@"enum/" count:10];
+    _server.errorRate = 1;
+    
+    TOSDeleteObjectsInput *input = [TOSDeleteObjectsInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosObjectEnumerator = objects.objectEnumerator;
+    TOSTask *task = [_client deleteObjects:input];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqualObjects(TOSServerErrorDomain, task.error.domain);
+    XCTAssertEqual(503, task.error.code);
+    XCTAssertNil(task.result);
+    XCTAssertNotNil([_server objectForKey:@"enum/00009"]);
+}
+
+@end
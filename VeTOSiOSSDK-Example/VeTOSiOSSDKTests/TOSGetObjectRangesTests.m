@@ -0,0 +1,121 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSGetObjectRangesTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+}
+
+@end
+
+@implementation TOSGetObjectRangesTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+}
+
+- (void)tearDown {
+    [_server stop];
+    [super tearDown];
+}
+
+- (TOSGetObjectRange *)rangeWithStart:(int64_t)start end:(int64_t)end {
+    TOSGetObjectRange *range = [TOSGetObjectRange new];
+    range.tosRangeStart = start;
+    range.tosRangeEnd = end;
+    return range;
+}
+
+- (TOSGetObjectRangesInput *)inputWithRanges:(NSArray<TOSGetObjectRange *> *)ranges {
+    TOSGetObjectRangesInput *input = [TOSGetObjectRangesInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"ranges";
+    input.tosRanges = ranges;
+    return input;
+}
+
+- (void)testAPI_getObjectRanges {
+    NSData *data = [TOSTestUtil randomDataWithLength:1024 * 1024];
+    [_server putObject:data forKey:@"ranges"];
+    // 乱序、重叠及相邻的区间，后两个与前面相距超过默认合并间隔，末尾区间超出对象末尾
+    NSArray<TOSGetObjectRange *> *ranges = @[
+        [self rangeWithStart:4096 end:8191],
+        [self rangeWithStart:0 end:1023],
+        [self rangeWithStart:512 end:2000],
+        [self rangeWithStart:2001 end:3000],
+        [self rangeWithStart:512 * 1024 end:512 * 1024 + 99],
+        [self rangeWithStart:data.length - 100 end:data.length + 1024],
+    ];
+    TOSTask *task = [_client getObjectRanges:[self inputWithRanges:ranges]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    TOSGetObjectRangesOutput *output = task.result;
+    XCTAssertEqual(3, output.tosRequestCount);
+    XCTAssertEqual((int64_t)data.length, output.tosObjectSize);
+    XCTAssertNotNil(output.tosETag);
+    XCTAssertEqual(ranges.count, output.tosContents.count);
+    for (NSUInteger i = 0; i < ranges.count; i++) {
+        int64_t end = MIN(ranges[i].tosRangeEnd, (int64_t)data.length - 1);
+        NSRange expected = NSMakeRange((NSUInteger)ranges[i].tosRangeStart, (NSUInteger)(end - ranges[i].tosRangeStart + 1));
+        XCTAssertEqualObjects([data subdataWithRange:expected], output.tosContents[i]);
+    }
+
+    // 间隔阈值为负数时只合并重叠或相邻的区间
+    TOSGetObjectRangesInput *input = [self inputWithRanges:ranges];
+    input.tosMergeGap = -1;
+    task = [_client getObjectRanges:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(4, [task.result tosRequestCount]);
+}
+
+- (void)testAPI_getObjectRangesFirstByte {
+    // 起止均为0的区间只读取首字节，不能退化为读取整个对象
+    NSData *data = [TOSTestUtil randomDataWithLength:4096];
+    [_server putObject:data forKey:@"ranges"];
+    TOSTask *task = [_client getObjectRanges:[self inputWithRanges:@[[self rangeWithStart:0 end:0]]]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    TOSGetObjectRangesOutput *output = task.result;
+    XCTAssertEqualObjects([data subdataWithRange:NSMakeRange(0, 1)], output.tosContents[0]);
+    XCTAssertEqual((int64_t)data.length, output.tosObjectSize);
+
+    // 对象只有1字节
+    NSData *single = [TOSTestUtil randomDataWithLength:1];
+    [_server putObject:single forKey:@"ranges"];
+    task = [_client getObjectRanges:[self inputWithRanges:@[[self rangeWithStart:0 end:0]]]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(single, [task.result tosContents][0]);
+}
+
+- (void)testAPI_getObjectRangesInvalidRanges {
+    TOSTask *task = [_client getObjectRanges:[self inputWithRanges:@[]]];
+    XCTAssertEqualObjects(@"tos: ranges are empty", task.error.userInfo[TOSErrorMessageTOKEN]);
+    task = [_client getObjectRanges:[self inputWithRanges:@[[self rangeWithStart:10 end:9]]]];
+    XCTAssertEqualObjects(@"tos: invalid range", task.error.userInfo[TOSErrorMessageTOKEN]);
+    task = [_client getObjectRanges:[self inputWithRanges:@[[self rangeWithStart:-1 end:9]]]];
+    XCTAssertEqualObjects(@"tos: invalid range", task.error.userInfo[TOSErrorMessageTOKEN]);
+}
+
+@end
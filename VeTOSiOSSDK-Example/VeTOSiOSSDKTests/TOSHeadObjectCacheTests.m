@@ -0,0 +1,164 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSHeadObjectCacheTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+}
+
+@end
+
+@implementation TOSHeadObjectCacheTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+    [_server putObject:[TOSTestUtil randomDataWithLength:16] forKey:@"head"];
+}
+
+- (void)tearDown {
+    _client.clientConfiguration.objectMetadataCache = nil;
+    [_server stop];
+    [super tearDown];
+}
+
+- (TOSTask *)headObject:(NSString *)key {
+    TOSHeadObjectInput *input = [TOSHeadObjectInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = key;
+    TOSTask *task = [_client headObject:input];
+    [task waitUntilFinished];
+    return task;
+}
+
+- (void)putObject:(NSString *)key length:(NSUInteger)length {
+    TOSPutObjectInput *input = [TOSPutObjectInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = key;
+    input.tosContent = [TOSTestUtil randomDataWithLength:length];
+    TOSTask *task = [_client putObject:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+}
+
+- (void)testAPI_headObjectCacheHit {
+    TOSObjectMetadataCache *cache = [[TOSObjectMetadataCache alloc] initWithMaxEntryCount:100 maxBytes:1024 * 1024 ttl:3600];
+    _client.clientConfiguration.objectMetadataCache = cache;
+    
+    int64_t requestsBefore = _server.requestCount;
+    TOSTask *task = [self headObject:@"head"];
+    XCTAssertNil(task.error);
+    TOSHeadObjectOutput *first = task.result;
+    XCTAssertEqual(16, first.tosContentLength);
+    for (int i = 0; i < 10; i++) {
+        task = [self headObject:@"head"];
+        XCTAssertNil(task.error);
+        XCTAssertEqual(16, [task.result tosContentLength]);
+        XCTAssertEqualObjects(first.tosETag, [task.result tosETag]);
+        // 每次命中返回新的Output
+        XCTAssertNotEqual(first, task.result);
+    }
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    XCTAssertEqual(1, cache.missCount);
+    XCTAssertEqual(10, cache.hitCount);
+    
+    // 其他客户端的修改在ttl内不可见
+    [_server putObject:[TOSTestUtil randomDataWithLength:64] forKey:@"head"];
+    task = [self headObject:@"head"];
+    XCTAssertEqual(16, [task.result tosContentLength]);
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    
+    // 携带条件头时不经过缓存
+    TOSHeadObjectInput *input = [TOSHeadObjectInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"head";
+    input.tosIfMatch = first.tosETag;
+    task = [_client headObject:input];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqual(412, task.error.code);
+    XCTAssertEqual(2, _server.requestCount - requestsBefore);
+    
+    // 404不缓存
+    task = [self headObject:@"not-exist"];
+    XCTAssertEqual(404, task.error.code);
+    task = [self headObject:@"not-exist"];
+    XCTAssertEqual(404, task.error.code);
+    XCTAssertEqual(4, _server.requestCount - requestsBefore);
+}
+
+- (void)testAPI_headObjectCacheInvalidation {
+    TOSObjectMetadataCache *cache = [[TOSObjectMetadataCache alloc] initWithMaxEntryCount:100 maxBytes:1024 * 1024 ttl:3600];
+    _client.clientConfiguration.objectMetadataCache = cache;
+    XCTAssertEqual(16, [[self headObject:@"head"].result tosContentLength]);
+    
+    // 本Client的写操作使条目失效
+    [self putObject:@"head" length:32];
+    int64_t requestsBefore = _server.requestCount;
+    TOSTask *task = [self headObject:@"head"];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(32, [task.result tosContentLength]);
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    XCTAssertEqual(32, [[self headObject:@"head"].result tosContentLength]);
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    
+    TOSDeleteObjectInput *deleteInput = [TOSDeleteObjectInput new];
+    deleteInput.tosBucket = @"local-bucket";
+    deleteInput.tosKey = @"head";
+    [[_client deleteObject:deleteInput] waitUntilFinished];
+    task = [self headObject:@"head"];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqual(404, task.error.code);
+}
+
+- (void)testAPI_headObjectCacheRevalidation {
+    // ttl为0时每次命中都以If-None-Match校验
+    TOSObjectMetadataCache *cache = [[TOSObjectMetadataCache alloc] initWithMaxEntryCount:100 maxBytes:1024 * 1024 ttl:0];
+    cache.revalidatesExpiredEntries = YES;
+    _client.clientConfiguration.objectMetadataCache = cache;
+    TOSTask *task = [self headObject:@"head"];
+    XCTAssertNil(task.error);
+    NSString *eTag = [task.result tosETag];
+    
+    // 未修改时服务端返回304，沿用缓存的属性
+    task = [self headObject:@"head"];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(16, [task.result tosContentLength]);
+    XCTAssertEqualObjects(eTag, [task.result tosETag]);
+    XCTAssertEqual(1, cache.revalidationCount);
+    XCTAssertEqual(1, cache.notModifiedCount);
+    
+    // 其他客户端修改后校验返回新属性并更新条目
+    [_server putObject:[TOSTestUtil randomDataWithLength:64] forKey:@"head"];
+    task = [self headObject:@"head"];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(64, [task.result tosContentLength]);
+    XCTAssertNotEqualObjects(eTag, [task.result tosETag]);
+    XCTAssertEqual(2, cache.revalidationCount);
+    XCTAssertEqual(1, cache.notModifiedCount);
+    
+    task = [self headObject:@"head"];
+    XCTAssertEqual(64, [task.result tosContentLength]);
+    XCTAssertEqual(2, cache.notModifiedCount);
+}
+
+@end
@@ -0,0 +1,57 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 本地TOS兼容服务，监听127.0.0.1，数据保存在内存中，仅模拟单个桶
+ * 支持PUT/GET(Range、If-None-Match、If-Match)/HEAD/DELETE、CopyObject、ListObjects、DeleteMultiObjects、分片上传的创建/上传/复制/合并/取消/列举以及追加写
+ * 客户端需使用自定义域名方式访问（TOSEndpoint isCustomDomain为YES）
+ */
+@interface TOSLocalServer : NSObject
+
+@property (nonatomic, readonly) uint16_t port;
+@property (nonatomic, readonly) NSString *endpoint; // http://127.0.0.1:port
+
+@property (nonatomic, assign) NSTimeInterval latency; // 每个请求响应前的附加延迟
+@property (nonatomic, assign) uint64_t bandwidth; // 每个连接的收发带宽，字节/秒，0为不限速
+@property (nonatomic, assign) double errorRate; // 按该概率返回503，取值0~1
+@property (nonatomic, assign) NSTimeInterval connectionLatency; // 新连接处理首个请求前的附加延迟，模拟DNS、TCP、TLS握手
+
+@property (nonatomic, readonly) int64_t requestCount;
+@property (nonatomic, readonly) int64_t injectedErrorCount;
+@property (nonatomic, readonly) int64_t connectionCount; // 已接受的连接数
+@property (nonatomic, readonly) NSUInteger uploadCount; // 未合并也未取消的分段上传任务数
+
+// 响应发出前调用，可修改header模拟服务端返回的异常值，如错误的x-tos-hash-crc64ecma
+@property (atomic, copy, nullable) void (^responseHeadersHandler)(NSString *method, NSString *key, NSDictionary<NSString *, NSString *> *query, NSMutableDictionary<NSString *, NSString *> *headers);
+
+- (BOOL)start:(NSError **)error;
+- (void)stop;
+
+// 预置或读取对象，不经过网络
+- (void)putObject:(NSData *)data forKey:(NSString *)key;
+- (nullable NSData *)objectForKey:(NSString *)key;
+- (void)removeAllObjects;
+
+// 不经过socket直接处理请求，供进程内传输（如TOSNetworkSimulator）使用
+- (NSHTTPURLResponse *)responseForURLRequest:(NSURLRequest *)request body:(nullable NSData *)body responseBody:(NSData * _Nullable * _Nonnull)responseBody;
+
+@end
+
+NS_ASSUME_NONNULL_END
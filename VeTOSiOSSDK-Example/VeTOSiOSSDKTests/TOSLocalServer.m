@@ -0,0 +1,1016 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSLocalServer.h"
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import <libkern/OSAtomic.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+static const NSUInteger TOSLocalServerIOChunkSize = 64 * 1024;
+static NSString * const TOSLocalServerBucket = @"local-bucket";
+
+@interface TOSLocalObject : NSObject
+@property (nonatomic, strong) NSMutableData *data;
+@property (nonatomic, copy) NSString *eTag;
+@property (nonatomic, assign) uint64_t crc64;
+@property (nonatomic, strong) NSDate *lastModified;
+@property (nonatomic, assign) BOOL appendable;
+@end
+
+@implementation TOSLocalObject
+@end
+
+@interface TOSLocalUpload : NSObject
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, copy) NSString *uploadID;
+@property (nonatomic, strong) NSDate *initiated;
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, TOSLocalObject *> *parts;
+@end
+
+@implementation TOSLocalUpload
+@end
+
+@interface TOSLocalRequest : NSObject
+@property (nonatomic, copy) NSString *method;
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, strong) NSDictionary<NSString *, NSString *> *query;
+@property (nonatomic, strong) NSDictionary<NSString *, NSString *> *headers; // 小写header名
+@property (nonatomic, strong) NSData *body;
+@property (nonatomic, assign) BOOL closeConnection;
+@end
+
+@implementation TOSLocalRequest
+@end
+
+@interface TOSLocalResponse : NSObject
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSString *> *headers;
+@property (nonatomic, strong) NSData *body;
+@end
+
+@implementation TOSLocalResponse
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _statusCode = 200;
+        _headers = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+@end
+
+@implementation TOSLocalServer {
+    int _listenSocket;
+    dispatch_source_t _acceptSource;
+    NSMutableSet<NSNumber *> *_connections;
+    NSMutableDictionary<NSString *, TOSLocalObject *> *_objects;
+    NSMutableDictionary<NSString *, TOSLocalUpload *> *_uploads;
+    NSDateFormatter *_dateFormatter;
+    volatile int64_t _requestCount;
+    volatile int64_t _injectedErrorCount;
+    volatile int64_t _connectionCount;
+    volatile int32_t _stopped;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _listenSocket = -1;
+        _connections = [NSMutableSet set];
+        _objects = [NSMutableDictionary dictionary];
+        _uploads = [NSMutableDictionary dictionary];
+        _dateFormatter = [[NSDateFormatter alloc] init];
+        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        _dateFormatter.timeZone = [NSTimeZone timeZoneWithAbbreviation:@"GMT"];
+        _dateFormatter.dateFormat = @"EEE, dd MMM yyyy HH:mm:ss 'GMT'";
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self stop];
+}
+
+- (NSString *)endpoint {
+    return [NSString stringWithFormat:@"http://127.0.0.1:%u", _port];
+}
+
+- (int64_t)requestCount {
+    return _requestCount;
+}
+
+- (int64_t)injectedErrorCount {
+    return _injectedErrorCount;
+}
+
+- (int64_t)connectionCount {
+    return _connectionCount;
+}
+
+#pragma mark - 监听与连接
+
+- (NSUInteger)uploadCount {
+    @synchronized (self) {
+        return _uploads.count;
+    }
+}
+
+- (BOOL)start:(NSError **)error {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        }
+        return NO;
+    }
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_len = sizeof(addr);
+    addr.sin_family = AF_INET;
+    addr.sin_port = 0;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLength = sizeof(addr);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 128) != 0 || getsockname(fd, (struct sockaddr *)&addr, &addrLength) != 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        }
+        close(fd);
+        return NO;
+    }
+    _port = ntohs(addr.sin_port);
+    _listenSocket = fd;
+    _stopped = 0;
+
+    __weak typeof(self) weakSelf = self;
+    _acceptSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, fd, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+    dispatch_source_set_event_handler(_acceptSource, ^{
+        int client = accept(fd, NULL, NULL);
+        if (client < 0) {
+            return;
+        }
+        int on = 1;
+        setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [weakSelf serveConnection:client];
+        });
+    });
+    dispatch_source_set_cancel_handler(_acceptSource, ^{
+        close(fd);
+    });
+    dispatch_resume(_acceptSource);
+    return YES;
+}
+
+- (void)stop {
+    if (!OSAtomicCompareAndSwap32Barrier(0, 1, &_stopped)) {
+        return;
+    }
+    if (_acceptSource) {
+        dispatch_source_cancel(_acceptSource);
+        _acceptSource = nil;
+    }
+    _listenSocket = -1;
+    @synchronized (_connections) {
+        for (NSNumber *fd in _connections) {
+            shutdown([fd intValue], SHUT_RDWR);
+        }
+    }
+}
+
+- (void)serveConnection:(int)fd {
+    @synchronized (_connections) {
+        [_connections addObject:@(fd)];
+    }
+    OSAtomicIncrement64Barrier(&_connectionCount);
+    NSMutableData *buffer = [NSMutableData data];
+    BOOL handshaking = _connectionLatency > 0;
+    while (!_stopped) {
+        @autoreleasepool {
+            TOSLocalRequest *request = [self readRequestFromSocket:fd buffer:buffer];
+            if (!request) {
+                break;
+            }
+            TOSLocalResponse *response = [self responseForRequest:request];
+            NSTimeInterval delay = _latency + (handshaking ? _connectionLatency : 0);
+            handshaking = NO;
+            if (delay > 0) {
+                usleep((useconds_t)(delay * 1000000));
+            }
+            if (![self writeResponse:response toSocket:fd includeBody:![request.method isEqualToString:@"HEAD"]] || request.closeConnection) {
+                break;
+            }
+        }
+    }
+    @synchronized (_connections) {
+        [_connections removeObject:@(fd)];
+    }
+    close(fd);
+}
+
+#pragma mark - 读写
+
+// 按带宽限制，传输n字节后休眠相应时长
+- (void)throttle:(NSUInteger)n {
+    uint64_t bandwidth = _bandwidth;
+    if (bandwidth > 0 && n > 0) {
+        usleep((useconds_t)((double)n / bandwidth * 1000000));
+    }
+}
+
+- (BOOL)readMoreFromSocket:(int)fd buffer:(NSMutableData *)buffer {
+    uint8_t chunk[TOSLocalServerIOChunkSize];
+    ssize_t n;
+    do {
+        n = read(fd, chunk, sizeof(chunk));
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        return NO;
+    }
+    [buffer appendBytes:chunk length:n];
+    [self throttle:n];
+    return YES;
+}
+
+- (BOOL)writeBytes:(const void *)bytes length:(NSUInteger)length toSocket:(int)fd {
+    NSUInteger offset = 0;
+    while (offset < length) {
+        NSUInteger size = MIN(TOSLocalServerIOChunkSize, length - offset);
+        ssize_t n = write(fd, (const uint8_t *)bytes + offset, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return NO;
+        }
+        offset += n;
+        [self throttle:n];
+    }
+    return YES;
+}
+
+// 读取以CRLF结尾的一行（不含CRLF），数据不足时继续从socket读取
+- (NSString *)readLineFromSocket:(int)fd buffer:(NSMutableData *)buffer {
+    while (YES) {
+        NSRange range = [buffer rangeOfData:[NSData dataWithBytes:"\r\n" length:2] options:0 range:NSMakeRange(0, buffer.length)];
+        if (range.location != NSNotFound) {
+            NSString *line = [[NSString alloc] initWithBytes:buffer.bytes length:range.location encoding:NSUTF8StringEncoding];
+            [buffer replaceBytesInRange:NSMakeRange(0, NSMaxRange(range)) withBytes:NULL length:0];
+            return line ?: @"";
+        }
+        if (![self readMoreFromSocket:fd buffer:buffer]) {
+            return nil;
+        }
+    }
+}
+
+- (NSData *)readBytes:(NSUInteger)length fromSocket:(int)fd buffer:(NSMutableData *)buffer {
+    while (buffer.length < length) {
+        if (![self readMoreFromSocket:fd buffer:buffer]) {
+            return nil;
+        }
+    }
+    NSData *data = [buffer subdataWithRange:NSMakeRange(0, length)];
+    [buffer replaceBytesInRange:NSMakeRange(0, length) withBytes:NULL length:0];
+    return data;
+}
+
+- (TOSLocalRequest *)readRequestFromSocket:(int)fd buffer:(NSMutableData *)buffer {
+    NSString *requestLine = [self readLineFromSocket:fd buffer:buffer];
+    if (requestLine.length == 0) {
+        return nil;
+    }
+    NSArray<NSString *> *parts = [requestLine componentsSeparatedByString:@" "];
+    if (parts.count != 3) {
+        return nil;
+    }
+
+    NSMutableDictionary *headers = [NSMutableDictionary dictionary];
+    while (YES) {
+        NSString *line = [self readLineFromSocket:fd buffer:buffer];
+        if (!line) {
+            return nil;
+        }
+        if (line.length == 0) {
+            break;
+        }
+        NSRange colon = [line rangeOfString:@":"];
+        if (colon.location == NSNotFound) {
+            continue;
+        }
+        NSString *name = [[line substringToIndex:colon.location] lowercaseString];
+        NSString *value = [[line substringFromIndex:colon.location + 1] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        headers[name] = value;
+    }
+
+    if ([[headers[@"expect"] lowercaseString] isEqualToString:@"100-continue"]) {
+        const char *continueLine = "HTTP/1.1 100 Continue\r\n\r\n";
+        if (![self writeBytes:continueLine length:strlen(continueLine) toSocket:fd]) {
+            return nil;
+        }
+    }
+
+    NSData *body = [NSData data];
+    if ([[headers[@"transfer-encoding"] lowercaseString] isEqualToString:@"chunked"]) {
+        NSMutableData *chunked = [NSMutableData data];
+        while (YES) {
+            NSString *sizeLine = [self readLineFromSocket:fd buffer:buffer];
+            if (!sizeLine) {
+                return nil;
+            }
+            unsigned long long size = strtoull([sizeLine UTF8String], NULL, 16);
+            if (size == 0) {
+                // 跳过trailer直到空行
+                NSString *trailer;
+                while ((trailer = [self readLineFromSocket:fd buffer:buffer]) && trailer.length > 0) {
+                }
+                if (!trailer) {
+                    return nil;
+                }
+                break;
+            }
+            NSData *chunk = [self readBytes:(NSUInteger)size + 2 fromSocket:fd buffer:buffer];
+            if (!chunk) {
+                return nil;
+            }
+            [chunked appendBytes:chunk.bytes length:(NSUInteger)size];
+        }
+        body = chunked;
+    } else if (headers[@"content-length"]) {
+        body = [self readBytes:(NSUInteger)[headers[@"content-length"] longLongValue] fromSocket:fd buffer:buffer];
+        if (!body) {
+            return nil;
+        }
+    }
+
+    TOSLocalRequest *request = [TOSLocalRequest new];
+    request.method = parts[0];
+    request.headers = headers;
+    request.body = body;
+    request.closeConnection = [[headers[@"connection"] lowercaseString] isEqualToString:@"close"];
+
+    NSString *target = parts[1];
+    NSRange question = [target rangeOfString:@"?"];
+    if (question.location != NSNotFound) {
+        [self parsePath:[target substringToIndex:question.location] query:[target substringFromIndex:question.location + 1] toRequest:request];
+    } else {
+        [self parsePath:target query:nil toRequest:request];
+    }
+    return request;
+}
+
+// path与query均为未解码的原始形式
+- (void)parsePath:(NSString *)path query:(NSString *)queryString toRequest:(TOSLocalRequest *)request {
+    NSMutableDictionary *query = [NSMutableDictionary dictionary];
+    for (NSString *item in [queryString componentsSeparatedByString:@"&"]) {
+        if (item.length == 0) {
+            continue;
+        }
+        NSRange equal = [item rangeOfString:@"="];
+        NSString *name = equal.location == NSNotFound ? item : [item substringToIndex:equal.location];
+        NSString *value = equal.location == NSNotFound ? @"" : [item substringFromIndex:equal.location + 1];
+        query[[name stringByRemovingPercentEncoding] ?: name] = [value stringByRemovingPercentEncoding] ?: value;
+    }
+    if ([path hasPrefix:@"/"]) {
+        path = [path substringFromIndex:1];
+    }
+    request.key = [path stringByRemovingPercentEncoding] ?: path;
+    request.query = query;
+}
+
+- (NSHTTPURLResponse *)responseForURLRequest:(NSURLRequest *)URLRequest body:(NSData *)body responseBody:(NSData **)responseBody {
+    TOSLocalRequest *request = [TOSLocalRequest new];
+    request.method = URLRequest.HTTPMethod ?: @"GET";
+    request.body = body ?: [NSData data];
+    NSMutableDictionary *headers = [NSMutableDictionary dictionary];
+    [URLRequest.allHTTPHeaderFields enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull obj, BOOL * _Nonnull stop) {
+        headers[[key lowercaseString]] = obj;
+    }];
+    request.headers = headers;
+    NSString *path = (NSString *)CFBridgingRelease(CFURLCopyPath((CFURLRef)URLRequest.URL));
+    [self parsePath:path ?: @"/" query:URLRequest.URL.query toRequest:request];
+
+    TOSLocalResponse *response = [self responseForRequest:request];
+    response.headers[@"Content-Length"] = [NSString stringWithFormat:@"%lu", (unsigned long)response.body.length];
+    *responseBody = [request.method isEqualToString:@"HEAD"] ? [NSData data] : (response.body ?: [NSData data]);
+    return [[NSHTTPURLResponse alloc] initWithURL:URLRequest.URL statusCode:response.statusCode HTTPVersion:@"HTTP/1.1" headerFields:response.headers];
+}
+
+- (BOOL)writeResponse:(TOSLocalResponse *)response toSocket:(int)fd includeBody:(BOOL)includeBody {
+    NSMutableString *head = [NSMutableString stringWithFormat:@"HTTP/1.1 %ld %@\r\n", (long)response.statusCode, [self reasonPhraseForStatusCode:response.statusCode]];
+    if (!response.headers[@"Content-Length"]) {
+        response.headers[@"Content-Length"] = [NSString stringWithFormat:@"%lu", (unsigned long)response.body.length];
+    }
+    [response.headers enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, NSString * _Nonnull obj, BOOL * _Nonnull stop) {
+        [head appendFormat:@"%@: %@\r\n", key, obj];
+    }];
+    [head appendString:@"\r\n"];
+    NSData *headData = [head dataUsingEncoding:NSUTF8StringEncoding];
+    if (![self writeBytes:headData.bytes length:headData.length toSocket:fd]) {
+        return NO;
+    }
+    if (includeBody && response.body.length > 0) {
+        return [self writeBytes:response.body.bytes length:response.body.length toSocket:fd];
+    }
+    return YES;
+}
+
+- (NSString *)reasonPhraseForStatusCode:(NSInteger)statusCode {
+    switch (statusCode) {
+        case 200: return @"OK";
+        case 204: return @"No Content";
+        case 206: return @"Partial Content";
+        case 304: return @"Not Modified";
+        case 400: return @"Bad Request";
+        case 404: return @"Not Found";
+        case 405: return @"Method Not Allowed";
+        case 409: return @"Conflict";
+        case 412: return @"Precondition Failed";
+        case 416: return @"Requested Range Not Satisfiable";
+        case 503: return @"Service Unavailable";
+        default: return @"Unknown";
+    }
+}
+
+#pragma mark - 路由
+
+- (TOSLocalResponse *)responseForRequest:(TOSLocalRequest *)request {
+    int64_t requestID = OSAtomicIncrement64Barrier(&_requestCount);
+    TOSLocalResponse *response;
+    if (_errorRate > 0 && arc4random_uniform(1000000) < _errorRate * 1000000) {
+        OSAtomicIncrement64Barrier(&_injectedErrorCount);
+        response = [self errorResponse:503 code:@"ServiceUnavailable" message:@"injected error"];
+    } else if (request.key.length == 0) {
+        response = [self bucketResponseForRequest:request];
+    } else {
+        response = [self objectResponseForRequest:request];
+    }
+    response.headers[@"x-tos-request-id"] = [NSString stringWithFormat:@"%016llx", requestID];
+    response.headers[@"x-tos-id-2"] = [NSString stringWithFormat:@"%016llx-local", requestID];
+    response.headers[@"Date"] = [self stringFromDate:[NSDate date]];
+    response.headers[@"Server"] = @"TOSLocalServer";
+    if (request.closeConnection) {
+        response.headers[@"Connection"] = @"close";
+    }
+    void (^handler)(NSString *, NSString *, NSDictionary *, NSMutableDictionary *) = self.responseHeadersHandler;
+    if (handler) {
+        handler(request.method, request.key ?: @"", request.query ?: @{}, response.headers);
+    }
+    return response;
+}
+
+- (TOSLocalResponse *)bucketResponseForRequest:(TOSLocalRequest *)request {
+    NSString *method = request.method;
+    if ([method isEqualToString:@"PUT"] || [method isEqualToString:@"HEAD"]) {
+        TOSLocalResponse *response = [TOSLocalResponse new];
+        response.headers[@"x-tos-bucket-region"] = @"local";
+        return response;
+    }
+    if ([method isEqualToString:@"DELETE"]) {
+        TOSLocalResponse *response = [TOSLocalResponse new];
+        response.statusCode = 204;
+        return response;
+    }
+    if ([method isEqualToString:@"GET"]) {
+        if (request.query[@"uploads"]) {
+            return [self listMultipartUploads:request];
+        }
+        return [self listObjects:request];
+    }
+    if ([method isEqualToString:@"POST"] && request.query[@"delete"]) {
+        return [self deleteMultiObjects:request];
+    }
+    return [self errorResponse:405 code:@"MethodNotAllowed" message:@"method not allowed"];
+}
+
+- (TOSLocalResponse *)objectResponseForRequest:(TOSLocalRequest *)request {
+    NSString *method = request.method;
+    NSDictionary *query = request.query;
+    if ([method isEqualToString:@"PUT"]) {
+        if (request.headers[@"x-tos-copy-source"]) {
+            return [self copyObject:request];
+        }
+        if (query[@"uploadId"] && query[@"partNumber"]) {
+            return [self uploadPart:request];
+        }
+        return [self putObject:request];
+    }
+    if ([method isEqualToString:@"POST"]) {
+        if (query[@"uploads"]) {
+            return [self createMultipartUpload:request];
+        }
+        if (query[@"uploadId"]) {
+            return [self completeMultipartUpload:request];
+        }
+        if (query[@"append"]) {
+            return [self appendObject:request];
+        }
+    }
+    if ([method isEqualToString:@"DELETE"]) {
+        if (query[@"uploadId"]) {
+            return [self abortMultipartUpload:request];
+        }
+        @synchronized (self) {
+            [_objects removeObjectForKey:request.key];
+        }
+        TOSLocalResponse *response = [TOSLocalResponse new];
+        response.statusCode = 204;
+        return response;
+    }
+    if ([method isEqualToString:@"GET"] && query[@"uploadId"]) {
+        return [self listParts:request];
+    }
+    if ([method isEqualToString:@"GET"] || [method isEqualToString:@"HEAD"]) {
+        return [self getObject:request];
+    }
+    return [self errorResponse:405 code:@"MethodNotAllowed" message:@"method not allowed"];
+}
+
+#pragma mark - 对象
+
+- (TOSLocalObject *)objectWithData:(NSData *)data {
+    TOSLocalObject *object = [TOSLocalObject new];
+    object.data = [data mutableCopy];
+    object.eTag = [NSString stringWithFormat:@"\"%@\"", [TOSUtil dataMD5String:data]];
+    object.crc64 = [TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length];
+    object.lastModified = [NSDate date];
+    return object;
+}
+
+- (void)putObject:(NSData *)data forKey:(NSString *)key {
+    TOSLocalObject *object = [self objectWithData:data];
+    @synchronized (self) {
+        _objects[key] = object;
+    }
+}
+
+- (NSData *)objectForKey:(NSString *)key {
+    @synchronized (self) {
+        return [_objects[key].data copy];
+    }
+}
+
+- (void)removeAllObjects {
+    @synchronized (self) {
+        [_objects removeAllObjects];
+        [_uploads removeAllObjects];
+    }
+}
+
+- (void)setObjectHeaders:(TOSLocalObject *)object toResponse:(TOSLocalResponse *)response {
+    response.headers[@"ETag"] = object.eTag;
+    response.headers[@"x-tos-hash-crc64ecma"] = [NSString stringWithFormat:@"%llu", object.crc64];
+}
+
+- (TOSLocalResponse *)putObject:(TOSLocalRequest *)request {
+    TOSLocalObject *object = [self objectWithData:request.body];
+    @synchronized (self) {
+        _objects[request.key] = object;
+    }
+    TOSLocalResponse *response = [TOSLocalResponse new];
+    [self setObjectHeaders:object toResponse:response];
+    return response;
+}
+
+- (TOSLocalResponse *)getObject:(TOSLocalRequest *)request {
+    TOSLocalObject *object;
+    NSData *data;
+    @synchronized (self) {
+        object = _objects[request.key];
+        data = [object.data copy];
+    }
+    if (!object) {
+        return [self errorResponse:404 code:@"NoSuchKey" message:@"The specified key does not exist."];
+    }
+
+    TOSLocalResponse *response = [TOSLocalResponse new];
+    [self setObjectHeaders:object toResponse:response];
+    if ([request.headers[@"if-none-match"] isEqualToString:object.eTag]) {
+        response.statusCode = 304;
+        return response;
+    }
+    if (request.headers[@"if-match"] && ![request.headers[@"if-match"] isEqualToString:object.eTag]) {
+        return [self errorResponse:412 code:@"PreconditionFailed" message:@"At least one of the pre-conditions you specified did not hold"];
+    }
+    response.headers[@"Last-Modified"] = [self stringFromDate:object.lastModified];
+    response.headers[@"Content-Type"] = request.headers[@"content-type"] ?: @"application/octet-stream";
+    response.headers[@"Accept-Ranges"] = @"bytes";
+    response.headers[@"x-tos-object-type"] = object.appendable ? @"Appendable" : @"Normal";
+    response.headers[@"x-tos-storage-class"] = @"STANDARD";
+
+    NSString *range = request.headers[@"range"];
+    if ([range hasPrefix:@"bytes="]) {
+        NSArray<NSString *> *bounds = [[range substringFromIndex:6] componentsSeparatedByString:@"-"];
+        uint64_t length = data.length;
+        uint64_t start = 0;
+        uint64_t end = length - 1;
+        if (bounds.count != 2 || length == 0) {
+            return [self errorResponse:416 code:@"InvalidRange" message:@"The requested range is not satisfiable"];
+        }
+        if (bounds[0].length == 0) {
+            uint64_t suffix = MIN((uint64_t)[bounds[1] longLongValue], length);
+            start = length - suffix;
+        } else {
+            start = [bounds[0] longLongValue];
+            if (bounds[1].length > 0) {
+                end = MIN((uint64_t)[bounds[1] longLongValue], length - 1);
+            }
+        }
+        if (start >= length || start > end) {
+            return [self errorResponse:416 code:@"InvalidRange" message:@"The requested range is not satisfiable"];
+        }
+        response.statusCode = 206;
+        response.headers[@"Content-Range"] = [NSString stringWithFormat:@"bytes %llu-%llu/%llu", start, end, length];
+        data = [data subdataWithRange:NSMakeRange((NSUInteger)start, (NSUInteger)(end - start + 1))];
+    }
+    response.body = data;
+    return response;
+}
+
+// CopyObject与UploadPartCopy，复制源只能是本桶中的对象，忽略versionId
+- (TOSLocalResponse *)copyObject:(TOSLocalRequest *)request {
+    NSString *source = request.headers[@"x-tos-copy-source"];
+    NSRange query = [source rangeOfString:@"?"];
+    if (query.location != NSNotFound) {
+        source = [source substringToIndex:query.location];
+    }
+    NSArray<NSString *> *components = [source componentsSeparatedByString:@"/"];
+    if (components.count < 3 || components[0].length != 0) {
+        return [self errorResponse:400 code:@"InvalidArgument" message:@"invalid copy source"];
+    }
+    NSString *sourceKey = [[components subarrayWithRange:NSMakeRange(2, components.count - 2)] componentsJoinedByString:@"/"];
+    sourceKey = [sourceKey stringByRemovingPercentEncoding] ?: sourceKey;
+
+    TOSLocalObject *object;
+    NSData *data;
+    @synchronized (self) {
+        object = _objects[sourceKey];
+        data = [object.data copy];
+    }
+    if (!object) {
+        return [self errorResponse:404 code:@"NoSuchKey" message:@"The specified key does not exist."];
+    }
+    NSString *ifMatch = request.headers[@"x-tos-copy-source-if-match"];
+    if (ifMatch && ![ifMatch isEqualToString:object.eTag]) {
+        return [self errorResponse:412 code:@"PreconditionFailed" message:@"At least one of the pre-conditions you specified did not hold"];
+    }
+
+    BOOL isPart = request.query[@"uploadId"] && request.query[@"partNumber"];
+    NSString *range = request.headers[@"x-tos-copy-source-range"];
+    if (isPart && [range hasPrefix:@"bytes="]) {
+        NSArray<NSString *> *bounds = [[range substringFromIndex:6] componentsSeparatedByString:@"-"];
+        uint64_t start = [bounds.firstObject longLongValue];
+        uint64_t end = [bounds.lastObject longLongValue];
+        if (bounds.count != 2 || start > end || end >= data.length) {
+            return [self errorResponse:416 code:@"InvalidRange" message:@"The requested range is not satisfiable"];
+        }
+        data = [data subdataWithRange:NSMakeRange((NSUInteger)start, (NSUInteger)(end - start + 1))];
+    }
+
+    TOSLocalObject *copied = [self objectWithData:data];
+    @synchronized (self) {
+        if (isPart) {
+            int partNumber = [request.query[@"partNumber"] intValue];
+            TOSLocalUpload *upload = [self uploadForRequest:request];
+            if (!upload) {
+                return [self errorResponse:404 code:@"NoSuchUpload" message:@"The specified multipart upload does not exist."];
+            }
+            upload.parts[@(partNumber)] = copied;
+        } else {
+            _objects[request.key] = copied;
+        }
+    }
+    TOSLocalResponse *response = [self jsonResponse:@{@"ETag": copied.eTag, @"LastModified": [self stringFromDate:copied.lastModified]}];
+    response.headers[@"x-tos-hash-crc64ecma"] = [NSString stringWithFormat:@"%llu", copied.crc64];
+    return response;
+}
+
+- (TOSLocalResponse *)appendObject:(TOSLocalRequest *)request {
+    int64_t offset = [request.query[@"offset"] longLongValue];
+    NSData *body = request.body;
+    uint64_t bodyCRC = [TOSUtil crc64ecma:0 buffer:(void *)body.bytes length:body.length];
+    TOSLocalObject *object;
+    @synchronized (self) {
+        object = _objects[request.key];
+        if (object && !object.appendable) {
+            return [self errorResponse:409 code:@"OperationNotSupported" message:@"The object is not appendable"];
+        }
+        if ((int64_t)object.data.length != offset) {
+            return [self errorResponse:409 code:@"PositionNotEqualToLength" message:@"Position is not equal to file length"];
+        }
+        if (!object) {
+            object = [self objectWithData:body];
+            object.appendable = YES;
+            _objects[request.key] = object;
+        } else {
+            [object.data appendData:body];
+            object.crc64 = [TOSUtil crc64ForCombineCRC1:object.crc64 CRC2:bodyCRC length:body.length];
+            object.eTag = [NSString stringWithFormat:@"\"%@\"", [TOSUtil dataMD5String:object.data]];
+            object.lastModified = [NSDate date];
+        }
+    }
+    TOSLocalResponse *response = [TOSLocalResponse new];
+    response.headers[@"x-tos-next-append-offset"] = [NSString stringWithFormat:@"%llu", (unsigned long long)(offset + body.length)];
+    response.headers[@"x-tos-hash-crc64ecma"] = [NSString stringWithFormat:@"%llu", object.crc64];
+    return response;
+}
+
+- (TOSLocalResponse *)listObjects:(TOSLocalRequest *)request {
+    NSString *prefix = request.query[@"prefix"] ?: @"";
+    NSString *delimiter = request.query[@"delimiter"] ?: @"";
+    NSString *marker = request.query[@"marker"] ?: @"";
+    int maxKeys = request.query[@"max-keys"] ? [request.query[@"max-keys"] intValue] : 1000;
+
+    NSMutableArray *contents = [NSMutableArray array];
+    NSMutableArray *commonPrefixes = [NSMutableArray array];
+    NSString *lastEntry = nil;
+    BOOL truncated = NO;
+    @synchronized (self) {
+        NSArray<NSString *> *keys = [[_objects allKeys] sortedArrayUsingSelector:@selector(compare:)];
+        for (NSString *key in keys) {
+            if (![key hasPrefix:prefix] || [key compare:marker] != NSOrderedDescending) {
+                continue;
+            }
+            if (delimiter.length > 0) {
+                NSRange range = [key rangeOfString:delimiter options:0 range:NSMakeRange(prefix.length, key.length - prefix.length)];
+                if (range.location != NSNotFound) {
+                    NSString *commonPrefix = [key substringToIndex:NSMaxRange(range)];
+                    if ([commonPrefix isEqualToString:lastEntry] || [commonPrefix compare:marker] != NSOrderedDescending) {
+                        continue;
+                    }
+                    if ((int)(contents.count + commonPrefixes.count) >= maxKeys) {
+                        truncated = YES;
+                        break;
+                    }
+                    [commonPrefixes addObject:@{@"Prefix": commonPrefix}];
+                    lastEntry = commonPrefix;
+                    continue;
+                }
+            }
+            if ((int)(contents.count + commonPrefixes.count) >= maxKeys) {
+                truncated = YES;
+                break;
+            }
+            TOSLocalObject *object = _objects[key];
+            [contents addObject:@{
+                @"Key": key,
+                @"ETag": object.eTag,
+                @"Size": @(object.data.length),
+                @"LastModified": [self stringFromDate:object.lastModified],
+                @"StorageClass": @"STANDARD",
+                @"HashCrc64ecma": [NSString stringWithFormat:@"%llu", object.crc64],
+            }];
+            lastEntry = key;
+        }
+    }
+
+    NSMutableDictionary *body = [NSMutableDictionary dictionary];
+    body[@"Name"] = TOSLocalServerBucket;
+    body[@"Prefix"] = prefix;
+    body[@"Marker"] = marker;
+    body[@"MaxKeys"] = @(maxKeys);
+    body[@"Delimiter"] = delimiter;
+    body[@"IsTruncated"] = @(truncated);
+    if (truncated && lastEntry) {
+        body[@"NextMarker"] = lastEntry;
+    }
+    body[@"Contents"] = contents;
+    body[@"CommonPrefixes"] = commonPrefixes;
+    return [self jsonResponse:body];
+}
+
+// 不支持多版本，VersionId被忽略；单次最多1000个对象
+- (TOSLocalResponse *)deleteMultiObjects:(TOSLocalRequest *)request {
+    NSDictionary *body = request.body.length > 0 ? [NSJSONSerialization JSONObjectWithData:request.body options:0 error:NULL] : nil;
+    NSArray *objects = [body isKindOfClass:[NSDictionary class]] ? body[@"Objects"] : nil;
+    if (![objects isKindOfClass:[NSArray class]] || objects.count == 0 || objects.count > 1000) {
+        return [self errorResponse:400 code:@"MalformedXML" message:@"invalid delete objects"];
+    }
+    BOOL quiet = [body[@"Quiet"] boolValue];
+    NSMutableArray *deleted = [NSMutableArray array];
+    @synchronized (self) {
+        for (NSDictionary *object in objects) {
+            NSString *key = object[@"Key"];
+            if (key.length == 0) {
+                continue;
+            }
+            [_objects removeObjectForKey:key];
+            if (!quiet) {
+                [deleted addObject:@{@"Key": key}];
+            }
+        }
+    }
+    return [self jsonResponse:@{@"Deleted": deleted, @"Error": @[]}];
+}
+
+#pragma mark - 分片上传
+
+- (TOSLocalResponse *)createMultipartUpload:(TOSLocalRequest *)request {
+    TOSLocalUpload *upload = [TOSLocalUpload new];
+    upload.key = request.key;
+    upload.uploadID = [[[NSUUID UUID] UUIDString] stringByReplacingOccurrencesOfString:@"-" withString:@""];
+    upload.initiated = [NSDate date];
+    upload.parts = [NSMutableDictionary dictionary];
+    @synchronized (self) {
+        _uploads[upload.uploadID] = upload;
+    }
+    return [self jsonResponse:@{@"Bucket": TOSLocalServerBucket, @"Key": request.key, @"UploadId": upload.uploadID}];
+}
+
+- (TOSLocalUpload *)uploadForRequest:(TOSLocalRequest *)request {
+    TOSLocalUpload *upload = _uploads[request.query[@"uploadId"]];
+    if (![upload.key isEqualToString:request.key]) {
+        return nil;
+    }
+    return upload;
+}
+
+- (TOSLocalResponse *)uploadPart:(TOSLocalRequest *)request {
+    int partNumber = [request.query[@"partNumber"] intValue];
+    if (partNumber < 1 || partNumber > 10000) {
+        return [self errorResponse:400 code:@"InvalidArgument" message:@"invalid part number"];
+    }
+    TOSLocalObject *part = [self objectWithData:request.body];
+    @synchronized (self) {
+        TOSLocalUpload *upload = [self uploadForRequest:request];
+        if (!upload) {
+            return [self errorResponse:404 code:@"NoSuchUpload" message:@"The specified multipart upload does not exist."];
+        }
+        upload.parts[@(partNumber)] = part;
+    }
+    TOSLocalResponse *response = [TOSLocalResponse new];
+    [self setObjectHeaders:part toResponse:response];
+    return response;
+}
+
+- (TOSLocalResponse *)completeMultipartUpload:(TOSLocalRequest *)request {
+    id body = [NSJSONSerialization JSONObjectWithData:request.body options:0 error:NULL];
+    NSArray *requestedParts = [body isKindOfClass:[NSDictionary class]] ? body[@"Parts"] : nil;
+    if (requestedParts.count == 0) {
+        return [self errorResponse:400 code:@"InvalidPart" message:@"parts should not be empty"];
+    }
+
+    TOSLocalObject *object = [TOSLocalObject new];
+    object.data = [NSMutableData data];
+    object.lastModified = [NSDate date];
+    NSMutableString *eTags = [NSMutableString string];
+    @synchronized (self) {
+        TOSLocalUpload *upload = [self uploadForRequest:request];
+        if (!upload) {
+            return [self errorResponse:404 code:@"NoSuchUpload" message:@"The specified multipart upload does not exist."];
+        }
+        int lastPartNumber = 0;
+        for (NSDictionary *item in requestedParts) {
+            int partNumber = [item[@"PartNumber"] intValue];
+            TOSLocalObject *part = upload.parts[@(partNumber)];
+            if (partNumber <= lastPartNumber) {
+                return [self errorResponse:400 code:@"InvalidPartOrder" message:@"part numbers should be ascending"];
+            }
+            if (!part || ![part.eTag isEqualToString:item[@"ETag"]]) {
+                return [self errorResponse:400 code:@"InvalidPart" message:[NSString stringWithFormat:@"part %d not found", partNumber]];
+            }
+            object.crc64 = [TOSUtil crc64ForCombineCRC1:object.crc64 CRC2:part.crc64 length:part.data.length];
+            [object.data appendData:part.data];
+            [eTags appendString:part.eTag];
+            lastPartNumber = partNumber;
+        }
+        NSData *eTagData = [eTags dataUsingEncoding:NSUTF8StringEncoding];
+        object.eTag = [NSString stringWithFormat:@"\"%@-%lu\"", [TOSUtil dataMD5String:eTagData], (unsigned long)requestedParts.count];
+        _objects[request.key] = object;
+        [_uploads removeObjectForKey:upload.uploadID];
+    }
+    // 合并分片响应不能带ETag/Location header，否则SDK会按回调结果解析
+    TOSLocalResponse *response = [self jsonResponse:@{
+        @"Bucket": TOSLocalServerBucket,
+        @"Key": request.key,
+        @"ETag": object.eTag,
+        @"Location": [NSString stringWithFormat:@"%@/%@", self.endpoint, request.key],
+    }];
+    response.headers[@"x-tos-hash-crc64ecma"] = [NSString stringWithFormat:@"%llu", object.crc64];
+    return response;
+}
+
+- (TOSLocalResponse *)abortMultipartUpload:(TOSLocalRequest *)request {
+    @synchronized (self) {
+        TOSLocalUpload *upload = [self uploadForRequest:request];
+        if (!upload) {
+            return [self errorResponse:404 code:@"NoSuchUpload" message:@"The specified multipart upload does not exist."];
+        }
+        [_uploads removeObjectForKey:upload.uploadID];
+    }
+    TOSLocalResponse *response = [TOSLocalResponse new];
+    response.statusCode = 204;
+    return response;
+}
+
+- (TOSLocalResponse *)listParts:(TOSLocalRequest *)request {
+    int marker = [request.query[@"part-number-marker"] intValue];
+    int maxParts = request.query[@"max-parts"] ? [request.query[@"max-parts"] intValue] : 1000;
+    NSMutableArray *parts = [NSMutableArray array];
+    BOOL truncated = NO;
+    int nextMarker = 0;
+    @synchronized (self) {
+        TOSLocalUpload *upload = [self uploadForRequest:request];
+        if (!upload) {
+            return [self errorResponse:404 code:@"NoSuchUpload" message:@"The specified multipart upload does not exist."];
+        }
+        NSArray<NSNumber *> *partNumbers = [[upload.parts allKeys] sortedArrayUsingSelector:@selector(compare:)];
+        for (NSNumber *partNumber in partNumbers) {
+            if ([partNumber intValue] <= marker) {
+                continue;
+            }
+            if ((int)parts.count >= maxParts) {
+                truncated = YES;
+                break;
+            }
+            TOSLocalObject *part = upload.parts[partNumber];
+            [parts addObject:@{
+                @"PartNumber": partNumber,
+                @"ETag": part.eTag,
+                @"Size": @(part.data.length),
+                @"LastModified": [self stringFromDate:part.lastModified],
+            }];
+            nextMarker = [partNumber intValue];
+        }
+    }
+    return [self jsonResponse:@{
+        @"Bucket": TOSLocalServerBucket,
+        @"Key": request.key,
+        @"UploadId": request.query[@"uploadId"],
+        @"PartNumberMarker": @(marker),
+        @"MaxParts": @(maxParts),
+        @"IsTruncated": @(truncated),
+        @"NextPartNumberMarker": @(nextMarker),
+        @"StorageClass": @"STANDARD",
+        @"Parts": parts,
+    }];
+}
+
+- (TOSLocalResponse *)listMultipartUploads:(TOSLocalRequest *)request {
+    NSString *prefix = request.query[@"prefix"] ?: @"";
+    NSMutableArray *uploads = [NSMutableArray array];
+    @synchronized (self) {
+        for (TOSLocalUpload *upload in [_uploads allValues]) {
+            if (![upload.key hasPrefix:prefix]) {
+                continue;
+            }
+            [uploads addObject:@{
+                @"Key": upload.key,
+                @"UploadId": upload.uploadID,
+                @"Initiated": [self stringFromDate:upload.initiated],
+                @"StorageClass": @"STANDARD",
+            }];
+        }
+    }
+    [uploads sortUsingDescriptors:@[[NSSortDescriptor sortDescriptorWithKey:@"Key" ascending:YES]]];
+    return [self jsonResponse:@{
+        @"Bucket": TOSLocalServerBucket,
+        @"Prefix": prefix,
+        @"MaxUploads": @1000,
+        @"IsTruncated": @NO,
+        @"Uploads": uploads,
+    }];
+}
+
+#pragma mark - 辅助方法
+
+- (NSString *)stringFromDate:(NSDate *)date {
+    @synchronized (_dateFormatter) {
+        return [_dateFormatter stringFromDate:date];
+    }
+}
+
+- (TOSLocalResponse *)jsonResponse:(id)object {
+    TOSLocalResponse *response = [TOSLocalResponse new];
+    response.headers[@"Content-Type"] = @"application/json";
+    response.body = [NSJSONSerialization dataWithJSONObject:object options:0 error:NULL];
+    return response;
+}
+
+- (TOSLocalResponse *)errorResponse:(NSInteger)statusCode code:(NSString *)code message:(NSString *)message {
+    TOSLocalResponse *response = [self jsonResponse:@{@"Code": code, @"Message": message, @"HostId": @"127.0.0.1"}];
+    response.statusCode = statusCode;
+    return response;
+}
+
+@end
@@ -0,0 +1,57 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import "TOSLocalServer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 进程内网络模拟，基于NSURLProtocol，不建立socket
+ * 请求由backend处理，模拟器在其上叠加RTT、单连接带宽、服务端延迟分布、连接数限制和脚本化的429/503
+ * 随机数由seed决定，相同配置下请求的延迟与错误序列可复现
+ *
+ * 用法：将protocolClass加入TOSClientConfiguration.protocolClasses，endpoint作为自定义域名
+ */
+@interface TOSNetworkSimulator : NSObject
+
+@property (nonatomic, strong, readonly) TOSLocalServer *backend;
+@property (nonatomic, readonly) NSString *endpoint; // http://<唯一host>，按host路由到对应模拟器
+
+@property (nonatomic, assign) NSTimeInterval rtt;
+@property (nonatomic, assign) uint64_t bandwidth; // 每个连接的收发带宽，字节/秒，0为不限速
+@property (nonatomic, assign) NSTimeInterval serverLatency; // 服务端处理耗时中位数
+@property (nonatomic, assign) double latencySigma; // 服务端耗时的对数正态分布参数，0为固定耗时
+@property (nonatomic, assign) double tailProbability; // 长尾请求概率
+@property (nonatomic, assign) NSTimeInterval tailLatency; // 长尾请求附加耗时的均值（指数分布）
+@property (nonatomic, assign) NSUInteger maxConnections; // 并发连接上限，超出的请求排队，0为不限制
+
+@property (nonatomic, readonly) int64_t requestCount;
+@property (nonatomic, readonly) int64_t scriptedErrorCount;
+@property (nonatomic, readonly) NSUInteger maxActiveConnections; // 观测到的最大并发连接数
+
++ (Class)protocolClass;
+
+- (instancetype)initWithBackend:(TOSLocalServer *)backend seed:(uint64_t)seed;
+
+// 第firstRequest个请求（从0计）起连续count个请求返回statusCode，retryAfter大于0时附带Retry-After
+- (void)addBurstWithStatusCode:(NSInteger)statusCode fromRequest:(int64_t)firstRequest count:(int64_t)count retryAfter:(NSTimeInterval)retryAfter;
+
+- (void)invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
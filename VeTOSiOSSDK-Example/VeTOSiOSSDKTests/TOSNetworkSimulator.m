@@ -0,0 +1,339 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSNetworkSimulator.h"
+#import <libkern/OSAtomic.h>
+
+static const NSUInteger TOSNetworkSimulatorChunkSize = 64 * 1024;
+
+static NSMapTable<NSString *, TOSNetworkSimulator *> *TOSNetworkSimulatorRegistry;
+static volatile int32_t TOSNetworkSimulatorCounter;
+
+// 以(seed, 请求序号)为输入的计数器式随机数，同一请求的随机序列与调度顺序无关
+static uint64_t TOSSplitMix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static double TOSRandomUnit(uint64_t *state) {
+    return ((TOSSplitMix64(state) >> 11) + 0.5) / 9007199254740992.0;
+}
+
+@interface TOSNetworkSimulator ()
+
+- (void)acquireConnection:(dispatch_block_t)block;
+- (void)releaseConnection;
+- (int64_t)nextRequestIndex;
+- (NSTimeInterval)transferTimeForLength:(NSUInteger)length;
+- (NSTimeInterval)serverLatencyForRequest:(int64_t)index;
+- (NSHTTPURLResponse *)responseForURLRequest:(NSURLRequest *)request body:(NSData *)body index:(int64_t)index responseBody:(NSData **)responseBody;
+
+@end
+
+@interface TOSSimulatedURLProtocol : NSURLProtocol
+@end
+
+@implementation TOSSimulatedURLProtocol {
+    TOSNetworkSimulator *_simulator;
+    NSThread *_clientThread;
+    NSArray<NSString *> *_modes;
+    dispatch_queue_t _queue;
+    volatile int32_t _stopped;
+    volatile int32_t _holdsConnection;
+}
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    @synchronized (TOSNetworkSimulatorRegistry) {
+        return request.URL.host && [TOSNetworkSimulatorRegistry objectForKey:request.URL.host] != nil;
+    }
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    @synchronized (TOSNetworkSimulatorRegistry) {
+        _simulator = [TOSNetworkSimulatorRegistry objectForKey:self.request.URL.host];
+    }
+    _clientThread = [NSThread currentThread];
+    NSString *mode = [[NSRunLoop currentRunLoop] currentMode];
+    _modes = (mode && ![mode isEqualToString:NSDefaultRunLoopMode]) ? @[NSDefaultRunLoopMode, mode] : @[NSDefaultRunLoopMode];
+    _queue = dispatch_queue_create("com.volcengine.tos.simulator.protocol", DISPATCH_QUEUE_SERIAL);
+
+    TOSNetworkSimulator *simulator = _simulator;
+    if (!simulator) {
+        [self.client URLProtocol:self didFailWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCannotConnectToHost userInfo:nil]];
+        return;
+    }
+    NSData *body = [self requestBody];
+    [simulator acquireConnection:^{
+        self->_holdsConnection = 1;
+        dispatch_async(self->_queue, ^{
+            [self sendRequestWithBody:body];
+        });
+    }];
+}
+
+- (void)stopLoading {
+    _stopped = 1;
+    [self releaseConnection];
+}
+
+- (void)releaseConnection {
+    if (OSAtomicCompareAndSwap32Barrier(1, 0, &_holdsConnection)) {
+        [_simulator releaseConnection];
+    }
+}
+
+- (NSData *)requestBody {
+    if (self.request.HTTPBody) {
+        return self.request.HTTPBody;
+    }
+    NSInputStream *stream = self.request.HTTPBodyStream;
+    if (!stream) {
+        return [NSData data];
+    }
+    NSMutableData *body = [NSMutableData data];
+    uint8_t buffer[TOSNetworkSimulatorChunkSize];
+    [stream open];
+    NSInteger n;
+    while ((n = [stream read:buffer maxLength:sizeof(buffer)]) > 0) {
+        [body appendBytes:buffer length:n];
+    }
+    [stream close];
+    return body;
+}
+
+- (void)performOnClientThread:(dispatch_block_t)block {
+    [self performSelector:@selector(runClientBlock:) onThread:_clientThread withObject:[block copy] waitUntilDone:NO modes:_modes];
+}
+
+- (void)runClientBlock:(dispatch_block_t)block {
+    if (!_stopped) {
+        block();
+    }
+}
+
+// 请求上行：半个RTT + 请求体传输；服务端处理；响应下行：半个RTT + 按带宽分片回传
+- (void)sendRequestWithBody:(NSData *)body {
+    if (_stopped) {
+        [self releaseConnection];
+        return;
+    }
+    TOSNetworkSimulator *simulator = _simulator;
+    int64_t index = [simulator nextRequestIndex];
+    NSTimeInterval delay = simulator.rtt + [simulator transferTimeForLength:body.length] + [simulator serverLatencyForRequest:index];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), _queue, ^{
+        if (self->_stopped) {
+            [self releaseConnection];
+            return;
+        }
+        NSData *responseBody = nil;
+        NSHTTPURLResponse *response = [simulator responseForURLRequest:self.request body:body index:index responseBody:&responseBody];
+        [self performOnClientThread:^{
+            [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+        }];
+        [self sendResponseBody:responseBody offset:0];
+    });
+}
+
+- (void)sendResponseBody:(NSData *)body offset:(NSUInteger)offset {
+    if (_stopped) {
+        [self releaseConnection];
+        return;
+    }
+    if (offset >= body.length) {
+        [self releaseConnection];
+        [self performOnClientThread:^{
+            [self.client URLProtocolDidFinishLoading:self];
+        }];
+        return;
+    }
+    NSUInteger size = MIN(TOSNetworkSimulatorChunkSize, body.length - offset);
+    NSData *chunk = [body subdataWithRange:NSMakeRange(offset, size)];
+    [self performOnClientThread:^{
+        [self.client URLProtocol:self didLoadData:chunk];
+    }];
+    NSTimeInterval delay = [_simulator transferTimeForLength:size];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), _queue, ^{
+        [self sendResponseBody:body offset:offset + size];
+    });
+}
+
+@end
+
+@implementation TOSNetworkSimulator {
+    NSString *_host;
+    uint64_t _seed;
+    NSUInteger _activeConnections;
+    NSMutableArray<dispatch_block_t> *_pendingConnections;
+    NSMutableArray<NSDictionary *> *_bursts;
+    volatile int64_t _requestCount;
+    volatile int64_t _scriptedErrorCount;
+}
+
++ (void)initialize {
+    if (self == [TOSNetworkSimulator class]) {
+        TOSNetworkSimulatorRegistry = [NSMapTable strongToWeakObjectsMapTable];
+    }
+}
+
++ (Class)protocolClass {
+    return [TOSSimulatedURLProtocol class];
+}
+
+- (instancetype)initWithBackend:(TOSLocalServer *)backend seed:(uint64_t)seed {
+    if (self = [super init]) {
+        _backend = backend;
+        _seed = seed;
+        _pendingConnections = [NSMutableArray array];
+        _bursts = [NSMutableArray array];
+        _host = [NSString stringWithFormat:@"tos-simulator-%d.invalid", OSAtomicIncrement32Barrier(&TOSNetworkSimulatorCounter)];
+        @synchronized (TOSNetworkSimulatorRegistry) {
+            [TOSNetworkSimulatorRegistry setObject:self forKey:_host];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self invalidate];
+}
+
+- (void)invalidate {
+    @synchronized (TOSNetworkSimulatorRegistry) {
+        if ([TOSNetworkSimulatorRegistry objectForKey:_host] == self) {
+            [TOSNetworkSimulatorRegistry removeObjectForKey:_host];
+        }
+    }
+}
+
+- (NSString *)endpoint {
+    return [NSString stringWithFormat:@"http://%@", _host];
+}
+
+- (int64_t)requestCount {
+    return _requestCount;
+}
+
+- (int64_t)scriptedErrorCount {
+    return _scriptedErrorCount;
+}
+
+- (void)addBurstWithStatusCode:(NSInteger)statusCode fromRequest:(int64_t)firstRequest count:(int64_t)count retryAfter:(NSTimeInterval)retryAfter {
+    @synchronized (self) {
+        [_bursts addObject:@{@"status": @(statusCode), @"first": @(firstRequest), @"count": @(count), @"retryAfter": @(retryAfter)}];
+    }
+}
+
+#pragma mark - 连接
+
+// 连接数达到上限时按FIFO排队，不占用线程
+- (void)acquireConnection:(dispatch_block_t)block {
+    BOOL run = NO;
+    @synchronized (self) {
+        if (_maxConnections == 0 || _activeConnections < _maxConnections) {
+            _activeConnections++;
+            _maxActiveConnections = MAX(_maxActiveConnections, _activeConnections);
+            run = YES;
+        } else {
+            [_pendingConnections addObject:[block copy]];
+        }
+    }
+    if (run) {
+        block();
+    }
+}
+
+- (void)releaseConnection {
+    dispatch_block_t next = nil;
+    @synchronized (self) {
+        if (_pendingConnections.count > 0) {
+            next = _pendingConnections.firstObject;
+            [_pendingConnections removeObjectAtIndex:0];
+        } else if (_activeConnections > 0) {
+            _activeConnections--;
+        }
+    }
+    if (next) {
+        next();
+    }
+}
+
+#pragma mark - 时延
+
+- (int64_t)nextRequestIndex {
+    return OSAtomicIncrement64Barrier(&_requestCount) - 1;
+}
+
+- (NSTimeInterval)transferTimeForLength:(NSUInteger)length {
+    uint64_t bandwidth = _bandwidth;
+    return bandwidth > 0 ? (double)length / bandwidth : 0;
+}
+
+- (NSTimeInterval)serverLatencyForRequest:(int64_t)index {
+    uint64_t state = _seed ^ ((uint64_t)index * 0xD1B54A32D192ED03ULL);
+    double latency = _serverLatency;
+    if (_latencySigma > 0 && latency > 0) {
+        // Box-Muller生成标准正态分布
+        double u1 = TOSRandomUnit(&state);
+        double u2 = TOSRandomUnit(&state);
+        double z = sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+        latency *= exp(_latencySigma * z);
+    }
+    if (_tailProbability > 0 && TOSRandomUnit(&state) < _tailProbability) {
+        latency += -log(TOSRandomUnit(&state)) * _tailLatency;
+    }
+    return latency;
+}
+
+#pragma mark - 响应
+
+- (NSHTTPURLResponse *)responseForURLRequest:(NSURLRequest *)request body:(NSData *)body index:(int64_t)index responseBody:(NSData **)responseBody {
+    NSDictionary *burst = nil;
+    @synchronized (self) {
+        for (NSDictionary *item in _bursts) {
+            int64_t first = [item[@"first"] longLongValue];
+            if (index >= first && index < first + [item[@"count"] longLongValue]) {
+                burst = item;
+                break;
+            }
+        }
+    }
+    if (!burst) {
+        return [_backend responseForURLRequest:request body:body responseBody:responseBody];
+    }
+
+    OSAtomicIncrement64Barrier(&_scriptedErrorCount);
+    NSInteger statusCode = [burst[@"status"] integerValue];
+    NSString *code = statusCode == 429 ? @"ExceedAccountQPSLimit" : @"ServiceUnavailable";
+    NSString *requestID = [NSString stringWithFormat:@"simulated-%lld", index];
+    NSData *data = [NSJSONSerialization dataWithJSONObject:@{@"Code": code, @"Message": @"simulated error", @"RequestId": requestID} options:0 error:NULL];
+    NSMutableDictionary *headers = [NSMutableDictionary dictionary];
+    headers[@"Content-Type"] = @"application/json";
+    headers[@"Content-Length"] = [NSString stringWithFormat:@"%lu", (unsigned long)data.length];
+    headers[@"x-tos-request-id"] = requestID;
+    if ([burst[@"retryAfter"] doubleValue] > 0) {
+        headers[@"Retry-After"] = [NSString stringWithFormat:@"%.0f", ceil([burst[@"retryAfter"] doubleValue])];
+    }
+    *responseBody = [request.HTTPMethod isEqualToString:@"HEAD"] ? [NSData data] : data;
+    return [[NSHTTPURLResponse alloc] initWithURL:request.URL statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:headers];
+}
+
+@end
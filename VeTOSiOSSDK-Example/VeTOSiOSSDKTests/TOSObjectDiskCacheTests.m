@@ -0,0 +1,249 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSObjectDiskCacheTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+    TOSObjectDiskCache *_cache;
+    NSString *_directory;
+    NSString *_filePath;
+    NSData *_data;
+    NSMutableArray<NSString *> *_contentRanges;
+}
+
+@end
+
+@implementation TOSObjectDiskCacheTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+    _directory = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-disk-cache-tests"];
+    [[NSFileManager defaultManager] removeItemAtPath:_directory error:nil];
+    _filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-disk-cache-tests-file"];
+    [[NSFileManager defaultManager] removeItemAtPath:_filePath error:nil];
+    // 64KB分段，对象共16个分段
+    _cache = [[TOSObjectDiskCache alloc] initWithDirectory:_directory maxBytes:16 * 1024 * 1024 segmentSize:64 * 1024];
+    _client.clientConfiguration.objectDiskCache = _cache;
+    _data = [TOSTestUtil randomDataWithLength:1024 * 1024];
+    [_server putObject:_data forKey:@"disk-cache"];
+    
+    // 记录实际发往服务端的GET返回的区间
+    NSMutableArray<NSString *> *contentRanges = [NSMutableArray array];
+    _contentRanges = contentRanges;
+    _server.responseHeadersHandler = ^(NSString *method, NSString *key, NSDictionary<NSString *, NSString *> *query, NSMutableDictionary<NSString *, NSString *> *headers) {
+        if ([method isEqualToString:@"GET"] && key.length > 0) {
+            @synchronized (contentRanges) {
+                [contentRanges addObject:headers[@"Content-Range"] ?: @""];
+            }
+        }
+    };
+}
+
+- (void)tearDown {
+    _client.clientConfiguration.objectDiskCache = nil;
+    [_cache removeAllObjects];
+    [_server stop];
+    [[NSFileManager defaultManager] removeItemAtPath:_directory error:nil];
+    [[NSFileManager defaultManager] removeItemAtPath:_filePath error:nil];
+    [super tearDown];
+}
+
+- (TOSTask *)getObjectWithRangeStart:(int64_t)start rangeEnd:(int64_t)end {
+    TOSGetObjectInput *input = [TOSGetObjectInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"disk-cache";
+    input.tosRangeStart = start;
+    input.tosRangeEnd = end;
+    TOSTask *task = [_client getObject:input];
+    [task waitUntilFinished];
+    return task;
+}
+
+- (TOSTask *)getObjectToFile {
+    TOSGetObjectToFileInput *input = [TOSGetObjectToFileInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"disk-cache";
+    input.tosFilePath = _filePath;
+    TOSTask *task = [_client getObjectToFile:input];
+    [task waitUntilFinished];
+    return task;
+}
+
+- (NSArray<NSString *> *)takeContentRanges {
+    @synchronized (_contentRanges) {
+        NSArray<NSString *> *ranges = [_contentRanges copy];
+        [_contentRanges removeAllObjects];
+        return ranges;
+    }
+}
+
+- (void)testAPI_getObjectRangedMiss {
+    _cache.revalidationInterval = 3600;
+    
+    // 未命中时区间按分段对齐扩大，返回调用方请求的部分
+    TOSTask *task = [self getObjectWithRangeStart:1000 rangeEnd:10999];
+    XCTAssertNil(task.error);
+    TOSGetObjectOutput *output = task.result;
+    XCTAssertEqualObjects([_data subdataWithRange:NSMakeRange(1000, 10000)], output.tosContent);
+    XCTAssertEqual(10000, output.tosContentLength);
+    XCTAssertEqualObjects(@"bytes 1000-10999/1048576", output.tosContentRange);
+    XCTAssertEqualObjects((@[@"bytes 0-65535/1048576"]), [self takeContentRanges]);
+    XCTAssertEqual(1, _cache.missCount);
+    
+    // 同一分段内的其他区间直接命中
+    task = [self getObjectWithRangeStart:20000 rangeEnd:29999];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects([_data subdataWithRange:NSMakeRange(20000, 10000)], [task.result tosContent]);
+    XCTAssertEqual(0, [self takeContentRanges].count);
+    XCTAssertEqual(1, _cache.hitCount);
+    
+    // 跨越未缓存的分段时按两个分段下载
+    task = [self getObjectWithRangeStart:60000 rangeEnd:69999];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects([_data subdataWithRange:NSMakeRange(60000, 10000)], [task.result tosContent]);
+    XCTAssertEqualObjects((@[@"bytes 0-131071/1048576"]), [self takeContentRanges]);
+    
+    // 区间超出对象末尾时截断到对象末尾
+    task = [self getObjectWithRangeStart:1040000 rangeEnd:1099999];
+    XCTAssertNil(task.error);
+    output = task.result;
+    XCTAssertEqualObjects([_data subdataWithRange:NSMakeRange(1040000, _data.length - 1040000)], output.tosContent);
+    XCTAssertEqualObjects(@"bytes 1040000-1048575/1048576", output.tosContentRange);
+    XCTAssertEqualObjects((@[@"bytes 983040-1048575/1048576"]), [self takeContentRanges]);
+    
+    // 起始位置超出对象大小
+    task = [self getObjectWithRangeStart:2 * 1024 * 1024 rangeEnd:2 * 1024 * 1024 + 99];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqual(416, task.error.code);
+}
+
+- (void)testAPI_getObjectFreshHit {
+    _cache.revalidationInterval = 3600;
+    TOSTask *task = [self getObjectWithRangeStart:0 rangeEnd:0];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(_data, [task.result tosContent]);
+    
+    // 校验间隔内命中不发起请求，其他客户端的修改不可见
+    [_server putObject:[TOSTestUtil randomDataWithLength:1024] forKey:@"disk-cache"];
+    int64_t requestsBefore = _server.requestCount;
+    for (int i = 0; i < 5; i++) {
+        task = [self getObjectWithRangeStart:0 rangeEnd:0];
+        XCTAssertNil(task.error);
+        XCTAssertEqualObjects(_data, [task.result tosContent]);
+    }
+    task = [self getObjectWithRangeStart:300000 rangeEnd:399999];
+    XCTAssertEqualObjects([_data subdataWithRange:NSMakeRange(300000, 100000)], [task.result tosContent]);
+    XCTAssertEqual(0, _server.requestCount - requestsBefore);
+    XCTAssertEqual(6, _cache.hitCount);
+}
+
+- (void)testAPI_getObjectRevalidation {
+    TOSTask *task = [self getObjectWithRangeStart:0 rangeEnd:0];
+    XCTAssertNil(task.error);
+    [self takeContentRanges];
+    
+    // 每次命中都携带If-None-Match校验，304时由缓存返回
+    int64_t requestsBefore = _server.requestCount;
+    task = [self getObjectWithRangeStart:100 rangeEnd:199];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects([_data subdataWithRange:NSMakeRange(100, 100)], [task.result tosContent]);
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    XCTAssertEqual(1, _cache.notModifiedCount);
+    // 304不带Content-Range，校验请求不按分段扩大区间也无需下载数据
+    XCTAssertEqualObjects((@[@""]), [self takeContentRanges]);
+    
+    // 其他客户端修改后返回新内容并替换缓存
+    NSData *modified = [TOSTestUtil randomDataWithLength:2048];
+    [_server putObject:modified forKey:@"disk-cache"];
+    task = [self getObjectWithRangeStart:0 rangeEnd:0];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(modified, [task.result tosContent]);
+    XCTAssertEqual(1, _cache.notModifiedCount);
+    task = [self getObjectWithRangeStart:0 rangeEnd:0];
+    XCTAssertEqualObjects(modified, [task.result tosContent]);
+    XCTAssertEqual(2, _cache.notModifiedCount);
+}
+
+- (void)testAPI_getObjectInvalidation {
+    _cache.revalidationInterval = 3600;
+    XCTAssertNil([self getObjectWithRangeStart:0 rangeEnd:0].error);
+    
+    // 本Client的写操作使缓存失效
+    TOSPutObjectInput *put = [TOSPutObjectInput new];
+    put.tosBucket = @"local-bucket";
+    put.tosKey = @"disk-cache";
+    put.tosContent = [TOSTestUtil randomDataWithLength:1024];
+    XCTAssertNil([[_client putObject:put] waitUntilFinished].error);
+    int64_t requestsBefore = _server.requestCount;
+    TOSTask *task = [self getObjectWithRangeStart:0 rangeEnd:0];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(put.tosContent, [task.result tosContent]);
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    
+    TOSDeleteObjectInput *deleteInput = [TOSDeleteObjectInput new];
+    deleteInput.tosBucket = @"local-bucket";
+    deleteInput.tosKey = @"disk-cache";
+    [[_client deleteObject:deleteInput] waitUntilFinished];
+    task = [self getObjectWithRangeStart:0 rangeEnd:0];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqual(404, task.error.code);
+}
+
+- (void)testAPI_getObjectToFile {
+    // 未命中时下载到文件，再从文件写入缓存
+    TOSTask *task = [self getObjectToFile];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(_data, [NSData dataWithContentsOfFile:_filePath]);
+    XCTAssertGreaterThanOrEqual(_cache.totalBytes, (uint64_t)_data.length);
+    
+    // 命中时先由缓存写入文件，校验返回304后保留该文件
+    [[NSFileManager defaultManager] removeItemAtPath:_filePath error:nil];
+    int64_t requestsBefore = _server.requestCount;
+    task = [self getObjectToFile];
+    XCTAssertNil(task.error);
+    XCTAssertEqual((int64_t)_data.length, [task.result tosContentLength]);
+    XCTAssertEqualObjects(_data, [NSData dataWithContentsOfFile:_filePath]);
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    XCTAssertEqual(1, _cache.notModifiedCount);
+    
+    // 校验间隔内不发起请求
+    _cache.revalidationInterval = 3600;
+    [[NSFileManager defaultManager] removeItemAtPath:_filePath error:nil];
+    task = [self getObjectToFile];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(_data, [NSData dataWithContentsOfFile:_filePath]);
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    
+    // 对象被修改时以下载的内容覆盖缓存写入的文件
+    _cache.revalidationInterval = 0;
+    NSData *modified = [TOSTestUtil randomDataWithLength:4096];
+    [_server putObject:modified forKey:@"disk-cache"];
+    task = [self getObjectToFile];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(modified, [NSData dataWithContentsOfFile:_filePath]);
+    task = [self getObjectWithRangeStart:0 rangeEnd:0];
+    XCTAssertEqualObjects(modified, [task.result tosContent]);
+    XCTAssertEqual(2, _cache.notModifiedCount);
+}
+
+@end
@@ -0,0 +1,144 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSObjectReaderTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+    TOSGetObjectInput *_readerInput;
+}
+
+@end
+
+@implementation TOSObjectReaderTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+    _readerInput = [TOSGetObjectInput new];
+    _readerInput.tosBucket = @"local-bucket";
+    _readerInput.tosKey = @"reader";
+}
+
+- (void)tearDown {
+    [_server stop];
+    [super tearDown];
+}
+
+- (void)testAPI_objectReaderSequentialRead {
+    NSData *data = [TOSTestUtil randomDataWithLength:16 * 1024 * 1024 + 100];
+    [_server putObject:data forKey:@"reader"];
+    TOSObjectReader *reader = [[TOSObjectReader alloc] initWithClient:_client input:_readerInput];
+    NSUInteger chunk = 64 * 1024;
+    NSMutableData *received = [NSMutableData dataWithCapacity:data.length];
+    int64_t requestsBefore = _server.requestCount;
+    while (YES) {
+        TOSTask *task = [reader readLength:chunk];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        if ([task.result length] == 0) {
+            break;
+        }
+        [received appendData:task.result];
+    }
+    XCTAssertEqualObjects(data, received);
+    XCTAssertEqual((int64_t)data.length, reader.position);
+    XCTAssertEqual((int64_t)data.length, reader.objectSize);
+    // HEAD一次，其余为预读合并后的区间
+    XCTAssertLessThan(_server.requestCount - requestsBefore, (int64_t)(data.length / chunk / 4));
+    XCTAssertGreaterThan(reader.blockHitCount, 0);
+    [reader close];
+}
+
+- (void)testAPI_objectReaderRandomRead {
+    NSData *data = [TOSTestUtil randomDataWithLength:1024 * 1024];
+    [_server putObject:data forKey:@"reader"];
+    TOSObjectReader *reader = [[TOSObjectReader alloc] initWithClient:_client input:_readerInput];
+    reader.blockSize = 16 * 1024;
+    NSUInteger readLength = 4 * 1024;
+    for (int i = 0; i < 50; i++) {
+        int64_t offset = (int64_t)((uint64_t)i * 2654435761u % (data.length - readLength));
+        TOSTask *task = [reader readAtOffset:offset length:readLength];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        XCTAssertEqualObjects([data subdataWithRange:NSMakeRange((NSUInteger)offset, readLength)], task.result);
+    }
+
+    // 超过对象末尾的部分被截断，起点在末尾时返回空数据
+    TOSTask *task = [reader readAtOffset:(int64_t)data.length - 10 length:100];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects([data subdataWithRange:NSMakeRange(data.length - 10, 10)], task.result);
+    task = [reader readAtOffset:(int64_t)data.length length:100];
+    [task waitUntilFinished];
+    XCTAssertEqual(0, [task.result length]);
+    [reader close];
+}
+
+- (void)testAPI_objectReaderZeroLengthObject {
+    [_server putObject:[NSData data] forKey:@"reader"];
+    TOSObjectReader *reader = [[TOSObjectReader alloc] initWithClient:_client input:_readerInput];
+    TOSTask *task = [reader open];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(0, reader.objectSize);
+    XCTAssertNotNil(reader.eTag);
+
+    task = [reader readLength:1024];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(0, [task.result length]);
+    XCTAssertEqual(0, reader.position);
+    task = [reader readAtOffset:0 length:1024];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(0, [task.result length]);
+    XCTAssertEqual(0, reader.requestCount);
+    [reader close];
+}
+
+- (void)testAPI_objectReaderObjectModified {
+    [_server putObject:[TOSTestUtil randomDataWithLength:1024] forKey:@"reader"];
+    TOSObjectReader *reader = [[TOSObjectReader alloc] initWithClient:_client input:_readerInput];
+    [[reader open] waitUntilFinished];
+    // 打开后对象被覆盖，区间下载因If-Match不满足而失败
+    [_server putObject:[TOSTestUtil randomDataWithLength:1024] forKey:@"reader"];
+    TOSTask *task = [reader readAtOffset:0 length:1];
+    [task waitUntilFinished];
+    XCTAssertEqual(412, task.error.code);
+    [reader close];
+}
+
+- (void)testAPI_objectReaderInvalidArguments {
+    [_server putObject:[TOSTestUtil randomDataWithLength:1024] forKey:@"reader"];
+    TOSObjectReader *reader = [[TOSObjectReader alloc] initWithClient:_client input:_readerInput];
+    NSError *error = nil;
+    XCTAssertFalse([reader seekToOffset:-1 error:&error]);
+    XCTAssertEqualObjects(@"tos: invalid seek offset", error.userInfo[TOSErrorMessageTOKEN]);
+    TOSTask *task = [reader readAtOffset:-1 length:1];
+    XCTAssertEqualObjects(@"tos: invalid read offset", task.error.userInfo[TOSErrorMessageTOKEN]);
+
+    [reader close];
+    task = [reader readAtOffset:0 length:1];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(@"tos: object reader is closed", task.error.userInfo[TOSErrorMessageTOKEN]);
+}
+
+@end
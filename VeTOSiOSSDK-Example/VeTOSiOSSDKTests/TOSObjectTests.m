@@ -1760,6 +1760,99 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_getObjectDiscontiguousContent {
+    TOSPutObjectFromFileInput *putInput = [TOSPutObjectFromFileInput new];
+    putInput.tosBucket = _privateBucket;
+    putInput.tosKey = _fileNames[4];
+    putInput.tosFilePath = [[TOSUtil documentDirectory] stringByAppendingPathComponent:_fileNames[4]];
+    TOSTask *task = [_client putObjectFromFile:putInput];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    
+    TOSGetObjectInput *getInput = [TOSGetObjectInput new];
+    getInput.tosBucket = _privateBucket;
+    getInput.tosKey = _fileNames[4];
+    getInput.tosDiscontiguousContent = YES;
+    task = [_client getObject:getInput];
+    [[task continueWithBlock:^id _Nullable(TOSTask * _Nonnull t) {
+        XCTAssertNil(t.error);
+        TOSGetObjectOutput *output = t.result;
+        XCTAssertEqual(200, output.tosStatusCode);
+        __block NSUInteger total = 0;
+        __block uint64_t crc64 = 0;
+        [output.tosContent enumerateByteRangesUsingBlock:^(const void * _Nonnull bytes, NSRange byteRange, BOOL * _Nonnull stop) {
+            crc64 = [TOSUtil crc64ecma:crc64 buffer:(void *)bytes length:byteRange.length];
+            total += byteRange.length;
+        }];
+        XCTAssertEqual([self->_fileSizes[4] unsignedIntegerValue], total);
+        XCTAssertEqual(output.tosHashCrc64ecma, crc64);
+        return nil;
+    }] waitUntilFinished];
+}
+
+- (void)testAPI_getObjectIntoBuffer {
+    TOSPutObjectFromFileInput *putInput = [TOSPutObjectFromFileInput new];
+    putInput.tosBucket = _privateBucket;
+    putInput.tosKey = _fileNames[3];
+    putInput.tosFilePath = [[TOSUtil documentDirectory] stringByAppendingPathComponent:_fileNames[3]];
+    TOSTask *task = [_client putObjectFromFile:putInput];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    
+    NSUInteger size = [_fileSizes[3] unsignedIntegerValue];
+    NSMutableData *buffer = [NSMutableData dataWithLength:size];
+    TOSGetObjectInput *getInput = [TOSGetObjectInput new];
+    getInput.tosBucket = _privateBucket;
+    getInput.tosKey = _fileNames[3];
+    task = [_client getObject:getInput intoBuffer:buffer.mutableBytes capacity:size];
+    [[task continueWithBlock:^id _Nullable(TOSTask * _Nonnull t) {
+        XCTAssertNil(t.error);
+        TOSGetObjectOutput *output = t.result;
+        XCTAssertEqual(200, output.tosStatusCode);
+        XCTAssertEqual(size, output.tosContent.length);
+        XCTAssertEqual(buffer.mutableBytes, output.tosContent.bytes);
+        NSData *local = [NSData dataWithContentsOfFile:putInput.tosFilePath];
+        XCTAssertTrue([local isEqualToData:buffer]);
+        return nil;
+    }] waitUntilFinished];
+    
+    // 缓冲区不足
+    task = [_client getObject:getInput intoBuffer:buffer.mutableBytes capacity:size / 2];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    XCTAssertEqualObjects(TOSClientErrorDomain, task.error.domain);
+    XCTAssertEqualObjects(@"tos: object content exceeds buffer capacity", task.error.userInfo[TOSErrorMessageTOKEN]);
+}
+
+- (void)testAPI_requestMetrics {
+    TOSPutObjectInput *putInput = [TOSPutObjectInput new];
+    putInput.tosBucket = _privateBucket;
+    putInput.tosKey = @"metrics-object";
+    putInput.tosContent = [@"metrics" dataUsingEncoding:NSUTF8StringEncoding];
+    TOSTask *task = [_client putObject:putInput];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    TOSRequestMetrics *metrics = ((TOSOutput *)task.result).tosMetrics;
+    XCTAssertNotNil(metrics);
+    XCTAssertEqual(TOSOperationTypePutObject, metrics.operationType);
+    XCTAssertEqual(200, metrics.statusCode);
+    XCTAssertTrue(metrics.totalDuration > 0);
+    XCTAssertTrue(metrics.totalDuration >= metrics.transferDuration);
+    if (@available(iOS 10.0, *)) {
+        XCTAssertNotNil(metrics.taskMetrics);
+    }
+    
+    TOSHeadObjectInput *headInput = [TOSHeadObjectInput new];
+    headInput.tosBucket = _privateBucket;
+    headInput.tosKey = @"metrics-object-not-exist";
+    task = [_client headObject:headInput];
+    [task waitUntilFinished];
+    XCTAssertNotNil(task.error);
+    metrics = task.error.userInfo[TOSErrorMetricsTOKEN];
+    XCTAssertNotNil(metrics);
+    XCTAssertEqual(404, metrics.statusCode);
+}
+
 - (void)testAPI_getObjectToFile {
     TOSPutObjectFromFileInput *putInput = [TOSPutObjectFromFileInput new];
     putInput.tosBucket = _privateBucket;
@@ -2344,6 +2437,52 @@
 }
 
 
+// 100次8MiB对象下载的耗时与内存峰值，响应体缓冲区来自缓冲池
+- (void)testPerformance_getObjectPooledBuffer {
+    NSString *key = @"perf-get-8m";
+    NSUInteger size = 8 * 1024 * 1024;
+    NSMutableData *content = [NSMutableData dataWithLength:size];
+    arc4random_buf(content.mutableBytes, size);
+    
+    TOSPutObjectInput *putInput = [TOSPutObjectInput new];
+    putInput.tosBucket = _privateBucket;
+    putInput.tosKey = key;
+    putInput.tosContent = content;
+    TOSTask *task = [_client putObject:putInput];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    
+    TOSBufferPool *pool = [TOSBufferPool sharedPool];
+    int64_t allocationCount = pool.allocationCount;
+    int64_t reuseCount = pool.reuseCount;
+    
+    void (^getObjects)(void) = ^{
+        for (int i = 0; i < 100; i++) {
+            @autoreleasepool {
+                TOSGetObjectInput *getInput = [TOSGetObjectInput new];
+                getInput.tosBucket = self->_privateBucket;
+                getInput.tosKey = key;
+                TOSTask *getTask = [self->_client getObject:getInput];
+                [getTask waitUntilFinished];
+                XCTAssertNil(getTask.error);
+                TOSGetObjectOutput *getOutput = getTask.result;
+                XCTAssertEqual(size, getOutput.tosContent.length);
+            }
+        }
+    };
+    if (@available(iOS 13.0, *)) {
+        XCTMeasureOptions *options = [XCTMeasureOptions defaultOptions];
+        options.iterationCount = 1;
+        [self measureWithMetrics:@[[XCTClockMetric new], [XCTMemoryMetric new]] options:options block:getObjects];
+    } else {
+        getObjects();
+    }
+    
+    NSLog(@"buffer pool allocations: %lld, reuses: %lld", pool.allocationCount - allocationCount, pool.reuseCount - reuseCount);
+    XCTAssertLessThan(pool.allocationCount - allocationCount, 100);
+}
+
+
 - (BOOL)checkMd5WithBucketName:(nonnull NSString *)bucketName objectKey:(nonnull NSString *)objectKey localFilePath:(nonnull NSString *)filePath {
     NSString * tempFilePath = [[TOSUtil documentDirectory] stringByAppendingPathComponent:@"tempfile_for_check"];
     
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSObjectWriterTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+    TOSCreateMultipartUploadInput *_writerInput;
+}
+
+@end
+
+@implementation TOSObjectWriterTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+    _writerInput = [TOSCreateMultipartUploadInput new];
+    _writerInput.tosBucket = @"local-bucket";
+    _writerInput.tosKey = @"writer";
+}
+
+- (void)tearDown {
+    [_server stop];
+    [super tearDown];
+}
+
+- (void)testAPI_objectWriterMultipart {
+    NSData *data = [TOSTestUtil randomDataWithLength:12 * 1024 * 1024];
+    TOSObjectWriter *writer = [[TOSObjectWriter alloc] initWithClient:_client input:_writerInput];
+    writer.partSize = 5 * 1024 * 1024;
+    NSUInteger chunk = 64 * 1024;
+    for (NSUInteger offset = 0; offset < data.length; offset += chunk) {
+        NSError *error = nil;
+        XCTAssertTrue([writer write:[data subdataWithRange:NSMakeRange(offset, MIN(chunk, data.length - offset))] error:&error]);
+        XCTAssertNil(error);
+    }
+    TOSTask *task = [writer close];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertTrue([task.result isKindOfClass:[TOSCompleteMultipartUploadOutput class]]);
+    XCTAssertEqual(3, writer.partCount);
+    XCTAssertEqual((int64_t)data.length, writer.bytesWritten);
+    XCTAssertEqual([TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length], writer.hashCrc64ecma);
+    XCTAssertNotNil(writer.eTag);
+    XCTAssertEqualObjects(data, [_server objectForKey:@"writer"]);
+    XCTAssertEqual(0, _server.uploadCount);
+    // close多次调用返回同一Task
+    XCTAssertEqual(task, [writer close]);
+}
+
+- (void)testAPI_objectWriterSmallObject {
+    NSData *data = [TOSTestUtil randomDataWithLength:1024 * 1024];
+    TOSObjectWriter *writer = [[TOSObjectWriter alloc] initWithClient:_client input:_writerInput];
+    writer.partSize = 5 * 1024 * 1024;
+    int64_t requestsBefore = _server.requestCount;
+    XCTAssertTrue([writer write:data error:nil]);
+    TOSTask *task = [writer close];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertTrue([task.result isKindOfClass:[TOSPutObjectOutput class]]);
+    XCTAssertNil(writer.uploadID);
+    XCTAssertEqual(0, writer.partCount);
+    XCTAssertEqual(1, _server.requestCount - requestsBefore);
+    XCTAssertEqualObjects(data, [_server objectForKey:@"writer"]);
+}
+
+- (void)testAPI_objectWriterAbortWithPartsInFlight {
+    // 服务端延迟响应，abort时两个段仍在上传
+    _server.latency = 0.5;
+    NSData *data = [TOSTestUtil randomDataWithLength:10 * 1024 * 1024];
+    TOSObjectWriter *writer = [[TOSObjectWriter alloc] initWithClient:_client input:_writerInput];
+    writer.partSize = 5 * 1024 * 1024;
+    XCTAssertTrue([writer write:data error:nil]);
+    XCTAssertEqual(2, writer.partCount);
+    TOSTask *task = [writer abort];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(0, _server.uploadCount);
+    XCTAssertNil([_server objectForKey:@"writer"]);
+
+    NSError *error = nil;
+    XCTAssertFalse([writer write:data error:&error]);
+    XCTAssertEqualObjects(@"tos: object writer is aborted", error.userInfo[TOSErrorMessageTOKEN]);
+    task = [writer close];
+    XCTAssertEqualObjects(@"tos: object writer is aborted", task.error.userInfo[TOSErrorMessageTOKEN]);
+}
+
+- (void)testAPI_objectWriterCRCMismatchOnComplete {
+    // 合并段的响应返回错误的CRC64
+    _server.responseHeadersHandler = ^(NSString *method, NSString *key, NSDictionary<NSString *, NSString *> *query, NSMutableDictionary<NSString *, NSString *> *headers) {
+        if ([method isEqualToString:@"POST"] && query[@"uploadId"]) {
+            headers[@"x-tos-hash-crc64ecma"] = @"1";
+        }
+    };
+    NSData *data = [TOSTestUtil randomDataWithLength:6 * 1024 * 1024];
+    TOSObjectWriter *writer = [[TOSObjectWriter alloc] initWithClient:_client input:_writerInput];
+    writer.partSize = 5 * 1024 * 1024;
+    XCTAssertTrue([writer write:data error:nil]);
+    TOSTask *task = [writer close];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(TOSClientErrorDomain, task.error.domain);
+    XCTAssertEqualObjects(@"tos: crc of uploaded object mismatch", task.error.userInfo[TOSErrorMessageTOKEN]);
+    XCTAssertNil(writer.eTag);
+    XCTAssertEqual(0, writer.hashCrc64ecma);
+}
+
+@end
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSPrewarmTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    TOSClient *_client;
+}
+
+@end
+
+@implementation TOSPrewarmTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _client = [TOSTestUtil clientWithLocalServer:_server];
+}
+
+- (void)tearDown {
+    [_client stopPrewarm];
+    [_server stop];
+    [super tearDown];
+}
+
+- (void)testAPI_prewarm {
+    TOSPrewarmInput *input = [TOSPrewarmInput new];
+    input.tosKey = @"prewarm/missing";
+    input.tosConnectionCount = 3;
+    int64_t requestsBefore = _server.requestCount;
+    TOSTask *task = [_client prewarm:input];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    // 对象不存在时的404同样完成连接建立，不计为失败
+    TOSPrewarmOutput *output = task.result;
+    XCTAssertEqual(3, output.tosRequestCount);
+    XCTAssertEqual(0, output.tosFailedCount);
+    XCTAssertEqual(3, _server.requestCount - requestsBefore);
+
+    input.tosConnectionCount = -1;
+    task = [_client prewarm:input];
+    XCTAssertEqualObjects(@"tos: invalid prewarm connection count or keep-alive interval", task.error.userInfo[TOSErrorMessageTOKEN]);
+}
+
+- (void)testAPI_prewarmRefreshAndStop {
+    TOSPrewarmInput *input = [TOSPrewarmInput new];
+    input.tosConnectionCount = 1;
+    input.tosKeepAliveInterval = 0.4;
+    [[_client prewarm:input] waitUntilFinished];
+    // 空闲期间按间隔刷新
+    int64_t requestsBefore = _server.requestCount;
+    [NSThread sleepForTimeInterval:1.0];
+    XCTAssertGreaterThanOrEqual(_server.requestCount - requestsBefore, 1);
+
+    // 停止后不再发送
+    [_client stopPrewarm];
+    [NSThread sleepForTimeInterval:0.1];
+    requestsBefore = _server.requestCount;
+    [NSThread sleepForTimeInterval:0.5];
+    XCTAssertEqual(requestsBefore, _server.requestCount);
+}
+
+- (void)testAPI_prewarmReplacesRefresh {
+    TOSPrewarmInput *input = [TOSPrewarmInput new];
+    input.tosConnectionCount = 1;
+    input.tosKeepAliveInterval = 0.4;
+    [[_client prewarm:input] waitUntilFinished];
+    // 再次调用且不刷新时取消之前的定时器
+    input.tosKeepAliveInterval = 0;
+    [[_client prewarm:input] waitUntilFinished];
+    [NSThread sleepForTimeInterval:0.1];
+    int64_t requestsBefore = _server.requestCount;
+    [NSThread sleepForTimeInterval:0.6];
+    XCTAssertEqual(requestsBefore, _server.requestCount);
+}
+
+- (void)testAPI_prewarmConcurrentRefresh {
+    // 并发调用只保留最后安装的定时器，停止后不再刷新
+    dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        TOSPrewarmInput *input = [TOSPrewarmInput new];
+        input.tosConnectionCount = 1;
+        input.tosKeepAliveInterval = 0.4;
+        [[self->_client prewarm:input] waitUntilFinished];
+    });
+    [_client stopPrewarm];
+    [NSThread sleepForTimeInterval:0.1];
+    int64_t requestsBefore = _server.requestCount;
+    [NSThread sleepForTimeInterval:0.6];
+    XCTAssertEqual(requestsBefore, _server.requestCount);
+}
+
+- (void)testAPI_prewarmStopsWithClient {
+    __weak TOSClient *weakClient = nil;
+    @autoreleasepool {
+        TOSClient *client = [TOSTestUtil clientWithLocalServer:_server];
+        weakClient = client;
+        TOSPrewarmInput *input = [TOSPrewarmInput new];
+        input.tosConnectionCount = 1;
+        input.tosKeepAliveInterval = 0.4;
+        [[client prewarm:input] waitUntilFinished];
+    }
+    // 定时器不持有Client，Client释放后不再刷新
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertNil(weakClient);
+    int64_t requestsBefore = _server.requestCount;
+    [NSThread sleepForTimeInterval:0.6];
+    XCTAssertEqual(requestsBefore, _server.requestCount);
+}
+
+@end
@@ -0,0 +1,122 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSTestUtil.h"
+
+@interface TOSSharedTransportTests : XCTestCase
+{
+    TOSLocalServer *_server;
+    NSData *_data;
+}
+
+@end
+
+@implementation TOSSharedTransportTests
+
+- (void)setUp {
+    [super setUp];
+    _server = [TOSTestUtil startLocalServer];
+    _data = [TOSTestUtil randomDataWithLength:4 * 1024];
+    [_server putObject:_data forKey:@"transport"];
+}
+
+- (void)tearDown {
+    [_server stop];
+    [super tearDown];
+}
+
+- (TOSClientConfiguration *)configurationWithTenant:(int)tenant {
+    TOSCredential *credential = [[TOSCredential alloc] initWithAccessKey:[NSString stringWithFormat:@"AKLTlocaltenant%d", tenant] secretKey:@"localsecretkeylocalsecretkey"];
+    TOSEndpoint *endpoint = [[TOSEndpoint alloc] initWithURLString:_server.endpoint withRegion:@"cn-beijing" isCustomDomain:YES];
+    return [[TOSClientConfiguration alloc] initWithEndpoint:endpoint credential:credential];
+}
+
+- (TOSTask *)getObjectWithClient:(TOSClient *)client {
+    TOSGetObjectInput *input = [TOSGetObjectInput new];
+    input.tosBucket = @"local-bucket";
+    input.tosKey = @"transport";
+    TOSTask *task = [client getObject:input];
+    [task waitUntilFinished];
+    return task;
+}
+
+- (void)testAPI_sharedTransport {
+    TOSClientConfiguration *first = [self configurationWithTenant:0];
+    TOSNetworkingTransport *transport = [[TOSNetworkingTransport alloc] initWithConfiguration:first];
+    int clientCount = 10;
+    NSMutableArray<TOSClient *> *clients = [NSMutableArray array];
+    for (int i = 0; i < clientCount; i++) {
+        TOSClientConfiguration *config = i == 0 ? first : [self configurationWithTenant:i];
+        config.transport = transport;
+        [clients addObject:[[TOSClient alloc] initWithConfiguration:config]];
+    }
+    // 依次请求时复用同一连接
+    int64_t connectionsBefore = _server.connectionCount;
+    for (TOSClient *client in clients) {
+        TOSTask *task = [self getObjectWithClient:client];
+        XCTAssertNil(task.error);
+        XCTAssertEqualObjects(_data, [task.result tosContent]);
+    }
+    XCTAssertLessThan(_server.connectionCount - connectionsBefore, 3);
+    [transport invalidate];
+}
+
+- (void)testAPI_sharedTransportOutlivesClient {
+    TOSClientConfiguration *config = [self configurationWithTenant:0];
+    TOSNetworkingTransport *transport = [[TOSNetworkingTransport alloc] initWithConfiguration:config];
+    config.transport = transport;
+    TOSClient *remaining = [[TOSClient alloc] initWithConfiguration:config];
+    @autoreleasepool {
+        TOSClientConfiguration *other = [self configurationWithTenant:1];
+        other.transport = transport;
+        TOSClient *client = [[TOSClient alloc] initWithConfiguration:other];
+        XCTAssertNil([self getObjectWithClient:client].error);
+    }
+    // 共享的传输不随某个Client释放而失效
+    XCTAssertNotNil(transport.session);
+    TOSTask *task = [self getObjectWithClient:remaining];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(_data, [task.result tosContent]);
+    [transport invalidate];
+}
+
+- (void)testAPI_sharedTransportInvalidate {
+    TOSClientConfiguration *config = [self configurationWithTenant:0];
+    TOSNetworkingTransport *transport = [[TOSNetworkingTransport alloc] initWithConfiguration:config];
+    config.transport = transport;
+    TOSClient *client = [[TOSClient alloc] initWithConfiguration:config];
+    XCTAssertNil([self getObjectWithClient:client].error);
+    [transport invalidate];
+    for (int i = 0; i < 100 && transport.session; i++) {
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    XCTAssertNil(transport.session);
+    TOSTask *task = [self getObjectWithClient:client];
+    XCTAssertEqualObjects(@"tos: networking transport is invalidated", task.error.userInfo[TOSErrorMessageTOKEN]);
+}
+
+- (void)testAPI_lazyTransport {
+    TOSClientConfiguration *config = [self configurationWithTenant:0];
+    config.lazyTransport = YES;
+    TOSClient *client = [[TOSClient alloc] initWithConfiguration:config];
+    TOSTask *task = [self getObjectWithClient:client];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(_data, [task.result tosContent]);
+}
+
+@end
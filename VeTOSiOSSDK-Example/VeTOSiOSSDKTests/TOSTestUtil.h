@@ -16,6 +16,7 @@
 
 #import <Foundation/Foundation.h>
 #import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import "TOSLocalServer.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -24,6 +25,11 @@ NS_ASSUME_NONNULL_BEGIN
 + (void)cleanBucket:(NSString *)bucket withClient:(TOSClient *)client;
 + (NSString *)randomString:(int) n;
 
+// 启动不注入错误的本地服务，供功能测试使用；bucket为local-bucket
++ (TOSLocalServer *)startLocalServer;
++ (TOSClient *)clientWithLocalServer:(TOSLocalServer *)server;
++ (NSData *)randomDataWithLength:(NSUInteger)length;
+
 @end
 
 @interface TOSProgressTestUtil : NSObject
@@ -33,4 +39,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+@interface TOSTracerTestUtil : NSObject <TOSTracer>
+
+@property (nonatomic, strong, readonly) NSArray<TOSSpan *> *finishedSpans;
+
+@end
+
 NS_ASSUME_NONNULL_END
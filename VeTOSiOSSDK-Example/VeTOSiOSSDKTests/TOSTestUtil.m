@@ -71,6 +71,28 @@
     return randomString;
 }
 
++ (TOSLocalServer *)startLocalServer {
+    TOSLocalServer *server = [TOSLocalServer new];
+    NSError *error = nil;
+    if (![server start:&error]) {
+        NSLog(@"start local server failed: %@", error);
+    }
+    return server;
+}
+
++ (TOSClient *)clientWithLocalServer:(TOSLocalServer *)server {
+    TOSCredential *credential = [[TOSCredential alloc] initWithAccessKey:@"AKLTlocalaccesskey" secretKey:@"localsecretkeylocalsecretkey"];
+    TOSEndpoint *endpoint = [[TOSEndpoint alloc] initWithURLString:server.endpoint withRegion:@"cn-beijing" isCustomDomain:YES];
+    TOSClientConfiguration *config = [[TOSClientConfiguration alloc] initWithEndpoint:endpoint credential:credential];
+    return [[TOSClient alloc] initWithConfiguration:config];
+}
+
++ (NSData *)randomDataWithLength:(NSUInteger)length {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    arc4random_buf(data.mutableBytes, length);
+    return data;
+}
+
 @end
 
 @interface TOSProgressTestUtil ()
@@ -93,3 +115,32 @@
     return self.totalBytesSent == self.totalBytesExpectedToSend;
 }
 @end
+
+@implementation TOSTracerTestUtil
+{
+    NSMutableArray<TOSSpan *> *_spans;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _spans = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)spanDidBegin:(TOSSpan *)span {
+}
+
+- (void)spanDidEnd:(TOSSpan *)span error:(NSError *)error {
+    @synchronized (self) {
+        [_spans addObject:span];
+    }
+}
+
+- (NSArray<TOSSpan *> *)finishedSpans {
+    @synchronized (self) {
+        return [_spans copy];
+    }
+}
+
+@end
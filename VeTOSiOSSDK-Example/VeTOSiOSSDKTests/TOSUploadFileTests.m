@@ -185,4 +185,66 @@
     }] waitUntilFinished];
 }
 
+- (void)testAPI_uploadFileProgress {
+    TOSUploadFileInput *uploadInput = [TOSUploadFileInput new];
+    uploadInput.tosBucket = _privateBucket;
+    uploadInput.tosKey = _fileNames[2];
+    uploadInput.tosEnableCheckpoint = NO;
+    uploadInput.tosPartSize = 5 * 1024 * 1024;
+    uploadInput.tosTaskNum = 2;
+    uploadInput.tosFilePath = [[TOSUtil documentDirectory] stringByAppendingPathComponent:_fileNames[2]];
+    
+    TOSProgressTestUtil *progressTest = [TOSProgressTestUtil new];
+    __block int64_t lastTotal = 0;
+    uploadInput.tosUploadProgress = ^(int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend) {
+        XCTAssertTrue(totalBytesSent >= lastTotal);
+        lastTotal = totalBytesSent;
+        [progressTest updateTotalBytes:totalBytesSent totalBytesExpected:totalBytesExpectedToSend];
+    };
+    
+    TOSTask *task = [_client uploadFile:uploadInput];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertTrue([progressTest completeValidateProgress]);
+    XCTAssertEqual([_fileSizes[2] longLongValue], lastTotal);
+}
+
+- (void)testAPI_uploadFileTracing {
+    TOSTracerTestUtil *tracer = [TOSTracerTestUtil new];
+    _client.clientConfiguration.tracer = tracer;
+    
+    TOSUploadFileInput *uploadInput = [TOSUploadFileInput new];
+    uploadInput.tosBucket = _privateBucket;
+    uploadInput.tosKey = _fileNames[2];
+    uploadInput.tosEnableCheckpoint = NO;
+    uploadInput.tosPartSize = 5 * 1024 * 1024;
+    uploadInput.tosTaskNum = 2;
+    uploadInput.tosFilePath = [[TOSUtil documentDirectory] stringByAppendingPathComponent:_fileNames[2]];
+    TOSTask *task = [_client uploadFile:uploadInput];
+    [task waitUntilFinished];
+    _client.clientConfiguration.tracer = nil;
+    XCTAssertNil(task.error);
+    
+    TOSSpan *uploadSpan = nil;
+    NSUInteger partCount = 0;
+    for (TOSSpan *span in tracer.finishedSpans) {
+        if ([span.name isEqualToString:@"uploadFile"]) {
+            uploadSpan = span;
+        } else if (span.operationType == TOSOperationTypeUploadPart) {
+            partCount++;
+        }
+    }
+    XCTAssertNotNil(uploadSpan);
+    XCTAssertEqual(0, uploadSpan.parentSpanID);
+    XCTAssertEqual(2, partCount);
+    for (TOSSpan *span in tracer.finishedSpans) {
+        XCTAssertEqual(uploadSpan.traceID, span.traceID);
+        if (span != uploadSpan) {
+            XCTAssertEqual(uploadSpan.spanID, span.parentSpanID);
+            XCTAssertNotNil(span.metrics);
+        }
+    }
+    // uploadFile、创建、2个分段、合并
+    XCTAssertEqual(5, tracer.finishedSpans.count);
+}
 @end
@@ -17,6 +17,7 @@
 
 #import <XCTest/XCTest.h>
 #import <VeTOSiOSSDK/VeTOSiOSSDK.h>
+#import <libkern/OSAtomic.h>
 
 @interface TOSUtilityTests : XCTestCase
 
@@ -61,4 +62,516 @@
     }
 }
 
+- (void)testFileSink {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-file-sink"];
+    NSError *error = nil;
+    TOSFileSink *sink = [[TOSFileSink alloc] initWithPath:path syncPolicy:TOSFileSyncPolicyOnClose writeBufferSize:64 * 1024 maxPendingWrites:2 error:&error];
+    XCTAssertNotNil(sink);
+    XCTAssertNil(error);
+    
+    // 预分配大于实际长度，关闭时截断
+    [sink preallocateLength:1024 * 1024];
+    NSMutableData *expected = [NSMutableData data];
+    for (int i = 0; i < 100; i++) {
+        NSMutableData *chunk = [NSMutableData dataWithLength:1000 + i * 37];
+        arc4random_buf(chunk.mutableBytes, chunk.length);
+        [expected appendData:chunk];
+        XCTAssertNil([sink appendData:chunk]);
+    }
+    XCTAssertTrue([sink closeWithError:&error]);
+    XCTAssertNil(error);
+    XCTAssertTrue([[NSData dataWithContentsOfFile:path] isEqualToData:expected]);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    
+    // 失败时丢弃，不残留预分配的文件
+    sink = [[TOSFileSink alloc] initWithPath:path syncPolicy:TOSFileSyncPolicyNone writeBufferSize:64 * 1024 maxPendingWrites:2 error:&error];
+    [sink preallocateLength:1024 * 1024];
+    XCTAssertNil([sink appendData:expected]);
+    XCTAssertEqual(expected.length, sink.length);
+    [sink discard];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:path]);
+    
+    // 设置背压回调时不阻塞写入方，达到上限时暂停、写出后恢复，关闭后暂停与恢复成对
+    sink = [[TOSFileSink alloc] initWithPath:path syncPolicy:TOSFileSyncPolicyEveryWrite writeBufferSize:64 * 1024 maxPendingWrites:1 error:&error];
+    __block int32_t pauseCount = 0;
+    __block int32_t resumeCount = 0;
+    __block BOOL paused = NO;
+    sink.backPressureHandler = ^(BOOL isPaused) {
+        XCTAssertNotEqual(paused, isPaused);
+        paused = isPaused;
+        OSAtomicIncrement32(isPaused ? &pauseCount : &resumeCount);
+    };
+    XCTAssertNil([sink appendData:expected]);
+    XCTAssertGreaterThan(pauseCount, 0);
+    XCTAssertTrue([sink closeWithError:&error]);
+    XCTAssertEqual(pauseCount, resumeCount);
+    XCTAssertFalse(paused);
+    XCTAssertTrue([[NSData dataWithContentsOfFile:path] isEqualToData:expected]);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+    
+    sink = [[TOSFileSink alloc] initWithPath:@"/not-exist-dir/tos-file-sink" syncPolicy:TOSFileSyncPolicyNone error:&error];
+    XCTAssertNil(sink);
+    XCTAssertNotNil(error);
+}
+
+// 以每次写入都fsync模拟慢速存储，对比同步NSFileHandle写入时回调线程上的耗时
+- (void)testPerformanceFileSinkThrottledIO {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-file-sink-perf"];
+    NSMutableData *chunk = [NSMutableData dataWithLength:16 * 1024];
+    arc4random_buf(chunk.mutableBytes, chunk.length);
+    int chunkCount = 2048;
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    [[NSFileManager defaultManager] createFileAtPath:path contents:nil attributes:nil];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:path];
+    for (int i = 0; i < chunkCount; i++) {
+        [fileHandle writeData:chunk];
+        [fileHandle synchronizeFile];
+    }
+    [fileHandle closeFile];
+    NSLog(@"NSFileHandle callback time: %.3fs", CFAbsoluteTimeGetCurrent() - start);
+    
+    [self measureBlock:^{
+        TOSFileSink *sink = [[TOSFileSink alloc] initWithPath:path syncPolicy:TOSFileSyncPolicyEveryWrite error:nil];
+        [sink preallocateLength:(uint64_t)chunk.length * chunkCount];
+        CFAbsoluteTime appendStart = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < chunkCount; i++) {
+            [sink appendData:chunk];
+        }
+        NSLog(@"TOSFileSink callback time: %.3fs", CFAbsoluteTimeGetCurrent() - appendStart);
+        XCTAssertTrue([sink closeWithError:nil]);
+    }];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+// 单个数据分片回调的开销：代理查找 + 用户回调
+- (void)testPerformanceDidReceiveDataCallback {
+    TOSNetworkingConfiguration *config = [TOSNetworkingConfiguration new];
+    TOSNetworking *networking = [[TOSNetworking alloc] initWithConfiguration:config];
+    NSURLSessionDataTask *dataTask = [networking.session dataTaskWithURL:[NSURL URLWithString:@"https://tos-cn-beijing.volces.com"]];
+    TOSNetworkingRequestDelegate *delegate = [TOSNetworkingRequestDelegate new];
+    __block NSUInteger received = 0;
+    delegate.onRecieveData = ^(NSData * _Nonnull data) {
+        received += data.length;
+    };
+    [networking setRequestDelegate:delegate forTask:dataTask];
+    XCTAssertEqual(delegate, [networking requestDelegateForTask:dataTask]);
+    
+    NSData *chunk = [NSMutableData dataWithLength:16 * 1024];
+    int callbackCount = 100000;
+    [self measureBlock:^{
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < callbackCount; i++) {
+            [networking URLSession:networking.session dataTask:dataTask didReceiveData:chunk];
+        }
+        NSLog(@"didReceiveData: %.1fns per chunk", (CFAbsoluteTimeGetCurrent() - start) * 1e9 / callbackCount);
+    }];
+    XCTAssertTrue(received > 0);
+    
+    [networking removeRequestDelegateForTask:dataTask];
+    XCTAssertNil([networking requestDelegateForTask:dataTask]);
+}
+
+- (void)testProgressAggregator {
+    __block int64_t reported = 0;
+    __block int callbackCount = 0;
+    TOSProgressAggregator *progress = [[TOSProgressAggregator alloc] initWithBlock:^(int64_t bytes, int64_t totalBytes, int64_t totalBytesExpected) {
+        reported += bytes;
+        callbackCount++;
+        XCTAssertEqual(reported, totalBytes);
+    } minimumInterval:3600 minimumBytes:1024 * 1024 executor:nil];
+    progress.totalBytesExpected = 64 * 1024 * 1024;
+    
+    // 64个线程并发累加，按1MiB粒度合并回调
+    dispatch_apply(64, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^(size_t i) {
+        for (int j = 0; j < 64; j++) {
+            [progress addBytes:16 * 1024];
+        }
+    });
+    [progress flush];
+    XCTAssertEqual(64 * 1024 * 1024, progress.totalBytes);
+    XCTAssertEqual(64 * 1024 * 1024, reported);
+    XCTAssertTrue(callbackCount <= 66);
+    
+    // 只设置字节粒度时不按时间触发回调
+    reported = 0;
+    callbackCount = 0;
+    progress = [[TOSProgressAggregator alloc] initWithBlock:^(int64_t bytes, int64_t totalBytes, int64_t totalBytesExpected) {
+        reported += bytes;
+        callbackCount++;
+    } minimumInterval:0 minimumBytes:64 * 1024 executor:nil];
+    for (int i = 0; i < 64; i++) {
+        [progress addBytes:16 * 1024];
+    }
+    XCTAssertEqual(16, callbackCount);
+    XCTAssertEqual(1024 * 1024, reported);
+    
+    // 两个阈值均为0时每次更新都回调
+    callbackCount = 0;
+    progress = [[TOSProgressAggregator alloc] initWithBlock:^(int64_t bytes, int64_t totalBytes, int64_t totalBytesExpected) {
+        callbackCount++;
+    } minimumInterval:0 minimumBytes:0 executor:nil];
+    for (int i = 0; i < 10; i++) {
+        [progress addBytes:1];
+    }
+    XCTAssertEqual(10, callbackCount);
+}
+
+- (void)testOperationStatistics {
+    TOSOperationStatistics *statistics = [TOSOperationStatistics new];
+    for (int i = 1; i <= 1000; i++) {
+        [statistics recordOperationType:TOSOperationTypeGetObject latency:i / 1000.0 bytesSent:0 bytesReceived:1024 statusCode:200 failed:NO retryCount:0];
+    }
+    [statistics recordOperationType:TOSOperationTypePutObject latency:0.01 bytesSent:100 bytesReceived:0 statusCode:503 failed:YES retryCount:2];
+    [statistics recordOperationType:TOSOperationTypePutObject latency:0.01 bytesSent:100 bytesReceived:0 statusCode:0 failed:YES retryCount:0];
+    
+    NSDictionary<NSNumber *, TOSOperationStatisticsSnapshot *> *snapshots = [statistics snapshotAndReset:YES];
+    XCTAssertEqual(2, snapshots.count);
+    TOSOperationStatisticsSnapshot *get = snapshots[@(TOSOperationTypeGetObject)];
+    XCTAssertEqual(1000, get.requestCount);
+    XCTAssertEqual(1024 * 1000, get.bytesReceived);
+    XCTAssertEqualWithAccuracy(0.5, get.p50, 0.5 * 0.07);
+    XCTAssertEqualWithAccuracy(0.99, get.p99, 0.99 * 0.07);
+    XCTAssertEqualWithAccuracy(0.999, get.p999, 0.999 * 0.07);
+    XCTAssertEqualWithAccuracy(1.0, get.maxLatency, 0.001);
+    
+    TOSOperationStatisticsSnapshot *put = snapshots[@(TOSOperationTypePutObject)];
+    XCTAssertEqual(2, put.errorCount);
+    XCTAssertEqual(2, put.retryCount);
+    XCTAssertEqual(200, put.bytesSent);
+    XCTAssertEqualObjects(@1, put.errorCountByStatusCode[@503]);
+    XCTAssertEqualObjects(@1, put.errorCountByStatusCode[@0]);
+    
+    XCTAssertEqual(0, [statistics snapshotAndReset:NO].count);
+}
+
+// 单次记录开销需小于1微秒
+- (void)testPerformanceOperationStatisticsRecord {
+    TOSOperationStatistics *statistics = [TOSOperationStatistics new];
+    int recordCount = 1000000;
+    [self measureBlock:^{
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (int i = 0; i < recordCount; i++) {
+            [statistics recordOperationType:TOSOperationTypeGetObject latency:(i % 1000) / 1000.0 bytesSent:0 bytesReceived:4096 statusCode:200 failed:NO retryCount:0];
+        }
+        double perRecord = (CFAbsoluteTimeGetCurrent() - start) * 1e9 / recordCount;
+        NSLog(@"operation statistics record: %.1fns", perRecord);
+        XCTAssertLessThan(perRecord, 1000);
+    }];
+}
+
+- (void)testInputCancellationReset {
+    TOSHeadObjectInput *input = [TOSHeadObjectInput new];
+    TOSCancellationToken *token = input.tosCancellationToken;
+    [input cancel];
+    XCTAssertTrue(token.isCancellationRequested);
+    XCTAssertTrue(input.tosCancellationToken.isCancellationRequested);
+    
+    // 置回NO后重新使用，新请求不再被旧令牌取消
+    input.isCancelled = NO;
+    XCTAssertFalse(input.tosCancellationToken.isCancellationRequested);
+    XCTAssertNotEqual(token, input.tosCancellationToken);
+    input.isCancelled = YES;
+    XCTAssertTrue(input.tosCancellationToken.isCancellationRequested);
+}
+
+- (void)testParallelMap {
+    NSMutableArray<NSNumber *> *numbers = [NSMutableArray array];
+    for (int i = 0; i < 100; i++) {
+        [numbers addObject:@(i)];
+    }
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0);
+    
+    // 有序结果，并发数不超过上限
+    __block int32_t running = 0;
+    __block int32_t maxRunning = 0;
+    NSObject *lock = [NSObject new];
+    TOSTask *task = [TOSTask taskForParallelMapOfEnumerator:numbers.objectEnumerator maxConcurrency:4 options:TOSTaskMapOptionsNone cancellationToken:nil block:^TOSTask * _Nullable(NSNumber *number, NSUInteger index) {
+        XCTAssertEqual(number.unsignedIntegerValue, index);
+        @synchronized (lock) {
+            running++;
+            maxRunning = MAX(maxRunning, running);
+        }
+        TOSTaskCompletionSource *source = [TOSTaskCompletionSource taskCompletionSource];
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)((index % 3) * NSEC_PER_MSEC)), queue, ^{
+            @synchronized (lock) {
+                running--;
+            }
+            source.result = @(number.intValue * 2);
+        });
+        return source.task;
+    }];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(100, [task.result count]);
+    for (int i = 0; i < 100; i++) {
+        XCTAssertEqualObjects(@(i * 2), task.result[i]);
+    }
+    XCTAssertTrue(maxRunning <= 4);
+    
+    // 同步完成的任务和nil结果
+    task = [TOSTask taskForParallelMapOfEnumerator:numbers.objectEnumerator maxConcurrency:0 options:TOSTaskMapOptionsUnordered cancellationToken:nil block:^TOSTask * _Nullable(NSNumber *number, NSUInteger index) {
+        return number.intValue % 2 ? nil : [TOSTask taskWithResult:number];
+    }];
+    XCTAssertTrue(task.completed);
+    XCTAssertEqual(100, [task.result count]);
+    XCTAssertEqual(50, [task.result indexesOfObjectsPassingTest:^BOOL(id obj, NSUInteger idx, BOOL *stop) {
+        return obj == [NSNull null];
+    }].count);
+    
+    // 快速失败：首个错误后不再发起新任务
+    __block int started = 0;
+    task = [TOSTask taskForParallelMapOfEnumerator:numbers.objectEnumerator maxConcurrency:2 options:TOSTaskMapOptionsNone cancellationToken:nil block:^TOSTask * _Nullable(NSNumber *number, NSUInteger index) {
+        started++;
+        if (index == 10) {
+            return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:index userInfo:nil]];
+        }
+        return [TOSTask taskWithResult:number];
+    }];
+    XCTAssertEqual(10, task.error.code);
+    XCTAssertEqual(11, started);
+    
+    // 收集所有错误
+    task = [TOSTask taskForParallelMapOfEnumerator:numbers.objectEnumerator maxConcurrency:8 options:TOSTaskMapOptionsCollectErrors cancellationToken:nil block:^TOSTask * _Nullable(NSNumber *number, NSUInteger index) {
+        if (index % 10 == 0) {
+            return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:index userInfo:nil]];
+        }
+        return [TOSTask taskWithResult:number];
+    }];
+    XCTAssertEqualObjects(TOSTaskErrorDomain, task.error.domain);
+    XCTAssertEqual(kTOSMultipleErrorsError, task.error.code);
+    XCTAssertEqual(10, [task.error.userInfo[TOSTaskMultipleErrorsUserInfoKey] count]);
+    
+    // 取消后立即结束，不再发起新任务
+    TOSCancellationTokenSource *cancellation = [TOSCancellationTokenSource cancellationTokenSource];
+    __block int32_t launched = 0;
+    task = [TOSTask taskForParallelMapOfEnumerator:numbers.objectEnumerator maxConcurrency:2 options:TOSTaskMapOptionsNone cancellationToken:cancellation.token block:^TOSTask * _Nullable(NSNumber *number, NSUInteger index) {
+        OSAtomicIncrement32(&launched);
+        return [TOSTask taskWithDelay:1000];
+    }];
+    XCTAssertFalse(task.completed);
+    [cancellation cancel];
+    XCTAssertTrue(task.cancelled);
+    XCTAssertEqual(2, launched);
+}
+
+- (void)testObjectMetadataCache {
+    TOSObjectMetadataCache *cache = [[TOSObjectMetadataCache alloc] initWithMaxEntryCount:2 maxBytes:1024 * 1024 ttl:3600];
+    BOOL expired = NO;
+    XCTAssertNil([cache outputForBucket:@"bucket" key:@"a" versionID:nil expired:&expired]);
+    
+    TOSHeadObjectOutput *a = [TOSHeadObjectOutput new];
+    a.tosETag = @"\"a\"";
+    a.tosRequestID = @"request-a";
+    a.tosMeta = @{@"key": @"value"};
+    TOSHeadObjectOutput *b = [TOSHeadObjectOutput new];
+    b.tosETag = @"\"b\"";
+    TOSHeadObjectOutput *c = [TOSHeadObjectOutput new];
+    c.tosETag = @"\"c\"";
+    [cache setOutput:a forBucket:@"bucket" key:@"a" versionID:nil generation:cache.generation];
+    [cache setOutput:b forBucket:@"bucket" key:@"b" versionID:nil generation:cache.generation];
+    TOSHeadObjectOutput *hit = [cache outputForBucket:@"bucket" key:@"a" versionID:nil expired:&expired];
+    XCTAssertFalse(expired);
+    XCTAssertEqualObjects(a.tosETag, hit.tosETag);
+    XCTAssertEqualObjects(a.tosMeta, hit.tosMeta);
+    XCTAssertNil(hit.tosRequestID);
+    // 每次命中返回独立的副本，修改不影响缓存
+    XCTAssertNotEqual(a, hit);
+    hit.tosETag = @"\"modified\"";
+    hit.tosMeta = @{};
+    a.tosETag = @"\"modified\"";
+    hit = [cache outputForBucket:@"bucket" key:@"a" versionID:nil expired:&expired];
+    XCTAssertEqualObjects(@"\"a\"", hit.tosETag);
+    XCTAssertEqualObjects(@"value", hit.tosMeta[@"key"]);
+    a.tosETag = @"\"a\"";
+    // a最近被访问，淘汰b
+    [cache setOutput:c forBucket:@"bucket" key:@"c" versionID:nil generation:cache.generation];
+    XCTAssertEqual(2, cache.count);
+    XCTAssertEqual(1, cache.evictionCount);
+    XCTAssertNil([cache outputForBucket:@"bucket" key:@"b" versionID:nil expired:&expired]);
+    XCTAssertEqualObjects(c.tosETag, [cache outputForBucket:@"bucket" key:@"c" versionID:nil expired:&expired].tosETag);
+    
+    // 失效前发起的HEAD结果被丢弃
+    int64_t generation = cache.generation;
+    [cache invalidateBucket:@"bucket" key:@"a"];
+    [cache setOutput:a forBucket:@"bucket" key:@"a" versionID:nil generation:generation];
+    XCTAssertNil([cache outputForBucket:@"bucket" key:@"a" versionID:nil expired:&expired]);
+    XCTAssertEqual(3, cache.hitCount);
+    XCTAssertEqual(3, cache.missCount);
+    
+    // 按字节数淘汰
+    TOSObjectMetadataCache *small = [[TOSObjectMetadataCache alloc] initWithMaxEntryCount:100 maxBytes:600 ttl:3600];
+    [small setOutput:a forBucket:@"bucket" key:@"a" versionID:nil generation:0];
+    [small setOutput:b forBucket:@"bucket" key:@"b" versionID:nil generation:0];
+    [small setOutput:c forBucket:@"bucket" key:@"c" versionID:nil generation:0];
+    XCTAssertEqual(2, small.count);
+    XCTAssertTrue(small.totalBytes <= 600);
+    
+    // 过期条目在重新校验模式下返回并标记expired
+    TOSObjectMetadataCache *revalidating = [[TOSObjectMetadataCache alloc] initWithMaxEntryCount:10 maxBytes:1024 * 1024 ttl:0];
+    revalidating.revalidatesExpiredEntries = YES;
+    [revalidating setOutput:a forBucket:@"bucket" key:@"a" versionID:@"v1" generation:0];
+    XCTAssertNil([revalidating outputForBucket:@"bucket" key:@"a" versionID:nil expired:&expired]);
+    XCTAssertEqualObjects(a.tosETag, [revalidating outputForBucket:@"bucket" key:@"a" versionID:@"v1" expired:&expired].tosETag);
+    XCTAssertTrue(expired);
+    XCTAssertEqual(1, revalidating.revalidationCount);
+    [revalidating invalidateBucket:@"bucket" key:@"a"];
+    XCTAssertEqual(0, revalidating.count);
+}
+
+- (TOSGetObjectOutput *)diskCacheOutputWithData:(NSData *)data eTag:(NSString *)eTag contentRange:(NSString *)contentRange {
+    TOSGetObjectOutput *output = [TOSGetObjectOutput new];
+    output.tosETag = eTag;
+    output.tosContent = data;
+    output.tosContentLength = (int64_t)data.length;
+    output.tosContentRange = contentRange;
+    output.tosContentType = @"text/plain";
+    if (!contentRange) {
+        output.tosHashCrc64ecma = [TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length];
+    }
+    return output;
+}
+
+- (void)testObjectDiskCache {
+    NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-disk-cache"];
+    [[NSFileManager defaultManager] removeItemAtPath:directory error:nil];
+    // 分段4字节，每个分段文件另有8字节CRC64，预算可容纳3个完整分段
+    TOSObjectDiskCache *cache = [[TOSObjectDiskCache alloc] initWithDirectory:directory maxBytes:36 segmentSize:4];
+    NSData *data = [@"0123456789" dataUsingEncoding:NSUTF8StringEncoding];
+    BOOL fresh = NO;
+    XCTAssertNil([cache outputForBucket:@"bucket" key:@"a" versionID:nil rangeStart:0 rangeEnd:0 ranged:NO fresh:&fresh]);
+
+    // CRC64与服务端不一致的完整对象不写入
+    TOSGetObjectOutput *corrupted = [self diskCacheOutputWithData:data eTag:@"\"a\"" contentRange:nil];
+    corrupted.tosHashCrc64ecma += 1;
+    [cache storeOutput:corrupted offset:0 forBucket:@"bucket" key:@"a" versionID:nil generation:cache.generation];
+    XCTAssertEqual(0, cache.totalBytes);
+
+    [cache storeOutput:[self diskCacheOutputWithData:data eTag:@"\"a\"" contentRange:nil] offset:0 forBucket:@"bucket" key:@"a" versionID:nil generation:cache.generation];
+    XCTAssertEqual(34, cache.totalBytes);
+    TOSGetObjectOutput *output = [cache outputForBucket:@"bucket" key:@"a" versionID:nil rangeStart:2 rangeEnd:5 ranged:YES fresh:&fresh];
+    XCTAssertEqualObjects(@"2345", [[NSString alloc] initWithData:output.tosContent encoding:NSUTF8StringEncoding]);
+    XCTAssertEqualObjects(@"bytes 2-5/10", output.tosContentRange);
+    XCTAssertEqualObjects(@"\"a\"", output.tosETag);
+    XCTAssertEqualObjects(@"text/plain", output.tosContentType);
+    XCTAssertEqual(206, output.tosStatusCode);
+    XCTAssertFalse(fresh);
+    output = [cache outputForBucket:@"bucket" key:@"a" versionID:nil rangeStart:0 rangeEnd:0 ranged:NO fresh:&fresh];
+    XCTAssertEqualObjects(data, output.tosContent);
+    XCTAssertEqual(200, output.tosStatusCode);
+
+    // 区间数据只保存完整覆盖的分段，超出预算时淘汰最久未访问的a的第0段
+    NSData *part = [@"wxyz" dataUsingEncoding:NSUTF8StringEncoding];
+    [cache storeOutput:[self diskCacheOutputWithData:part eTag:@"\"b\"" contentRange:@"bytes 4-7/20"] offset:4 forBucket:@"bucket" key:@"b" versionID:nil generation:cache.generation];
+    XCTAssertEqual(1, cache.evictionCount);
+    XCTAssertEqual(34, cache.totalBytes);
+    XCTAssertNil([cache outputForBucket:@"bucket" key:@"a" versionID:nil rangeStart:0 rangeEnd:3 ranged:YES fresh:&fresh]);
+    XCTAssertNil([cache outputForBucket:@"bucket" key:@"b" versionID:nil rangeStart:0 rangeEnd:3 ranged:YES fresh:&fresh]);
+    XCTAssertEqualObjects(part, [cache outputForBucket:@"bucket" key:@"b" versionID:nil rangeStart:4 rangeEnd:7 ranged:YES fresh:&fresh].tosContent);
+    XCTAssertEqual(3, cache.hitCount);
+    XCTAssertEqual(3, cache.missCount);
+
+    // 重新打开目录后索引恢复
+    TOSObjectDiskCache *reopened = [[TOSObjectDiskCache alloc] initWithDirectory:directory maxBytes:36 segmentSize:4];
+    XCTAssertEqual(34, reopened.totalBytes);
+    output = [reopened outputForBucket:@"bucket" key:@"a" versionID:nil rangeStart:4 rangeEnd:100 ranged:YES fresh:&fresh];
+    XCTAssertEqualObjects(@"456789", [[NSString alloc] initWithData:output.tosContent encoding:NSUTF8StringEncoding]);
+    XCTAssertEqualObjects(@"bytes 4-9/10", output.tosContentRange);
+
+    // 篡改分段内容后校验失败，按未命中处理并删除该分段
+    NSString *segmentPath = nil;
+    for (NSString *path in [[NSFileManager defaultManager] subpathsOfDirectoryAtPath:directory error:nil]) {
+        if ([path hasSuffix:@".seg"] && [[NSData dataWithContentsOfFile:[directory stringByAppendingPathComponent:path]] rangeOfData:part options:0 range:NSMakeRange(0, 4)].location == 0) {
+            segmentPath = [directory stringByAppendingPathComponent:path];
+        }
+    }
+    XCTAssertNotNil(segmentPath);
+    NSMutableData *tampered = [NSMutableData dataWithContentsOfFile:segmentPath];
+    ((uint8_t *)tampered.mutableBytes)[0] ^= 0xff;
+    [tampered writeToFile:segmentPath atomically:YES];
+    XCTAssertNil([reopened outputForBucket:@"bucket" key:@"b" versionID:nil rangeStart:4 rangeEnd:7 ranged:YES fresh:&fresh]);
+    XCTAssertEqual(1, reopened.corruptionCount);
+    XCTAssertEqual(22, reopened.totalBytes);
+
+    // 新ETag替换旧内容；失效前发起的下载结果被丢弃
+    [reopened storeOutput:[self diskCacheOutputWithData:part eTag:@"\"a2\"" contentRange:@"bytes 0-3/4"] offset:0 forBucket:@"bucket" key:@"a" versionID:nil generation:reopened.generation];
+    XCTAssertEqual(12, reopened.totalBytes);
+    reopened.revalidationInterval = 3600;
+    output = [reopened outputForBucket:@"bucket" key:@"a" versionID:nil rangeStart:0 rangeEnd:0 ranged:NO fresh:&fresh];
+    XCTAssertEqualObjects(@"\"a2\"", output.tosETag);
+    XCTAssertTrue(fresh);
+    int64_t generation = reopened.generation;
+    [reopened invalidateBucket:@"bucket" key:@"a"];
+    [reopened storeOutput:[self diskCacheOutputWithData:data eTag:@"\"a\"" contentRange:nil] offset:0 forBucket:@"bucket" key:@"a" versionID:nil generation:generation];
+    XCTAssertEqual(0, reopened.totalBytes);
+
+    // 从文件逐段写入，读取时按分段回调而不拼接
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"tos-disk-cache-file"];
+    [data writeToFile:filePath atomically:YES];
+    [reopened storeFileAtPath:filePath output:[self diskCacheOutputWithData:data eTag:@"\"c\"" contentRange:nil] offset:0 forBucket:@"bucket" key:@"c" versionID:nil generation:reopened.generation];
+    XCTAssertEqual(34, reopened.totalBytes);
+    NSMutableArray<NSString *> *chunks = [NSMutableArray array];
+    output = [reopened outputForBucket:@"bucket" key:@"c" versionID:nil rangeStart:1 rangeEnd:9 ranged:YES fresh:&fresh usingBlock:^BOOL(NSData *chunk) {
+        [chunks addObject:[[NSString alloc] initWithData:chunk encoding:NSUTF8StringEncoding]];
+        return YES;
+    }];
+    XCTAssertEqualObjects((@[@"123", @"4567", @"89"]), chunks);
+    XCTAssertNil(output.tosContent);
+    XCTAssertEqual(9, output.tosContentLength);
+    XCTAssertNil([reopened outputForBucket:@"bucket" key:@"c" versionID:nil rangeStart:0 rangeEnd:0 ranged:NO fresh:&fresh usingBlock:^BOOL(NSData *chunk) {
+        return NO;
+    }]);
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+
+    // 超过maxStoreBytes的数据不写入
+    [reopened invalidateBucket:@"bucket" key:@"c"];
+    reopened.maxStoreBytes = 8;
+    [reopened storeOutput:[self diskCacheOutputWithData:data eTag:@"\"c\"" contentRange:nil] offset:0 forBucket:@"bucket" key:@"c" versionID:nil generation:reopened.generation];
+    XCTAssertEqual(0, reopened.totalBytes);
+    [reopened removeAllObjects];
+    XCTAssertEqual(0, [[NSFileManager defaultManager] contentsOfDirectoryAtPath:directory error:nil].count);
+}
+
+- (void)testBufferPool {
+    TOSBufferPool *pool = [[TOSBufferPool alloc] init];
+    // 33MiB按级别取整为36MiB，而非64MiB
+    NSUInteger capacity = 0;
+    void *buffer = [pool acquireBufferWithCapacity:33 * 1024 * 1024 actualCapacity:&capacity];
+    XCTAssertEqual(36 * 1024 * 1024, capacity);
+    [pool recycleBuffer:buffer capacity:capacity];
+    buffer = [pool acquireBufferWithCapacity:35 * 1024 * 1024 actualCapacity:&capacity];
+    XCTAssertEqual(36 * 1024 * 1024, capacity);
+    XCTAssertEqual(1, pool.reuseCount);
+    
+    // 各级别取整浪费不超过1/8
+    for (NSUInteger request = TOSBufferPoolMinimumCapacity; request <= 64 * 1024 * 1024; request = request * 9 / 8 + 1) {
+        NSUInteger actual = 0;
+        void *b = [pool acquireBufferWithCapacity:request actualCapacity:&actual];
+        XCTAssertGreaterThanOrEqual(actual, request);
+        XCTAssertLessThanOrEqual(actual - request, request / 8);
+        [pool recycleBuffer:b capacity:actual];
+    }
+    
+    // 长度接近容量时不拷贝，NSData释放后缓冲区归还
+    [pool drain];
+    int64_t reuseCount = pool.reuseCount;
+    @autoreleasepool {
+        NSData *data = [pool dataWithBuffer:buffer length:capacity - 1024 capacity:capacity];
+        XCTAssertEqual(buffer, data.bytes);
+    }
+    buffer = [pool acquireBufferWithCapacity:capacity actualCapacity:&capacity];
+    XCTAssertEqual(reuseCount + 1, pool.reuseCount);
+    
+    // 长度远小于容量时拷贝为精确大小，缓冲区立即归还
+    memset(buffer, 'b', 1024);
+    NSData *data = [pool dataWithBuffer:buffer length:1024 capacity:capacity];
+    XCTAssertNotEqual(buffer, data.bytes);
+    XCTAssertEqual(1024, data.length);
+    XCTAssertEqual('b', ((const char *)data.bytes)[1023]);
+    buffer = [pool acquireBufferWithCapacity:capacity actualCapacity:&capacity];
+    XCTAssertEqual(reuseCount + 2, pool.reuseCount);
+    [pool recycleBuffer:buffer capacity:capacity];
+    [pool drain];
+}
+
 @end
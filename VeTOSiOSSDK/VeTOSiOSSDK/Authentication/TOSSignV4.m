@@ -31,10 +31,13 @@
 }
 
 - (TOSTask *_Nullable)interceptRequest: (NSMutableURLRequest * _Nonnull)request {
-    return [[TOSTask taskWithResult:nil] continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull t) {
-        [self signTOSRequestV4:request];
-        return nil;
-    }];
+    [self signTOSRequestV4:request];
+    return [TOSTask taskWithResult:nil];
+}
+
+- (BOOL)interceptRequest:(NSMutableURLRequest *)request error:(NSError **)error {
+    [self signTOSRequestV4:request];
+    return YES;
 }
 
 + (NSString *)getCanonicalizedRequest:(NSString *)method path:(NSString *)path query:(NSString *)query headers:(NSDictionary *)headers contentSha256:(NSString *)contentSha256 {
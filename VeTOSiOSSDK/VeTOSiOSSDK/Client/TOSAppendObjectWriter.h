@@ -0,0 +1,85 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSClient.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ 追加写缓冲写入器：在appendObject之上合并小块写入。
+ 缓冲达到bufferSize或最早的数据等待超过flushInterval时发起追加，单次追加至多bufferSize字节；同一时刻只有一个追加请求在途，
+ 请求返回tosNextAppendOffset后立即发送期间积累的数据。缓冲超过maxBufferedBytes时write阻塞调用线程，请勿在主线程调用。
+ 本地按CRC64链式计算已写入数据的校验值，与服务端返回的x-tos-hash-crc64ecma比对。
+ 任一追加失败后写入器进入失败状态，后续write、flush、close均返回该错误。
+ */
+@interface TOSAppendObjectWriter : NSObject
+
+@property (nonatomic, copy, readonly) NSString *bucket;
+@property (nonatomic, copy, readonly) NSString *key;
+
+/**
+ 缓冲达到该字节数时发起追加，同时是单次追加请求的上限，默认为1MB
+ */
+@property (nonatomic, assign) NSUInteger bufferSize;
+
+/**
+ 在途追加期间允许积累的缓冲上限，默认为4MB，小于bufferSize时按bufferSize计；超出时write等待在途追加完成
+ */
+@property (nonatomic, assign) NSUInteger maxBufferedBytes;
+
+/**
+ 数据在缓冲中的最长等待时间，默认为1秒，为0时仅按bufferSize及flush发起追加
+ */
+@property (nonatomic, assign) NSTimeInterval flushInterval;
+
+/**
+ 服务端已确认的下一次追加位置及对应的CRC64；续写已有对象但未提供tosPreHashCrc64ecma时不校验CRC，hashCrc64ecma保持为0
+ */
+@property (atomic, assign, readonly) int64_t nextAppendOffset;
+@property (atomic, assign, readonly) uint64_t hashCrc64ecma;
+
+/**
+ 已发起的追加请求数
+ */
+@property (atomic, assign, readonly) int64_t appendCount;
+
+/**
+ input为模板：tosBucket、tosKey为必填，tosOffset和tosPreHashCrc64ecma为续写已有对象时的起始位置和CRC64；
+ 元数据等其余字段仅在从0开始创建对象的首次追加中携带，tosContent被忽略
+ */
+- (instancetype)initWithClient:(TOSClient *)client input:(TOSAppendObjectInput *)input NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ 写入缓冲，缓冲未超过maxBufferedBytes时不等待网络；写入器已关闭或已失败时返回NO
+ */
+- (BOOL)write:(NSData *)data error:(NSError **)error;
+
+/**
+ 立即追加缓冲中的数据，返回的Task在此前写入的数据全部被服务端确认后完成
+ */
+- (TOSTask *)flush;
+
+/**
+ flush后关闭写入器，之后的write返回错误
+ */
+- (TOSTask *)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,323 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSAppendObjectWriter.h"
+#import <VeTOSiOSSDK/TOSUtil.h>
+#import <VeTOSiOSSDK/TOSTaskCompletionSource.h>
+#import <VeTOSiOSSDK/TOSExecutor.h>
+
+static const NSUInteger TOSAppendWriterDefaultBufferSize = 1024 * 1024;
+static const NSUInteger TOSAppendWriterDefaultMaxBufferedBytes = 4 * 1024 * 1024;
+
+// flush等待的数据末尾位置
+@interface TOSAppendFlushWaiter : NSObject
+@property (nonatomic, assign) int64_t offset;
+@property (nonatomic, strong) TOSTaskCompletionSource *source;
+@end
+
+@implementation TOSAppendFlushWaiter
+@end
+
+@implementation TOSAppendObjectWriter
+{
+    TOSClient *_client;
+    TOSAppendObjectInput *_template;
+    NSMutableData *_pendingData;
+    NSUInteger _pendingOffset; // _pendingData中已取出发送的前缀
+    CFAbsoluteTime _pendingSince;
+    int64_t _acceptedOffset; // 已写入缓冲的数据末尾
+    int64_t _nextAppendOffset;
+    uint64_t _hashCrc64ecma;
+    int64_t _appendCount;
+    BOOL _verifyCRC; // 续写已有对象但未提供起始CRC时无法校验
+    BOOL _inflight;
+    BOOL _timerScheduled;
+    BOOL _closed;
+    NSError *_error;
+    NSMutableArray<TOSAppendFlushWaiter *> *_waiters;
+    dispatch_semaphore_t _drainSemaphore; // 追加完成时唤醒因缓冲超限阻塞的write
+    NSInteger _blockedWriters;
+    TOSExecutor *_executor; // 追加完成的处理及下一次追加的CRC计算、发起，不占用会话回调队列
+}
+
+- (instancetype)initWithClient:(TOSClient *)client input:(TOSAppendObjectInput *)input {
+    if (self = [super init]) {
+        _client = client;
+        _template = input;
+        _bucket = [input.tosBucket copy];
+        _key = [input.tosKey copy];
+        _bufferSize = TOSAppendWriterDefaultBufferSize;
+        _flushInterval = 1;
+        _maxBufferedBytes = TOSAppendWriterDefaultMaxBufferedBytes;
+        _pendingData = [NSMutableData data];
+        _acceptedOffset = input.tosOffset;
+        _nextAppendOffset = input.tosOffset;
+        _hashCrc64ecma = input.tosPreHashCrc64ecma;
+        _verifyCRC = input.tosOffset == 0 || input.tosPreHashCrc64ecma != 0;
+        _waiters = [NSMutableArray array];
+        _drainSemaphore = dispatch_semaphore_create(0);
+        _executor = [TOSExecutor executorWithDispatchQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+    }
+    return self;
+}
+
+- (int64_t)nextAppendOffset {
+    @synchronized (self) {
+        return _nextAppendOffset;
+    }
+}
+
+- (uint64_t)hashCrc64ecma {
+    @synchronized (self) {
+        return _hashCrc64ecma;
+    }
+}
+
+- (int64_t)appendCount {
+    @synchronized (self) {
+        return _appendCount;
+    }
+}
+
+- (BOOL)write:(NSData *)data error:(NSError **)error {
+    if (data.length == 0) {
+        return YES;
+    }
+    NSError *writeError = nil;
+    NSData *next = nil;
+    int64_t nextOffset = 0;
+    while (YES) {
+        BOOL blocked = NO;
+        @synchronized (self) {
+            NSUInteger pendingLength = [self pendingLengthLocked];
+            if (_error) {
+                writeError = _error;
+            } else if (_closed) {
+                writeError = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: append writer is closed"}];
+            } else if (_inflight && pendingLength > 0 && pendingLength + data.length > MAX(_maxBufferedBytes, _bufferSize)) {
+                // 缓冲超过上限，等待在途追加完成
+                _blockedWriters++;
+                blocked = YES;
+            } else {
+                if (pendingLength == 0) {
+                    _pendingSince = CFAbsoluteTimeGetCurrent();
+                }
+                [_pendingData appendData:data];
+                _acceptedOffset += data.length;
+                next = [self nextAppendLocked:&nextOffset];
+            }
+        }
+        if (!blocked) {
+            break;
+        }
+        dispatch_semaphore_wait(_drainSemaphore, DISPATCH_TIME_FOREVER);
+    }
+    if (writeError) {
+        if (error) {
+            *error = writeError;
+        }
+        return NO;
+    }
+    if (next) {
+        [self appendData:next offset:nextOffset];
+    }
+    return YES;
+}
+
+- (TOSTask *)flush {
+    TOSAppendFlushWaiter *waiter = nil;
+    NSData *next = nil;
+    int64_t nextOffset = 0;
+    @synchronized (self) {
+        if (_error) {
+            return [TOSTask taskWithError:_error];
+        }
+        if (_acceptedOffset == _nextAppendOffset) {
+            return [TOSTask taskWithResult:nil];
+        }
+        waiter = [TOSAppendFlushWaiter new];
+        waiter.offset = _acceptedOffset;
+        waiter.source = [TOSTaskCompletionSource taskCompletionSource];
+        [_waiters addObject:waiter];
+        next = [self nextAppendLocked:&nextOffset];
+    }
+    if (next) {
+        [self appendData:next offset:nextOffset];
+    }
+    return waiter.source.task;
+}
+
+- (TOSTask *)close {
+    @synchronized (self) {
+        _closed = YES;
+    }
+    return [self flush];
+}
+
+#pragma mark - 追加
+
+- (NSUInteger)pendingLengthLocked {
+    return _pendingData.length - _pendingOffset;
+}
+
+// 调用方持有锁；满足条件时取出至多bufferSize字节并标记在途，否则按需设置定时器
+- (NSData *)nextAppendLocked:(int64_t *)offset {
+    NSUInteger pendingLength = [self pendingLengthLocked];
+    if (_inflight || _error || pendingLength == 0) {
+        return nil;
+    }
+    CFAbsoluteTime waited = CFAbsoluteTimeGetCurrent() - _pendingSince;
+    BOOL ready = _closed || _waiters.count > 0 || pendingLength >= _bufferSize ||
+                 (_flushInterval > 0 && waited >= _flushInterval);
+    if (!ready) {
+        if (_flushInterval > 0 && !_timerScheduled) {
+            _timerScheduled = YES;
+            dispatch_time_t deadline = dispatch_time(DISPATCH_TIME_NOW, (int64_t)((_flushInterval - waited) * NSEC_PER_SEC));
+            dispatch_after(deadline, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                [self flushIntervalDidElapse];
+            });
+        }
+        return nil;
+    }
+    // 单次追加不超过bufferSize，剩余数据在本次追加完成后继续发送
+    NSUInteger length = MIN(pendingLength, MAX(_bufferSize, 1));
+    NSData *data = nil;
+    if (_pendingOffset == 0 && length == _pendingData.length) {
+        data = _pendingData;
+        _pendingData = [NSMutableData data];
+    } else {
+        data = [_pendingData subdataWithRange:NSMakeRange(_pendingOffset, length)];
+        _pendingOffset += length;
+        if (_pendingOffset == _pendingData.length) {
+            _pendingData = [NSMutableData data];
+            _pendingOffset = 0;
+        } else if (_pendingOffset > _pendingData.length - _pendingOffset) {
+            // 已发送的前缀超过剩余数据时压缩，拷贝量不超过已发送的数据量
+            _pendingData = [[_pendingData subdataWithRange:NSMakeRange(_pendingOffset, _pendingData.length - _pendingOffset)] mutableCopy];
+            _pendingOffset = 0;
+        }
+    }
+    _inflight = YES;
+    _appendCount++;
+    *offset = _nextAppendOffset;
+    return data;
+}
+
+- (void)flushIntervalDidElapse {
+    NSData *next = nil;
+    int64_t nextOffset = 0;
+    @synchronized (self) {
+        _timerScheduled = NO;
+        next = [self nextAppendLocked:&nextOffset];
+    }
+    if (next) {
+        [self appendData:next offset:nextOffset];
+    }
+}
+
+- (TOSAppendObjectInput *)appendInputWithOffset:(int64_t)offset {
+    TOSAppendObjectInput *input = [TOSAppendObjectInput new];
+    input.tosBucket = _template.tosBucket;
+    input.tosKey = _template.tosKey;
+    input.tosOffset = offset;
+    // 元数据仅在创建对象时生效
+    if (offset == 0) {
+        input.tosCacheControl = _template.tosCacheControl;
+        input.tosContentDisposition = _template.tosContentDisposition;
+        input.tosContentEncoding = _template.tosContentEncoding;
+        input.tosContentLanguage = _template.tosContentLanguage;
+        input.tosContentType = _template.tosContentType;
+        input.tosExpires = _template.tosExpires;
+        input.tosACL = _template.tosACL;
+        input.tosGrantFullControl = _template.tosGrantFullControl;
+        input.tosGrantRead = _template.tosGrantRead;
+        input.tosGrantReadAcp = _template.tosGrantReadAcp;
+        input.tosGrantWriteAcp = _template.tosGrantWriteAcp;
+        input.tosMeta = _template.tosMeta;
+        input.tosWebsiteRedirectLocation = _template.tosWebsiteRedirectLocation;
+        input.tosStorageClass = _template.tosStorageClass;
+    }
+    return input;
+}
+
+- (void)appendData:(NSData *)data offset:(int64_t)offset {
+    uint64_t dataCRC = _verifyCRC ? [TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length] : 0;
+    TOSAppendObjectInput *input = [self appendInputWithOffset:offset];
+    input.tosContent = data;
+    input.tosContentLength = (int64_t)data.length;
+    [[_client appendObject:input] continueWithExecutor:_executor withBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        [self didAppendData:data CRC:dataCRC offset:offset task:task];
+        return nil;
+    }];
+}
+
+- (void)didAppendData:(NSData *)data CRC:(uint64_t)dataCRC offset:(int64_t)offset task:(TOSTask *)task {
+    NSError *error = task.error;
+    NSMutableArray<TOSAppendFlushWaiter *> *finished = [NSMutableArray array];
+    NSData *next = nil;
+    int64_t nextOffset = 0;
+    NSInteger wakeCount = 0;
+    @synchronized (self) {
+        _inflight = NO;
+        if (!error) {
+            TOSAppendObjectOutput *output = task.result;
+            int64_t expectedOffset = offset + (int64_t)data.length;
+            // 不校验时起始CRC未知，合并结果没有意义，保持为0
+            uint64_t crc = _verifyCRC ? [TOSUtil crc64ForCombineCRC1:_hashCrc64ecma CRC2:dataCRC length:(uintmax_t)data.length] : 0;
+            if (output.tosNextAppendOffset != expectedOffset) {
+                NSString *message = [NSString stringWithFormat:@"tos: unexpected next append offset %lld, expect %lld", output.tosNextAppendOffset, expectedOffset];
+                error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: message}];
+            } else if (_verifyCRC && output.tosHashCrc64ecma != 0 && output.tosHashCrc64ecma != crc) {
+                error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: crc of appended object mismatch"}];
+            } else {
+                _nextAppendOffset = expectedOffset;
+                _hashCrc64ecma = crc;
+            }
+        }
+        if (error) {
+            _error = error;
+            [finished addObjectsFromArray:_waiters];
+            [_waiters removeAllObjects];
+            _pendingData = [NSMutableData data];
+            _pendingOffset = 0;
+        } else {
+            for (TOSAppendFlushWaiter *waiter in _waiters) {
+                if (waiter.offset <= _nextAppendOffset) {
+                    [finished addObject:waiter];
+                }
+            }
+            [_waiters removeObjectsInArray:finished];
+            next = [self nextAppendLocked:&nextOffset];
+        }
+        wakeCount = _blockedWriters;
+        _blockedWriters = 0;
+    }
+    for (NSInteger i = 0; i < wakeCount; i++) {
+        dispatch_semaphore_signal(_drainSemaphore);
+    }
+    for (TOSAppendFlushWaiter *waiter in finished) {
+        if (error) {
+            [waiter.source trySetError:error];
+        } else {
+            [waiter.source trySetResult:nil];
+        }
+    }
+    if (next) {
+        [self appendData:next offset:nextOffset];
+    }
+}
+
+@end
@@ -38,11 +38,22 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (TOSTask *)invokeRequest:(TOSNetworkingRequestDelegate *)request HTTPMethod: (TOSHTTPMethodType *)HTTPMethod OperationType: (TOSOperationType) operationType;
 
+/**
+ 发起请求，未显式设置cancellationToken时使用input的取消令牌
+ */
+- (TOSTask *)invokeRequest:(TOSNetworkingRequestDelegate *)request input:(TOSInput * _Nullable)input HTTPMethod: (TOSHTTPMethodType *)HTTPMethod OperationType: (TOSOperationType) operationType;
+
 - (NSString *)generateURLWithBucketName:(NSString * _Nullable)bucketName
                          withObjectName:(NSString * _Nullable)objectName
                         withQueryParams:(NSDictionary * _Nullable)queryParams
                         withEndpoint:(NSString * _Nullable)endpoint;
 
+/**
+ 按操作类型统计的延迟分位数、流量、错误与重试计数，reset为YES时返回后清零
+ */
+- (NSDictionary<NSNumber *, TOSOperationStatisticsSnapshot *> *)operationStatisticsWithReset:(BOOL)reset;
+- (void)resetOperationStatistics;
+
 @end
 
 @interface TOSClient (Bucket)
@@ -63,8 +74,21 @@ NS_ASSUME_NONNULL_BEGIN
 - (TOSTask *)copyObject:(TOSCopyObjectInput *)request;
 - (TOSTask *)deleteObject:(TOSDeleteObjectInput *)request;
 - (TOSTask *)deleteMultiObjects:(TOSDeleteMultiObjectsInput *)request;
+// 流式批量删除，结果为TOSDeleteObjectsOutput；任一批次请求失败时返回该错误
+- (TOSTask *)deleteObjects:(TOSDeleteObjectsInput *)request;
+- (TOSTask *)deleteObjectsByPrefix:(TOSDeleteObjectsByPrefixInput *)request;
 - (TOSTask *)getObject:(TOSGetObjectInput *)request;
+/**
+ 将对象内容直接写入调用方提供的缓冲区，超出capacity时任务失败；
+ 返回的TOSGetObjectOutput.tosContent引用该缓冲区（不拷贝），调用方需保证使用tosContent期间缓冲区有效
+ */
+- (TOSTask *)getObject:(TOSGetObjectInput *)request intoBuffer:(void *)buffer capacity:(NSUInteger)capacity;
 - (TOSTask *)getObjectToFile:(TOSGetObjectToFileInput *)request;
+/**
+ 一次读取对象的多个区间：间隔不超过tosMergeGap的区间合并为一次区间下载，最多tosTaskNum个请求并发；
+ 结果为TOSGetObjectRangesOutput，tosContents中的切片引用下载的数据，不额外拷贝
+ */
+- (TOSTask *)getObjectRanges:(TOSGetObjectRangesInput *)request;
 - (TOSTask *)getObjectAcl:(TOSGetObjectACLInput *)request;
 - (TOSTask *)headObject:(TOSHeadObjectInput *)request;
 - (TOSTask *)appendObject:(TOSAppendObjectInput *) request;
@@ -92,9 +116,19 @@ NS_ASSUME_NONNULL_BEGIN
 - (TOSTask *)listParts:(TOSListPartsInput *)request;
 
 - (TOSTask *)uploadFile:(TOSUploadFileInput *)request;
+- (TOSTask *)copyFile:(TOSCopyFileInput *)request;
 
 @end
 
+@interface TOSClient (Prewarm)
+/**
+ 预先建立到endpoint或各桶虚拟主机的连接，使后续请求不再承担DNS、TCP、TLS握手的耗时；结果为TOSPrewarmOutput。
+ tosKeepAliveInterval大于0时在空闲期间定期重新发送预热请求，再次调用会替换之前的刷新设置
+ */
+- (TOSTask *)prewarm:(TOSPrewarmInput *)request;
+- (void)stopPrewarm;
+@end
+
 @interface TOSClient (PresignURL)
 - (TOSTask *)preSignedURL:(TOSPreSignedURLInput *)request;
 @end
@@ -18,12 +18,20 @@
 #import <VeTOSiOSSDK/TOSNetworkingResponseParser.h>
 #import <VeTOSiOSSDK/TOSUtil.h>
 #import "TOSURLRequestRetryHandler.h"
+#import "TOSObjectMetadataCache.h"
+#import "TOSObjectDiskCache.h"
+#import <VeTOSiOSSDK/TOSFileSink.h>
 #include <libkern/OSAtomic.h>
 
 @interface TOSClient()
 
 @property (nonatomic, strong) TOSNetworking *networking;
+@property (atomic, assign) CFAbsoluteTime lastRequestTime; // 用于判断连接是否空闲
+@property (nonatomic, strong) dispatch_source_t prewarmTimer;
 + (NSError *)cancelError;
+- (TOSTask *)sendHeadObject:(TOSHeadObjectInput *)request;
+- (nullable NSError *)normalizePartSize:(int64_t *)partSize taskNum:(int *)taskNum;
+- (TOSTask *)runOperation:(NSString *)name request:(TOSInput *)request userRequest:(TOSInput *)userRequest block:(id _Nullable (^)(void))block;
 
 @end
 
@@ -60,11 +68,37 @@ static NSObject *uploadLock;
     return self;
 }
 
+- (void)dealloc {
+    if (_prewarmTimer) {
+        dispatch_source_cancel(_prewarmTimer);
+    }
+}
+
 - (TOSTask *)invokeRequest: (TOSNetworkingRequestDelegate *)request HTTPMethod: (TOSHTTPMethodType *)Method OperationType: (TOSOperationType) operationType {
+    return [self invokeRequest:request input:nil HTTPMethod:Method OperationType:operationType];
+}
+
+- (TOSTask *)invokeRequest: (TOSNetworkingRequestDelegate *)request input: (TOSInput *)input HTTPMethod: (TOSHTTPMethodType *)Method OperationType: (TOSOperationType) operationType {
     
     @autoreleasepool {
         
+        self.lastRequestTime = CFAbsoluteTimeGetCurrent();
+        // 请求随输入的取消令牌中断
+        if (!request.cancellationToken) {
+            request.cancellationToken = input.tosCancellationToken;
+        }
         request.HTTPMethod = Method;
+        request.metrics = [TOSRequestMetrics new];
+        request.metrics.startTime = [TOSRequestMetrics now];
+        request.metrics.operationType = operationType;
+        request.metrics.HTTPMethod = Method;
+        request.metrics.bucket = request.bucket;
+        request.metrics.object = request.object;
+        id<TOSTracer> tracer = self.clientConfiguration.tracer;
+        if (tracer) {
+            request.span = [[TOSSpan alloc] initWithName:request.HTTPMethod operationType:operationType parent:[TOSSpan currentSpan]];
+            [tracer spanDidBegin:request.span];
+        }
         NSString *urlString = [self generateURLWithBucketName:request.bucket withObjectName:request.object withQueryParams:request.queryParams withEndpoint:nil];
         NSURL *url = [NSURL URLWithString:urlString];
         request.internalRequest = [NSMutableURLRequest requestWithURL:url];
@@ -103,6 +137,12 @@ static NSObject *uploadLock;
         
         if ([TOSUtil isNotEmptyString:request.downloadingFilePath]) {
             request.responseParser.downloadingFileURL = [NSURL fileURLWithPath:request.downloadingFilePath];
+            request.responseParser.fileSyncPolicy = request.fileSyncPolicy;
+        }
+        request.responseParser.keepsDiscontiguousData = request.discontiguousContent;
+        if (request.receivingBuffer) {
+            request.responseParser.destinationBuffer = request.receivingBuffer;
+            request.responseParser.destinationBufferCapacity = request.receivingBufferCapacity;
         }
         return [self.networking sendRequest: request];
     }
@@ -277,6 +317,55 @@ static NSObject *uploadLock;
     return nil;
 }
 
+// 分段大小为0时取默认值，并发数限制在[TOSMinTaskNum, TOSMaxTaskNum]
+- (nullable NSError *)normalizePartSize:(int64_t *)partSize taskNum:(int *)taskNum {
+    if (*partSize == 0) {
+        *partSize = TOSDefaultPartSize;
+    }
+    if (*taskNum < TOSMinTaskNum) {
+        *taskNum = TOSMinTaskNum;
+    }
+    if (*taskNum > TOSMaxTaskNum) {
+        *taskNum = TOSMaxTaskNum;
+    }
+    if (*partSize < TOSMinPartSize || *partSize > TOSMaxPartSize) {
+        NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: invalid part size, the size must be [5242880, 5368709120]"};
+        return [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo];
+    }
+    return nil;
+}
+
+// 在操作执行器上执行uploadFile/copyFile等组合操作：子请求挂在name对应的Span下，
+// request为用户请求的拷贝（mutableCopy不带取消状态），取消userRequest时同步取消request
+- (TOSTask *)runOperation:(NSString *)name request:(TOSInput *)request userRequest:(TOSInput *)userRequest block:(id _Nullable (^)(void))block {
+    id<TOSTracer> tracer = self.clientConfiguration.tracer;
+    TOSSpan *span = nil;
+    if (tracer) {
+        span = [[TOSSpan alloc] initWithName:name operationType:(TOSOperationType)-1 parent:[TOSSpan currentSpan]];
+        [tracer spanDidBegin:span];
+    }
+    __weak TOSInput *weakRequest = request;
+    TOSCancellationTokenRegistration *cancellation = [userRequest.tosCancellationToken registerCancellationObserverWithBlock:^{
+        [weakRequest cancel];
+    }];
+    if (userRequest.isCancelled) {
+        [request cancel];
+    }
+    TOSTask *task = [[TOSTask taskWithResult:nil] continueWithExecutor:self.tosOperationExecutor withBlock:^id _Nullable(TOSTask * _Nonnull t) {
+        id result = [TOSSpan performWithSpan:span block:block];
+        [cancellation dispose];
+        return result;
+    }];
+    if (!span) {
+        return task;
+    }
+    return [task continueWithBlock:^id _Nullable(TOSTask * _Nonnull t) {
+        span.endTime = [TOSRequestMetrics now];
+        [tracer spanDidEnd:span error:t.error];
+        return t;
+    }];
+}
+
 - (TOSTask *)validateUploadFileRequest:(TOSUploadFileInput *)request {
     NSError *error = nil;
     
@@ -307,21 +396,14 @@ static NSObject *uploadLock;
     if (![TOSUtil isValidObjectName:request.tosKey withError:&error]) {
         return [TOSTask taskWithError:error];
     }
-    if (request.tosPartSize == 0) {
-        request.tosPartSize = TOSDefaultPartSize;
-    }
-    if (request.tosTaskNum < 1) {
-        request.tosTaskNum = TOSMinTaskNum;
-    }
-    if (request.tosTaskNum > 5) {
-        request.tosTaskNum = TOSMaxTaskNum;
-    }
-    
-    if (request.tosPartSize < TOSMinPartSize || request.tosPartSize > TOSMaxPartSize) {
-        NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: invalid part size, the size must be [5242880, 5368709120]"};
-        error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo];
+    int64_t partSize = request.tosPartSize;
+    int taskNum = request.tosTaskNum;
+    error = [self normalizePartSize:&partSize taskNum:&taskNum];
+    if (error) {
         return [TOSTask taskWithError:error];
     }
+    request.tosPartSize = partSize;
+    request.tosTaskNum = taskNum;
     
     if (request.tosEnableCheckpoint) {
         if ([TOSUtil isNotEmptyString:request.tosCheckpointFile]) {
@@ -362,6 +444,34 @@ static NSObject *uploadLock;
     return [filePath hasSuffix:@"/"];
 }
 
+- (NSDictionary<NSNumber *, TOSOperationStatisticsSnapshot *> *)operationStatisticsWithReset:(BOOL)reset {
+    return [self.networking.operationStatistics snapshotAndReset:reset];
+}
+
+- (void)resetOperationStatistics {
+    [self.networking.operationStatistics reset];
+}
+
+// 写操作发起和完成时均使元数据缓存和磁盘缓存失效，避免期间发起的headObject、getObject写回旧数据
+- (TOSTask *)invalidateCachesOfBucket:(NSString *)bucket keys:(NSArray<NSString *> *)keys afterTask:(TOSTask *)task {
+    TOSObjectMetadataCache *cache = self.clientConfiguration.objectMetadataCache;
+    TOSObjectDiskCache *diskCache = self.clientConfiguration.objectDiskCache;
+    if ((!cache && !diskCache) || !bucket || keys.count == 0) {
+        return task;
+    }
+    for (NSString *key in keys) {
+        [cache invalidateBucket:bucket key:key];
+        [diskCache invalidateBucket:bucket key:key];
+    }
+    return [task continueWithBlock:^id _Nullable(TOSTask * _Nonnull t) {
+        for (NSString *key in keys) {
+            [cache invalidateBucket:bucket key:key];
+            [diskCache invalidateBucket:bucket key:key];
+        }
+        return t;
+    }];
+}
+
 + (NSError *)cancelError{
     static NSError *error = nil;
     static dispatch_once_t onceToken;
@@ -425,7 +535,7 @@ static NSObject *uploadLock;
     requestDelegate.bucket = request.tosBucket;
     requestDelegate.headerParams = [request headerParamsDict];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeCreateBucket];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeCreateBucket];
 }
 
 - (TOSTask *)headBucket:(TOSHeadBucketInput *)request {
@@ -439,7 +549,7 @@ static NSObject *uploadLock;
     requestDelegate.bucket = request.tosBucket;
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeHead;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeHead OperationType:TOSOperationTypeHeadBucket];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeHead OperationType:TOSOperationTypeHeadBucket];
 }
 
 - (TOSTask *)deleteBucket:(TOSDeleteBucketInput *)request {
@@ -453,7 +563,7 @@ static NSObject *uploadLock;
     requestDelegate.bucket = request.tosBucket;
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeDelete;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeDelete OperationType:TOSOperationTypeDeleteBucket];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeDelete OperationType:TOSOperationTypeDeleteBucket];
 }
 
 - (TOSTask *)listBuckets:(TOSListBucketsInput *)request {
@@ -464,7 +574,7 @@ static NSObject *uploadLock;
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeGet;
     
 
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListBuckets];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListBuckets];
 }
 
 
@@ -481,7 +591,7 @@ static NSObject *uploadLock;
     requestDelegate.body = [request requestBody];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypePut;
 
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutBucketCustomDomain];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutBucketCustomDomain];
 }
 
 - (TOSTask *)listBucketCustomDomain:(TOSListBucketCustomDomainInput *)request {
@@ -496,7 +606,7 @@ static NSObject *uploadLock;
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeGet;
 
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListBucketCustomDomain];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListBucketCustomDomain];
 }
 
 - (TOSTask *)deleteBucketCustomDomain:(TOSDeleteBucketCustomDomainInput *)request {
@@ -511,7 +621,7 @@ static NSObject *uploadLock;
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeDelete;
 
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeDelete OperationType:TOSOperationTypeDeleteBucketCustomDomain];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeDelete OperationType:TOSOperationTypeDeleteBucketCustomDomain];
 }
 
 @end
@@ -534,7 +644,8 @@ static NSObject *uploadLock;
     requestDelegate.HTTPMethod = TOSHTTPMethodTypePut;
     requestDelegate.headerParams = [request headerParamsDict];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeCopyObject];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeCopyObject];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 - (TOSTask *)deleteObject:(TOSDeleteObjectInput *)request {
@@ -553,7 +664,8 @@ static NSObject *uploadLock;
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeDelete;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeDelete OperationType:TOSOperationTypeDeleteObject];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeDelete OperationType:TOSOperationTypeDeleteObject];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 - (TOSTask *)deleteMultiObjects:(TOSDeleteMultiObjectsInput *)request {
@@ -570,42 +682,509 @@ static NSObject *uploadLock;
     requestDelegate.body = [request requestBody];
     
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeDeleteMultiObjects];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeDeleteMultiObjects];
+    if (!self.clientConfiguration.objectMetadataCache && !self.clientConfiguration.objectDiskCache) {
+        return task;
+    }
+    NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithCapacity:request.tosObjects.count];
+    for (TOSObjectTobeDeleted *object in request.tosObjects) {
+        if (object.tosKey) {
+            [keys addObject:object.tosKey];
+        }
+    }
+    return [self invalidateCachesOfBucket:request.tosBucket keys:keys afterTask:task];
 }
 
-- (TOSTask *)getObject:(TOSGetObjectInput *)request {
-    TOSNetworkingRequestDelegate *requestDelegate = [[TOSNetworkingRequestDelegate alloc] init];
-
+- (TOSTask *)deleteObjects:(TOSDeleteObjectsInput *)request {
     NSError *error = nil;
     if (!self.clientConfiguration.tosEndpoint.isCustomDomain && ![TOSUtil isValidBucketName:request.tosBucket withError:&error]) {
         return [TOSTask taskWithError:error];
     }
-    if (![TOSUtil isValidObjectName:request.tosKey withError:&error]) {
+    if (!request.tosObjectEnumerator) {
+        NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: object enumerator is empty"};
+        return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo]];
+    }
+    
+    NSEnumerator<TOSObjectTobeDeleted *> *enumerator = request.tosObjectEnumerator;
+    int batchSize = [self deleteBatchSize:request.tosBatchSize];
+    return [self deleteObjectsInBucket:request.tosBucket request:request batchSize:batchSize taskNum:request.tosTaskNum nextPage:^NSArray<TOSObjectTobeDeleted *> *(NSError **error) {
+        NSMutableArray<TOSObjectTobeDeleted *> *page = [NSMutableArray arrayWithCapacity:batchSize];
+        TOSObjectTobeDeleted *object;
+        while (page.count < (NSUInteger)batchSize && (object = [enumerator nextObject])) {
+            [page addObject:object];
+        }
+        return page.count > 0 ? page : nil;
+    }];
+}
+
+- (TOSTask *)deleteObjectsByPrefix:(TOSDeleteObjectsByPrefixInput *)request {
+    NSError *error = nil;
+    if (!self.clientConfiguration.tosEndpoint.isCustomDomain && ![TOSUtil isValidBucketName:request.tosBucket withError:&error]) {
         return [TOSTask taskWithError:error];
     }
     
+    // 逐页列举，列举下一页的同时上一页的批次已在并发删除
+    __block BOOL truncated = YES;
+    __block NSString *marker = nil;
+    __block NSString *versionIDMarker = nil;
+    NSArray<TOSObjectTobeDeleted *> * _Nullable (^nextPage)(NSError **) = ^NSArray<TOSObjectTobeDeleted *> *(NSError **error) {
+        if (!truncated) {
+            return nil;
+        }
+        NSMutableArray<TOSObjectTobeDeleted *> *page = [NSMutableArray array];
+        TOSTask *listTask;
+        if (request.tosIncludeVersions) {
+            TOSListObjectVersionsInput *listInput = [TOSListObjectVersionsInput new];
+            listInput.tosBucket = request.tosBucket;
+            listInput.tosPrefix = request.tosPrefix;
+            listInput.tosKeyMarker = marker;
+            listInput.tosVersionIDMarker = versionIDMarker;
+            listInput.tosMaxKeys = 1000;
+            listTask = [self listObjectVersions:listInput];
+            [listTask waitUntilFinished];
+            TOSListObjectVersionsOutput *output = listTask.result;
+            for (TOSListedObjectVersion *version in output.tosVersions) {
+                TOSObjectTobeDeleted *object = [TOSObjectTobeDeleted new];
+                object.tosKey = version.tosKey;
+                object.tosVersionID = version.tosVersionID;
+                [page addObject:object];
+            }
+            for (TOSListedDeleteMarker *deleteMarker in output.tosDeleteMarkers) {
+                TOSObjectTobeDeleted *object = [TOSObjectTobeDeleted new];
+                object.tosKey = deleteMarker.tosKey;
+                object.tosVersionID = deleteMarker.tosVersionID;
+                [page addObject:object];
+            }
+            truncated = output.tosIsTruncated;
+            marker = output.tosNextKeyMarker;
+            versionIDMarker = output.tosNextVersionIDMarker;
+        } else {
+            TOSListObjectsInput *listInput = [TOSListObjectsInput new];
+            listInput.tosBucket = request.tosBucket;
+            listInput.tosPrefix = request.tosPrefix;
+            listInput.tosMarker = marker;
+            listInput.tosMaxKeys = 1000;
+            listTask = [self listObjects:listInput];
+            [listTask waitUntilFinished];
+            TOSListObjectsOutput *output = listTask.result;
+            for (TOSListedObject *listedObject in output.tosContents) {
+                TOSObjectTobeDeleted *object = [TOSObjectTobeDeleted new];
+                object.tosKey = listedObject.tosKey;
+                [page addObject:object];
+            }
+            truncated = output.tosIsTruncated;
+            marker = output.tosNextMarker;
+        }
+        if (listTask.error) {
+            if (error) {
+                *error = listTask.error;
+            }
+            return nil;
+        }
+        return page;
+    };
+    return [self deleteObjectsInBucket:request.tosBucket request:request batchSize:[self deleteBatchSize:request.tosBatchSize] taskNum:request.tosTaskNum nextPage:nextPage];
+}
+
+- (int)deleteBatchSize:(int)batchSize {
+    // DeleteMultiObjects单次最多1000个对象
+    return (batchSize <= 0 || batchSize > 1000) ? 1000 : batchSize;
+}
+
+// 在后台线程上从nextPage拉取待删对象，凑满一批即发起DeleteMultiObjects，同时在途的请求不超过taskNum个
+// nextPage返回nil表示没有更多对象，可返回空数组
+- (TOSTask *)deleteObjectsInBucket:(NSString *)bucket
+                           request:(TOSInput *)request
+                         batchSize:(int)batchSize
+                           taskNum:(int)taskNum
+                          nextPage:(NSArray<TOSObjectTobeDeleted *> * _Nullable (^)(NSError **error))nextPage {
+    if (taskNum <= 0) {
+        taskNum = 4;
+    }
+    return [[TOSTask taskWithResult:nil] continueWithExecutor:self.tosOperationExecutor withBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        dispatch_semaphore_t slots = dispatch_semaphore_create(taskNum);
+        dispatch_group_t group = dispatch_group_create();
+        NSObject *lock = [NSObject new];
+        __block NSError *requestError = nil;
+        __block int64_t deletedCount = 0;
+        __block int requestCount = 0;
+        NSMutableArray<TOSDeleteError *> *deleteErrors = [NSMutableArray array];
+        
+        NSMutableArray<TOSObjectTobeDeleted *> *pending = [NSMutableArray array];
+        BOOL exhausted = NO;
+        while (!exhausted || pending.count > 0) {
+            if (request.isCancelled) {
+                break;
+            }
+            @synchronized (lock) {
+                if (requestError) {
+                    break;
+                }
+            }
+            if (!exhausted && pending.count < (NSUInteger)batchSize) {
+                NSError *error = nil;
+                NSArray<TOSObjectTobeDeleted *> *page = nextPage(&error);
+                if (error) {
+                    @synchronized (lock) {
+                        requestError = requestError ?: error;
+                    }
+                    break;
+                }
+                if (page) {
+                    [pending addObjectsFromArray:page];
+                } else {
+                    exhausted = YES;
+                }
+                continue;
+            }
+            
+            NSRange range = NSMakeRange(0, MIN((NSUInteger)batchSize, pending.count));
+            NSArray<TOSObjectTobeDeleted *> *batch = [pending subarrayWithRange:range];
+            [pending removeObjectsInRange:range];
+            
+            dispatch_semaphore_wait(slots, DISPATCH_TIME_FOREVER);
+            TOSDeleteMultiObjectsInput *deleteInput = [TOSDeleteMultiObjectsInput new];
+            deleteInput.tosBucket = bucket;
+            deleteInput.tosObjects = batch;
+            deleteInput.tosQuiet = YES;
+            // 整体取消时立即中断在途批次
+            TOSCancellationTokenRegistration *cancellation = [request.tosCancellationToken registerCancellationObserverWithBlock:^{
+                [deleteInput cancel];
+            }];
+            dispatch_group_enter(group);
+            [[self deleteMultiObjects:deleteInput] continueWithBlock:^id _Nullable(TOSTask * _Nonnull deleteTask) {
+                [cancellation dispose];
+                TOSDeleteMultiObjectsOutput *output = deleteTask.result;
+                @synchronized (lock) {
+                    requestCount++;
+                    if (deleteTask.error) {
+                        requestError = requestError ?: deleteTask.error;
+                    } else {
+                        // Quiet模式下只返回失败项
+                        [deleteErrors addObjectsFromArray:output.tosError];
+                        deletedCount += (int64_t)batch.count - (int64_t)output.tosError.count;
+                    }
+                }
+                dispatch_semaphore_signal(slots);
+                dispatch_group_leave(group);
+                return nil;
+            }];
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+        
+        if (requestError) {
+            return [TOSTask taskWithError:requestError];
+        }
+        if (request.isCancelled) {
+            return [TOSTask taskWithError:[TOSClient cancelError]];
+        }
+        TOSDeleteObjectsOutput *output = [TOSDeleteObjectsOutput new];
+        output.tosDeletedCount = deletedCount;
+        output.tosErrors = deleteErrors;
+        output.tosRequestCount = requestCount;
+        output.tosElapsedTime = CFAbsoluteTimeGetCurrent() - start;
+        output.tosObjectsPerSecond = output.tosElapsedTime > 0 ? deletedCount / output.tosElapsedTime : 0;
+        return output;
+    }];
+}
+
+- (TOSTask *)getObject:(TOSGetObjectInput *)request {
+    TOSObjectDiskCache *cache = self.clientConfiguration.objectDiskCache;
+    if (cache && [self isDiskCacheableGetObject:request]) {
+        return [self getObject:request withDiskCache:cache];
+    }
+    return [self sendGetObject:request];
+}
+
+// 条件请求、SSE-C对象、图片处理、response-*覆盖及流式回调不经过磁盘缓存
+- (BOOL)isDiskCacheableGetObject:(TOSGetObjectInput *)request {
+    return !request.tosIfMatch && !request.tosIfModifiedSince && !request.tosIfNoneMatch && !request.tosIfUnmodifiedSince &&
+           !request.tosSSECKey && !request.tosRange && request.tosPartNumber == 0 &&
+           !request.tosProcess && !request.tosProcessSaveAsObject && !request.tosProcessSaveAsBucket &&
+           !request.tosResponseCacheControl && !request.tosResponseContentDisposition && !request.tosResponseContentEncoding &&
+           !request.tosResponseContentLanguage && !request.tosResponseContentType && !request.tosResponseExpires &&
+           !request.tosOnReceiveData && !request.tosDiscontiguousContent &&
+           request.tosRangeStart >= 0 && request.tosRangeEnd >= request.tosRangeStart &&
+           [TOSUtil isNotEmptyString:request.tosBucket] && [TOSUtil isNotEmptyString:request.tosKey];
+}
+
+- (TOSTask *)getObject:(TOSGetObjectInput *)request withDiskCache:(TOSObjectDiskCache *)cache {
+    BOOL ranged = request.tosRangeStart != 0 || request.tosRangeEnd != 0;
+    // 分段读取和校验在后台队列执行，不占用调用方线程
+    TOSExecutor *ioExecutor = [TOSExecutor executorWithDispatchQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+    return [TOSTask taskFromExecutor:ioExecutor withBlock:^id _Nullable{
+        BOOL fresh = NO;
+        TOSGetObjectOutput *cached = [cache outputForBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID
+                                                 rangeStart:request.tosRangeStart rangeEnd:request.tosRangeEnd ranged:ranged fresh:&fresh];
+        if (cached && fresh) {
+            [self reportDownloadProgressOfCachedOutput:cached request:request];
+            return cached;
+        }
+        int64_t generation = cache.generation;
+        TOSGetObjectInput *getInput = [TOSGetObjectInput new];
+        getInput.tosBucket = request.tosBucket;
+        getInput.tosKey = request.tosKey;
+        getInput.tosVersionID = request.tosVersionID;
+        getInput.tosSSECAlgorithm = request.tosSSECAlgorithm;
+        getInput.tosSSECKeyMD5 = request.tosSSECKeyMD5;
+        getInput.tosDownloadProgress = request.tosDownloadProgress;
+        getInput.tosRangeStart = request.tosRangeStart;
+        getInput.tosRangeEnd = request.tosRangeEnd;
+        if (cached) {
+            // 携带ETag校验，未修改时服务端返回304
+            getInput.tosIfNoneMatch = cached.tosETag;
+        } else if (ranged) {
+            // 区间按分段对齐扩大，下载的数据整段写入缓存
+            int64_t segmentSize = (int64_t)cache.segmentSize;
+            getInput.tosRangeStart = request.tosRangeStart / segmentSize * segmentSize;
+            if (request.tosRangeEnd < INT64_MAX - segmentSize) {
+                getInput.tosRangeEnd = (request.tosRangeEnd / segmentSize + 1) * segmentSize - 1;
+            }
+        }
+        int64_t offset = getInput.tosRangeStart;
+        __weak TOSGetObjectInput *weakInput = getInput;
+        TOSCancellationTokenRegistration *cancellation = [request.tosCancellationToken registerCancellationObserverWithBlock:^{
+            [weakInput cancel];
+        }];
+        if (request.isCancelled) {
+            [getInput cancel];
+        }
+        return [[self sendGetObject:getInput] continueWithExecutor:ioExecutor withBlock:^id _Nullable(TOSTask * _Nonnull task) {
+            [cancellation dispose];
+            NSError *error = task.error;
+            if (cached && [error.domain isEqualToString:TOSServerErrorDomain] && error.code == 304) {
+                [cache markValidatedBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID];
+                [self reportDownloadProgressOfCachedOutput:cached request:request];
+                return cached;
+            }
+            if (error) {
+                return task;
+            }
+            TOSGetObjectOutput *output = task.result;
+            [cache storeOutput:output offset:offset forBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID generation:generation];
+            if (offset == request.tosRangeStart && getInput.tosRangeEnd == request.tosRangeEnd) {
+                return output;
+            }
+            return [self sliceOutput:output offset:offset rangeStart:request.tosRangeStart rangeEnd:request.tosRangeEnd];
+        }];
+    }];
+}
+
+// 从按分段对齐下载的数据中截取调用方请求的区间
+- (id)sliceOutput:(TOSGetObjectOutput *)output offset:(int64_t)offset rangeStart:(int64_t)start rangeEnd:(int64_t)end {
+    int64_t length = (int64_t)output.tosContent.length;
+    if (start - offset >= length) {
+        NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: the requested range is not satisfiable"};
+        return [TOSTask taskWithError:[NSError errorWithDomain:TOSServerErrorDomain code:416 userInfo:userInfo]];
+    }
+    end = MIN(end, offset + length - 1);
+    output.tosContent = [output.tosContent subdataWithRange:NSMakeRange((NSUInteger)(start - offset), (NSUInteger)(end - start + 1))];
+    output.tosContentLength = end - start + 1;
+    NSRange slash = [output.tosContentRange rangeOfString:@"/" options:NSBackwardsSearch];
+    NSString *total = slash.location != NSNotFound ? [output.tosContentRange substringFromIndex:slash.location + 1] : @"*";
+    output.tosContentRange = [NSString stringWithFormat:@"bytes %lld-%lld/%@", start, end, total];
+    return output;
+}
+
+- (void)reportDownloadProgressOfCachedOutput:(TOSGetObjectOutput *)output request:(TOSGetObjectInput *)request {
+    if (request.tosDownloadProgress) {
+        int64_t length = output.tosContentLength;
+        request.tosDownloadProgress(length, length, length);
+    }
+}
+
+// getObject各变体共用的参数校验和请求构造
+- (TOSNetworkingRequestDelegate *)getObjectRequestDelegate:(TOSGetObjectInput *)request error:(NSError **)error {
+    if (!self.clientConfiguration.tosEndpoint.isCustomDomain && ![TOSUtil isValidBucketName:request.tosBucket withError:error]) {
+        return nil;
+    }
+    if (![TOSUtil isValidObjectName:request.tosKey withError:error]) {
+        return nil;
+    }
+    
     if (request.tosRangeEnd != 0 || request.tosRangeStart != 0) {
         if (request.tosRangeEnd < request.tosRangeStart) {
-            NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: invalid range"};
-            error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo];
-            return [TOSTask taskWithError:error];
+            if (error) {
+                NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: invalid range"};
+                *error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo];
+            }
+            return nil;
         }
     }
     
+    TOSNetworkingRequestDelegate *requestDelegate = [[TOSNetworkingRequestDelegate alloc] init];
     requestDelegate.bucket = request.tosBucket;
     requestDelegate.object = request.tosKey;
     requestDelegate.headerParams = [request headerParamsDict];
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeGet;
     requestDelegate.downloadProgress = request.tosDownloadProgress;
+    return requestDelegate;
+}
+
+- (TOSTask *)sendGetObject:(TOSGetObjectInput *)request {
+    NSError *error = nil;
+    TOSNetworkingRequestDelegate *requestDelegate = [self getObjectRequestDelegate:request error:&error];
+    if (!requestDelegate) {
+        return [TOSTask taskWithError:error];
+    }
     requestDelegate.onRecieveData = request.tosOnReceiveData;
-    
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeGetObject];
+    requestDelegate.discontiguousContent = request.tosDiscontiguousContent;
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeGetObject];
+}
+
+- (TOSTask *)getObject:(TOSGetObjectInput *)request intoBuffer:(void *)buffer capacity:(NSUInteger)capacity {
+    if (buffer == NULL) {
+        NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: buffer is empty"};
+        return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo]];
+    }
+    NSError *error = nil;
+    TOSNetworkingRequestDelegate *requestDelegate = [self getObjectRequestDelegate:request error:&error];
+    if (!requestDelegate) {
+        return [TOSTask taskWithError:error];
+    }
+    requestDelegate.receivingBuffer = buffer;
+    requestDelegate.receivingBufferCapacity = capacity;
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeGetObject];
 }
 
 - (TOSTask *)getObjectToFile:(TOSGetObjectToFileInput *)request {
-    TOSNetworkingRequestDelegate *requestDelegate = [[TOSNetworkingRequestDelegate alloc] init];
-    
+    TOSObjectDiskCache *cache = self.clientConfiguration.objectDiskCache;
+    if (cache && [TOSUtil isNotEmptyString:request.tosFilePath] && [self isDiskCacheableGetObject:request]) {
+        return [self getObjectToFile:request withDiskCache:cache];
+    }
+    return [self sendGetObjectToFile:request];
+}
+
+// 命中时分段直接写入目标文件；未命中时由sendGetObjectToFile:流式下载到文件，完成后再从文件写入缓存，
+// 整个过程不在内存中保留对象内容
+- (TOSTask *)getObjectToFile:(TOSGetObjectToFileInput *)request withDiskCache:(TOSObjectDiskCache *)cache {
+    BOOL ranged = request.tosRangeStart != 0 || request.tosRangeEnd != 0;
+    TOSExecutor *ioExecutor = [TOSExecutor executorWithDispatchQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)];
+    return [TOSTask taskFromExecutor:ioExecutor withBlock:^id _Nullable{
+        NSString *dirName = [request.tosFilePath stringByDeletingLastPathComponent];
+        [[NSFileManager defaultManager] createDirectoryAtPath:dirName withIntermediateDirectories:YES attributes:nil error:nil];
+        __block TOSFileSink *sink = nil;
+        __block NSError *sinkError = nil;
+        BOOL fresh = NO;
+        TOSGetObjectOutput *cached = [cache outputForBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID
+                                                 rangeStart:request.tosRangeStart rangeEnd:request.tosRangeEnd ranged:ranged fresh:&fresh
+                                                 usingBlock:^BOOL(NSData *data) {
+            if (!sink) {
+                NSError *error = nil;
+                sink = [[TOSFileSink alloc] initWithPath:request.tosFilePath syncPolicy:request.tosFileSyncPolicy error:&error];
+                if (!sink) {
+                    sinkError = error;
+                    return NO;
+                }
+            }
+            sinkError = [sink appendData:data];
+            return sinkError == nil;
+        }];
+        if (sinkError) {
+            [sink discard];
+            return [TOSTask taskWithError:sinkError];
+        }
+        if (!cached) {
+            // 未命中时已写入的部分由下载覆盖
+            [sink discard];
+        } else {
+            NSError *closeError = nil;
+            if (sink && ![sink closeWithError:&closeError]) {
+                [sink discard];
+                return [TOSTask taskWithError:closeError];
+            }
+            if (fresh) {
+                [self reportDownloadProgressOfCachedOutput:cached request:request];
+                return [self fileOutputFromOutput:cached];
+            }
+        }
+
+        int64_t generation = cache.generation;
+        TOSGetObjectToFileInput *getInput = [TOSGetObjectToFileInput new];
+        getInput.tosBucket = request.tosBucket;
+        getInput.tosKey = request.tosKey;
+        getInput.tosVersionID = request.tosVersionID;
+        getInput.tosSSECAlgorithm = request.tosSSECAlgorithm;
+        getInput.tosSSECKeyMD5 = request.tosSSECKeyMD5;
+        getInput.tosDownloadProgress = request.tosDownloadProgress;
+        getInput.tosRangeStart = request.tosRangeStart;
+        getInput.tosRangeEnd = request.tosRangeEnd;
+        getInput.tosFilePath = request.tosFilePath;
+        getInput.tosFileSyncPolicy = request.tosFileSyncPolicy;
+        if (cached) {
+            // 携带ETag校验，304时不写目标文件，保留上面从缓存写入的内容
+            getInput.tosIfNoneMatch = cached.tosETag;
+        }
+        __weak TOSGetObjectToFileInput *weakInput = getInput;
+        TOSCancellationTokenRegistration *cancellation = [request.tosCancellationToken registerCancellationObserverWithBlock:^{
+            [weakInput cancel];
+        }];
+        if (request.isCancelled) {
+            [getInput cancel];
+        }
+        return [[self sendGetObjectToFile:getInput] continueWithExecutor:ioExecutor withBlock:^id _Nullable(TOSTask * _Nonnull task) {
+            [cancellation dispose];
+            NSError *error = task.error;
+            if (cached && [error.domain isEqualToString:TOSServerErrorDomain] && error.code == 304) {
+                [cache markValidatedBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID];
+                [self reportDownloadProgressOfCachedOutput:cached request:request];
+                return [self fileOutputFromOutput:cached];
+            }
+            if (error) {
+                if (cached) {
+                    [[NSFileManager defaultManager] removeItemAtPath:request.tosFilePath error:nil];
+                }
+                return task;
+            }
+            TOSGetObjectToFileOutput *output = task.result;
+            [cache storeFileAtPath:request.tosFilePath output:output offset:request.tosRangeStart forBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID generation:generation];
+            return output;
+        }];
+    }];
+}
+
+- (TOSGetObjectToFileOutput *)fileOutputFromOutput:(TOSGetObjectOutput *)output {
+    TOSGetObjectToFileOutput *fileOutput = [TOSGetObjectToFileOutput new];
+    fileOutput.tosStatusCode = output.tosStatusCode;
+    fileOutput.tosHeader = output.tosHeader;
+    fileOutput.tosRequestID = output.tosRequestID;
+    fileOutput.tosID2 = output.tosID2;
+    fileOutput.tosContentRange = output.tosContentRange;
+    fileOutput.tosETag = output.tosETag;
+    fileOutput.tosLastModified = output.tosLastModified;
+    fileOutput.tosDeleteMarker = output.tosDeleteMarker;
+    fileOutput.tosSSECAlgorithm = output.tosSSECAlgorithm;
+    fileOutput.tosSSECKeyMD5 = output.tosSSECKeyMD5;
+    fileOutput.tosVersionID = output.tosVersionID;
+    fileOutput.tosWebsiteRedirectLocation = output.tosWebsiteRedirectLocation;
+    fileOutput.tosObjectType = output.tosObjectType;
+    fileOutput.tosHashCrc64ecma = output.tosHashCrc64ecma;
+    fileOutput.tosStorageClass = output.tosStorageClass;
+    fileOutput.tosMeta = output.tosMeta;
+    fileOutput.tosContentLength = output.tosContentLength;
+    fileOutput.tosContentType = output.tosContentType;
+    fileOutput.tosCacheControl = output.tosCacheControl;
+    fileOutput.tosContentDisposition = output.tosContentDisposition;
+    fileOutput.tosContentEncoding = output.tosContentEncoding;
+    fileOutput.tosContentLanguage = output.tosContentLanguage;
+    fileOutput.tosExpires = output.tosExpires;
+    return fileOutput;
+}
+
+- (TOSTask *)sendGetObjectToFile:(TOSGetObjectToFileInput *)request {
+    NSError *error = nil;
+    TOSNetworkingRequestDelegate *requestDelegate = [self getObjectRequestDelegate:request error:&error];
+    if (!requestDelegate) {
+        return [TOSTask taskWithError:error];
+    }
+    requestDelegate.downloadingFilePath = request.tosFilePath;
+    requestDelegate.fileSyncPolicy = request.tosFileSyncPolicy;
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeGetObjectToFile];
+}
+
+- (TOSTask *)getObjectRanges:(TOSGetObjectRangesInput *)request {
     NSError *error = nil;
     if (!self.clientConfiguration.tosEndpoint.isCustomDomain && ![TOSUtil isValidBucketName:request.tosBucket withError:&error]) {
         return [TOSTask taskWithError:error];
@@ -613,24 +1192,128 @@ static NSObject *uploadLock;
     if (![TOSUtil isValidObjectName:request.tosKey withError:&error]) {
         return [TOSTask taskWithError:error];
     }
-    
-    if (request.tosRangeEnd != 0 || request.tosRangeStart != 0) {
-        if (request.tosRangeEnd < request.tosRangeStart) {
+    if (request.tosRanges.count == 0) {
+        NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: ranges are empty"};
+        return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo]];
+    }
+    for (TOSGetObjectRange *range in request.tosRanges) {
+        if (range.tosRangeStart < 0 || range.tosRangeEnd < range.tosRangeStart) {
             NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: invalid range"};
-            error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo];
-            return [TOSTask taskWithError:error];
+            return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo]];
         }
     }
     
-    requestDelegate.bucket = request.tosBucket;
-    requestDelegate.object = request.tosKey;
-    requestDelegate.headerParams = [request headerParamsDict];
-    requestDelegate.queryParams = [request queryParamsDict];
-    requestDelegate.HTTPMethod = TOSHTTPMethodTypeGet;
-    requestDelegate.downloadingFilePath = request.tosFilePath;
-    requestDelegate.downloadProgress = request.tosDownloadProgress;
+    // 按起点排序后合并间隔不超过gap的区间，members记录每个合并区间覆盖的原始区间序号
+    int64_t gap = request.tosMergeGap == 0 ? TOSDefaultRangeMergeGap : MAX(request.tosMergeGap, 0);
+    NSArray<TOSGetObjectRange *> *ranges = [request.tosRanges copy];
+    NSMutableArray<NSNumber *> *order = [NSMutableArray arrayWithCapacity:ranges.count];
+    for (NSUInteger i = 0; i < ranges.count; i++) {
+        [order addObject:@(i)];
+    }
+    [order sortUsingComparator:^NSComparisonResult(NSNumber *obj1, NSNumber *obj2) {
+        int64_t start1 = ranges[obj1.unsignedIntegerValue].tosRangeStart;
+        int64_t start2 = ranges[obj2.unsignedIntegerValue].tosRangeStart;
+        return start1 < start2 ? NSOrderedAscending : (start1 > start2 ? NSOrderedDescending : NSOrderedSame);
+    }];
+    NSMutableArray<TOSGetObjectRange *> *groups = [NSMutableArray array];
+    NSMutableArray<NSMutableArray<NSNumber *> *> *members = [NSMutableArray array];
+    for (NSNumber *index in order) {
+        TOSGetObjectRange *range = ranges[index.unsignedIntegerValue];
+        TOSGetObjectRange *group = groups.lastObject;
+        if (group && range.tosRangeStart - group.tosRangeEnd <= gap + 1) {
+            group.tosRangeEnd = MAX(group.tosRangeEnd, range.tosRangeEnd);
+            [members.lastObject addObject:index];
+            continue;
+        }
+        group = [TOSGetObjectRange new];
+        group.tosRangeStart = range.tosRangeStart;
+        group.tosRangeEnd = range.tosRangeEnd;
+        [groups addObject:group];
+        [members addObject:[NSMutableArray arrayWithObject:index]];
+    }
+    
+    int taskNum = request.tosTaskNum > 0 ? request.tosTaskNum : 4;
+    TOSTask *groupsTask = [TOSTask taskForParallelMapOfEnumerator:groups.objectEnumerator
+                                                    maxConcurrency:taskNum
+                                                           options:0
+                                                 cancellationToken:request.tosCancellationToken
+                                                             block:^TOSTask * _Nullable(TOSGetObjectRange *group, NSUInteger index) {
+        TOSGetObjectInput *input = [TOSGetObjectInput new];
+        input.tosBucket = request.tosBucket;
+        input.tosKey = request.tosKey;
+        input.tosVersionID = request.tosVersionID;
+        input.tosIfMatch = request.tosIfMatch;
+        input.tosSSECAlgorithm = request.tosSSECAlgorithm;
+        input.tosSSECKey = request.tosSSECKey;
+        input.tosSSECKeyMD5 = request.tosSSECKeyMD5;
+        input.tosRangeStart = group.tosRangeStart;
+        // 起止均为0时getObject不携带Range，扩展1字节，多余部分在截取时丢弃
+        input.tosRangeEnd = MAX(group.tosRangeEnd, 1);
+        TOSCancellationTokenRegistration *cancellation = [request.tosCancellationToken registerCancellationObserverWithBlock:^{
+            [input cancel];
+        }];
+        if (request.isCancelled) {
+            [input cancel];
+        }
+        return [[self getObject:input] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+            [cancellation dispose];
+            return task;
+        }];
+    }];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeGetObjectToFile];
+    return [groupsTask continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        NSArray<TOSGetObjectOutput *> *outputs = task.result;
+        NSMutableArray *contents = [NSMutableArray arrayWithCapacity:ranges.count];
+        for (NSUInteger i = 0; i < ranges.count; i++) {
+            [contents addObject:[NSNull null]];
+        }
+        TOSGetObjectRangesOutput *output = [TOSGetObjectRangesOutput new];
+        output.tosObjectSize = -1;
+        for (NSUInteger i = 0; i < groups.count; i++) {
+            TOSGetObjectOutput *groupOutput = outputs[i];
+            // 未指定If-Match时以各请求返回的ETag一致性保证读取的是同一版本
+            if (output.tosETag && ![output.tosETag isEqualToString:groupOutput.tosETag]) {
+                NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: object changed during ranged reads"};
+                return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo]];
+            }
+            if (i == 0) {
+                output.tosStatusCode = groupOutput.tosStatusCode;
+                output.tosHeader = groupOutput.tosHeader;
+                output.tosRequestID = groupOutput.tosRequestID;
+                output.tosID2 = groupOutput.tosID2;
+                output.tosETag = groupOutput.tosETag;
+                output.tosVersionID = groupOutput.tosVersionID;
+            }
+            NSRange slash = [groupOutput.tosContentRange rangeOfString:@"/" options:NSBackwardsSearch];
+            if (slash.location != NSNotFound) {
+                output.tosObjectSize = [[groupOutput.tosContentRange substringFromIndex:slash.location + 1] longLongValue];
+            }
+            NSData *content = groupOutput.tosContent ?: [NSData data];
+            int64_t groupStart = groups[i].tosRangeStart;
+            for (NSNumber *index in members[i]) {
+                TOSGetObjectRange *range = ranges[index.unsignedIntegerValue];
+                int64_t from = MIN(range.tosRangeStart - groupStart, (int64_t)content.length);
+                int64_t length = MIN(range.tosRangeEnd - range.tosRangeStart + 1, (int64_t)content.length - from);
+                contents[index.unsignedIntegerValue] = [TOSClient sliceOfData:content range:NSMakeRange((NSUInteger)from, (NSUInteger)length)];
+            }
+        }
+        output.tosContents = contents;
+        output.tosRequestCount = (int)groups.count;
+        return output;
+    }];
+}
+
+// 引用data中的一段内存而不拷贝，切片存活期间保留data
++ (NSData *)sliceOfData:(NSData *)data range:(NSRange)range {
+    if (range.location == 0 && range.length == data.length) {
+        return data;
+    }
+    if (range.length == 0) {
+        return [NSData data];
+    }
+    return [[NSData alloc] initWithBytesNoCopy:(uint8_t *)data.bytes + range.location length:range.length deallocator:^(void *bytes, NSUInteger length) {
+        [data length];
+    }];
 }
 
 - (TOSTask *)getObjectAcl:(TOSGetObjectACLInput *)request {
@@ -649,10 +1332,63 @@ static NSObject *uploadLock;
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeGet;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeGetObjectACL];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeGetObjectACL];
 }
 
 - (TOSTask *)headObject:(TOSHeadObjectInput *)request {
+    TOSObjectMetadataCache *cache = self.clientConfiguration.objectMetadataCache;
+    // 条件请求和SSE-C对象不经过缓存
+    if (cache && !request.tosIfMatch && !request.tosIfModifiedSince && !request.tosIfNoneMatch &&
+        !request.tosIfUnmodifiedSince && !request.tosSSECKey &&
+        [TOSUtil isNotEmptyString:request.tosBucket] && [TOSUtil isNotEmptyString:request.tosKey]) {
+        return [self headObject:request withCache:cache];
+    }
+    return [self sendHeadObject:request];
+}
+
+- (TOSTask *)headObject:(TOSHeadObjectInput *)request withCache:(TOSObjectMetadataCache *)cache {
+    BOOL expired = NO;
+    TOSHeadObjectOutput *cached = [cache outputForBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID expired:&expired];
+    if (cached && !expired) {
+        return [TOSTask taskWithResult:cached];
+    }
+    int64_t generation = cache.generation;
+    TOSHeadObjectInput *headInput = request;
+    TOSCancellationTokenRegistration *cancellation = nil;
+    if (cached) {
+        // 携带ETag重新校验，未修改时服务端返回304
+        headInput = [TOSHeadObjectInput new];
+        headInput.tosBucket = request.tosBucket;
+        headInput.tosKey = request.tosKey;
+        headInput.tosVersionID = request.tosVersionID;
+        headInput.tosSSECAlgorithm = request.tosSSECAlgorithm;
+        headInput.tosSSECKeyMD5 = request.tosSSECKeyMD5;
+        headInput.tosIfNoneMatch = cached.tosETag;
+        __weak TOSHeadObjectInput *weakInput = headInput;
+        cancellation = [request.tosCancellationToken registerCancellationObserverWithBlock:^{
+            [weakInput cancel];
+        }];
+        if (request.isCancelled) {
+            [headInput cancel];
+        }
+    }
+    return [[self sendHeadObject:headInput] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        [cancellation dispose];
+        NSError *error = task.error;
+        if (cached && [error.domain isEqualToString:TOSServerErrorDomain] && error.code == 304) {
+            [cache refreshOutputForBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID];
+            return [TOSTask taskWithResult:cached];
+        }
+        if (!error) {
+            [cache setOutput:task.result forBucket:request.tosBucket key:request.tosKey versionID:request.tosVersionID generation:generation];
+        } else if (cached) {
+            [cache invalidateBucket:request.tosBucket key:request.tosKey];
+        }
+        return task;
+    }];
+}
+
+- (TOSTask *)sendHeadObject:(TOSHeadObjectInput *)request {
     TOSNetworkingRequestDelegate *requestDelegate = [[TOSNetworkingRequestDelegate alloc] init];
 
     NSError *error = nil;
@@ -669,7 +1405,7 @@ static NSObject *uploadLock;
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeHead;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeHead OperationType:TOSOperationTypeHeadObject];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeHead OperationType:TOSOperationTypeHeadObject];
 }
 
 - (TOSTask *)appendObject:(TOSAppendObjectInput *) request {
@@ -696,7 +1432,8 @@ static NSObject *uploadLock;
     }
     requestDelegate.HTTPMethod = TOSHTTPMethodTypePost;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeAppendObject];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeAppendObject];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 - (TOSTask *)listObjects:(TOSListObjectsInput *)request {
@@ -712,7 +1449,7 @@ static NSObject *uploadLock;
     requestDelegate.bucket = request.tosBucket;
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeGet;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListObjects];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListObjects];
 }
 
 - (TOSTask *)listObjectVersions:(TOSListObjectVersionsInput *)request {
@@ -727,7 +1464,7 @@ static NSObject *uploadLock;
     requestDelegate.bucket = request.tosBucket;
     requestDelegate.HTTPMethod = TOSHTTPMethodTypeGet;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListObjectVersions];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListObjectVersions];
 }
 
 - (TOSTask *)putObject:(TOSPutObjectInput *)request {
@@ -749,7 +1486,8 @@ static NSObject *uploadLock;
     requestDelegate.HTTPMethod = TOSHTTPMethodTypePut;
     requestDelegate.uploadProgress = request.tosUploadProgress;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutObject];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutObject];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 - (TOSTask *)putObjectFromFile:(TOSPutObjectFromFileInput *)request {
@@ -771,7 +1509,8 @@ static NSObject *uploadLock;
 //    requestDelegate.uploadingData = [NSData dataWithContentsOfFile:request.filePath];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypePut;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutObjectFromFile];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutObjectFromFile];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 - (TOSTask *)putObjectFromStream:(TOSPutObjectFromStreamInput *)request {
@@ -795,7 +1534,8 @@ static NSObject *uploadLock;
     requestDelegate.uploadProgress = request.tosUploadProgress;
     requestDelegate.HTTPMethod = TOSHTTPMethodTypePut;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutObjectFromStream];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutObjectFromStream];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 - (TOSTask *)putObjectAcl:(TOSPutObjectACLInput *)request {
@@ -816,7 +1556,7 @@ static NSObject *uploadLock;
     requestDelegate.body = [request requestBody];
     requestDelegate.HTTPMethod = TOSHTTPMethodTypePut;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutObjectACL];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypePutObjectACL];
 }
 
 - (TOSTask *)setObjectMeta:(TOSSetObjectMetaInput *)request {
@@ -835,7 +1575,8 @@ static NSObject *uploadLock;
     requestDelegate.headerParams = [request headerParamsDict];
     requestDelegate.queryParams = [request queryParamsDict];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeSetObjectMeta];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeSetObjectMeta];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 - (TOSTask *)setObjectExpires:(TOSSetObjectExpiresInput *)request {
@@ -860,7 +1601,8 @@ static NSObject *uploadLock;
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.body = [request requestBody];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeSetObjectExpires];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeSetObjectExpires];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 @end
@@ -883,7 +1625,7 @@ static NSObject *uploadLock;
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.headerParams = [request headerParamsDict];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeCreateMultipartUpload];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeCreateMultipartUpload];
 }
 
 - (TOSTask *)uploadPart:(TOSUploadPartInput *)request {
@@ -906,7 +1648,7 @@ static NSObject *uploadLock;
     requestDelegate.partNumber = [NSNumber numberWithLong:request.tosPartNumber];
     requestDelegate.uploadProgress = request.tosUploadProgress;
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeUploadPart];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeUploadPart];
 }
 
 - (TOSTask *)uploadPartFromFile:(TOSUploadPartFromFileInput *)request {
@@ -927,7 +1669,7 @@ static NSObject *uploadLock;
     requestDelegate.uploadingFileURL = [NSURL fileURLWithPath:request.tosFilePath];
     requestDelegate.partNumber = [NSNumber numberWithLong:request.tosPartNumber];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeUploadPartFromFile];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeUploadPartFromFile];
 }
 
 - (TOSTask *)uploadPartFromStream:(TOSUploadPartFromStreamInput *)request{
@@ -951,7 +1693,7 @@ static NSObject *uploadLock;
     requestDelegate.inputStream = request.tosInputStream;
     requestDelegate.partNumber = [NSNumber numberWithLong:request.tosPartNumber];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeUploadPartFromStream];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeUploadPartFromStream];
     
 }
 
@@ -972,7 +1714,8 @@ static NSObject *uploadLock;
     requestDelegate.queryParams = [request queryParamsDict];
     requestDelegate.body = [request requestBody];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeCompleteMultipartUpload];
+    TOSTask *task = [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePost OperationType:TOSOperationTypeCompleteMultipartUpload];
+    return [self invalidateCachesOfBucket:request.tosBucket keys:@[request.tosKey] afterTask:task];
 }
 
 - (TOSTask *)abortMultipartUpload:(TOSAbortMultipartUploadInput *)request {
@@ -990,7 +1733,7 @@ static NSObject *uploadLock;
     requestDelegate.object = request.tosKey;
     requestDelegate.queryParams = [request queryParamsDict];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeDelete OperationType:TOSOperationTypeAbortMultipartUpload];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeDelete OperationType:TOSOperationTypeAbortMultipartUpload];
 }
 
 - (TOSTask *)uploadPartCopy:(TOSUploadPartCopyInput *)request {
@@ -1018,7 +1761,7 @@ static NSObject *uploadLock;
     requestDelegate.headerParams = [request headerParamsDict];
     requestDelegate.partNumber = [NSNumber numberWithLong:request.tosPartNumber];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeUploadPartCopy];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypePut OperationType:TOSOperationTypeUploadPartCopy];
 }
 
 - (TOSTask *)listMultipartUploads:(TOSListMultipartUploadsInput *)request {
@@ -1032,7 +1775,7 @@ static NSObject *uploadLock;
     requestDelegate.bucket = request.tosBucket;
     requestDelegate.queryParams = [request queryParamsDict];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListMultipartUploads];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListMultipartUploads];
 }
 
 - (TOSTask *)listParts:(TOSListPartsInput *)request {
@@ -1050,17 +1793,16 @@ static NSObject *uploadLock;
     requestDelegate.object = request.tosKey;
     requestDelegate.queryParams = [request queryParamsDict];
     
-    return [self invokeRequest:requestDelegate HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListParts];
+    return [self invokeRequest:requestDelegate input:request HTTPMethod:TOSHTTPMethodTypeGet OperationType:TOSOperationTypeListParts];
 }
 
 - (TOSTask *)upload:(TOSUploadFileInput *) request
          checkPoint:(TOSUploadFileCheckpoint *)checkPoint
-     uploadedLength:(uint64_t *)uploadedLength
-           fileSize:(uint64_t)fileSize
+           progress:(TOSProgressAggregator *)progress
 {
     NSOperationQueue *queue = [[NSOperationQueue alloc] init];
     [queue setMaxConcurrentOperationCount: request.tosTaskNum];
-    NSObject *localLock = [[NSObject alloc] init];
+    TOSExecutor *partExecutor = [TOSExecutor executorWithOperationQueue:queue];
     __block TOSTask *errorTask;
     // 打开待传文件句柄
     NSError *readError;
@@ -1070,77 +1812,76 @@ static NSObject *uploadLock;
         return [TOSTask taskWithError:readError];
     }
     
-    NSData *uploadPartData;
-    __block BOOL hasError = NO;
+    // 分段在其他线程上传，需显式传递父Span
+    TOSSpan *parentSpan = self.clientConfiguration.tracer ? [TOSSpan currentSpan] : nil;
     
+    NSMutableArray<TOSUploadPartInfo *> *pendingParts = [NSMutableArray array];
     for (TOSUploadPartInfo *partInfo in checkPoint.tosPartsInfo) {
-        
-        if (request.isCancelled) {
-            [queue cancelAllOperations];
-            break;
+        if (!partInfo.tosIsCompleted) {
+            [pendingParts addObject:partInfo];
         }
-        
-//        TOSUploadPartInfo *partInfo = [checkPoint.tosPartsInfo objectAtIndex:idx];
-        if (partInfo.tosIsCompleted) {
-            continue;
-        }
-        while (queue.operationCount >= request.tosTaskNum) {
-            [NSThread sleepForTimeInterval: 0.15f];
+    }
+    
+    // 同时在传的分片数不超过tosTaskNum，前一个分片完成后才读取下一个分片的数据；
+    // 读文件出错或取消后不再发起新分片，已发起的分片仍等待其结束
+    TOSTask *partsTask = [TOSTask taskForParallelMapOfEnumerator:pendingParts.objectEnumerator
+                                                  maxConcurrency:request.tosTaskNum
+                                                         options:TOSTaskMapOptionsUnordered | TOSTaskMapOptionsCollectErrors
+                                               cancellationToken:nil
+                                                           block:^TOSTask * _Nullable(TOSUploadPartInfo *partInfo, NSUInteger index) {
+        if (request.isCancelled || errorTask) {
+            return [TOSTask cancelledTask];
         }
+        NSData *uploadPartData;
         @autoreleasepool {
             if (@available(iOS 13.0, *)) {
                 NSError *error = nil;
                 [fileHandle seekToOffset:partInfo.tosOffset error:&error];
-                if (error) {
-                    hasError = YES;
-                    errorTask = [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain
-                                                                           code:400
-                                                                       userInfo:[error userInfo]]];
-                    break;
+                if (!error) {
+                    uploadPartData = [fileHandle readDataUpToLength:(unsigned int)partInfo.tosPartSize error:&error];
                 }
-                error = nil;
-                uploadPartData = [fileHandle readDataUpToLength:(unsigned int)partInfo.tosPartSize error:&error];
                 if (error) {
-                    hasError = YES;
                     errorTask = [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain
                                                                            code:400
                                                                        userInfo:[error userInfo]]];
-                    break;
+                    return [TOSTask cancelledTask];
                 }
             } else {
                 [fileHandle seekToFileOffset: partInfo.tosOffset];
                 uploadPartData = [fileHandle readDataOfLength:(unsigned int)partInfo.tosPartSize];
             }
+        } // autorelease
+        
+        return [TOSTask taskFromExecutor:partExecutor withBlock:^id _Nullable{
+            __block TOSTask *uploadPartErrorTask = nil;
             
-            NSBlockOperation *operation = [NSBlockOperation blockOperationWithBlock:^{
-                TOSTask *uploadPartErrorTask = nil;
-                
+            [TOSSpan performWithSpan:parentSpan block:^id _Nullable{
+                TOSTask *partErrorTask = nil;
                 [self executeUploadPartData:request
                                  checkPoint:checkPoint
                                    partInfo:partInfo
                                    partData:uploadPartData
-                                  errorTask:&uploadPartErrorTask
-                             totalBytesSent:uploadedLength
-                   totalBytesExpectedToSend:fileSize];
-                
-                if (uploadPartErrorTask != nil) {
-                    @synchronized (localLock) {
-                        if (!hasError) {
-                            hasError = YES;
-                            errorTask = uploadPartErrorTask;
-                        }
-                    }
-                    uploadPartErrorTask = nil;
-                }
+                                  errorTask:&partErrorTask
+                                   progress:progress];
+                uploadPartErrorTask = partErrorTask;
+                return nil;
             }];
-            [queue addOperation:operation];
-        } // autorelease
-    } // for
+            return uploadPartErrorTask;
+        }];
+    }];
+    [partsTask waitUntilFinished]; // 等待所有分片执行完毕
     [fileHandle closeFile]; // 关闭文件句柄
 
     // newTosClientError("tos: some upload tasks failed.", nil)
-    [queue waitUntilAllOperationsAreFinished]; // 等待所有子线程执行完毕
-    localLock = nil;
+    if (!errorTask && partsTask.error) {
+        // 与之前保持一致，返回首个失败分片的错误
+        NSError *partError = partsTask.error;
+        NSArray<NSError *> *partErrors = partError.userInfo[TOSTaskMultipleErrorsUserInfoKey];
+        if ([partError.domain isEqualToString:TOSTaskErrorDomain] && partError.code == kTOSMultipleErrorsError && partErrors.count > 0) {
+            partError = partErrors.firstObject;
+        }
+        errorTask = [TOSTask taskWithError:partError];
+    }
     if (!errorTask && request.isCancelled) { // errorTask为空 && isCancelled == true
         errorTask = [TOSTask taskWithError:[TOSClient cancelError]];
     }
@@ -1152,8 +1893,7 @@ static NSObject *uploadLock;
                      partInfo:(TOSUploadPartInfo *)partInfo
                      partData:(NSData *)partData
                     errorTask:(TOSTask **)errorTask
-               totalBytesSent:(uint64_t *)totalBytesSent
-     totalBytesExpectedToSend:(uint64_t)totalBytesExpectedToSend
+                     progress:(TOSProgressAggregator *)progress
 {
     TOSUploadPartInput *uploadInput = [TOSUploadPartInput new];
     uploadInput.tosBucket = request.tosBucket;
@@ -1162,20 +1902,28 @@ static NSObject *uploadLock;
     uploadInput.tosUploadID = checkPoint.tosUploadID;
     uploadInput.tosContent = partData;
     uploadInput.tosContentMD5 = [TOSUtil base64Md5FromData:partData];
-    // 进度条功能 2.2.0
-//    if (request.tosUploadProgress) {
-//        uploadInput.tosUploadProgress = ^(int64_t bytesSent, int64_t totalSent, int64_t totalExpectedToSend) {
-//            @synchronized (uploadLock) {
-//                *totalBytesSent += bytesSent;
-//            }
-//            request.tosUploadProgress(bytesSent, *totalBytesSent, totalBytesExpectedToSend);
-//        };
-//    }
-    
-    
+    // 各分片的进度汇总到同一个聚合器
+    __block int64_t partBytesSent = 0;
+    if (progress) {
+        uploadInput.tosUploadProgress = ^(int64_t bytesSent, int64_t totalSent, int64_t totalExpectedToSend) {
+            partBytesSent += bytesSent;
+            [progress addBytes:bytesSent];
+        };
+    }
+    
+    // uploadFile被取消时立即中断在传的分片
+    TOSCancellationTokenRegistration *cancellation = [request.tosCancellationToken registerCancellationObserverWithBlock:^{
+        [uploadInput cancel];
+    }];
+    if (request.isCancelled) {
+        [uploadInput cancel];
+    }
     TOSTask *uploadTask = [self uploadPart:uploadInput];
     [uploadTask waitUntilFinished];
+    [cancellation dispose];
     if (uploadTask.error) {
+        // 分片失败，回退该分片已计入的进度
+        [progress addBytes:-partBytesSent];
         // abort黑名单
         if (uploadTask.error.code == 403 || uploadTask.error.code == 404 || uploadTask.error.code == 405) {
             if (request.tosUploadEventListener) {
@@ -1352,7 +2100,8 @@ static NSObject *uploadLock;
     if (checkTask) {
         return checkTask;
     }
-    return [[TOSTask taskWithResult:nil] continueWithExecutor:self.tosOperationExecutor withBlock:^id _Nullable(TOSTask * _Nonnull task) {
+    // 子请求（创建/上传分段/合并/取消）均挂在uploadFile的Span下
+    id _Nullable (^uploadBlock)(void) = ^id _Nullable {
         __block uint64_t uploadedLength = 0;
         __block TOSTask * errorTask;
         
@@ -1401,9 +2150,6 @@ static NSObject *uploadLock;
                             uploadedLength += info.tosPartSize;
                         }
                     }
-//                    if (request.tosUploadProgress && uploadedLength > 0 && fileSize > 0) {
-//                        request.tosUploadProgress(0, uploadedLength, fileSize);
-//                    }
                 } else {
                     // CheckPoint文件失效
                     TOSTask *abortTask = [self abortUploadFile:request uploadID:checkPoint.tosUploadID];
@@ -1431,10 +2177,21 @@ static NSObject *uploadLock;
             return [TOSTask taskWithError:[TOSClient cancelError]];
         }
         
+        TOSProgressAggregator *progress = nil;
+        if (request.tosUploadProgress) {
+            // 已完成的分片计入初始进度
+            progress = [[TOSProgressAggregator alloc] initWithBlock:request.tosUploadProgress
+                                                    minimumInterval:self.clientConfiguration.progressReportInterval
+                                                       minimumBytes:self.clientConfiguration.progressReportBytes
+                                                           executor:self.clientConfiguration.progressExecutor];
+            progress.totalBytesExpected = fileSize;
+            [progress addBytes:uploadedLength];
+        }
+        
         errorTask = [self upload:request
                       checkPoint:checkPoint
-                  uploadedLength:&uploadedLength
-                        fileSize:fileSize];
+                        progress:progress];
+        [progress flush];
         
         if (errorTask.error) {
             // Abort本次上传任务
@@ -1465,11 +2222,612 @@ static NSObject *uploadLock;
         
         // crc64校验
         return [self postUpload:request checkPoint:checkPoint];
+    };
+    return [self runOperation:@"uploadFile" request:request userRequest:uploadRequest block:uploadBlock];
+}
+
+- (TOSTask *)validateCopyFileRequest:(TOSCopyFileInput *)request {
+    NSError *error = nil;
+    if (!self.clientConfiguration.tosEndpoint.isCustomDomain && ![TOSUtil isValidBucketName:request.tosBucket withError:&error]) {
+        return [TOSTask taskWithError:error];
+    }
+    if (![TOSUtil isValidObjectName:request.tosKey withError:&error]) {
+        return [TOSTask taskWithError:error];
+    }
+    if (!self.clientConfiguration.tosEndpoint.isCustomDomain && ![TOSUtil isValidBucketName:request.tosSrcBucket withError:&error]) {
+        return [TOSTask taskWithError:error];
+    }
+    if (![TOSUtil isValidObjectName:request.tosSrcKey withError:&error]) {
+        return [TOSTask taskWithError:error];
+    }
+    int64_t partSize = request.tosPartSize;
+    int taskNum = request.tosTaskNum;
+    error = [self normalizePartSize:&partSize taskNum:&taskNum];
+    if (error) {
+        return [TOSTask taskWithError:error];
+    }
+    request.tosPartSize = partSize;
+    request.tosTaskNum = taskNum;
+    if (request.tosCopyThreshold <= 0) {
+        request.tosCopyThreshold = TOSDefaultCopyThreshold;
+    }
+    // CopyObject单次最多复制5GB
+    if (request.tosCopyThreshold > TOSMaxPartSize) {
+        request.tosCopyThreshold = TOSMaxPartSize;
+    }
+    
+    if (request.tosEnableCheckpoint) {
+        NSString *originalString = [NSString stringWithFormat:@"%@.%@.%@.%@", request.tosSrcBucket, request.tosSrcKey, request.tosBucket, request.tosKey];
+        NSData *originalData = [originalString dataUsingEncoding:NSUTF8StringEncoding];
+        NSString *base64String = [originalData base64EncodedStringWithOptions:0];
+        base64String = [base64String stringByReplacingOccurrencesOfString:@"/" withString:@"_"];
+        base64String = [base64String stringByReplacingOccurrencesOfString:@"+" withString:@"-"];
+        NSString *fileName = [NSString stringWithFormat:@"%@.%@", base64String, @"copy"];
+        
+        if ([TOSUtil isNotEmptyString:request.tosCheckpointFile]) {
+            BOOL isDir = false;
+            BOOL isExist = [[NSFileManager defaultManager] fileExistsAtPath:request.tosCheckpointFile isDirectory:&isDir];
+            if (isExist && isDir) {
+                request.tosCheckpointFile = [request.tosCheckpointFile stringByAppendingPathComponent:fileName];
+            }
+        } else {
+            request.tosCheckpointFile = [NSTemporaryDirectory() stringByAppendingPathComponent:fileName];
+        }
+    }
+    return nil;
+}
+
+- (TOSCopyFileCheckpoint *)getCopyCheckpoint:(TOSCopyFileInput *)request {
+    if (![[NSFileManager defaultManager] fileExistsAtPath:request.tosCheckpointFile]) {
+        return nil;
+    }
+    TOSCopyFileCheckpoint *checkPoint = [NSKeyedUnarchiver unarchiveObjectWithFile:request.tosCheckpointFile];
+    if (checkPoint && [checkPoint isKindOfClass:[TOSCopyFileCheckpoint class]]) {
+        return checkPoint;
+    }
+    return nil;
+}
+
+// 源对象、目标对象和分段大小均未变化时CheckPoint有效
+- (BOOL)isValidCopyCheckpoint:(TOSCopyFileCheckpoint *)checkPoint
+                      request:(TOSCopyFileInput *)request
+                   headOutput:(TOSHeadObjectOutput *)headOutput
+{
+    return [checkPoint.tosBucket isEqualToString:request.tosBucket] &&
+           [checkPoint.tosKey isEqualToString:request.tosKey] &&
+           [checkPoint.tosSrcBucket isEqualToString:request.tosSrcBucket] &&
+           [checkPoint.tosSrcKey isEqualToString:request.tosSrcKey] &&
+           (checkPoint.tosSrcVersionID == request.tosSrcVersionID || [checkPoint.tosSrcVersionID isEqualToString:request.tosSrcVersionID]) &&
+           [checkPoint.tosSrcETag isEqualToString:headOutput.tosETag] &&
+           checkPoint.tosSrcObjectSize == (uint64_t)headOutput.tosContentLength &&
+           checkPoint.tosPartSize == request.tosPartSize &&
+           [TOSUtil isNotEmptyString:checkPoint.tosUploadID];
+}
+
+// 目标对象的元数据：未指定时沿用源对象（与CopyObject的COPY语义一致）
+- (BOOL)copyFileReplacesMetadata:(TOSCopyFileInput *)request {
+    return request.tosMeta != nil || request.tosContentType != nil;
+}
+
+- (TOSCopyFileCheckpoint *)createCopyCheckpoint:(TOSCopyFileInput *)request
+                                     headOutput:(TOSHeadObjectOutput *)headOutput
+                                      withError:(NSError **)error
+{
+    uint64_t objectSize = (uint64_t)headOutput.tosContentLength;
+    uint64_t partCount = objectSize / request.tosPartSize;
+    uint64_t lastPartSize = objectSize % request.tosPartSize;
+    if (lastPartSize) {
+        partCount++;
+    }
+    if (partCount > TOSMaxPartCount) {
+        NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: unsupported part number, the maximum is 10000"};
+        *error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo];
+        return nil;
+    }
+    
+    TOSCreateMultipartUploadInput *createInput = [TOSCreateMultipartUploadInput new];
+    createInput.tosBucket = request.tosBucket;
+    createInput.tosKey = request.tosKey;
+    createInput.tosEncodingType = request.tosEncodingType;
+    createInput.tosACL = request.tosACL;
+    createInput.tosGrantFullControl = request.tosGrantFullControl;
+    createInput.tosGrantRead = request.tosGrantRead;
+    createInput.tosGrantReadAcp = request.tosGrantReadAcp;
+    createInput.tosGrantWriteAcp = request.tosGrantWriteAcp;
+    createInput.tosSSECAlgorithm = request.tosSSECAlgorithm;
+    createInput.tosSSECKey = request.tosSSECKey;
+    createInput.tosSSECKeyMD5 = request.tosSSECKeyMD5;
+    createInput.tosServerSideEncryption = request.tosServerSideEncryption;
+    createInput.tosWebsiteRedirectLocation = request.tosWebsiteRedirectLocation;
+    createInput.tosStorageClass = request.tosStorageClass;
+    if ([self copyFileReplacesMetadata:request]) {
+        createInput.tosCacheControl = request.tosCacheControl;
+        createInput.tosContentDisposition = request.tosContentDisposition;
+        createInput.tosContentEncoding = request.tosContentEncoding;
+        createInput.tosContentLanguage = request.tosContentLanguage;
+        createInput.tosContentType = request.tosContentType;
+        createInput.tosExpires = request.tosExpires;
+        createInput.tosMeta = request.tosMeta;
+    } else {
+        createInput.tosCacheControl = headOutput.tosCacheControl;
+        createInput.tosContentDisposition = headOutput.tosContentDisposition;
+        createInput.tosContentEncoding = headOutput.tosContentEncoding;
+        createInput.tosContentLanguage = headOutput.tosContentLanguage;
+        createInput.tosContentType = headOutput.tosContentType;
+        createInput.tosExpires = headOutput.tosExpires;
+        createInput.tosMeta = headOutput.tosMeta;
+    }
+    
+    TOSTask *task = [self createMultipartUpload:createInput];
+    [task waitUntilFinished];
+    if (task.error) {
+        *error = task.error;
+        return nil;
+    }
+    TOSCreateMultipartUploadOutput *createOutput = task.result;
+    
+    TOSCopyFileCheckpoint *checkPoint = [TOSCopyFileCheckpoint new];
+    checkPoint.tosBucket = request.tosBucket;
+    checkPoint.tosKey = request.tosKey;
+    checkPoint.tosSrcBucket = request.tosSrcBucket;
+    checkPoint.tosSrcKey = request.tosSrcKey;
+    checkPoint.tosSrcVersionID = request.tosSrcVersionID;
+    checkPoint.tosSrcETag = headOutput.tosETag;
+    checkPoint.tosSrcObjectSize = objectSize;
+    checkPoint.tosSrcHashCrc64ecma = headOutput.tosHashCrc64ecma;
+    checkPoint.tosPartSize = request.tosPartSize;
+    checkPoint.tosUploadID = createOutput.tosUploadID;
+    
+    NSMutableArray<TOSUploadPartInfo *> *parts = [NSMutableArray array];
+    for (uint64_t i = 0; i < partCount; i++) {
+        TOSUploadPartInfo *p = [TOSUploadPartInfo new];
+        p.tosPartNumber = (int)(i + 1);
+        p.tosPartSize = request.tosPartSize;
+        p.tosOffset = (int64_t)i * request.tosPartSize;
+        p.tosIsCompleted = false;
+        [parts addObject:p];
+    }
+    if (lastPartSize != 0) {
+        parts[(int)(partCount - 1)].tosPartSize = (int64_t)lastPartSize;
+    }
+    checkPoint.tosPartsInfo = parts;
+    
+    if (request.tosEnableCheckpoint) {
+        BOOL isOK = [NSKeyedArchiver archiveRootObject:checkPoint toFile:request.tosCheckpointFile];
+        if (!isOK) {
+            NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: write checkpoint file failed"};
+            *error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo];
+            return nil;
+        }
+    }
+    return checkPoint;
+}
+
+- (TOSTask *)copyParts:(TOSCopyFileInput *)request
+            checkPoint:(TOSCopyFileCheckpoint *)checkPoint
+              progress:(TOSProgressAggregator *)progress
+{
+    NSMutableArray<TOSUploadPartInfo *> *pendingParts = [NSMutableArray array];
+    for (TOSUploadPartInfo *partInfo in checkPoint.tosPartsInfo) {
+        if (!partInfo.tosIsCompleted) {
+            [pendingParts addObject:partInfo];
+        }
+    }
+    
+    // 分段完成后的断点文件写入及下一分段的发起放在独立的串行队列上，不占用会话回调队列；
+    // 不复用tosOperationExecutor，其并发数有限且当前线程正阻塞等待
+    TOSExecutor *checkpointExecutor = [TOSExecutor executorWithDispatchQueue:dispatch_queue_create("com.volces.tos.copyFileCheckpoint", DISPATCH_QUEUE_SERIAL)];
+    // 数据在服务端复制，分段请求直接异步等待，无需占用线程
+    TOSTask *partsTask = [TOSTask taskForParallelMapOfEnumerator:pendingParts.objectEnumerator
+                                                  maxConcurrency:request.tosTaskNum
+                                                         options:TOSTaskMapOptionsUnordered | TOSTaskMapOptionsCollectErrors
+                                               cancellationToken:request.tosCancellationToken
+                                                           block:^TOSTask * _Nullable(TOSUploadPartInfo *partInfo, NSUInteger index) {
+        TOSUploadPartCopyInput *copyInput = [TOSUploadPartCopyInput new];
+        copyInput.tosBucket = request.tosBucket;
+        copyInput.tosKey = request.tosKey;
+        copyInput.tosUploadID = checkPoint.tosUploadID;
+        copyInput.tosPartNumber = partInfo.tosPartNumber;
+        copyInput.tosSrcBucket = request.tosSrcBucket;
+        copyInput.tosSrcKey = request.tosSrcKey;
+        copyInput.tosSrcVersionID = request.tosSrcVersionID;
+        copyInput.tosCopySourceRangeStart = partInfo.tosOffset;
+        copyInput.tosCopySourceRangeEnd = partInfo.tosOffset + partInfo.tosPartSize - 1;
+        // 源对象在复制过程中被覆盖时分段失败，避免拼接出不一致的对象
+        copyInput.tosCopySourceIfMatch = checkPoint.tosSrcETag;
+        copyInput.tosCopySourceSSECAlgorithm = request.tosCopySourceSSECAlgorithm;
+        copyInput.tosCopySourceSSECKey = request.tosCopySourceSSECKey;
+        copyInput.tosCopySourceSSECKeyMD5 = request.tosCopySourceSSECKeyMD5;
+        
+        TOSCancellationTokenRegistration *cancellation = [request.tosCancellationToken registerCancellationObserverWithBlock:^{
+            [copyInput cancel];
+        }];
+        if (request.isCancelled) {
+            [copyInput cancel];
+        }
+        return [[self uploadPartCopy:copyInput] continueWithExecutor:checkpointExecutor withBlock:^id _Nullable(TOSTask * _Nonnull task) {
+            [cancellation dispose];
+            if (task.error) {
+                return task;
+            }
+            TOSUploadPartCopyOutput *copyOutput = task.result;
+            partInfo.tosETag = copyOutput.tosETag;
+            partInfo.tosHashCrc64ecma = copyOutput.tosHashCrc64ecma;
+            partInfo.tosIsCompleted = YES;
+            [progress addBytes:partInfo.tosPartSize];
+            
+            @synchronized (uploadLock) {
+                if (request.tosEnableCheckpoint) {
+                    BOOL isOK = [NSKeyedArchiver archiveRootObject:checkPoint toFile:request.tosCheckpointFile];
+                    if (!isOK) {
+                        NSDictionary *userInfo = @{TOSErrorMessageTOKEN: @"tos: write checkpoint file failed"};
+                        return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:userInfo]];
+                    }
+                }
+            }
+            return nil;
+        }];
+    }];
+    [partsTask waitUntilFinished];
+    
+    if (partsTask.error) {
+        // 返回首个失败分段的错误
+        NSError *partError = partsTask.error;
+        NSArray<NSError *> *partErrors = partError.userInfo[TOSTaskMultipleErrorsUserInfoKey];
+        if ([partError.domain isEqualToString:TOSTaskErrorDomain] && partError.code == kTOSMultipleErrorsError && partErrors.count > 0) {
+            partError = partErrors.firstObject;
+        }
+        return [TOSTask taskWithError:partError];
+    }
+    if (partsTask.cancelled || request.isCancelled) {
+        return [TOSTask taskWithError:[TOSClient cancelError]];
+    }
+    return nil;
+}
+
+- (TOSTask *)postCopy:(TOSCopyFileInput *)request
+           checkPoint:(TOSCopyFileCheckpoint *)checkPoint
+{
+    TOSCompleteMultipartUploadInput *completeInput = [TOSCompleteMultipartUploadInput new];
+    completeInput.tosBucket = request.tosBucket;
+    completeInput.tosKey = request.tosKey;
+    completeInput.tosUploadID = checkPoint.tosUploadID;
+    NSMutableArray<TOSUploadedPart *> *parts = [NSMutableArray array];
+    for (TOSUploadPartInfo *info in checkPoint.tosPartsInfo) {
+        TOSUploadedPart *p = [TOSUploadedPart new];
+        p.tosPartNumber = info.tosPartNumber;
+        p.tosETag = info.tosETag;
+        p.tosSize = info.tosPartSize;
+        [parts addObject:p];
+    }
+    completeInput.tosParts = parts;
+    
+    TOSTask *task = [self completeMultipartUpload:completeInput];
+    [task waitUntilFinished];
+    if (task.error) {
+        return task;
+    }
+    TOSCompleteMultipartUploadOutput *completeOutput = task.result;
+    
+    // CRC64校验：合并后的对象与源对象一致；各分段均返回CRC时，分段CRC合并结果与合并后的对象一致
+    BOOL mismatch = checkPoint.tosSrcHashCrc64ecma != 0 && completeOutput.tosHashCrc64ecma != 0 &&
+                    checkPoint.tosSrcHashCrc64ecma != completeOutput.tosHashCrc64ecma;
+    BOOL hasPartCRC = completeOutput.tosHashCrc64ecma != 0;
+    uint64_t combinedCRC64 = 0;
+    for (TOSUploadPartInfo *info in checkPoint.tosPartsInfo) {
+        if (info.tosHashCrc64ecma == 0 && info.tosPartSize > 0) {
+            hasPartCRC = NO;
+            break;
+        }
+        combinedCRC64 = [TOSUtil crc64ForCombineCRC1:combinedCRC64 CRC2:info.tosHashCrc64ecma length:(uintmax_t)info.tosPartSize];
+    }
+    if (hasPartCRC && combinedCRC64 != completeOutput.tosHashCrc64ecma) {
+        mismatch = YES;
+    }
+    if (mismatch) {
+        NSError *error = [NSError errorWithDomain:TOSClientErrorDomain
+                                             code:400
+                                         userInfo:@{TOSErrorMessageTOKEN: @"tos: crc of entire file mismatch"}];
+        return [TOSTask taskWithError:error];
+    }
+    
+    TOSCopyFileOutput *result = [TOSCopyFileOutput new];
+    result.tosRequestID = completeOutput.tosRequestID;
+    result.tosID2 = completeOutput.tosID2;
+    result.tosStatusCode = completeOutput.tosStatusCode;
+    result.tosHeader = completeOutput.tosHeader;
+    
+    result.tosBucket = request.tosBucket;
+    result.tosKey = request.tosKey;
+    result.tosUploadID = checkPoint.tosUploadID;
+    result.tosETag = completeOutput.tosETag;
+    result.tosVersionID = completeOutput.tosVersionID;
+    result.tosCopySourceVersionID = request.tosSrcVersionID;
+    result.tosHashCrc64ecma = completeOutput.tosHashCrc64ecma;
+    result.tosPartCount = (int)checkPoint.tosPartsInfo.count;
+    return [TOSTask taskWithResult:result];
+}
+
+- (TOSTask *)copySmallObject:(TOSCopyFileInput *)request
+                  headOutput:(TOSHeadObjectOutput *)headOutput
+{
+    TOSCopyObjectInput *copyInput = [TOSCopyObjectInput new];
+    copyInput.tosBucket = request.tosBucket;
+    copyInput.tosKey = request.tosKey;
+    copyInput.tosSrcBucket = request.tosSrcBucket;
+    copyInput.tosSrcKey = request.tosSrcKey;
+    copyInput.tosSrcVersionID = request.tosSrcVersionID;
+    copyInput.tosCopySourceIfMatch = headOutput.tosETag;
+    copyInput.tosCopySourceSSECAlgorithm = request.tosCopySourceSSECAlgorithm;
+    copyInput.tosCopySourceSSECKey = request.tosCopySourceSSECKey;
+    copyInput.tosCopySourceSSECKeyMD5 = request.tosCopySourceSSECKeyMD5;
+    copyInput.tosServerSideEncryption = request.tosServerSideEncryption;
+    copyInput.tosACL = request.tosACL;
+    copyInput.tosGrantFullControl = request.tosGrantFullControl;
+    copyInput.tosGrantRead = request.tosGrantRead;
+    copyInput.tosGrantReadAcp = request.tosGrantReadAcp;
+    copyInput.tosGrantWriteAcp = request.tosGrantWriteAcp;
+    copyInput.tosWebsiteRedirectLocation = request.tosWebsiteRedirectLocation;
+    copyInput.tosStorageClass = request.tosStorageClass;
+    if ([self copyFileReplacesMetadata:request]) {
+        copyInput.tosMetadataDirective = TOSMetadataDirectiveReplace;
+        copyInput.tosCacheControl = request.tosCacheControl;
+        copyInput.tosContentDisposition = request.tosContentDisposition;
+        copyInput.tosContentEncoding = request.tosContentEncoding;
+        copyInput.tosContentLanguage = request.tosContentLanguage;
+        copyInput.tosContentType = request.tosContentType;
+        copyInput.tosExpires = request.tosExpires;
+        copyInput.tosMeta = request.tosMeta;
+    }
+    
+    TOSCancellationTokenRegistration *cancellation = [request.tosCancellationToken registerCancellationObserverWithBlock:^{
+        [copyInput cancel];
     }];
+    if (request.isCancelled) {
+        [copyInput cancel];
+    }
+    TOSTask *task = [self copyObject:copyInput];
+    [task waitUntilFinished];
+    [cancellation dispose];
+    if (task.error) {
+        return task;
+    }
+    TOSCopyObjectOutput *copyOutput = task.result;
+    
+    TOSCopyFileOutput *result = [TOSCopyFileOutput new];
+    result.tosRequestID = copyOutput.tosRequestID;
+    result.tosID2 = copyOutput.tosID2;
+    result.tosStatusCode = copyOutput.tosStatusCode;
+    result.tosHeader = copyOutput.tosHeader;
+    
+    result.tosBucket = request.tosBucket;
+    result.tosKey = request.tosKey;
+    result.tosETag = copyOutput.tosETag;
+    result.tosVersionID = copyOutput.tosVersionID;
+    result.tosCopySourceVersionID = copyOutput.tosCopySourceVersionID;
+    result.tosHashCrc64ecma = headOutput.tosHashCrc64ecma;
+    return [TOSTask taskWithResult:result];
 }
+
+- (void)abortCopyFile:(TOSCopyFileInput *)request
+             uploadID:(NSString *)uploadID
+{
+    if (request.tosEnableCheckpoint && [[NSFileManager defaultManager] fileExistsAtPath:request.tosCheckpointFile]) {
+        [[NSFileManager defaultManager] removeItemAtPath:request.tosCheckpointFile error:nil];
+    }
+    TOSAbortMultipartUploadInput *abortInput = [TOSAbortMultipartUploadInput new];
+    abortInput.tosBucket = request.tosBucket;
+    abortInput.tosKey = request.tosKey;
+    abortInput.tosUploadID = uploadID;
+    [[self abortMultipartUpload:abortInput] waitUntilFinished];
+}
+
+- (TOSTask *)copyFile:(TOSCopyFileInput *)copyRequest {
+    // 拷贝原Request，避免修改用户Request请求
+    TOSCopyFileInput *request = [copyRequest mutableCopy];
+    
+    TOSTask *checkTask = [self validateCopyFileRequest:request];
+    if (checkTask) {
+        return checkTask;
+    }
+    id _Nullable (^copyBlock)(void) = ^id _Nullable {
+        // 获取源对象信息
+        TOSHeadObjectInput *headInput = [TOSHeadObjectInput new];
+        headInput.tosBucket = request.tosSrcBucket;
+        headInput.tosKey = request.tosSrcKey;
+        headInput.tosVersionID = request.tosSrcVersionID;
+        headInput.tosSSECAlgorithm = request.tosCopySourceSSECAlgorithm;
+        headInput.tosSSECKey = request.tosCopySourceSSECKey;
+        headInput.tosSSECKeyMD5 = request.tosCopySourceSSECKeyMD5;
+        TOSTask *headTask = [self headObject:headInput];
+        [headTask waitUntilFinished];
+        if (headTask.error) {
+            return headTask;
+        }
+        TOSHeadObjectOutput *headOutput = headTask.result;
+        
+        if (request.isCancelled) {
+            return [TOSTask taskWithError:[TOSClient cancelError]];
+        }
+        
+        // 小对象一次CopyObject即可完成
+        if (headOutput.tosContentLength <= request.tosCopyThreshold) {
+            return [self copySmallObject:request headOutput:headOutput];
+        }
+        
+        NSError *error = nil;
+        uint64_t copiedLength = 0;
+        TOSCopyFileCheckpoint *checkPoint = nil;
+        if (request.tosEnableCheckpoint) {
+            checkPoint = [self getCopyCheckpoint:request];
+            if (checkPoint && ![self isValidCopyCheckpoint:checkPoint request:request headOutput:headOutput]) {
+                // CheckPoint失效
+                if ([TOSUtil isNotEmptyString:checkPoint.tosUploadID]) {
+                    [self abortCopyFile:request uploadID:checkPoint.tosUploadID];
+                }
+                checkPoint = nil;
+            }
+            for (TOSUploadPartInfo *info in checkPoint.tosPartsInfo) {
+                if (info.tosIsCompleted) {
+                    copiedLength += info.tosPartSize;
+                }
+            }
+        }
+        if (!checkPoint) {
+            checkPoint = [self createCopyCheckpoint:request headOutput:headOutput withError:&error];
+            if (!checkPoint) {
+                return [TOSTask taskWithError:error];
+            }
+        }
+        
+        TOSProgressAggregator *progress = nil;
+        if (request.tosCopyProgress) {
+            progress = [[TOSProgressAggregator alloc] initWithBlock:request.tosCopyProgress
+                                                    minimumInterval:self.clientConfiguration.progressReportInterval
+                                                       minimumBytes:self.clientConfiguration.progressReportBytes
+                                                           executor:self.clientConfiguration.progressExecutor];
+            progress.totalBytesExpected = (int64_t)checkPoint.tosSrcObjectSize;
+            [progress addBytes:copiedLength];
+        }
+        
+        TOSTask *errorTask = [self copyParts:request checkPoint:checkPoint progress:progress];
+        [progress flush];
+        if (!errorTask) {
+            errorTask = [self postCopy:request checkPoint:checkPoint];
+            if (!errorTask.error) {
+                if (request.tosEnableCheckpoint && [[NSFileManager defaultManager] fileExistsAtPath:request.tosCheckpointFile]) {
+                    [[NSFileManager defaultManager] removeItemAtPath:request.tosCheckpointFile error:nil];
+                }
+                return errorTask;
+            }
+        }
+        
+        // 未开启断点续传或错误不可重试时取消分段任务；否则保留CheckPoint，等待用户重试
+        NSInteger code = errorTask.error.code;
+        BOOL retryable = request.tosEnableCheckpoint && code != 403 && code != 404 && code != 405 && code != 412;
+        if (!retryable) {
+            [self abortCopyFile:request uploadID:checkPoint.tosUploadID];
+        }
+        return errorTask;
+    };
+    return [self runOperation:@"copyFile" request:request userRequest:copyRequest block:copyBlock];
+}
+@end
+
+
+@implementation TOSClient (Prewarm)
+
+- (TOSTask *)prewarm:(TOSPrewarmInput *)request {
+    if (request.tosConnectionCount < 0 || request.tosKeepAliveInterval < 0) {
+        return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: invalid prewarm connection count or keep-alive interval"}]];
+    }
+    NSError *error = nil;
+    if (!self.clientConfiguration.tosEndpoint.isCustomDomain) {
+        for (NSString *bucket in request.tosBuckets) {
+            if (![TOSUtil isValidBucketName:bucket withError:&error]) {
+                return [TOSTask taskWithError:error];
+            }
+        }
+    }
+    if (request.tosKey && ![TOSUtil isValidObjectName:request.tosKey withError:&error]) {
+        return [TOSTask taskWithError:error];
+    }
+    if (request.tosKeepAliveInterval > 0) {
+        [self schedulePrewarmRefresh:request];
+    } else {
+        [self stopPrewarm];
+    }
+    return [self sendPrewarm:request];
+}
+
+- (void)stopPrewarm {
+    @synchronized (self) {
+        if (self.prewarmTimer) {
+            dispatch_source_cancel(self.prewarmTimer);
+            self.prewarmTimer = nil;
+        }
+    }
+}
+
+// 每个域名同时发起tosConnectionCount个请求，会话中没有空闲连接时各自建立新连接
+- (TOSTask *)sendPrewarm:(TOSPrewarmInput *)request {
+    int count = request.tosConnectionCount > 0 ? request.tosConnectionCount : 4;
+    NSArray *buckets = request.tosBuckets;
+    if (buckets.count == 0) {
+        buckets = @[[NSNull null]];
+    } else if (self.clientConfiguration.tosEndpoint.isCustomDomain) {
+        // 自定义域名下所有桶共用同一域名
+        buckets = @[buckets.firstObject];
+    }
+    NSMutableArray<TOSTask *> *tasks = [NSMutableArray array];
+    for (id bucket in buckets) {
+        for (int i = 0; i < count; i++) {
+            [tasks addObject:[self prewarmTaskWithBucket:(bucket == [NSNull null] ? nil : bucket) key:request.tosKey]];
+        }
+    }
+    return [[TOSTask taskForCompletionOfAllTasks:tasks] continueWithBlock:^id _Nullable(TOSTask * _Nonnull t) {
+        int failed = 0;
+        NSError *error = nil;
+        for (TOSTask *task in tasks) {
+            // 服务端返回的错误码说明连接已建立
+            if (task.error && ![task.error.domain isEqualToString:TOSServerErrorDomain]) {
+                failed++;
+                error = task.error;
+            }
+        }
+        if (failed == (int)tasks.count) {
+            return [TOSTask taskWithError:error];
+        }
+        TOSPrewarmOutput *output = [TOSPrewarmOutput new];
+        output.tosRequestCount = (int)tasks.count;
+        output.tosFailedCount = failed;
+        return output;
+    }];
+}
+
+- (TOSTask *)prewarmTaskWithBucket:(nullable NSString *)bucket key:(nullable NSString *)key {
+    if (key && (bucket || self.clientConfiguration.tosEndpoint.isCustomDomain)) {
+        // 绕过元数据缓存，保证请求发到服务端
+        TOSHeadObjectInput *input = [TOSHeadObjectInput new];
+        input.tosBucket = bucket;
+        input.tosKey = key;
+        return [self sendHeadObject:input];
+    }
+    if (bucket) {
+        TOSHeadBucketInput *input = [TOSHeadBucketInput new];
+        input.tosBucket = bucket;
+        return [self headBucket:input];
+    }
+    return [self listBuckets:[TOSListBucketsInput new]];
+}
+
+// 定时器周期为刷新间隔的一半，空闲超过半个周期即刷新，保证连接的空闲时间不超过tosKeepAliveInterval
+- (void)schedulePrewarmRefresh:(TOSPrewarmInput *)request {
+    NSTimeInterval period = request.tosKeepAliveInterval / 2;
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0));
+    uint64_t interval = (uint64_t)(period * NSEC_PER_SEC);
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(timer, ^{
+        TOSClient *client = weakSelf;
+        if (client && CFAbsoluteTimeGetCurrent() - client.lastRequestTime >= period) {
+            [client sendPrewarm:request];
+        }
+    });
+    // 取消旧定时器与安装新定时器在同一临界区内完成，并发调用prewarm:时不会遗留未取消的定时器
+    @synchronized (self) {
+        if (self.prewarmTimer) {
+            dispatch_source_cancel(self.prewarmTimer);
+        }
+        self.prewarmTimer = timer;
+        dispatch_resume(timer);
+    }
+}
+
 @end
 
 
+
 @implementation TOSClient (PresignURL)
 
 - (TOSTask *)preSignedURL:(TOSPreSignedURLInput *)request {
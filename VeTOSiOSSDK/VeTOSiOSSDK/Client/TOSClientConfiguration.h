@@ -21,11 +21,18 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class TOSObjectMetadataCache;
+@class TOSObjectDiskCache;
+
 @interface TOSClientConfiguration : TOSNetworkingConfiguration
 
 @property (nonatomic, readonly) BOOL enableCRC;
 @property (nonatomic, strong, readonly) TOSEndpoint *tosEndpoint;
 @property (nonatomic, strong, readonly) TOSCredential *credential;
+// headObject元数据缓存，为nil时不缓存
+@property (nonatomic, strong, nullable) TOSObjectMetadataCache *objectMetadataCache;
+// getObject持久化缓存，为nil时不缓存
+@property (nonatomic, strong, nullable) TOSObjectDiskCache *objectDiskCache;
 
 - (instancetype)initWithEndpoint:(TOSEndpoint *)endpoint
                       credential:(TOSCredential *)credential;
@@ -27,6 +27,8 @@ static NSString *const TOSConfigurationUnknown = @"Unknown";
     if (self = [super init]) {
         _tosEndpoint = endpoint;
         _credential = credential;
+        // 与TOSClient一致，以该配置直接创建共享传输时同样允许蜂窝网络
+        self.allowsCellularAccess = YES;
     }
     return self;
 }
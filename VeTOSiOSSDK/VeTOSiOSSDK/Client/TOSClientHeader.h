@@ -19,5 +19,10 @@
 
 #import "TOSClientConfiguration.h"
 #import "TOSClient.h"
+#import "TOSAppendObjectWriter.h"
+#import "TOSObjectMetadataCache.h"
+#import "TOSObjectDiskCache.h"
+#import "TOSObjectReader.h"
+#import "TOSObjectWriter.h"
 
 #endif /* TOSClientHeader_h */
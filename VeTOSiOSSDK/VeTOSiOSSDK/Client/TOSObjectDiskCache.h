@@ -0,0 +1,131 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSModel.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ getObject持久化缓存：对象内容按bucket/key/versionID/ETag寻址，切分为固定大小的分段存放在directory下，
+ 只要区间覆盖的分段均已缓存，带Range的读取即可在本地完成。
+ 每个分段文件末尾附带该分段的CRC64，读取时重新计算校验，不一致的分段被删除并按未命中处理。
+ 分段按最近访问做LRU淘汰，总大小不超过maxBytes；重启后按分段写入时间恢复淘汰顺序。
+ 设置到TOSClientConfiguration.objectDiskCache后，未携带条件头、SSE-C密钥、图片处理和response-*覆盖参数的
+ getObject及getObjectToFile经过缓存；命中时携带If-None-Match向服务端校验，304时由本地返回数据。
+ 同一Client的写操作会使对应对象的缓存失效。
+ */
+@interface TOSObjectDiskCache : NSObject
+
+@property (nonatomic, copy, readonly) NSString *directory;
+@property (nonatomic, assign, readonly) uint64_t maxBytes;
+@property (nonatomic, assign, readonly) uint64_t segmentSize;
+
+/**
+ 两次校验之间的最长间隔，在此时间内命中的数据不再向服务端校验；默认为0，即每次命中都发起条件请求
+ */
+@property (atomic, assign) NSTimeInterval revalidationInterval;
+
+/**
+ 单次写入的数据量上限，超过时不写入缓存，避免大对象挤出其他缓存；默认为maxBytes的一半
+ */
+@property (atomic, assign) uint64_t maxStoreBytes;
+
+@property (atomic, assign, readonly) int64_t hitCount; // 请求区间的分段全部命中
+@property (atomic, assign, readonly) int64_t missCount; // 存在未缓存的分段，从服务端下载
+@property (atomic, assign, readonly) int64_t notModifiedCount; // 条件请求返回304
+@property (atomic, assign, readonly) int64_t evictionCount; // 淘汰的分段数
+@property (atomic, assign, readonly) int64_t corruptionCount; // CRC64校验失败的分段数
+
+@property (atomic, assign, readonly) uint64_t totalBytes;
+
+/**
+ 写操作使缓存失效时递增，用于丢弃失效前发起的下载结果
+ */
+@property (atomic, assign, readonly) int64_t generation;
+
+/**
+ 打开或创建缓存目录并加载已有索引；segmentSize为0时使用1MB
+ */
+- (instancetype)initWithDirectory:(NSString *)directory
+                         maxBytes:(uint64_t)maxBytes
+                      segmentSize:(uint64_t)segmentSize NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ 读取[start, end]区间（end为闭区间，ranged为NO时读取整个对象），所有分段命中且校验通过时返回Output，
+ tosContent为区间数据；fresh为YES表示距上次校验未超过revalidationInterval
+ */
+- (nullable TOSGetObjectOutput *)outputForBucket:(NSString *)bucket
+                                             key:(NSString *)key
+                                       versionID:(nullable NSString *)versionID
+                                      rangeStart:(int64_t)start
+                                        rangeEnd:(int64_t)end
+                                          ranged:(BOOL)ranged
+                                           fresh:(BOOL *)fresh;
+
+/**
+ 与上一方法相同，但不拼接区间数据：按顺序逐段调用block，data仅在调用期间有效；
+ block返回NO或分段校验失败时返回nil。返回的Output不含tosContent，tosContentLength为区间长度
+ */
+- (nullable TOSGetObjectOutput *)outputForBucket:(NSString *)bucket
+                                             key:(NSString *)key
+                                       versionID:(nullable NSString *)versionID
+                                      rangeStart:(int64_t)start
+                                        rangeEnd:(int64_t)end
+                                          ranged:(BOOL)ranged
+                                           fresh:(BOOL *)fresh
+                                      usingBlock:(BOOL (^)(NSData *data))block;
+
+/**
+ 写入服务端返回的数据，offset为tosContent在对象中的起始位置，只保存完整覆盖的分段；
+ ETag与已缓存的不同时替换原有内容；generation小于当前值时丢弃
+ */
+- (void)storeOutput:(TOSGetObjectOutput *)output
+             offset:(int64_t)offset
+          forBucket:(NSString *)bucket
+                key:(NSString *)key
+          versionID:(nullable NSString *)versionID
+         generation:(int64_t)generation;
+
+/**
+ 从已下载的文件逐段写入缓存，offset为文件内容在对象中的起始位置，其余同storeOutput
+ */
+- (void)storeFileAtPath:(NSString *)path
+                 output:(TOSGetObjectBasicOutput *)output
+                 offset:(int64_t)offset
+              forBucket:(NSString *)bucket
+                    key:(NSString *)key
+              versionID:(nullable NSString *)versionID
+             generation:(int64_t)generation;
+
+/**
+ 条件请求返回304后更新校验时间
+ */
+- (void)markValidatedBucket:(NSString *)bucket key:(NSString *)key versionID:(nullable NSString *)versionID;
+
+/**
+ 删除对象所有版本的缓存
+ */
+- (void)invalidateBucket:(NSString *)bucket key:(NSString *)key;
+
+- (void)removeAllObjects;
+- (void)resetStatistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
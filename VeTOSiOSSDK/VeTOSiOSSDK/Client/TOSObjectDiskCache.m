@@ -0,0 +1,629 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSObjectDiskCache.h"
+#import "TOSObjectVersionIndex.h"
+#import <VeTOSiOSSDK/TOSUtil.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint64_t TOSDiskCacheDefaultSegmentSize = 1024 * 1024;
+static NSString * const TOSDiskCacheMetaFileName = @"meta.plist";
+static NSString * const TOSDiskCacheSegmentExtension = @"seg";
+
+@interface TOSDiskCacheEntry : NSObject
+@property (nonatomic, copy) NSString *cacheKey;
+@property (nonatomic, copy) NSString *objectKey; // bucket + key，用于按对象失效
+@property (nonatomic, copy) NSString *directoryName;
+@property (nonatomic, copy) NSString *eTag;
+@property (nonatomic, assign) int64_t objectSize;
+@property (nonatomic, strong) NSDictionary *metadata; // 即meta.plist的内容
+@property (nonatomic, strong) NSMutableIndexSet *segments;
+@property (nonatomic, assign) CFAbsoluteTime validatedTime;
+@end
+
+@implementation TOSDiskCacheEntry
+@end
+
+@implementation TOSObjectDiskCache
+{
+    NSMutableDictionary<NSString *, TOSDiskCacheEntry *> *_entries;
+    NSMutableDictionary<NSString *, TOSDiskCacheEntry *> *_directories;
+    TOSObjectVersionIndex *_versions;
+    // 分段标识为"目录名/序号.seg"，头部优先淘汰
+    NSMutableOrderedSet<NSString *> *_lru;
+    NSMutableDictionary<NSString *, NSNumber *> *_segmentBytes;
+    uint64_t _totalBytes;
+    int64_t _generation;
+    int64_t _hitCount;
+    int64_t _missCount;
+    int64_t _notModifiedCount;
+    int64_t _evictionCount;
+    int64_t _corruptionCount;
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory maxBytes:(uint64_t)maxBytes segmentSize:(uint64_t)segmentSize {
+    if (self = [super init]) {
+        _directory = [directory copy];
+        _maxBytes = maxBytes;
+        _segmentSize = segmentSize > 0 ? segmentSize : TOSDiskCacheDefaultSegmentSize;
+        _maxStoreBytes = maxBytes / 2;
+        _entries = [NSMutableDictionary dictionary];
+        _directories = [NSMutableDictionary dictionary];
+        _versions = [TOSObjectVersionIndex new];
+        _lru = [NSMutableOrderedSet orderedSet];
+        _segmentBytes = [NSMutableDictionary dictionary];
+        [[NSFileManager defaultManager] createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:nil];
+        [self loadIndex];
+    }
+    return self;
+}
+
+#pragma mark - 统计
+
+- (int64_t)hitCount {
+    @synchronized (self) {
+        return _hitCount;
+    }
+}
+
+- (int64_t)missCount {
+    @synchronized (self) {
+        return _missCount;
+    }
+}
+
+- (int64_t)notModifiedCount {
+    @synchronized (self) {
+        return _notModifiedCount;
+    }
+}
+
+- (int64_t)evictionCount {
+    @synchronized (self) {
+        return _evictionCount;
+    }
+}
+
+- (int64_t)corruptionCount {
+    @synchronized (self) {
+        return _corruptionCount;
+    }
+}
+
+- (uint64_t)totalBytes {
+    @synchronized (self) {
+        return _totalBytes;
+    }
+}
+
+- (int64_t)generation {
+    @synchronized (self) {
+        return _generation;
+    }
+}
+
+- (void)resetStatistics {
+    @synchronized (self) {
+        _hitCount = 0;
+        _missCount = 0;
+        _notModifiedCount = 0;
+        _evictionCount = 0;
+        _corruptionCount = 0;
+    }
+}
+
+#pragma mark - 路径与元数据
+
++ (NSString *)segmentIDForDirectory:(NSString *)directoryName index:(NSUInteger)index {
+    return [NSString stringWithFormat:@"%@/%lu.%@", directoryName, (unsigned long)index, TOSDiskCacheSegmentExtension];
+}
+
+- (NSString *)pathForSegmentID:(NSString *)segmentID {
+    return [_directory stringByAppendingPathComponent:segmentID];
+}
+
+- (uint64_t)lengthOfSegment:(NSUInteger)index objectSize:(int64_t)objectSize {
+    uint64_t start = (uint64_t)index * _segmentSize;
+    return MIN(_segmentSize, (uint64_t)objectSize - start);
+}
+
++ (NSDictionary *)metadataFromOutput:(TOSGetObjectBasicOutput *)output {
+    NSMutableDictionary *metadata = [NSMutableDictionary dictionary];
+    metadata[@"etag"] = output.tosETag;
+    metadata[@"hash_crc64ecma"] = output.tosHashCrc64ecma != 0 ? [NSString stringWithFormat:@"%llu", output.tosHashCrc64ecma] : nil;
+    metadata[@"last_modified"] = output.tosLastModified;
+    metadata[@"version_id"] = output.tosVersionID;
+    metadata[@"website_redirect_location"] = output.tosWebsiteRedirectLocation;
+    metadata[@"object_type"] = output.tosObjectType;
+    metadata[@"storage_class"] = output.tosStorageClass;
+    metadata[@"meta"] = output.tosMeta;
+    metadata[@"content_type"] = output.tosContentType;
+    metadata[@"cache_control"] = output.tosCacheControl;
+    metadata[@"content_disposition"] = output.tosContentDisposition;
+    metadata[@"content_encoding"] = output.tosContentEncoding;
+    metadata[@"content_language"] = output.tosContentLanguage;
+    metadata[@"expires"] = output.tosExpires;
+    return metadata;
+}
+
++ (TOSGetObjectOutput *)outputFromMetadata:(NSDictionary *)metadata {
+    TOSGetObjectOutput *output = [TOSGetObjectOutput new];
+    output.tosETag = metadata[@"etag"];
+    output.tosHashCrc64ecma = strtoull([metadata[@"hash_crc64ecma"] UTF8String] ?: "0", NULL, 0);
+    output.tosLastModified = metadata[@"last_modified"];
+    output.tosVersionID = metadata[@"version_id"];
+    output.tosWebsiteRedirectLocation = metadata[@"website_redirect_location"];
+    output.tosObjectType = metadata[@"object_type"];
+    output.tosStorageClass = metadata[@"storage_class"];
+    output.tosMeta = metadata[@"meta"] ?: @{};
+    output.tosContentType = metadata[@"content_type"];
+    output.tosCacheControl = metadata[@"cache_control"];
+    output.tosContentDisposition = metadata[@"content_disposition"];
+    output.tosContentEncoding = metadata[@"content_encoding"];
+    output.tosContentLanguage = metadata[@"content_language"];
+    output.tosExpires = metadata[@"expires"];
+    return output;
+}
+
+// 解析"bytes a-b/total"中的对象大小，失败时返回-1
++ (int64_t)objectSizeFromContentRange:(NSString *)contentRange {
+    NSRange slash = [contentRange rangeOfString:@"/" options:NSBackwardsSearch];
+    if (slash.location == NSNotFound) {
+        return -1;
+    }
+    NSString *total = [contentRange substringFromIndex:slash.location + 1];
+    if (total.length == 0 || [total isEqualToString:@"*"]) {
+        return -1;
+    }
+    return [total longLongValue];
+}
+
+#pragma mark - 读写
+
+- (TOSGetObjectOutput *)outputForBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID rangeStart:(int64_t)start rangeEnd:(int64_t)end ranged:(BOOL)ranged fresh:(BOOL *)fresh {
+    NSMutableData *content = [NSMutableData data];
+    TOSGetObjectOutput *output = [self outputForBucket:bucket key:key versionID:versionID rangeStart:start rangeEnd:end ranged:ranged fresh:fresh usingBlock:^BOOL(NSData *data) {
+        [content appendData:data];
+        return YES;
+    }];
+    output.tosContent = content;
+    return output;
+}
+
+- (TOSGetObjectOutput *)outputForBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID rangeStart:(int64_t)start rangeEnd:(int64_t)end ranged:(BOOL)ranged fresh:(BOOL *)fresh usingBlock:(BOOL (^)(NSData *data))block {
+    NSString *cacheKey = [TOSObjectVersionIndex cacheKeyForBucket:bucket key:key versionID:versionID];
+    *fresh = NO;
+    TOSDiskCacheEntry *entry = nil;
+    NSUInteger first = 0;
+    NSUInteger last = 0;
+    @synchronized (self) {
+        entry = _entries[cacheKey];
+        if (entry) {
+            int64_t size = entry.objectSize;
+            if (!ranged) {
+                start = 0;
+                end = size - 1;
+            }
+            end = MIN(end, size - 1);
+            first = (NSUInteger)(start / (int64_t)_segmentSize);
+            last = (NSUInteger)(end / (int64_t)_segmentSize);
+            // 起点越界交由服务端返回416
+            if (start >= size || ![entry.segments containsIndexesInRange:NSMakeRange(first, last - first + 1)]) {
+                entry = nil;
+            }
+        }
+        if (!entry) {
+            _missCount++;
+            return nil;
+        }
+    }
+
+    for (NSUInteger index = first; index <= last; index++) {
+        NSString *segmentID = [TOSObjectDiskCache segmentIDForDirectory:entry.directoryName index:index];
+        NSData *segment = [self readSegment:segmentID length:[self lengthOfSegment:index objectSize:entry.objectSize]];
+        if (!segment) {
+            @synchronized (self) {
+                _missCount++;
+            }
+            return nil;
+        }
+        int64_t segmentStart = (int64_t)index * (int64_t)_segmentSize;
+        int64_t from = MAX(start, segmentStart) - segmentStart;
+        int64_t to = MIN(end + 1, segmentStart + (int64_t)segment.length) - segmentStart;
+        // 逐段交给调用方，不在内存中拼接整个区间
+        NSData *data = (from == 0 && to == (int64_t)segment.length) ? segment : [segment subdataWithRange:NSMakeRange((NSUInteger)from, (NSUInteger)(to - from))];
+        if (!block(data)) {
+            @synchronized (self) {
+                _missCount++;
+            }
+            return nil;
+        }
+    }
+
+    TOSGetObjectOutput *output = nil;
+    @synchronized (self) {
+        if (_entries[cacheKey] != entry) {
+            _missCount++;
+            return nil;
+        }
+        for (NSUInteger index = first; index <= last; index++) {
+            NSString *segmentID = [TOSObjectDiskCache segmentIDForDirectory:entry.directoryName index:index];
+            [_lru removeObject:segmentID];
+            [_lru addObject:segmentID];
+        }
+        _hitCount++;
+        *fresh = _revalidationInterval > 0 && CFAbsoluteTimeGetCurrent() - entry.validatedTime < _revalidationInterval;
+        output = [TOSObjectDiskCache outputFromMetadata:entry.metadata];
+        if (ranged) {
+            output.tosStatusCode = 206;
+            output.tosContentRange = [NSString stringWithFormat:@"bytes %lld-%lld/%lld", start, end, entry.objectSize];
+        } else {
+            output.tosStatusCode = 200;
+        }
+    }
+    output.tosContentLength = end - start + 1;
+    return output;
+}
+
+// 读取分段并校验末尾的CRC64，文件缺失返回nil，校验失败时同时删除该分段
+- (NSData *)readSegment:(NSString *)segmentID length:(uint64_t)length {
+    NSData *data = [NSData dataWithContentsOfFile:[self pathForSegmentID:segmentID]];
+    if (!data) {
+        return nil;
+    }
+    uint64_t stored = 0;
+    BOOL valid = data.length == length + sizeof(stored);
+    if (valid) {
+        [data getBytes:&stored range:NSMakeRange((NSUInteger)length, sizeof(stored))];
+        stored = CFSwapInt64LittleToHost(stored);
+        valid = [TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:(size_t)length] == stored;
+    }
+    if (!valid) {
+        @synchronized (self) {
+            _corruptionCount++;
+            [self removeSegmentLocked:segmentID];
+        }
+        return nil;
+    }
+    return [data subdataWithRange:NSMakeRange(0, (NSUInteger)length)];
+}
+
+- (void)storeOutput:(TOSGetObjectOutput *)output offset:(int64_t)offset forBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID generation:(int64_t)generation {
+    NSData *content = output.tosContent;
+    [self storeOutput:output offset:offset length:(int64_t)content.length forBucket:bucket key:key versionID:versionID generation:generation readBlock:^NSData *(int64_t position, NSUInteger length) {
+        return [NSData dataWithBytesNoCopy:(uint8_t *)content.bytes + position length:length freeWhenDone:NO];
+    }];
+}
+
+- (void)storeFileAtPath:(NSString *)path output:(TOSGetObjectBasicOutput *)output offset:(int64_t)offset forBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID generation:(int64_t)generation {
+    int fd = open([path fileSystemRepresentation], O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        [self storeOutput:output offset:offset length:(int64_t)st.st_size forBucket:bucket key:key versionID:versionID generation:generation readBlock:^NSData *(int64_t position, NSUInteger length) {
+            NSMutableData *data = [NSMutableData dataWithLength:length];
+            NSUInteger done = 0;
+            while (done < length) {
+                ssize_t n = pread(fd, (uint8_t *)data.mutableBytes + done, length - done, (off_t)(position + done));
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    return nil;
+                }
+                done += (NSUInteger)n;
+            }
+            return data;
+        }];
+    }
+    close(fd);
+}
+
+// readBlock按相对offset的位置读取数据，读取失败返回nil
+- (void)storeOutput:(TOSGetObjectBasicOutput *)output offset:(int64_t)offset length:(int64_t)length forBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID generation:(int64_t)generation readBlock:(NSData * _Nullable (^)(int64_t position, NSUInteger length))readBlock {
+    if (output.tosETag.length == 0 || length <= 0 || offset < 0 || (uint64_t)length > self.maxStoreBytes) {
+        return;
+    }
+    int64_t size = -1;
+    if (output.tosContentRange) {
+        size = [TOSObjectDiskCache objectSizeFromContentRange:output.tosContentRange];
+    } else if (offset == 0) {
+        size = length;
+        // 完整对象先与服务端CRC64比对，避免缓存传输中损坏的数据
+        if (output.tosHashCrc64ecma != 0) {
+            uint64_t crc = 0;
+            for (int64_t position = 0; position < length; position += (int64_t)_segmentSize) {
+                NSData *data = readBlock(position, (NSUInteger)MIN((int64_t)_segmentSize, length - position));
+                if (!data) {
+                    return;
+                }
+                crc = [TOSUtil crc64ecma:crc buffer:(void *)data.bytes length:data.length];
+            }
+            if (crc != output.tosHashCrc64ecma) {
+                return;
+            }
+        }
+    }
+    if (size <= 0 || offset + length > size) {
+        return;
+    }
+
+    NSString *cacheKey = [TOSObjectVersionIndex cacheKeyForBucket:bucket key:key versionID:versionID];
+    TOSDiskCacheEntry *entry = nil;
+    NSMutableIndexSet *pending = [NSMutableIndexSet indexSet];
+    @synchronized (self) {
+        if (generation < _generation) {
+            return;
+        }
+        entry = _entries[cacheKey];
+        if (entry && (![entry.eTag isEqualToString:output.tosETag] || entry.objectSize != size)) {
+            [self removeEntryLocked:entry];
+            entry = nil;
+        }
+        if (!entry) {
+            entry = [self createEntryLockedWithCacheKey:cacheKey bucket:bucket key:key versionID:versionID output:output objectSize:size];
+            if (!entry) {
+                return;
+            }
+        }
+        entry.validatedTime = CFAbsoluteTimeGetCurrent();
+        // 只保存被数据完整覆盖的分段
+        NSUInteger index = (NSUInteger)((offset + (int64_t)_segmentSize - 1) / (int64_t)_segmentSize);
+        for (; (int64_t)index * (int64_t)_segmentSize < size; index++) {
+            int64_t segmentEnd = (int64_t)index * (int64_t)_segmentSize + (int64_t)[self lengthOfSegment:index objectSize:size];
+            if (segmentEnd > offset + length) {
+                break;
+            }
+            if (![entry.segments containsIndex:index]) {
+                [pending addIndex:index];
+            }
+        }
+    }
+
+    NSMutableIndexSet *written = [NSMutableIndexSet indexSet];
+    [pending enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        uint64_t segmentLength = [self lengthOfSegment:index objectSize:size];
+        NSData *data = readBlock((int64_t)index * (int64_t)self->_segmentSize - offset, (NSUInteger)segmentLength);
+        if (!data) {
+            *stop = YES;
+            return;
+        }
+        uint64_t crc = CFSwapInt64HostToLittle([TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length]);
+        NSMutableData *segment = [NSMutableData dataWithCapacity:data.length + sizeof(crc)];
+        [segment appendData:data];
+        [segment appendBytes:&crc length:sizeof(crc)];
+        NSString *segmentID = [TOSObjectDiskCache segmentIDForDirectory:entry.directoryName index:index];
+        if ([segment writeToFile:[self pathForSegmentID:segmentID] atomically:YES]) {
+            [written addIndex:index];
+        }
+    }];
+
+    @synchronized (self) {
+        if (_entries[cacheKey] != entry) {
+            // 写入期间已失效，目录已随条目删除
+            return;
+        }
+        [written enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+            if ([entry.segments containsIndex:index]) {
+                return;
+            }
+            NSString *segmentID = [TOSObjectDiskCache segmentIDForDirectory:entry.directoryName index:index];
+            uint64_t bytes = [self lengthOfSegment:index objectSize:size] + sizeof(uint64_t);
+            [entry.segments addIndex:index];
+            [self->_lru addObject:segmentID];
+            self->_segmentBytes[segmentID] = @(bytes);
+            self->_totalBytes += bytes;
+        }];
+        if (entry.segments.count == 0) {
+            [self removeEntryLocked:entry];
+        }
+        [self evictLocked];
+    }
+}
+
+- (void)markValidatedBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID {
+    NSString *cacheKey = [TOSObjectVersionIndex cacheKeyForBucket:bucket key:key versionID:versionID];
+    @synchronized (self) {
+        _notModifiedCount++;
+        _entries[cacheKey].validatedTime = CFAbsoluteTimeGetCurrent();
+    }
+}
+
+- (void)invalidateBucket:(NSString *)bucket key:(NSString *)key {
+    NSString *objectKey = [TOSObjectVersionIndex objectKeyForBucket:bucket key:key];
+    @synchronized (self) {
+        _generation++;
+        for (NSString *cacheKey in [_versions cacheKeysForObjectKey:objectKey]) {
+            [self removeEntryLocked:_entries[cacheKey]];
+        }
+    }
+}
+
+- (void)removeAllObjects {
+    @synchronized (self) {
+        _generation++;
+        for (TOSDiskCacheEntry *entry in [_entries allValues]) {
+            [self removeEntryLocked:entry];
+        }
+        // 同时清理加载时未能识别的文件
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        for (NSString *name in [fileManager contentsOfDirectoryAtPath:_directory error:nil]) {
+            [fileManager removeItemAtPath:[_directory stringByAppendingPathComponent:name] error:nil];
+        }
+    }
+}
+
+#pragma mark - 索引，调用方持有锁
+
+- (TOSDiskCacheEntry *)createEntryLockedWithCacheKey:(NSString *)cacheKey bucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID output:(TOSGetObjectBasicOutput *)output objectSize:(int64_t)size {
+    NSString *name = [NSString stringWithFormat:@"%@#%@", cacheKey, output.tosETag];
+    NSString *directoryName = [TOSUtil dataMD5String:[name dataUsingEncoding:NSUTF8StringEncoding]];
+    NSString *path = [_directory stringByAppendingPathComponent:directoryName];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    [fileManager removeItemAtPath:path error:nil];
+    if (![fileManager createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:nil]) {
+        return nil;
+    }
+    NSMutableDictionary *metadata = [[TOSObjectDiskCache metadataFromOutput:output] mutableCopy];
+    metadata[@"bucket"] = bucket;
+    metadata[@"key"] = key;
+    metadata[@"request_version_id"] = versionID;
+    metadata[@"object_size"] = @(size);
+    metadata[@"segment_size"] = @(_segmentSize);
+    if (![metadata writeToFile:[path stringByAppendingPathComponent:TOSDiskCacheMetaFileName] atomically:YES]) {
+        [fileManager removeItemAtPath:path error:nil];
+        return nil;
+    }
+    TOSDiskCacheEntry *entry = [TOSDiskCacheEntry new];
+    entry.cacheKey = cacheKey;
+    entry.objectKey = [TOSObjectVersionIndex objectKeyForBucket:bucket key:key];
+    entry.directoryName = directoryName;
+    entry.eTag = output.tosETag;
+    entry.objectSize = size;
+    entry.metadata = metadata;
+    entry.segments = [NSMutableIndexSet indexSet];
+    [self addEntryLocked:entry];
+    return entry;
+}
+
+- (void)addEntryLocked:(TOSDiskCacheEntry *)entry {
+    _entries[entry.cacheKey] = entry;
+    _directories[entry.directoryName] = entry;
+    [_versions addCacheKey:entry.cacheKey objectKey:entry.objectKey];
+}
+
+- (void)removeEntryLocked:(TOSDiskCacheEntry *)entry {
+    if (!entry) {
+        return;
+    }
+    [entry.segments enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        NSString *segmentID = [TOSObjectDiskCache segmentIDForDirectory:entry.directoryName index:index];
+        [self->_lru removeObject:segmentID];
+        self->_totalBytes -= [self->_segmentBytes[segmentID] unsignedLongLongValue];
+        [self->_segmentBytes removeObjectForKey:segmentID];
+    }];
+    [entry.segments removeAllIndexes];
+    [[NSFileManager defaultManager] removeItemAtPath:[_directory stringByAppendingPathComponent:entry.directoryName] error:nil];
+    [_versions removeCacheKey:entry.cacheKey objectKey:entry.objectKey];
+    [_directories removeObjectForKey:entry.directoryName];
+    if (_entries[entry.cacheKey] == entry) {
+        [_entries removeObjectForKey:entry.cacheKey];
+    }
+}
+
+- (void)removeSegmentLocked:(NSString *)segmentID {
+    NSString *directoryName = [segmentID stringByDeletingLastPathComponent];
+    NSUInteger index = (NSUInteger)[[[segmentID lastPathComponent] stringByDeletingPathExtension] integerValue];
+    TOSDiskCacheEntry *entry = _directories[directoryName];
+    if (![entry.segments containsIndex:index]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self pathForSegmentID:segmentID] error:nil];
+        return;
+    }
+    [entry.segments removeIndex:index];
+    [_lru removeObject:segmentID];
+    _totalBytes -= [_segmentBytes[segmentID] unsignedLongLongValue];
+    [_segmentBytes removeObjectForKey:segmentID];
+    [[NSFileManager defaultManager] removeItemAtPath:[self pathForSegmentID:segmentID] error:nil];
+    if (entry.segments.count == 0) {
+        [self removeEntryLocked:entry];
+    }
+}
+
+- (void)evictLocked {
+    while (_totalBytes > _maxBytes && _lru.count > 0) {
+        [self removeSegmentLocked:_lru.firstObject];
+        _evictionCount++;
+    }
+}
+
+// 启动时扫描缓存目录，按分段文件的修改时间恢复LRU顺序，无法识别或分段大小不一致的目录直接删除
+- (void)loadIndex {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSMutableArray<NSDictionary *> *segmentFiles = [NSMutableArray array];
+    NSMutableDictionary<NSString *, NSDate *> *entryDates = [NSMutableDictionary dictionary];
+    @synchronized (self) {
+        for (NSString *directoryName in [fileManager contentsOfDirectoryAtPath:_directory error:nil]) {
+            NSString *path = [_directory stringByAppendingPathComponent:directoryName];
+            NSString *metaPath = [path stringByAppendingPathComponent:TOSDiskCacheMetaFileName];
+            NSDictionary *metadata = [NSDictionary dictionaryWithContentsOfFile:metaPath];
+            NSDate *metaDate = [fileManager attributesOfItemAtPath:metaPath error:nil].fileModificationDate;
+            if (!metadata[@"bucket"] || !metadata[@"key"] || !metadata[@"etag"] ||
+                [metadata[@"segment_size"] unsignedLongLongValue] != _segmentSize || [metadata[@"object_size"] longLongValue] <= 0) {
+                [fileManager removeItemAtPath:path error:nil];
+                continue;
+            }
+            TOSDiskCacheEntry *entry = [TOSDiskCacheEntry new];
+            entry.cacheKey = [TOSObjectVersionIndex cacheKeyForBucket:metadata[@"bucket"] key:metadata[@"key"] versionID:metadata[@"request_version_id"]];
+            entry.objectKey = [TOSObjectVersionIndex objectKeyForBucket:metadata[@"bucket"] key:metadata[@"key"]];
+            entry.directoryName = directoryName;
+            entry.eTag = metadata[@"etag"];
+            entry.objectSize = [metadata[@"object_size"] longLongValue];
+            entry.metadata = metadata;
+            entry.segments = [NSMutableIndexSet indexSet];
+
+            // 同一对象存在多个ETag的目录时保留最新的
+            TOSDiskCacheEntry *existing = _entries[entry.cacheKey];
+            if (existing) {
+                if ([entryDates[existing.directoryName] compare:metaDate] != NSOrderedAscending) {
+                    [fileManager removeItemAtPath:path error:nil];
+                    continue;
+                }
+                [self removeEntryLocked:existing];
+            }
+            entryDates[directoryName] = metaDate ?: [NSDate distantPast];
+            [self addEntryLocked:entry];
+
+            for (NSString *name in [fileManager contentsOfDirectoryAtPath:path error:nil]) {
+                if (![[name pathExtension] isEqualToString:TOSDiskCacheSegmentExtension]) {
+                    continue;
+                }
+                NSUInteger index = (NSUInteger)[[name stringByDeletingPathExtension] integerValue];
+                NSString *segmentID = [TOSObjectDiskCache segmentIDForDirectory:directoryName index:index];
+                NSDictionary *attributes = [fileManager attributesOfItemAtPath:[path stringByAppendingPathComponent:name] error:nil];
+                uint64_t bytes = [self lengthOfSegment:index objectSize:entry.objectSize] + sizeof(uint64_t);
+                if ((int64_t)index * (int64_t)_segmentSize >= entry.objectSize || attributes.fileSize != bytes) {
+                    [fileManager removeItemAtPath:[path stringByAppendingPathComponent:name] error:nil];
+                    continue;
+                }
+                [entry.segments addIndex:index];
+                [segmentFiles addObject:@{@"id": segmentID, @"date": attributes.fileModificationDate ?: [NSDate distantPast], @"bytes": @(bytes)}];
+            }
+            if (entry.segments.count == 0) {
+                [self removeEntryLocked:entry];
+            }
+        }
+
+        [segmentFiles sortUsingComparator:^NSComparisonResult(NSDictionary *obj1, NSDictionary *obj2) {
+            return [obj1[@"date"] compare:obj2[@"date"]];
+        }];
+        for (NSDictionary *file in segmentFiles) {
+            NSString *segmentID = file[@"id"];
+            if (!_directories[[segmentID stringByDeletingLastPathComponent]]) {
+                continue;
+            }
+            [_lru addObject:segmentID];
+            _segmentBytes[segmentID] = file[@"bytes"];
+            _totalBytes += [file[@"bytes"] unsignedLongLongValue];
+        }
+        [self evictLocked];
+    }
+}
+
+@end
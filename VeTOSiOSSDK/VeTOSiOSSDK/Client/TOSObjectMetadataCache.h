@@ -0,0 +1,92 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSModel.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ headObject元数据缓存：按条目数和估算字节数做LRU淘汰，条目在ttl后过期。
+ 设置到TOSClientConfiguration.objectMetadataCache后，未携带条件头和SSE-C密钥的headObject优先读取缓存；
+ 同一Client的putObject/deleteObject/copyObject/setObjectMeta等写操作会使对应对象的条目失效。
+ 缓存保存对象属性的快照，每次命中都返回新的Output对象，不含原请求的tosRequestID、tosHeader和tosMetrics。
+ */
+@interface TOSObjectMetadataCache : NSObject
+
+@property (nonatomic, assign, readonly) NSUInteger maxEntryCount;
+@property (nonatomic, assign, readonly) NSUInteger maxBytes;
+@property (nonatomic, assign, readonly) NSTimeInterval ttl;
+
+/**
+ 为YES时过期条目不直接丢弃，而是携带If-None-Match重新校验，服务端返回304时沿用缓存并续期；
+ ttl为0时每次命中都会校验
+ */
+@property (atomic, assign) BOOL revalidatesExpiredEntries;
+
+@property (atomic, assign, readonly) int64_t hitCount; // 直接由缓存返回
+@property (atomic, assign, readonly) int64_t missCount; // 无可用条目，发起完整HEAD
+@property (atomic, assign, readonly) int64_t revalidationCount; // 发起条件HEAD
+@property (atomic, assign, readonly) int64_t notModifiedCount; // 条件HEAD返回304
+@property (atomic, assign, readonly) int64_t evictionCount;
+
+@property (atomic, assign, readonly) NSUInteger count;
+@property (atomic, assign, readonly) NSUInteger totalBytes;
+
+/**
+ 写操作使条目失效时递增，用于丢弃失效前发起的HEAD结果
+ */
+@property (atomic, assign, readonly) int64_t generation;
+
+- (instancetype)initWithMaxEntryCount:(NSUInteger)maxEntryCount
+                             maxBytes:(NSUInteger)maxBytes
+                                  ttl:(NSTimeInterval)ttl NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ 查找条目并计数，返回条目的副本；expired为YES表示条目已过期且需要重新校验，仅在revalidatesExpiredEntries为YES时返回过期条目
+ */
+- (nullable TOSHeadObjectOutput *)outputForBucket:(NSString *)bucket
+                                              key:(NSString *)key
+                                        versionID:(nullable NSString *)versionID
+                                          expired:(BOOL *)expired;
+
+/**
+ 写入output的快照，之后修改output不影响缓存；generation小于当前值时说明期间对象已被修改，丢弃该结果
+ */
+- (void)setOutput:(TOSHeadObjectOutput *)output
+        forBucket:(NSString *)bucket
+              key:(NSString *)key
+        versionID:(nullable NSString *)versionID
+       generation:(int64_t)generation;
+
+/**
+ 条件HEAD返回304后续期条目
+ */
+- (void)refreshOutputForBucket:(NSString *)bucket key:(NSString *)key versionID:(nullable NSString *)versionID;
+
+/**
+ 使对象所有版本的条目失效
+ */
+- (void)invalidateBucket:(NSString *)bucket key:(NSString *)key;
+
+- (void)removeAllEntries;
+- (void)resetStatistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
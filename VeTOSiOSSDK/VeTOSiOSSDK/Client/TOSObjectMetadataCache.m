@@ -0,0 +1,296 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSObjectMetadataCache.h"
+#import "TOSObjectVersionIndex.h"
+
+// 条目的固定开销估算（对象本身及字典、链表节点）
+static const NSUInteger TOSMetadataCacheEntryOverhead = 256;
+
+@interface TOSMetadataCacheEntry : NSObject
+@property (nonatomic, copy) NSString *cacheKey;
+@property (nonatomic, copy) NSString *objectKey; // bucket + key，用于按对象失效
+@property (nonatomic, strong) TOSHeadObjectOutput *output;
+@property (nonatomic, assign) NSUInteger bytes;
+@property (nonatomic, assign) CFAbsoluteTime expireTime;
+@property (nonatomic, unsafe_unretained) TOSMetadataCacheEntry *prev;
+@property (nonatomic, strong) TOSMetadataCacheEntry *next;
+@end
+
+@implementation TOSMetadataCacheEntry
+@end
+
+@implementation TOSObjectMetadataCache
+{
+    NSMutableDictionary<NSString *, TOSMetadataCacheEntry *> *_entries;
+    TOSObjectVersionIndex *_versions;
+    // 链表头为最近使用，尾部优先淘汰
+    TOSMetadataCacheEntry *_head;
+    TOSMetadataCacheEntry *_tail;
+    NSUInteger _totalBytes;
+    int64_t _generation;
+    int64_t _hitCount;
+    int64_t _missCount;
+    int64_t _revalidationCount;
+    int64_t _notModifiedCount;
+    int64_t _evictionCount;
+}
+
+- (instancetype)initWithMaxEntryCount:(NSUInteger)maxEntryCount maxBytes:(NSUInteger)maxBytes ttl:(NSTimeInterval)ttl {
+    if (self = [super init]) {
+        _maxEntryCount = maxEntryCount;
+        _maxBytes = maxBytes;
+        _ttl = MAX(0, ttl);
+        _entries = [NSMutableDictionary dictionary];
+        _versions = [TOSObjectVersionIndex new];
+    }
+    return self;
+}
+
+#pragma mark - 统计
+
+- (int64_t)hitCount {
+    @synchronized (self) {
+        return _hitCount;
+    }
+}
+
+- (int64_t)missCount {
+    @synchronized (self) {
+        return _missCount;
+    }
+}
+
+- (int64_t)revalidationCount {
+    @synchronized (self) {
+        return _revalidationCount;
+    }
+}
+
+- (int64_t)notModifiedCount {
+    @synchronized (self) {
+        return _notModifiedCount;
+    }
+}
+
+- (int64_t)evictionCount {
+    @synchronized (self) {
+        return _evictionCount;
+    }
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return _entries.count;
+    }
+}
+
+- (NSUInteger)totalBytes {
+    @synchronized (self) {
+        return _totalBytes;
+    }
+}
+
+- (int64_t)generation {
+    @synchronized (self) {
+        return _generation;
+    }
+}
+
+- (void)resetStatistics {
+    @synchronized (self) {
+        _hitCount = 0;
+        _missCount = 0;
+        _revalidationCount = 0;
+        _notModifiedCount = 0;
+        _evictionCount = 0;
+    }
+}
+
+#pragma mark - 读写
+
+// 只复制对象属性，请求相关的tosRequestID、tosHeader、tosMetrics不进入缓存
++ (TOSHeadObjectOutput *)snapshotOfOutput:(TOSHeadObjectOutput *)output {
+    TOSHeadObjectOutput *snapshot = [TOSHeadObjectOutput new];
+    snapshot.tosStatusCode = output.tosStatusCode;
+    snapshot.tosETag = output.tosETag;
+    snapshot.tosLastModified = output.tosLastModified;
+    snapshot.tosDeleteMarker = output.tosDeleteMarker;
+    snapshot.tosSSECAlgorithm = output.tosSSECAlgorithm;
+    snapshot.tosSSECKeyMD5 = output.tosSSECKeyMD5;
+    snapshot.tosVersionID = output.tosVersionID;
+    snapshot.tosWebsiteRedirectLocation = output.tosWebsiteRedirectLocation;
+    snapshot.tosObjectType = output.tosObjectType;
+    snapshot.tosHashCrc64ecma = output.tosHashCrc64ecma;
+    snapshot.tosStorageClass = output.tosStorageClass;
+    snapshot.tosMeta = output.tosMeta ? [NSDictionary dictionaryWithDictionary:output.tosMeta] : nil;
+    snapshot.tosContentLength = output.tosContentLength;
+    snapshot.tosContentType = output.tosContentType;
+    snapshot.tosCacheControl = output.tosCacheControl;
+    snapshot.tosContentDisposition = output.tosContentDisposition;
+    snapshot.tosContentEncoding = output.tosContentEncoding;
+    snapshot.tosContentLanguage = output.tosContentLanguage;
+    snapshot.tosExpiration = output.tosExpiration;
+    snapshot.tosExpires = output.tosExpires;
+    return snapshot;
+}
+
++ (NSUInteger)estimatedBytesOfOutput:(TOSHeadObjectOutput *)output {
+    __block NSUInteger bytes = TOSMetadataCacheEntryOverhead;
+    for (NSString *value in @[output.tosETag ?: @"", output.tosVersionID ?: @"", output.tosContentType ?: @"",
+                              output.tosCacheControl ?: @"", output.tosContentDisposition ?: @"", output.tosContentEncoding ?: @"",
+                              output.tosContentLanguage ?: @"", output.tosExpiration ?: @"", output.tosObjectType ?: @"",
+                              output.tosStorageClass ?: @"", output.tosWebsiteRedirectLocation ?: @""]) {
+        bytes += value.length;
+    }
+    [output.tosMeta enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+        bytes += key.length + value.length;
+    }];
+    return bytes;
+}
+
+- (TOSHeadObjectOutput *)outputForBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID expired:(BOOL *)expired {
+    NSString *cacheKey = [TOSObjectVersionIndex cacheKeyForBucket:bucket key:key versionID:versionID];
+    @synchronized (self) {
+        *expired = NO;
+        TOSMetadataCacheEntry *entry = _entries[cacheKey];
+        if (!entry) {
+            _missCount++;
+            return nil;
+        }
+        if (CFAbsoluteTimeGetCurrent() < entry.expireTime) {
+            [self moveToHeadLocked:entry];
+            _hitCount++;
+            return [TOSObjectMetadataCache snapshotOfOutput:entry.output];
+        }
+        if (self.revalidatesExpiredEntries && entry.output.tosETag.length > 0) {
+            [self moveToHeadLocked:entry];
+            _revalidationCount++;
+            *expired = YES;
+            return [TOSObjectMetadataCache snapshotOfOutput:entry.output];
+        }
+        [self removeEntryLocked:entry];
+        _missCount++;
+        return nil;
+    }
+}
+
+- (void)setOutput:(TOSHeadObjectOutput *)output forBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID generation:(int64_t)generation {
+    output = [TOSObjectMetadataCache snapshotOfOutput:output];
+    NSUInteger bytes = [TOSObjectMetadataCache estimatedBytesOfOutput:output];
+    if (_maxEntryCount == 0 || bytes > _maxBytes) {
+        return;
+    }
+    TOSMetadataCacheEntry *entry = [TOSMetadataCacheEntry new];
+    entry.cacheKey = [TOSObjectVersionIndex cacheKeyForBucket:bucket key:key versionID:versionID];
+    entry.objectKey = [TOSObjectVersionIndex objectKeyForBucket:bucket key:key];
+    entry.output = output;
+    entry.bytes = bytes;
+    entry.expireTime = CFAbsoluteTimeGetCurrent() + _ttl;
+    @synchronized (self) {
+        if (generation < _generation) {
+            return;
+        }
+        TOSMetadataCacheEntry *old = _entries[entry.cacheKey];
+        if (old) {
+            [self removeEntryLocked:old];
+        }
+        _entries[entry.cacheKey] = entry;
+        [_versions addCacheKey:entry.cacheKey objectKey:entry.objectKey];
+        _totalBytes += bytes;
+        [self insertAtHeadLocked:entry];
+        while (_tail && (_entries.count > _maxEntryCount || _totalBytes > _maxBytes)) {
+            [self removeEntryLocked:_tail];
+            _evictionCount++;
+        }
+    }
+}
+
+- (void)refreshOutputForBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID {
+    NSString *cacheKey = [TOSObjectVersionIndex cacheKeyForBucket:bucket key:key versionID:versionID];
+    @synchronized (self) {
+        _notModifiedCount++;
+        TOSMetadataCacheEntry *entry = _entries[cacheKey];
+        entry.expireTime = CFAbsoluteTimeGetCurrent() + _ttl;
+    }
+}
+
+- (void)invalidateBucket:(NSString *)bucket key:(NSString *)key {
+    NSString *objectKey = [TOSObjectVersionIndex objectKeyForBucket:bucket key:key];
+    @synchronized (self) {
+        _generation++;
+        for (NSString *cacheKey in [_versions cacheKeysForObjectKey:objectKey]) {
+            [self removeEntryLocked:_entries[cacheKey]];
+        }
+    }
+}
+
+- (void)removeAllEntries {
+    @synchronized (self) {
+        _generation++;
+        // 逐个断开强引用链，避免长链表递归释放
+        while (_tail) {
+            [self removeEntryLocked:_tail];
+        }
+    }
+}
+
+#pragma mark - LRU链表，调用方持有锁
+
+- (void)insertAtHeadLocked:(TOSMetadataCacheEntry *)entry {
+    entry.prev = nil;
+    entry.next = _head;
+    _head.prev = entry;
+    _head = entry;
+    if (!_tail) {
+        _tail = entry;
+    }
+}
+
+- (void)unlinkLocked:(TOSMetadataCacheEntry *)entry {
+    if (entry.prev) {
+        entry.prev.next = entry.next;
+    } else {
+        _head = entry.next;
+    }
+    if (entry.next) {
+        entry.next.prev = entry.prev;
+    } else {
+        _tail = entry.prev;
+    }
+    entry.prev = nil;
+    entry.next = nil;
+}
+
+- (void)moveToHeadLocked:(TOSMetadataCacheEntry *)entry {
+    if (_head == entry) {
+        return;
+    }
+    [self unlinkLocked:entry];
+    [self insertAtHeadLocked:entry];
+}
+
+- (void)removeEntryLocked:(TOSMetadataCacheEntry *)entry {
+    if (!entry) {
+        return;
+    }
+    [self unlinkLocked:entry];
+    [_versions removeCacheKey:entry.cacheKey objectKey:entry.objectKey];
+    _totalBytes -= entry.bytes;
+    [_entries removeObjectForKey:entry.cacheKey];
+}
+
+@end
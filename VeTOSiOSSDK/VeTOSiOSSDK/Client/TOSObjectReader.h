@@ -0,0 +1,102 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSClient.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ 对象随机读取器：按blockSize将对象划分为块，读取时只下载未缓存的块，已下载的块按LRU保留在内存中。
+ 连续读取（本次起点紧接上次终点）时预读窗口从1块开始逐次翻倍，最多maxReadAheadBlocks块，
+ 预读范围拆分为多个区间并发下载，与调用方的消费重叠；随机读取时窗口归零，只下载覆盖请求区间的块。
+ 打开时通过headObject获取对象大小和ETag，之后的区间下载均携带If-Match，对象被修改时读取返回412错误。
+ */
+@interface TOSObjectReader : NSObject
+
+@property (nonatomic, copy, readonly) NSString *bucket;
+@property (nonatomic, copy, readonly) NSString *key;
+
+/**
+ 块大小，默认为128KB，需在首次读取前设置
+ */
+@property (nonatomic, assign) NSUInteger blockSize;
+
+/**
+ 内存中保留的块数上限，默认为128
+ */
+@property (nonatomic, assign) NSUInteger maxCachedBlocks;
+
+/**
+ 预读窗口上限（块数），默认为32，为0时关闭预读
+ */
+@property (nonatomic, assign) NSUInteger maxReadAheadBlocks;
+
+/**
+ 预读时同时在途的区间请求数上限，默认为4；覆盖当前读取区间的请求不受此限制
+ */
+@property (nonatomic, assign) NSUInteger maxConcurrentReadAheads;
+
+/**
+ 打开前为-1
+ */
+@property (atomic, assign, readonly) int64_t objectSize;
+@property (atomic, copy, readonly, nullable) NSString *eTag;
+
+/**
+ readLength:的读取位置
+ */
+@property (atomic, assign, readonly) int64_t position;
+
+@property (atomic, assign, readonly) int64_t requestCount; // 发起的区间下载数
+@property (atomic, assign, readonly) int64_t blockHitCount; // 已缓存或正在预读的块
+@property (atomic, assign, readonly) int64_t blockMissCount; // 读取时才开始下载的块
+
+/**
+ input为模板：tosBucket、tosKey为必填，tosVersionID及SSE-C字段随每次请求携带，其余字段被忽略
+ */
+- (instancetype)initWithClient:(TOSClient *)client input:(TOSGetObjectInput *)input NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ 获取对象大小和ETag，读取时会自动调用；多次调用返回同一Task
+ */
+- (TOSTask *)open;
+
+/**
+ 读取[offset, offset + length)，Task结果为NSData；超过对象末尾的部分被截断，起点不小于对象大小时返回空数据
+ */
+- (TOSTask *)readAtOffset:(int64_t)offset length:(NSUInteger)length;
+
+/**
+ 从position读取并将position后移实际读取的长度
+ */
+- (TOSTask *)readLength:(NSUInteger)length;
+
+/**
+ 设置position，offset为负数时返回NO
+ */
+- (BOOL)seekToOffset:(int64_t)offset error:(NSError **)error;
+
+/**
+ 取消在途下载并释放缓存，之后的读取返回错误
+ */
+- (void)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
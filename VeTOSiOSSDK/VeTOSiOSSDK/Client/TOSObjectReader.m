@@ -0,0 +1,363 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSObjectReader.h"
+#import <VeTOSiOSSDK/TOSTaskCompletionSource.h>
+
+static const NSUInteger TOSObjectReaderDefaultBlockSize = 128 * 1024;
+
+@implementation TOSObjectReader
+{
+    TOSClient *_client;
+    TOSGetObjectInput *_template;
+    TOSTask *_openTask;
+    int64_t _objectSize;
+    NSString *_eTag;
+    int64_t _position;
+    // 已下载的块，_lru头部优先淘汰
+    NSMutableDictionary<NSNumber *, NSData *> *_blocks;
+    NSMutableOrderedSet<NSNumber *> *_lru;
+    // 正在下载的块
+    NSMutableDictionary<NSNumber *, TOSTaskCompletionSource *> *_pending;
+    NSMutableSet<TOSGetObjectInput *> *_inflightInputs;
+    NSUInteger _inflightReadAheads;
+    int64_t _lastReadEnd;
+    NSUInteger _readAheadWindow;
+    uint64_t _activeBlockSize; // 打开时确定，之后修改blockSize不影响已划分的块
+    int64_t _requestCount;
+    int64_t _blockHitCount;
+    int64_t _blockMissCount;
+    BOOL _closed;
+}
+
+- (instancetype)initWithClient:(TOSClient *)client input:(TOSGetObjectInput *)input {
+    if (self = [super init]) {
+        _client = client;
+        _template = input;
+        _bucket = [input.tosBucket copy];
+        _key = [input.tosKey copy];
+        _blockSize = TOSObjectReaderDefaultBlockSize;
+        _maxCachedBlocks = 128;
+        _maxReadAheadBlocks = 32;
+        _maxConcurrentReadAheads = 4;
+        _objectSize = -1;
+        _lastReadEnd = -1;
+        _blocks = [NSMutableDictionary dictionary];
+        _lru = [NSMutableOrderedSet orderedSet];
+        _pending = [NSMutableDictionary dictionary];
+        _inflightInputs = [NSMutableSet set];
+    }
+    return self;
+}
+
+- (int64_t)objectSize {
+    @synchronized (self) {
+        return _objectSize;
+    }
+}
+
+- (NSString *)eTag {
+    @synchronized (self) {
+        return _eTag;
+    }
+}
+
+- (int64_t)position {
+    @synchronized (self) {
+        return _position;
+    }
+}
+
+- (int64_t)requestCount {
+    @synchronized (self) {
+        return _requestCount;
+    }
+}
+
+- (int64_t)blockHitCount {
+    @synchronized (self) {
+        return _blockHitCount;
+    }
+}
+
+- (int64_t)blockMissCount {
+    @synchronized (self) {
+        return _blockMissCount;
+    }
+}
+
++ (NSError *)closedError {
+    return [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: object reader is closed"}];
+}
+
+- (TOSTask *)open {
+    @synchronized (self) {
+        if (_closed) {
+            return [TOSTask taskWithError:[TOSObjectReader closedError]];
+        }
+        if (_openTask && !_openTask.faulted && !_openTask.cancelled) {
+            return _openTask;
+        }
+        TOSHeadObjectInput *input = [TOSHeadObjectInput new];
+        input.tosBucket = _template.tosBucket;
+        input.tosKey = _template.tosKey;
+        input.tosVersionID = _template.tosVersionID;
+        input.tosSSECAlgorithm = _template.tosSSECAlgorithm;
+        input.tosSSECKey = _template.tosSSECKey;
+        input.tosSSECKeyMD5 = _template.tosSSECKeyMD5;
+        _openTask = [[_client headObject:input] continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
+            TOSHeadObjectOutput *output = task.result;
+            @synchronized (self) {
+                self->_objectSize = output.tosContentLength;
+                self->_eTag = [output.tosETag copy];
+                self->_activeBlockSize = MAX(self->_blockSize, 1);
+            }
+            return nil;
+        }];
+        return _openTask;
+    }
+}
+
+- (TOSTask *)readAtOffset:(int64_t)offset length:(NSUInteger)length {
+    if (offset < 0) {
+        return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: invalid read offset"}]];
+    }
+    return [[self open] continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        return [self readOpenedAtOffset:offset length:length];
+    }];
+}
+
+- (TOSTask *)readLength:(NSUInteger)length {
+    return [[self open] continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        int64_t offset = 0;
+        @synchronized (self) {
+            offset = self->_position;
+            self->_position = MAX(offset, MIN(offset + (int64_t)length, self->_objectSize));
+        }
+        return [self readOpenedAtOffset:offset length:length];
+    }];
+}
+
+- (BOOL)seekToOffset:(int64_t)offset error:(NSError **)error {
+    if (offset < 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: invalid seek offset"}];
+        }
+        return NO;
+    }
+    @synchronized (self) {
+        _position = offset;
+    }
+    return YES;
+}
+
+- (void)close {
+    NSArray<TOSGetObjectInput *> *inputs = nil;
+    @synchronized (self) {
+        _closed = YES;
+        inputs = [_inflightInputs allObjects];
+        [_blocks removeAllObjects];
+        [_lru removeAllObjects];
+    }
+    for (TOSGetObjectInput *input in inputs) {
+        [input cancel];
+    }
+}
+
+#pragma mark - 读取
+
+- (TOSTask *)readOpenedAtOffset:(int64_t)offset length:(NSUInteger)length {
+    NSMutableArray<TOSTask *> *blockTasks = [NSMutableArray array];
+    NSMutableArray<NSValue *> *fetches = [NSMutableArray array];
+    NSArray<NSValue *> *readAheads = nil;
+    int64_t end = 0;
+    uint64_t blockSize = 0;
+    @synchronized (self) {
+        if (_closed) {
+            return [TOSTask taskWithError:[TOSObjectReader closedError]];
+        }
+        if (offset >= _objectSize || length == 0) {
+            return [TOSTask taskWithResult:[NSData data]];
+        }
+        blockSize = _activeBlockSize;
+        end = MIN(offset + (int64_t)length, _objectSize);
+        NSUInteger first = (NSUInteger)(offset / (int64_t)blockSize);
+        NSUInteger last = (NSUInteger)((end - 1) / (int64_t)blockSize);
+
+        // 起点落在上次终点之后一块以内视为连续读取，窗口翻倍；否则视为随机读取
+        BOOL sequential = _lastReadEnd >= 0 && offset >= _lastReadEnd && offset - _lastReadEnd <= (int64_t)blockSize;
+        if (sequential) {
+            _readAheadWindow = MIN(MAX(_readAheadWindow * 2, 1), _maxReadAheadBlocks);
+        } else {
+            _readAheadWindow = 0;
+        }
+        _lastReadEnd = end;
+
+        NSUInteger runStart = NSNotFound;
+        for (NSUInteger index = first; index <= last; index++) {
+            NSNumber *number = @(index);
+            NSData *block = _blocks[number];
+            TOSTaskCompletionSource *source = _pending[number];
+            if (block) {
+                [_lru removeObject:number];
+                [_lru addObject:number];
+                [blockTasks addObject:[TOSTask taskWithResult:block]];
+                _blockHitCount++;
+            } else if (source) {
+                [blockTasks addObject:source.task];
+                _blockHitCount++;
+            } else {
+                source = [TOSTaskCompletionSource taskCompletionSource];
+                _pending[number] = source;
+                [blockTasks addObject:source.task];
+                _blockMissCount++;
+                if (runStart == NSNotFound) {
+                    runStart = index;
+                }
+            }
+            // 连续缺失的块合并为一次下载
+            BOOL runEnds = index == last || _blocks[@(index + 1)] || _pending[@(index + 1)];
+            if (runStart != NSNotFound && runEnds) {
+                [fetches addObject:[NSValue valueWithRange:NSMakeRange(runStart, index - runStart + 1)]];
+                runStart = NSNotFound;
+            }
+        }
+        readAheads = [self readAheadRangesLockedAfterBlock:last];
+    }
+
+    for (NSValue *value in fetches) {
+        [self fetchBlocks:value.rangeValue readAhead:NO];
+    }
+    for (NSValue *value in readAheads) {
+        [self fetchBlocks:value.rangeValue readAhead:YES];
+    }
+    return [[TOSTask taskForCompletionOfAllTasksWithResults:blockTasks] continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        NSArray<NSData *> *blocks = task.result;
+        int64_t firstBlockStart = offset / (int64_t)blockSize * (int64_t)blockSize;
+        if (blocks.count == 1) {
+            return [blocks[0] subdataWithRange:NSMakeRange((NSUInteger)(offset - firstBlockStart), (NSUInteger)(end - offset))];
+        }
+        NSMutableData *data = [NSMutableData dataWithCapacity:(NSUInteger)(end - offset)];
+        int64_t blockStart = firstBlockStart;
+        for (NSData *block in blocks) {
+            int64_t from = MAX(offset, blockStart) - blockStart;
+            int64_t to = MIN(end, blockStart + (int64_t)block.length) - blockStart;
+            [data appendBytes:(const uint8_t *)block.bytes + from length:(NSUInteger)(to - from)];
+            blockStart += (int64_t)blockSize;
+        }
+        return data;
+    }];
+}
+
+// 调用方持有锁；将窗口内未缓存的块按在途上限拆分为多个区间，并登记为正在下载
+- (NSArray<NSValue *> *)readAheadRangesLockedAfterBlock:(NSUInteger)last {
+    NSMutableArray<NSValue *> *ranges = [NSMutableArray array];
+    if (_readAheadWindow == 0 || _maxConcurrentReadAheads == 0) {
+        return ranges;
+    }
+    uint64_t blockSize = _activeBlockSize;
+    NSUInteger lastBlock = (NSUInteger)((_objectSize - 1) / (int64_t)blockSize);
+    NSUInteger windowEnd = MIN(last + _readAheadWindow, lastBlock);
+    NSUInteger chunk = MAX(_readAheadWindow / _maxConcurrentReadAheads, 1);
+    NSUInteger index = last + 1;
+    while (index <= windowEnd && _inflightReadAheads < _maxConcurrentReadAheads) {
+        if (_blocks[@(index)] || _pending[@(index)]) {
+            index++;
+            continue;
+        }
+        NSUInteger start = index;
+        while (index <= windowEnd && index - start < chunk && !_blocks[@(index)] && !_pending[@(index)]) {
+            _pending[@(index)] = [TOSTaskCompletionSource taskCompletionSource];
+            index++;
+        }
+        _inflightReadAheads++;
+        [ranges addObject:[NSValue valueWithRange:NSMakeRange(start, index - start)]];
+    }
+    return ranges;
+}
+
+// readAhead为YES时计入预读在途数
+- (void)fetchBlocks:(NSRange)range readAhead:(BOOL)readAhead {
+    TOSGetObjectInput *input = [TOSGetObjectInput new];
+    int64_t start = 0;
+    int64_t end = 0;
+    uint64_t blockSize = 0;
+    @synchronized (self) {
+        blockSize = _activeBlockSize;
+        start = (int64_t)(range.location * blockSize);
+        end = MIN((int64_t)(NSMaxRange(range) * blockSize), _objectSize) - 1;
+        input.tosBucket = _template.tosBucket;
+        input.tosKey = _template.tosKey;
+        input.tosVersionID = _template.tosVersionID;
+        input.tosSSECAlgorithm = _template.tosSSECAlgorithm;
+        input.tosSSECKey = _template.tosSSECKey;
+        input.tosSSECKeyMD5 = _template.tosSSECKeyMD5;
+        input.tosIfMatch = _eTag;
+        input.tosRangeStart = start;
+        input.tosRangeEnd = end;
+        [_inflightInputs addObject:input];
+        _requestCount++;
+    }
+    [[_client getObject:input] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        NSError *error = task.error;
+        NSData *content = [task.result tosContent];
+        if (!error && (int64_t)content.length != end - start + 1) {
+            error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: unexpected length of ranged read"}];
+        }
+        NSMutableArray<TOSTaskCompletionSource *> *sources = [NSMutableArray arrayWithCapacity:range.length];
+        NSMutableArray<NSData *> *blocks = [NSMutableArray arrayWithCapacity:range.length];
+        @synchronized (self) {
+            [self->_inflightInputs removeObject:input];
+            if (readAhead) {
+                self->_inflightReadAheads--;
+            }
+            for (NSUInteger index = range.location; index < NSMaxRange(range); index++) {
+                NSNumber *number = @(index);
+                TOSTaskCompletionSource *source = self->_pending[number];
+                [self->_pending removeObjectForKey:number];
+                if (!source) {
+                    continue;
+                }
+                [sources addObject:source];
+                if (error) {
+                    continue;
+                }
+                NSUInteger from = (NSUInteger)((int64_t)(index * blockSize) - start);
+                NSData *block = [content subdataWithRange:NSMakeRange(from, MIN((NSUInteger)blockSize, content.length - from))];
+                [blocks addObject:block];
+                if (!self->_closed && self->_maxCachedBlocks > 0) {
+                    self->_blocks[number] = block;
+                    [self->_lru removeObject:number];
+                    [self->_lru addObject:number];
+                }
+            }
+            while (self->_lru.count > self->_maxCachedBlocks) {
+                [self->_blocks removeObjectForKey:self->_lru.firstObject];
+                [self->_lru removeObjectAtIndex:0];
+            }
+        }
+        for (NSUInteger i = 0; i < sources.count; i++) {
+            if (error) {
+                [sources[i] trySetError:error];
+            } else {
+                [sources[i] trySetResult:blocks[i]];
+            }
+        }
+        return nil;
+    }];
+}
+
+@end
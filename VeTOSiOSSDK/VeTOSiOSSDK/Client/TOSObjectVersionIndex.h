@@ -0,0 +1,40 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ 对象缓存的键及版本索引：条目按bucket/key/versionID寻址，同一对象的各版本条目按bucket/key聚合，
+ 写操作据此使对象的所有版本失效。非线程安全，由持有者加锁访问。
+ */
+@interface TOSObjectVersionIndex : NSObject
+
++ (NSString *)objectKeyForBucket:(NSString *)bucket key:(NSString *)key;
++ (NSString *)cacheKeyForBucket:(NSString *)bucket key:(NSString *)key versionID:(nullable NSString *)versionID;
+
+- (void)addCacheKey:(NSString *)cacheKey objectKey:(NSString *)objectKey;
+- (void)removeCacheKey:(NSString *)cacheKey objectKey:(NSString *)objectKey;
+
+/**
+ 对象当前所有版本的条目，返回副本，遍历期间可以删除条目
+ */
+- (NSArray<NSString *> *)cacheKeysForObjectKey:(NSString *)objectKey;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,60 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSObjectVersionIndex.h"
+
+@implementation TOSObjectVersionIndex
+{
+    NSMutableDictionary<NSString *, NSMutableSet<NSString *> *> *_versions;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _versions = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
++ (NSString *)objectKeyForBucket:(NSString *)bucket key:(NSString *)key {
+    return [NSString stringWithFormat:@"%@/%@", bucket, key];
+}
+
++ (NSString *)cacheKeyForBucket:(NSString *)bucket key:(NSString *)key versionID:(NSString *)versionID {
+    return [NSString stringWithFormat:@"%@/%@?%@", bucket, key, versionID ?: @""];
+}
+
+- (void)addCacheKey:(NSString *)cacheKey objectKey:(NSString *)objectKey {
+    NSMutableSet<NSString *> *versions = _versions[objectKey];
+    if (!versions) {
+        versions = [NSMutableSet set];
+        _versions[objectKey] = versions;
+    }
+    [versions addObject:cacheKey];
+}
+
+- (void)removeCacheKey:(NSString *)cacheKey objectKey:(NSString *)objectKey {
+    NSMutableSet<NSString *> *versions = _versions[objectKey];
+    [versions removeObject:cacheKey];
+    if (versions.count == 0) {
+        [_versions removeObjectForKey:objectKey];
+    }
+}
+
+- (NSArray<NSString *> *)cacheKeysForObjectKey:(NSString *)objectKey {
+    return [_versions[objectKey] allObjects] ?: @[];
+}
+
+@end
@@ -0,0 +1,85 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSClient.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ 流式分段上传写入器：写入的数据按partSize切分为段，段写满后立即上传，最多taskNum个段并发上传。
+ 在途的段达到taskNum时write阻塞调用线程直到有段上传完成，内存占用不超过(taskNum + 1) * partSize，请勿在主线程调用。
+ 第一个段写满时才创建分段上传任务；close时总大小不足一个段则改为一次putObject上传。
+ 本地按段计算CRC64并合并，与合并段返回的x-tos-hash-crc64ecma比对。
+ 任一请求失败后写入器进入失败状态，等待在途的段结束后取消分段上传任务，后续write、close均返回该错误。
+ */
+@interface TOSObjectWriter : NSObject
+
+@property (nonatomic, copy, readonly) NSString *bucket;
+@property (nonatomic, copy, readonly) NSString *key;
+
+/**
+ 段大小，默认为20MB，小于5MB时按5MB处理，需在首次写入前设置
+ */
+@property (nonatomic, assign) int64_t partSize;
+
+/**
+ 并发上传的段数，默认为3，取值范围为[1, 5]，需在首次写入前设置
+ */
+@property (nonatomic, assign) int taskNum;
+
+/**
+ 分段上传任务ID，未创建时为nil
+ */
+@property (atomic, copy, readonly, nullable) NSString *uploadID;
+
+@property (atomic, assign, readonly) int64_t bytesWritten;
+@property (atomic, assign, readonly) int64_t partCount; // 已发起上传的段数
+
+/**
+ close成功后的结果
+ */
+@property (atomic, copy, readonly, nullable) NSString *eTag;
+@property (atomic, copy, readonly, nullable) NSString *versionID;
+@property (atomic, assign, readonly) uint64_t hashCrc64ecma;
+
+/**
+ input为模板：tosBucket、tosKey为必填，元数据、ACL、SSE-C等字段用于创建分段上传任务或单次上传，
+ SSE-C字段同时随每个段携带
+ */
+- (instancetype)initWithClient:(TOSClient *)client input:(TOSCreateMultipartUploadInput *)input NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ 写入数据，段写满时发起上传；并发已满时阻塞至有段上传完成；写入器已关闭或已失败时返回NO
+ */
+- (BOOL)write:(NSData *)data error:(NSError **)error;
+
+/**
+ 上传剩余数据并合并段，Task结果为TOSPutObjectOutput（单次上传）或TOSCompleteMultipartUploadOutput；
+ 多次调用返回同一Task
+ */
+- (TOSTask *)close;
+
+/**
+ 取消在途的段并取消分段上传任务，之后的write、close返回错误；close之后调用返回错误
+ */
+- (TOSTask *)abort;
+
+@end
+
+NS_ASSUME_NONNULL_END
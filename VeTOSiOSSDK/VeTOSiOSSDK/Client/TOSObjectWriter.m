@@ -0,0 +1,405 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSObjectWriter.h"
+#import <VeTOSiOSSDK/TOSUtil.h>
+#import <VeTOSiOSSDK/TOSConstants.h>
+#import <VeTOSiOSSDK/TOSTaskCompletionSource.h>
+
+static const int TOSObjectWriterDefaultTaskNum = 3;
+
+@interface TOSObjectWriter ()
+@property (atomic, copy, readwrite, nullable) NSString *uploadID;
+@property (atomic, copy, readwrite, nullable) NSString *eTag;
+@property (atomic, copy, readwrite, nullable) NSString *versionID;
+@property (atomic, assign, readwrite) uint64_t hashCrc64ecma;
+@end
+
+@implementation TOSObjectWriter
+{
+    TOSClient *_client;
+    TOSCreateMultipartUploadInput *_template;
+    BOOL _started;
+    int64_t _activePartSize; // 首次写入时确定
+    NSMutableData *_buffer;
+    int _nextPartNumber;
+    int64_t _bytesWritten;
+    int64_t _partCount;
+    dispatch_semaphore_t _slots; // 并发上传的段数
+    dispatch_group_t _group; // 在途的段
+    TOSTask *_createTask; // 结果为uploadID
+    NSMutableSet<TOSUploadPartInput *> *_inflight;
+    NSMutableDictionary<NSNumber *, TOSUploadedPart *> *_parts;
+    NSMutableDictionary<NSNumber *, NSNumber *> *_partCRCs;
+    NSError *_error;
+    BOOL _closed;
+    TOSTask *_closeTask;
+    TOSTask *_abortTask;
+}
+
+- (instancetype)initWithClient:(TOSClient *)client input:(TOSCreateMultipartUploadInput *)input {
+    if (self = [super init]) {
+        _client = client;
+        _template = input;
+        _bucket = [input.tosBucket copy];
+        _key = [input.tosKey copy];
+        _partSize = TOSDefaultPartSize;
+        _taskNum = TOSObjectWriterDefaultTaskNum;
+        _nextPartNumber = 1;
+        _group = dispatch_group_create();
+        _inflight = [NSMutableSet set];
+        _parts = [NSMutableDictionary dictionary];
+        _partCRCs = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (int64_t)bytesWritten {
+    @synchronized (self) {
+        return _bytesWritten;
+    }
+}
+
+- (int64_t)partCount {
+    @synchronized (self) {
+        return _partCount;
+    }
+}
+
+- (BOOL)write:(NSData *)data error:(NSError **)error {
+    NSUInteger consumed = 0;
+    while (consumed < data.length) {
+        NSError *writeError = nil;
+        NSData *part = nil;
+        int partNumber = 0;
+        @synchronized (self) {
+            if (_error) {
+                writeError = _error;
+            } else if (_closed) {
+                writeError = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: object writer is closed"}];
+            } else {
+                [self startLocked];
+                if (!_buffer) {
+                    _buffer = [NSMutableData dataWithCapacity:(NSUInteger)_activePartSize];
+                }
+                NSUInteger n = (NSUInteger)MIN((int64_t)(data.length - consumed), _activePartSize - (int64_t)_buffer.length);
+                [_buffer appendBytes:(const uint8_t *)data.bytes + consumed length:n];
+                consumed += n;
+                _bytesWritten += n;
+                if ((int64_t)_buffer.length == _activePartSize) {
+                    part = _buffer;
+                    _buffer = nil;
+                    partNumber = _nextPartNumber++;
+                }
+            }
+        }
+        if (writeError) {
+            if (error) {
+                *error = writeError;
+            }
+            return NO;
+        }
+        if (part) {
+            [self uploadPartData:part partNumber:partNumber];
+        }
+    }
+    return YES;
+}
+
+- (TOSTask *)close {
+    NSData *last = nil;
+    int partNumber = 0;
+    BOOL multipart = NO;
+    @synchronized (self) {
+        if (_closeTask) {
+            return _closeTask;
+        }
+        if (_error) {
+            return [TOSTask taskWithError:_error];
+        }
+        _closed = YES;
+        [self startLocked];
+        multipart = _createTask != nil;
+        last = _buffer ?: [NSData data];
+        _buffer = nil;
+        if (multipart && last.length > 0) {
+            partNumber = _nextPartNumber++;
+        }
+    }
+    TOSTask *task = nil;
+    if (!multipart) {
+        task = [self putObjectData:last];
+    } else {
+        if (partNumber > 0) {
+            [self uploadPartData:last partNumber:partNumber];
+        }
+        task = [self completeWhenIdle];
+    }
+    @synchronized (self) {
+        if (!_closeTask) {
+            _closeTask = task;
+        }
+        return _closeTask;
+    }
+}
+
+- (TOSTask *)abort {
+    NSArray<TOSUploadPartInput *> *inflight = nil;
+    @synchronized (self) {
+        if (_closeTask) {
+            return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: object writer is closed"}]];
+        }
+        _closed = YES;
+        if (!_error) {
+            _error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: object writer is aborted"}];
+        }
+        inflight = [_inflight allObjects];
+    }
+    for (TOSUploadPartInput *input in inflight) {
+        [input cancel];
+    }
+    return [self abortWhenIdle];
+}
+
+#pragma mark - 上传
+
+// 调用方持有锁；首次写入时确定段大小和并发数
+- (void)startLocked {
+    if (_started) {
+        return;
+    }
+    _started = YES;
+    _activePartSize = MIN(MAX(_partSize, TOSMinPartSize), TOSMaxPartSize);
+    int taskNum = MIN(MAX(_taskNum, TOSMinTaskNum), TOSMaxTaskNum);
+    _slots = dispatch_semaphore_create(taskNum);
+}
+
+- (TOSTask *)createMultipartUpload {
+    return [[_client createMultipartUpload:_template] continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        TOSCreateMultipartUploadOutput *output = task.result;
+        self.uploadID = output.tosUploadID;
+        return output.tosUploadID;
+    }];
+}
+
+- (void)uploadPartData:(NSData *)data partNumber:(int)partNumber {
+    // 并发已满时阻塞写入方，限制缓冲的段数
+    dispatch_semaphore_wait(_slots, DISPATCH_TIME_FOREVER);
+    TOSUploadPartInput *input = [TOSUploadPartInput new];
+    input.tosBucket = _template.tosBucket;
+    input.tosKey = _template.tosKey;
+    input.tosPartNumber = partNumber;
+    input.tosSSECAlgorithm = _template.tosSSECAlgorithm;
+    input.tosSSECKey = _template.tosSSECKey;
+    input.tosSSECKeyMD5 = _template.tosSSECKeyMD5;
+    input.tosContent = data;
+    input.tosContentLength = (int64_t)data.length;
+    TOSTask *createTask = nil;
+    @synchronized (self) {
+        if (_error) {
+            dispatch_semaphore_signal(_slots);
+            return;
+        }
+        if (!_createTask) {
+            _createTask = [self createMultipartUpload];
+        }
+        createTask = _createTask;
+        [_inflight addObject:input];
+        _partCount++;
+        dispatch_group_enter(_group);
+    }
+    uint64_t partCRC = [TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length];
+    [[createTask continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        input.tosUploadID = task.result;
+        if (input.isCancelled) {
+            return [TOSTask cancelledTask];
+        }
+        return [self->_client uploadPart:input];
+    }] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        NSError *error = task.error;
+        if (!error && task.cancelled) {
+            error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: upload part is cancelled"}];
+        }
+        BOOL failed = NO;
+        @synchronized (self) {
+            [self->_inflight removeObject:input];
+            if (error) {
+                if (!self->_error) {
+                    self->_error = error;
+                }
+                failed = YES;
+            } else {
+                TOSUploadPartOutput *output = task.result;
+                TOSUploadedPart *part = [TOSUploadedPart new];
+                part.tosPartNumber = partNumber;
+                part.tosETag = output.tosETag;
+                part.tosSize = (int64_t)data.length;
+                self->_parts[@(partNumber)] = part;
+                self->_partCRCs[@(partNumber)] = @(partCRC);
+            }
+        }
+        dispatch_semaphore_signal(self->_slots);
+        dispatch_group_leave(self->_group);
+        if (failed) {
+            [self abortWhenIdle];
+        }
+        return nil;
+    }];
+}
+
+- (TOSTask *)putObjectData:(NSData *)data {
+    TOSPutObjectInput *input = [TOSPutObjectInput new];
+    input.tosBucket = _template.tosBucket;
+    input.tosKey = _template.tosKey;
+    input.tosCacheControl = _template.tosCacheControl;
+    input.tosContentDisposition = _template.tosContentDisposition;
+    input.tosContentEncoding = _template.tosContentEncoding;
+    input.tosContentLanguage = _template.tosContentLanguage;
+    input.tosContentType = _template.tosContentType;
+    input.tosExpires = _template.tosExpires;
+    input.tosACL = _template.tosACL;
+    input.tosGrantFullControl = _template.tosGrantFullControl;
+    input.tosGrantRead = _template.tosGrantRead;
+    input.tosGrantReadAcp = _template.tosGrantReadAcp;
+    input.tosGrantWriteAcp = _template.tosGrantWriteAcp;
+    input.tosSSECAlgorithm = _template.tosSSECAlgorithm;
+    input.tosSSECKey = _template.tosSSECKey;
+    input.tosSSECKeyMD5 = _template.tosSSECKeyMD5;
+    input.tosServerSideEncryption = _template.tosServerSideEncryption;
+    input.tosMeta = _template.tosMeta;
+    input.tosWebsiteRedirectLocation = _template.tosWebsiteRedirectLocation;
+    input.tosStorageClass = _template.tosStorageClass;
+    input.tosContent = data;
+    input.tosContentLength = (int64_t)data.length;
+    uint64_t crc = [TOSUtil crc64ecma:0 buffer:(void *)data.bytes length:data.length];
+    return [[_client putObject:input] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        NSError *error = task.error;
+        TOSPutObjectOutput *output = task.result;
+        if (!error && output.tosHashCrc64ecma != 0 && output.tosHashCrc64ecma != crc) {
+            error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: crc of uploaded object mismatch"}];
+        }
+        if (error) {
+            @synchronized (self) {
+                if (!self->_error) {
+                    self->_error = error;
+                }
+            }
+            return [TOSTask taskWithError:error];
+        }
+        self.eTag = output.tosETag;
+        self.versionID = output.tosVersionID;
+        self.hashCrc64ecma = crc;
+        return [TOSTask taskWithResult:output];
+    }];
+}
+
+// 在途的段全部结束后合并段，失败时取消分段上传任务
+- (TOSTask *)completeWhenIdle {
+    TOSTaskCompletionSource *source = [TOSTaskCompletionSource taskCompletionSource];
+    dispatch_group_notify(_group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSError *error = nil;
+        NSArray<TOSUploadedPart *> *parts = nil;
+        uint64_t crc = 0;
+        @synchronized (self) {
+            error = self->_error;
+            parts = [self->_parts.allValues sortedArrayUsingComparator:^NSComparisonResult(TOSUploadedPart *a, TOSUploadedPart *b) {
+                return a.tosPartNumber < b.tosPartNumber ? NSOrderedAscending : (a.tosPartNumber > b.tosPartNumber ? NSOrderedDescending : NSOrderedSame);
+            }];
+            for (TOSUploadedPart *part in parts) {
+                uint64_t partCRC = [self->_partCRCs[@(part.tosPartNumber)] unsignedLongLongValue];
+                crc = [TOSUtil crc64ForCombineCRC1:crc CRC2:partCRC length:(uintmax_t)part.tosSize];
+            }
+        }
+        if (error) {
+            [[self abortWhenIdle] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+                [source trySetError:error];
+                return nil;
+            }];
+            return;
+        }
+        TOSCompleteMultipartUploadInput *input = [TOSCompleteMultipartUploadInput new];
+        input.tosBucket = self->_template.tosBucket;
+        input.tosKey = self->_template.tosKey;
+        input.tosUploadID = self.uploadID;
+        input.tosParts = parts;
+        [[self->_client completeMultipartUpload:input] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+            TOSCompleteMultipartUploadOutput *output = task.result;
+            if (task.error) {
+                @synchronized (self) {
+                    if (!self->_error) {
+                        self->_error = task.error;
+                    }
+                }
+                [[self abortWhenIdle] continueWithBlock:^id _Nullable(TOSTask * _Nonnull t) {
+                    [source trySetError:task.error];
+                    return nil;
+                }];
+            } else if (output.tosHashCrc64ecma != 0 && output.tosHashCrc64ecma != crc) {
+                // 合并已完成，对象无法回滚，只报告错误
+                [source trySetError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: crc of uploaded object mismatch"}]];
+            } else {
+                self.eTag = output.tosETag;
+                self.versionID = output.tosVersionID;
+                self.hashCrc64ecma = crc;
+                [source trySetResult:output];
+            }
+            return nil;
+        }];
+    });
+    return source.task;
+}
+
+// 在途的段全部结束后取消分段上传任务，只执行一次；未创建任务时直接完成
+- (TOSTask *)abortWhenIdle {
+    TOSTaskCompletionSource *source = nil;
+    TOSTask *createTask = nil;
+    @synchronized (self) {
+        if (_abortTask) {
+            return _abortTask;
+        }
+        source = [TOSTaskCompletionSource taskCompletionSource];
+        _abortTask = source.task;
+        createTask = _createTask;
+    }
+    if (!createTask) {
+        [source trySetResult:nil];
+        return source.task;
+    }
+    dispatch_group_notify(_group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [createTask continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
+            if (task.error || task.cancelled) {
+                [source trySetResult:nil];
+                return nil;
+            }
+            TOSAbortMultipartUploadInput *input = [TOSAbortMultipartUploadInput new];
+            input.tosBucket = self->_template.tosBucket;
+            input.tosKey = self->_template.tosKey;
+            input.tosUploadID = task.result;
+            [[self->_client abortMultipartUpload:input] continueWithBlock:^id _Nullable(TOSTask * _Nonnull t) {
+                if (t.error) {
+                    [source trySetError:t.error];
+                } else {
+                    [source trySetResult:nil];
+                }
+                return nil;
+            }];
+            return nil;
+        }];
+    });
+    return source.task;
+}
+
+@end
@@ -15,12 +15,18 @@
  */
 
 #import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSCancellationToken.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface TOSInput : NSObject
 
+// 置为YES即取消：不再发起新的请求，并立即中断该操作已发出的请求（包括uploadFile的各个分片）
 @property (nonatomic, assign) BOOL isCancelled;
+// 随isCancelled触发的取消令牌，SDK据此中断在途的NSURLSessionTask；isCancelled置回NO后返回新的令牌
+@property (nonatomic, strong, readonly) TOSCancellationToken *tosCancellationToken;
+
+- (void)cancel;
 
 - (NSDictionary *)queryParamsDict;
 - (NSDictionary *)headerParamsDict;
@@ -16,6 +16,7 @@
 
 #import "TOSInput.h"
 #import <VeTOSiOSSDK/TOSNetworkingRequestDelegate.h>
+#import <VeTOSiOSSDK/TOSCancellationTokenSource.h>
 
 //@interface TOSRequest ()
 //
@@ -23,7 +24,9 @@
 //
 //@end
 
-@implementation TOSInput
+@implementation TOSInput {
+    TOSCancellationTokenSource *_cancellationTokenSource;
+}
 
 //- (instancetype)init {
 //    if (self = [super init]) {
@@ -37,6 +40,34 @@
     self.isCancelled = YES;
 }
 
+- (void)setIsCancelled:(BOOL)isCancelled {
+    _isCancelled = isCancelled;
+    if (isCancelled) {
+        [[self cancellationTokenSource] cancel];
+    } else {
+        // 重新使用输入时换一个新的令牌，已取消的令牌无法恢复
+        @synchronized (self) {
+            if (_cancellationTokenSource.isCancellationRequested) {
+                _cancellationTokenSource = nil;
+            }
+        }
+    }
+}
+
+- (TOSCancellationToken *)tosCancellationToken {
+    return [self cancellationTokenSource].token;
+}
+
+// 首次使用时创建，未发起请求的输入不产生额外开销
+- (TOSCancellationTokenSource *)cancellationTokenSource {
+    @synchronized (self) {
+        if (!_cancellationTokenSource) {
+            _cancellationTokenSource = [TOSCancellationTokenSource cancellationTokenSource];
+        }
+        return _cancellationTokenSource;
+    }
+}
+
 - (NSDictionary *)queryParamsDict {
     return nil;
 }
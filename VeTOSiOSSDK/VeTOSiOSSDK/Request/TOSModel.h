@@ -198,6 +198,34 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 
+/**
+ 批量删除/DeleteObjects
+ 按枚举器或前缀流式删除，每1000个对象一批，以Quiet模式并发发起DeleteMultiObjects
+ */
+@interface TOSDeleteObjectsInput : TOSInput
+@property (nonatomic, copy) NSString *tosBucket; // required
+@property (nonatomic, strong) NSEnumerator<TOSObjectTobeDeleted *> *tosObjectEnumerator; // required，仅在后台线程上按需读取
+@property (nonatomic, assign) int tosBatchSize; // 单次DeleteMultiObjects的对象数，默认且最大为1000
+@property (nonatomic, assign) int tosTaskNum; // 并发请求数，默认为4
+@end
+
+@interface TOSDeleteObjectsByPrefixInput : TOSInput
+@property (nonatomic, copy) NSString *tosBucket; // required
+@property (nonatomic, copy) NSString *tosPrefix; // 为空时删除桶内所有对象
+@property (nonatomic, assign) BOOL tosIncludeVersions; // 通过ListObjectVersions列举，删除所有版本及删除标记
+@property (nonatomic, assign) int tosBatchSize; // 单次DeleteMultiObjects的对象数，默认且最大为1000
+@property (nonatomic, assign) int tosTaskNum; // 并发请求数，默认为4
+@end
+
+@interface TOSDeleteObjectsOutput : TOSOutput
+@property (nonatomic, assign) int64_t tosDeletedCount; // 删除成功的对象（版本）数
+@property (nonatomic, copy) NSArray<TOSDeleteError *> *tosErrors; // 各批次返回的删除失败项
+@property (nonatomic, assign) int tosRequestCount; // 发起的DeleteMultiObjects请求数
+@property (nonatomic, assign) NSTimeInterval tosElapsedTime; // 总耗时，秒
+@property (nonatomic, assign) double tosObjectsPerSecond; // 删除吞吐
+@end
+
+
 /**
  下载对象/GetObject
  */
@@ -234,6 +262,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, copy) TOSNetworkingDownloadProgressBlock tosDownloadProgress; // 下载进度条
 @property (nonatomic, copy) TOSNetworkingOnRecieveDataBlock tosOnReceiveData;
+@property (nonatomic, assign) BOOL tosDiscontiguousContent; // tosContent保留网络接收的分片（dispatch_data），不拼接为连续内存，建议通过enumerateByteRangesUsingBlock:读取
 @end
 
 @interface TOSGetObjectBasicOutput : TOSOutput
@@ -270,11 +299,43 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @interface TOSGetObjectToFileInput : TOSGetObjectInput
 @property (nonatomic, copy) NSString * tosFilePath;
+@property (nonatomic, assign) TOSFileSyncPolicy tosFileSyncPolicy; // 默认TOSFileSyncPolicyNone
 @end
 
 @interface TOSGetObjectToFileOutput : TOSGetObjectBasicOutput
 @end
 
+/**
+ 批量区间下载/GetObjectRanges
+ */
+@interface TOSGetObjectRange : NSObject
+@property (nonatomic, assign) int64_t tosRangeStart;
+@property (nonatomic, assign) int64_t tosRangeEnd; // 闭区间
+@end
+
+@interface TOSGetObjectRangesInput : TOSInput
+@property (nonatomic, copy) NSString *tosBucket; // required
+@property (nonatomic, copy) NSString *tosKey; // required
+@property (nonatomic, copy) NSString *tosVersionID;
+@property (nonatomic, copy) NSArray<TOSGetObjectRange *> *tosRanges; // required，可乱序、可重叠
+@property (nonatomic, assign) int64_t tosMergeGap; // 间隔不超过该字节数的区间合并为一次请求，默认64KB，为负数时只合并重叠或相邻的区间
+@property (nonatomic, assign) int tosTaskNum; // 并发请求数，默认为4
+
+@property (nonatomic, copy) NSString *tosIfMatch;
+
+@property (nonatomic, copy) NSString *tosSSECAlgorithm;
+@property (nonatomic, copy) NSString *tosSSECKey;
+@property (nonatomic, copy) NSString *tosSSECKeyMD5;
+@end
+
+@interface TOSGetObjectRangesOutput : TOSOutput
+@property (nonatomic, copy) NSString *tosETag;
+@property (nonatomic, copy) NSString *tosVersionID;
+@property (nonatomic, assign) int64_t tosObjectSize;
+@property (nonatomic, copy) NSArray<NSData *> *tosContents; // 与tosRanges一一对应，引用合并请求下载的数据，不拷贝；超出对象末尾的部分被截断
+@property (nonatomic, assign) int tosRequestCount; // 合并后发起的GetObject请求数
+@end
+
 
 /**
  获取对象访问权限/GetObjectACL
@@ -827,6 +888,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, copy) NSString *tosETag;
 @property (nonatomic, strong) NSDate *tosLastModified;
 @property (nonatomic, copy) NSString *tosCopySourceVersionID;
+@property (nonatomic, assign) uint64_t tosHashCrc64ecma; // 服务端未返回时为0
 
 @end
 
@@ -971,7 +1033,7 @@ typedef void (^TOSUploadEventListener) (TOSUploadEvent *e);
 @property (nonatomic, assign) int tosTaskNum; // 并发数，默认为1
 @property (nonatomic, assign) BOOL tosEnableCheckpoint; // 是否启用断点续传（是否保存CheckPoint文件）
 @property (nonatomic, copy) NSString *tosCheckpointFile; // 断点续传文件全路径，如果是文件夹，则在该文件夹下生成断点续传文件，命名方式：FilePath文件名+"."+桶名+"."+对象名+"."+upload，如果为空，就在FilePath的同路径下以前述命名方式生成断点续传文件
-//@property (nonatomic, copy) TOSNetworkingUploadProgressBlock tosUploadProgress;
+@property (nonatomic, copy) TOSNetworkingUploadProgressBlock tosUploadProgress; // 上传文件进度条，各分片进度合并后回调
 @property (nonatomic, copy) TOSUploadEventListener tosUploadEventListener;
 @end
 
@@ -992,6 +1054,53 @@ typedef void (^TOSUploadEventListener) (TOSUploadEvent *e);
 @end
 
 
+// 实现NSCoding协议
+@interface TOSCopyFileCheckpoint : NSObject <NSCoding>
+@property (nonatomic, copy) NSString *tosBucket;
+@property (nonatomic, copy) NSString *tosKey;
+@property (nonatomic, copy) NSString *tosSrcBucket;
+@property (nonatomic, copy) NSString *tosSrcKey;
+@property (nonatomic, copy) NSString *tosSrcVersionID;
+@property (nonatomic, copy) NSString *tosSrcETag; // 源对象ETag，源对象变化后CheckPoint失效
+@property (nonatomic, assign) uint64_t tosSrcObjectSize;
+@property (nonatomic, assign) uint64_t tosSrcHashCrc64ecma;
+@property (nonatomic, assign) int64_t tosPartSize;
+@property (nonatomic, copy) NSString *tosUploadID;
+@property (nonatomic, strong) NSArray<TOSUploadPartInfo *> *tosPartsInfo; // tosOffset为源对象中的偏移
+@end
+
+// 断点续传复制/CopyFile
+// 源对象不超过tosCopyThreshold时使用CopyObject，否则使用UploadPartCopy并发复制分段
+// 未设置tosMeta和tosContentType时沿用源对象的元数据，否则以Input中的元数据替换
+@interface TOSCopyFileInput : TOSCreateMultipartUploadInput <NSMutableCopying>
+@property (nonatomic, copy) NSString *tosSrcBucket; // required
+@property (nonatomic, copy) NSString *tosSrcKey; // required
+@property (nonatomic, copy) NSString *tosSrcVersionID;
+
+@property (nonatomic, copy) NSString *tosCopySourceSSECAlgorithm;
+@property (nonatomic, copy) NSString *tosCopySourceSSECKey;
+@property (nonatomic, copy) NSString *tosCopySourceSSECKeyMD5;
+
+@property (nonatomic, assign) int64_t tosPartSize; // 默认为20MB
+@property (nonatomic, assign) int tosTaskNum; // 并发数，默认为1
+@property (nonatomic, assign) int64_t tosCopyThreshold; // 默认为64MB，最大为5GB
+@property (nonatomic, assign) BOOL tosEnableCheckpoint; // 是否启用断点续传（是否保存CheckPoint文件）
+@property (nonatomic, copy) NSString *tosCheckpointFile; // 断点续传文件全路径，如果是文件夹，则在该文件夹下生成断点续传文件，命名方式：源桶名+"."+源对象名+"."+桶名+"."+对象名经Base64编码+"."+copy，如果为空，就在临时目录下以前述命名方式生成断点续传文件
+@property (nonatomic, copy) TOSNetworkingUploadProgressBlock tosCopyProgress; // 复制进度，按已完成的分段回调
+@end
+
+@interface TOSCopyFileOutput : TOSOutput
+@property (nonatomic, copy) NSString *tosBucket;
+@property (nonatomic, copy) NSString *tosKey;
+@property (nonatomic, copy) NSString *tosUploadID; // 使用CopyObject复制时为空
+@property (nonatomic, copy) NSString *tosETag;
+@property (nonatomic, copy) NSString *tosVersionID;
+@property (nonatomic, copy) NSString *tosCopySourceVersionID;
+@property (nonatomic, assign) uint64_t tosHashCrc64ecma;
+@property (nonatomic, assign) int tosPartCount; // 使用CopyObject复制时为0
+@end
+
+
 /**
  * 自定义域名模型/CustomDomainRule
  */
@@ -1037,4 +1146,19 @@ typedef void (^TOSUploadEventListener) (TOSUploadEvent *e);
 @interface TOSDeleteBucketCustomDomainOutput : TOSOutput
 @end
 
+/**
+ * 连接预热/Prewarm
+ */
+@interface TOSPrewarmInput : TOSInput
+@property (nonatomic, copy) NSArray<NSString *> *tosBuckets; // 为空时只预热endpoint域名；非自定义域名时分别预热各桶的虚拟主机域名
+@property (nonatomic, copy) NSString *tosKey; // 设置后以HEAD该对象代替headBucket，对象不存在时的404同样完成连接建立
+@property (nonatomic, assign) int tosConnectionCount; // 每个域名并发发起的请求数，默认为4，超过HTTPMaximumConnectionsPerHost的部分不会建立新连接
+@property (nonatomic, assign) NSTimeInterval tosKeepAliveInterval; // 空闲超过该时间时重新发送预热请求，应小于服务端的连接空闲超时，0为不刷新
+@end
+
+@interface TOSPrewarmOutput : TOSOutput
+@property (nonatomic, assign) int tosRequestCount;
+@property (nonatomic, assign) int tosFailedCount; // 未收到服务端响应的请求数，服务端返回的错误码不计入
+@end
+
 NS_ASSUME_NONNULL_END
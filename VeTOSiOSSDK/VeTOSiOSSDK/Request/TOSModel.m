@@ -112,7 +112,7 @@
     }
     if ([TOSUtil isNotEmptyString:_tosSrcBucket] && [TOSUtil isNotEmptyString:_tosSrcKey]) {
         if ([TOSUtil isNotEmptyString:_tosSrcVersionID]) {
-            [headerParams setObject:[NSString stringWithFormat:@"/%@/%@?versionId%@", _tosSrcBucket, _tosSrcKey, _tosSrcVersionID] forKey:@"x-tos-copy-source"];
+            [headerParams setObject:[NSString stringWithFormat:@"/%@/%@?versionId=%@", _tosSrcBucket, _tosSrcKey, _tosSrcVersionID] forKey:@"x-tos-copy-source"];
         } else {
             [headerParams setObject:[NSString stringWithFormat:@"/%@/%@", _tosSrcBucket, _tosSrcKey] forKey:@"x-tos-copy-source"];
         }
@@ -242,6 +242,19 @@
 @end
 
 
+/**
+ 批量删除/DeleteObjects
+ */
+@implementation TOSDeleteObjectsInput
+@end
+
+@implementation TOSDeleteObjectsByPrefixInput
+@end
+
+@implementation TOSDeleteObjectsOutput
+@end
+
+
 /**
  下载对象/GetObject
  */
@@ -335,6 +348,18 @@
 @implementation TOSGetObjectToFileOutput
 @end
 
+/**
+ 批量区间下载/GetObjectRanges
+ */
+@implementation TOSGetObjectRange
+@end
+
+@implementation TOSGetObjectRangesInput
+@end
+
+@implementation TOSGetObjectRangesOutput
+@end
+
 
 /**
  获取对象访问权限/GetObjectACL
@@ -1378,7 +1403,7 @@
     cp.tosTaskNum = self.tosTaskNum;
     cp.tosEnableCheckpoint = self.tosEnableCheckpoint;
     cp.tosCheckpointFile = self.tosCheckpointFile;
-//    cp.tosUploadProgress = self.tosUploadProgress;
+    cp.tosUploadProgress = self.tosUploadProgress;
     cp.tosUploadEventListener = self.tosUploadEventListener;
     return cp;
 }
@@ -1400,7 +1425,7 @@
         _tosPartNumber = [coder decodeIntForKey:@"part_number"];
         _tosPartSize = [coder decodeInt64ForKey:@"part_size"];
         _tosOffset = [coder decodeInt64ForKey:@"offset"];
-        _tosETag = [coder decodeObjectForKey:@"etat"];
+        _tosETag = [coder decodeObjectForKey:@"etag"];
         _tosHashCrc64ecma = strtoull([[coder decodeObjectForKey:@"hash_crc64ecma"] UTF8String], NULL, 0);
         _tosIsCompleted = [coder decodeBoolForKey:@"is_completed"];
     }
@@ -1459,6 +1484,90 @@
 @implementation TOSUploadFileOutput
 @end
 
+@implementation TOSCopyFileCheckpoint
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [coder encodeObject:_tosBucket forKey:@"bucket_name"];
+    [coder encodeObject:_tosKey forKey:@"object_name"];
+    [coder encodeObject:_tosSrcBucket forKey:@"src_bucket_name"];
+    [coder encodeObject:_tosSrcKey forKey:@"src_object_name"];
+    [coder encodeObject:_tosSrcVersionID forKey:@"src_version_id"];
+    [coder encodeObject:_tosSrcETag forKey:@"src_etag"];
+    [coder encodeObject:[NSString stringWithFormat:@"%llu", _tosSrcObjectSize] forKey:@"src_object_size"];
+    [coder encodeObject:[NSString stringWithFormat:@"%llu", _tosSrcHashCrc64ecma] forKey:@"src_hash_crc64ecma"];
+    [coder encodeInt64:_tosPartSize forKey:@"part_size"];
+    [coder encodeObject:_tosUploadID forKey:@"upload_id"];
+    [coder encodeObject:_tosPartsInfo forKey:@"parts_info"];
+}
+
+- (id)initWithCoder:(NSCoder *)coder {
+    if (self = [super init]) {
+        _tosBucket = [coder decodeObjectForKey:@"bucket_name"];
+        _tosKey = [coder decodeObjectForKey:@"object_name"];
+        _tosSrcBucket = [coder decodeObjectForKey:@"src_bucket_name"];
+        _tosSrcKey = [coder decodeObjectForKey:@"src_object_name"];
+        _tosSrcVersionID = [coder decodeObjectForKey:@"src_version_id"];
+        _tosSrcETag = [coder decodeObjectForKey:@"src_etag"];
+        _tosSrcObjectSize = strtoull([[coder decodeObjectForKey:@"src_object_size"] UTF8String], NULL, 0);
+        _tosSrcHashCrc64ecma = strtoull([[coder decodeObjectForKey:@"src_hash_crc64ecma"] UTF8String], NULL, 0);
+        _tosPartSize = [coder decodeInt64ForKey:@"part_size"];
+        _tosUploadID = [coder decodeObjectForKey:@"upload_id"];
+        _tosPartsInfo = [coder decodeObjectForKey:@"parts_info"];
+    }
+    return self;
+}
+@end
+
+@implementation TOSCopyFileInput
+- (nonnull id)mutableCopyWithZone:(nullable NSZone *)zone {
+    TOSCopyFileInput *cp = [[[self class] allocWithZone:zone] init];
+    cp.tosBucket = self.tosBucket;
+    cp.tosKey = self.tosKey;
+    
+    cp.tosEncodingType = self.tosEncodingType;
+    cp.tosCacheControl = self.tosCacheControl;
+    cp.tosContentDisposition = self.tosContentDisposition;
+    cp.tosContentEncoding = self.tosContentEncoding;
+    cp.tosContentLanguage = self.tosContentLanguage;
+    cp.tosContentType = self.tosContentType;
+    cp.tosExpires = self.tosExpires;
+    cp.tosACL = self.tosACL;
+    
+    cp.tosGrantFullControl = self.tosGrantFullControl;
+    cp.tosGrantRead = self.tosGrantRead;
+    cp.tosGrantReadAcp = self.tosGrantReadAcp;
+    cp.tosGrantWriteAcp = self.tosGrantWriteAcp;
+    
+    cp.tosSSECAlgorithm = self.tosSSECAlgorithm;
+    cp.tosSSECKey = self.tosSSECKey;
+    cp.tosSSECKeyMD5 = self.tosSSECKeyMD5;
+    
+    cp.tosServerSideEncryption = self.tosServerSideEncryption;
+    
+    cp.tosMeta = self.tosMeta; // DO NOT MODIFIED tosMeta
+    cp.tosWebsiteRedirectLocation = self.tosWebsiteRedirectLocation;
+    cp.tosStorageClass = self.tosStorageClass;
+    
+    cp.tosSrcBucket = self.tosSrcBucket;
+    cp.tosSrcKey = self.tosSrcKey;
+    cp.tosSrcVersionID = self.tosSrcVersionID;
+    cp.tosCopySourceSSECAlgorithm = self.tosCopySourceSSECAlgorithm;
+    cp.tosCopySourceSSECKey = self.tosCopySourceSSECKey;
+    cp.tosCopySourceSSECKeyMD5 = self.tosCopySourceSSECKeyMD5;
+    
+    cp.tosPartSize = self.tosPartSize;
+    cp.tosTaskNum = self.tosTaskNum;
+    cp.tosCopyThreshold = self.tosCopyThreshold;
+    cp.tosEnableCheckpoint = self.tosEnableCheckpoint;
+    cp.tosCheckpointFile = self.tosCheckpointFile;
+    cp.tosCopyProgress = self.tosCopyProgress;
+    return cp;
+}
+
+@end
+
+@implementation TOSCopyFileOutput
+@end
+
 @implementation TOSCustomDomainRule
 @end
 
@@ -1511,3 +1620,9 @@
 
 @implementation TOSDeleteBucketCustomDomainOutput
 @end
+
+@implementation TOSPrewarmInput
+@end
+
+@implementation TOSPrewarmOutput
+@end
@@ -18,6 +18,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class TOSRequestMetrics;
 
 /**
  TOS通用响应结构体
@@ -28,6 +29,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, copy) NSString * tosID2;
 @property (nonatomic, assign) NSInteger tosStatusCode;
 @property (nonatomic, strong) NSDictionary * tosHeader;
+@property (nonatomic, strong, nullable) TOSRequestMetrics * tosMetrics; // 请求耗时统计，失败时见error.userInfo[TOSErrorMetricsTOKEN]
 
 @end
 
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSConstants.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ 下载文件的异步写入器：网络分片先合并到对齐的写缓冲区，写满后在独立的I/O队列上按偏移pwrite，
+ 避免慢速存储阻塞会话回调队列。写入失败的错误在下一次appendData:或closeWithError:时返回。
+ */
+@interface TOSFileSink : NSObject
+
+/**
+ 单次合并写入的大小，默认1MiB，按4KiB对齐
+ */
+@property (nonatomic, assign, readonly) NSUInteger writeBufferSize;
+
+/**
+ 已交给I/O队列但尚未落盘的缓冲区上限，默认8。
+ 未设置backPressureHandler时，超出上限appendData:阻塞等待；设置后不阻塞，改由handler暂停数据来源
+ */
+@property (nonatomic, assign, readonly) NSUInteger maxPendingWrites;
+
+/**
+ 背压回调：待写缓冲区达到上限时以YES调用（在appendData:的调用线程），
+ I/O队列写出后低于上限时以NO调用（在I/O队列）。在会话回调队列上写入时应设置，
+ 由回调暂停/恢复对应的NSURLSessionTask，避免阻塞共享的回调队列
+ */
+@property (atomic, copy, nullable) void (^backPressureHandler)(BOOL paused);
+
+@property (nonatomic, assign, readonly) TOSFileSyncPolicy syncPolicy;
+
+/**
+ 已接收的字节数
+ */
+@property (nonatomic, assign, readonly) uint64_t length;
+
+- (nullable instancetype)initWithPath:(NSString *)path
+                           syncPolicy:(TOSFileSyncPolicy)syncPolicy
+                                error:(NSError **)error;
+
+- (nullable instancetype)initWithPath:(NSString *)path
+                           syncPolicy:(TOSFileSyncPolicy)syncPolicy
+                      writeBufferSize:(NSUInteger)writeBufferSize
+                      maxPendingWrites:(NSUInteger)maxPendingWrites
+                                error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ 按预期长度预分配磁盘空间，失败不影响后续写入
+ */
+- (void)preallocateLength:(uint64_t)length;
+
+/**
+ 追加数据，返回此前异步写入产生的错误
+ */
+- (nullable NSError *)appendData:(NSData *)data;
+
+/**
+ 写出剩余数据、按策略fsync、截断到实际长度并关闭文件
+ */
+- (BOOL)closeWithError:(NSError **)error;
+
+/**
+ 下载失败时调用：丢弃未写出的数据、关闭并删除文件，避免残留预分配的空文件
+ */
+- (void)discard;
+
+@end
+
+NS_ASSUME_NONNULL_END
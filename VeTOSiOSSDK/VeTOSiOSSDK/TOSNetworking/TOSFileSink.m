@@ -0,0 +1,256 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSFileSink.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+static const NSUInteger TOSFileSinkAlignment = 4096;
+static const NSUInteger TOSFileSinkDefaultWriteBufferSize = 1024 * 1024;
+static const NSUInteger TOSFileSinkDefaultMaxPendingWrites = 8;
+
+@implementation TOSFileSink
+{
+    int _fd;
+    NSString * _path;
+    dispatch_queue_t _ioQueue;
+    dispatch_semaphore_t _pendingSemaphore;
+    // 设置backPressureHandler时的待写计数与暂停状态，由@synchronized (self)保护
+    NSUInteger _pendingWrites;
+    BOOL _paused;
+    uint8_t * _buffer;
+    NSUInteger _bufferLength;
+    uint64_t _bufferOffset;
+    uint64_t _preallocatedLength;
+    NSError * _writeError;
+}
+
+- (nullable instancetype)initWithPath:(NSString *)path syncPolicy:(TOSFileSyncPolicy)syncPolicy error:(NSError **)error {
+    return [self initWithPath:path
+                   syncPolicy:syncPolicy
+              writeBufferSize:TOSFileSinkDefaultWriteBufferSize
+             maxPendingWrites:TOSFileSinkDefaultMaxPendingWrites
+                        error:error];
+}
+
+- (nullable instancetype)initWithPath:(NSString *)path
+                           syncPolicy:(TOSFileSyncPolicy)syncPolicy
+                      writeBufferSize:(NSUInteger)writeBufferSize
+                     maxPendingWrites:(NSUInteger)maxPendingWrites
+                                error:(NSError **)error {
+    if (self = [super init]) {
+        _fd = open([path fileSystemRepresentation], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_fd < 0) {
+            if (error) {
+                *error = [TOSFileSink errorWithMessage:[NSString stringWithFormat:@"tos: can't open file at %@", path] errnum:errno];
+            }
+            return nil;
+        }
+        _path = [path copy];
+        _syncPolicy = syncPolicy;
+        _writeBufferSize = MAX(TOSFileSinkAlignment, (writeBufferSize + TOSFileSinkAlignment - 1) / TOSFileSinkAlignment * TOSFileSinkAlignment);
+        _maxPendingWrites = MAX(1, maxPendingWrites);
+        _ioQueue = dispatch_queue_create("com.volces.tos.fileSink", DISPATCH_QUEUE_SERIAL);
+        _pendingSemaphore = dispatch_semaphore_create(_maxPendingWrites);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+    free(_buffer);
+}
+
++ (NSError *)errorWithMessage:(NSString *)message errnum:(int)errnum {
+    return [NSError errorWithDomain:TOSClientErrorDomain code:0 userInfo:@{TOSErrorMessageTOKEN: message, @"OriginErrorCode": [NSString stringWithFormat:@"%d", errnum]}];
+}
+
+- (nullable NSError *)currentWriteError {
+    @synchronized (self) {
+        return _writeError;
+    }
+}
+
+- (void)recordWriteError:(NSError *)error {
+    @synchronized (self) {
+        if (!_writeError) {
+            _writeError = error;
+        }
+    }
+}
+
+- (void)preallocateLength:(uint64_t)length {
+    if (_fd < 0 || length == 0) {
+        return;
+    }
+#if defined(F_PREALLOCATE)
+    fstore_t store = {F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t)length, 0};
+    if (fcntl(_fd, F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        if (fcntl(_fd, F_PREALLOCATE, &store) == -1) {
+            return;
+        }
+    }
+    if (ftruncate(_fd, (off_t)length) == 0) {
+        _preallocatedLength = length;
+    }
+#else
+    if (posix_fallocate(_fd, 0, (off_t)length) == 0) {
+        _preallocatedLength = length;
+    }
+#endif
+}
+
+- (nullable NSError *)appendData:(NSData *)data {
+    NSError *error = [self currentWriteError];
+    if (error) {
+        return error;
+    }
+    [data enumerateByteRangesUsingBlock:^(const void * _Nonnull bytes, NSRange byteRange, BOOL * _Nonnull stop) {
+        const uint8_t *src = bytes;
+        NSUInteger remaining = byteRange.length;
+        while (remaining > 0) {
+            if (!self->_buffer) {
+                if (posix_memalign((void **)&self->_buffer, TOSFileSinkAlignment, self->_writeBufferSize) != 0) {
+                    self->_buffer = NULL;
+                    [self recordWriteError:[TOSFileSink errorWithMessage:@"tos: can't allocate write buffer" errnum:ENOMEM]];
+                    *stop = YES;
+                    return;
+                }
+                self->_bufferLength = 0;
+            }
+            NSUInteger n = MIN(remaining, self->_writeBufferSize - self->_bufferLength);
+            memcpy(self->_buffer + self->_bufferLength, src, n);
+            self->_bufferLength += n;
+            self->_length += n;
+            src += n;
+            remaining -= n;
+            if (self->_bufferLength == self->_writeBufferSize) {
+                [self submitBuffer];
+            }
+        }
+    }];
+    return [self currentWriteError];
+}
+
+// 将当前缓冲区交给I/O队列，缓冲区由I/O队列写完后释放
+- (void)submitBuffer {
+    if (!_buffer || _bufferLength == 0) {
+        return;
+    }
+    uint8_t *buffer = _buffer;
+    NSUInteger length = _bufferLength;
+    uint64_t offset = _bufferOffset;
+    _buffer = NULL;
+    _bufferLength = 0;
+    _bufferOffset += length;
+    
+    void (^handler)(BOOL) = self.backPressureHandler;
+    if (handler) {
+        // 回调在锁内执行，保证暂停与恢复的调用顺序与计数变化一致
+        @synchronized (self) {
+            _pendingWrites++;
+            if (!_paused && _pendingWrites >= _maxPendingWrites) {
+                _paused = YES;
+                handler(YES);
+            }
+        }
+    } else {
+        dispatch_semaphore_wait(_pendingSemaphore, DISPATCH_TIME_FOREVER);
+    }
+    dispatch_async(_ioQueue, ^{
+        if (![self currentWriteError]) {
+            NSError *error = [self writeBuffer:buffer length:length offset:offset];
+            if (error) {
+                [self recordWriteError:error];
+            }
+        }
+        free(buffer);
+        if (handler) {
+            [self didFinishPendingWriteWithHandler:handler];
+        } else {
+            dispatch_semaphore_signal(self->_pendingSemaphore);
+        }
+    });
+}
+
+- (void)didFinishPendingWriteWithHandler:(void (^)(BOOL))handler {
+    @synchronized (self) {
+        _pendingWrites--;
+        if (_paused && _pendingWrites < _maxPendingWrites) {
+            _paused = NO;
+            handler(NO);
+        }
+    }
+}
+
+- (nullable NSError *)writeBuffer:(const uint8_t *)buffer length:(NSUInteger)length offset:(uint64_t)offset {
+    NSUInteger written = 0;
+    while (written < length) {
+        ssize_t n = pwrite(_fd, buffer + written, length - written, (off_t)(offset + written));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return [TOSFileSink errorWithMessage:@"tos: write file failed" errnum:errno];
+        }
+        written += (NSUInteger)n;
+    }
+    if (_syncPolicy == TOSFileSyncPolicyEveryWrite && fsync(_fd) != 0) {
+        return [TOSFileSink errorWithMessage:@"tos: fsync file failed" errnum:errno];
+    }
+    return nil;
+}
+
+- (BOOL)closeWithError:(NSError **)error {
+    if (_fd < 0) {
+        return YES;
+    }
+    [self submitBuffer];
+    __block NSError *closeError = nil;
+    dispatch_sync(_ioQueue, ^{
+        closeError = [self currentWriteError];
+        if (!closeError && self->_preallocatedLength != self->_length && ftruncate(self->_fd, (off_t)self->_length) != 0) {
+            closeError = [TOSFileSink errorWithMessage:@"tos: truncate file failed" errnum:errno];
+        }
+        if (!closeError && self->_syncPolicy != TOSFileSyncPolicyNone && fsync(self->_fd) != 0) {
+            closeError = [TOSFileSink errorWithMessage:@"tos: fsync file failed" errnum:errno];
+        }
+    });
+    close(_fd);
+    _fd = -1;
+    if (closeError && error) {
+        *error = closeError;
+    }
+    return closeError == nil;
+}
+
+- (void)discard {
+    free(_buffer);
+    _buffer = NULL;
+    _bufferLength = 0;
+    if (_fd >= 0) {
+        // 等待已提交的写入结束后再关闭，避免I/O队列写入已关闭的fd
+        dispatch_sync(_ioQueue, ^{});
+        close(_fd);
+        _fd = -1;
+    }
+    unlink([_path fileSystemRepresentation]);
+}
+
+@end
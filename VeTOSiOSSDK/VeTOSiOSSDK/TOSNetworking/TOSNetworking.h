@@ -19,6 +19,9 @@
 #import <VeTOSiOSSDK/TOSNetworkingRequestDelegate.h>
 #import <VeTOSiOSSDK/TOSSynchronizedMutableDictionary.h>
 #import <VeTOSiOSSDK/TOSURLRequestRetryHandler.h>
+#import <VeTOSiOSSDK/TOSOperationStatistics.h>
+#import <VeTOSiOSSDK/TOSTracer.h>
+#import <VeTOSiOSSDK/TOSNetworkingTransport.h>
 
 
 
@@ -45,6 +48,10 @@ typedef NS_ENUM(NSInteger, TOSNetworkingErrorType) {
 @required
 - (TOSTask *)interceptRequest:(NSMutableURLRequest *)request;
 
+@optional
+// 同步拦截，所有拦截器都实现时网络层在调用线程上直接执行，不创建TOSTask；失败时返回NO并通过error返回错误
+- (BOOL)interceptRequest:(NSMutableURLRequest *)request error:(NSError **)error;
+
 @end
 
 @protocol TOSURLRequestSerializer <NSObject>
@@ -110,18 +117,38 @@ typedef NS_ENUM(NSInteger, TOSNetworkingErrorType) {
 @property (nonatomic, assign) uint32_t maxRetryCount;
 @property (nonatomic, assign) NSTimeInterval timeoutIntervalForRequest;
 @property (nonatomic, assign) NSTimeInterval timeoutIntervalForResource;
+// 每个域名的最大并发连接数，0为系统默认值（iOS为4）
+@property (nonatomic, assign) NSInteger HTTPMaximumConnectionsPerHost;
 
 @property (nonatomic, strong) NSArray<id<TOSNetworkingRequestInterceptor>> *requestInterceptors;
 @property (nonatomic, strong) TOSURLRequestRetryHandler *retryHandler;
 
+// 进度回调合并：最小回调间隔（秒）与字节粒度，均为0时每次收发数据都回调
+@property (nonatomic, assign) NSTimeInterval progressReportInterval;
+@property (nonatomic, assign) int64_t progressReportBytes;
+// 进度回调执行器，为nil时在会话回调线程上直接执行
+@property (nonatomic, strong) TOSExecutor *progressExecutor;
+// 请求指标导出，为nil时不导出（指标仍会挂在TOSOutput.tosMetrics上）
+@property (nonatomic, strong) id<TOSMetricsSink> metricsSink;
+// 链路追踪，为nil时不创建Span
+@property (nonatomic, strong) id<TOSTracer> tracer;
+// 自定义NSURLProtocol，优先于系统协议注册到会话配置上，可用于网络模拟
+@property (nonatomic, strong) NSArray<Class> *protocolClasses;
+// 共享的网络传输，多个Client设置同一实例时共用会话和连接池；为nil时各自创建独享的传输
+@property (nonatomic, strong) TOSNetworkingTransport *transport;
+// 为YES时独享的传输在首次请求时才创建，降低Client的创建开销
+@property (nonatomic, assign) BOOL lazyTransport;
+
 @end
 
 
 @interface TOSNetworking : NSObject <NSURLSessionDelegate, NSURLSessionDataDelegate>
 
-@property (nonatomic, strong) NSURLSession *session;
-@property (nonatomic, strong) TOSExecutor *taskExecutor;
+@property (nonatomic, strong, readonly) NSURLSession *session;
+@property (nonatomic, strong, readonly) TOSNetworkingTransport *transport;
+@property (nonatomic, strong) TOSExecutor *taskExecutor; // 首次使用时创建
 @property (nonatomic, strong) TOSSynchronizedMutableDictionary *sessionDelagateManager;
+@property (nonatomic, strong, readonly) TOSOperationStatistics *operationStatistics;
 
 + (NSString *)tos_stringWithHTTPMethod:(TOSHTTPMethod)HTTPMethod;
 
@@ -129,5 +156,17 @@ typedef NS_ENUM(NSInteger, TOSNetworkingErrorType) {
 
 - (TOSTask *)sendRequest:(TOSNetworkingRequestDelegate *)request;
 
+/**
+ 请求代理以关联对象的形式挂在NSURLSessionTask上，会话回调通过它直接取得代理
+ */
+- (void)setRequestDelegate:(TOSNetworkingRequestDelegate *)delegate forTask:(NSURLSessionTask *)task;
+- (TOSNetworkingRequestDelegate *)requestDelegateForTask:(NSURLSessionTask *)task;
+- (void)removeRequestDelegateForTask:(NSURLSessionTask *)task;
+
+/**
+ 发起该Task的TOSNetworking，共享传输按它转发会话回调
+ */
++ (TOSNetworking *)networkingForTask:(NSURLSessionTask *)task;
+
 @end
 
@@ -19,6 +19,7 @@
 #import "TOSBolts.h"
 #import "TOSSynchronizedMutableDictionary.h"
 #import "NSDate+TOS.h"
+#import <objc/runtime.h>
 
 
 NSString *const TOSNetworkingErrorDomain = @"com.volcengine.TOSNetworkingErrorDomain";
@@ -26,6 +27,8 @@ NSString *const TOSNetworkingErrorDomain = @"com.volcengine.TOSNetworkingErrorDo
 //NSString *const TOSiOSSDKVersion = @"2.0.0";
 static NSString *const TOSServiceConfigurationUnknown = @"Unknown";
 static NSMutableArray *_globalUserAgentPrefixes = nil;
+static char TOSSessionTaskRequestDelegateKey;
+static char TOSSessionTaskNetworkingKey;
 
 @implementation TOSNetworkingConfiguration
 
@@ -102,10 +105,14 @@ static NSMutableArray *_globalUserAgentPrefixes = nil;
 }
 
 - (TOSTask *)interceptRequest:(NSMutableURLRequest *)request {
+    [self interceptRequest:request error:nil];
+    return [TOSTask taskWithResult:nil];
+}
+
+- (BOOL)interceptRequest:(NSMutableURLRequest *)request error:(NSError **)error {
     [request setValue:self.userAgent
    forHTTPHeaderField:@"User-Agent"];
-    
-    return [TOSTask taskWithResult:nil];
+    return YES;
 }
 
 @end
@@ -113,42 +120,71 @@ static NSMutableArray *_globalUserAgentPrefixes = nil;
 
 @interface TOSNetworking()
 
-@property (nonatomic) BOOL isSessionValid;
 //@property (nonatomic, strong) TOSSynchronizedMutableDictionary *sessionManagerDelegates;
 @property (nonatomic, strong, readonly) TOSNetworkingConfiguration *configuration;
 
 @end
 
-@implementation TOSNetworking
+@implementation TOSNetworking {
+    TOSNetworkingTransport *_transport;
+    BOOL _ownsTransport;
+    TOSExecutor *_taskExecutor;
+}
 
 - (instancetype)initWithConfiguration:(TOSNetworkingConfiguration *)configuration {
     if (self = [super init]) {
         _configuration = configuration;
-        
-        NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
-        sessionConfiguration.URLCache = nil;
-        if (configuration.timeoutIntervalForRequest > 0) {
-            sessionConfiguration.timeoutIntervalForRequest = configuration.timeoutIntervalForRequest;
-        }
-        if (configuration.timeoutIntervalForResource > 0) {
-            sessionConfiguration.timeoutIntervalForResource = configuration.timeoutIntervalForResource;
+        if (configuration.transport) {
+            _transport = configuration.transport;
+        } else {
+            _ownsTransport = YES;
+            if (!configuration.lazyTransport) {
+                _transport = [[TOSNetworkingTransport alloc] initWithConfiguration:configuration];
+            }
         }
-        sessionConfiguration.allowsCellularAccess = configuration.allowsCellularAccess;
-        sessionConfiguration.sharedContainerIdentifier = configuration.sharedContainerIdentifier;
-        
-        _isSessionValid = YES;
-        NSOperationQueue * sessionQueue = [NSOperationQueue new];
-        _session = [NSURLSession sessionWithConfiguration: sessionConfiguration
-                                                 delegate: self
-                                            delegateQueue: sessionQueue];
         _sessionDelagateManager = [TOSSynchronizedMutableDictionary new];
-        NSOperationQueue * operationQueue = [NSOperationQueue new];
-        operationQueue.maxConcurrentOperationCount = 3;
-        _taskExecutor = [TOSExecutor executorWithOperationQueue: operationQueue];
+        _operationStatistics = [TOSOperationStatistics new];
     }
     return self;
 }
 
+- (void)dealloc {
+    // 会话只强引用传输，独享的传输需在此失效，否则会话及其连接不会释放
+    if (_ownsTransport) {
+        [_transport invalidate];
+    }
+}
+
+- (TOSNetworkingTransport *)transport {
+    @synchronized (self) {
+        if (!_transport) {
+            _transport = [[TOSNetworkingTransport alloc] initWithConfiguration:_configuration];
+        }
+        return _transport;
+    }
+}
+
+- (NSURLSession *)session {
+    return self.transport.session;
+}
+
+- (TOSExecutor *)taskExecutor {
+    @synchronized (self) {
+        if (!_taskExecutor) {
+            NSOperationQueue * operationQueue = [NSOperationQueue new];
+            operationQueue.maxConcurrentOperationCount = 3;
+            _taskExecutor = [TOSExecutor executorWithOperationQueue: operationQueue];
+        }
+        return _taskExecutor;
+    }
+}
+
+- (void)setTaskExecutor:(TOSExecutor *)taskExecutor {
+    @synchronized (self) {
+        _taskExecutor = taskExecutor;
+    }
+}
+
 + (NSString *)tos_stringWithHTTPMethod:(TOSHTTPMethod)HTTPMethod {
     NSString *string = nil;
     switch (HTTPMethod) {
@@ -185,6 +221,22 @@ static NSMutableArray *_globalUserAgentPrefixes = nil;
     
     requestDelegate.taskCompletionSource = [TOSTaskCompletionSource taskCompletionSource];
     requestDelegate.retryHandler = _configuration.retryHandler;
+    if (!requestDelegate.metrics) {
+        requestDelegate.metrics = [TOSRequestMetrics new];
+        requestDelegate.metrics.startTime = [TOSRequestMetrics now];
+        requestDelegate.metrics.HTTPMethod = requestDelegate.HTTPMethod;
+    }
+    if (requestDelegate.cancellationToken.cancellationRequested) {
+        requestDelegate.taskCompletionSource.error = [self finishMetrics:requestDelegate error:[self cancelledError]];
+        return requestDelegate.taskCompletionSource.task;
+    }
+    TOSProgressAggregatorBlock progressBlock = requestDelegate.uploadProgress ?: requestDelegate.downloadProgress;
+    if (progressBlock && !requestDelegate.progressAggregator) {
+        requestDelegate.progressAggregator = [[TOSProgressAggregator alloc] initWithBlock:progressBlock
+                                                                         minimumInterval:_configuration.progressReportInterval
+                                                                            minimumBytes:_configuration.progressReportBytes
+                                                                                executor:_configuration.progressExecutor];
+    }
     //    delegate.request = request;
     //    delegate.taskType = TOSURLSessionTaskTypeData;
     //    delegate.downloadingFileURL = request.downloadingFileURL;
@@ -199,71 +251,154 @@ static NSMutableArray *_globalUserAgentPrefixes = nil;
 }
 
 - (void)taskWithDelegate:(TOSNetworkingRequestDelegate *)delegate {
+    NSArray<id<TOSNetworkingRequestInterceptor>> *interceptors = _configuration.requestInterceptors;
+    for (id<TOSNetworkingRequestInterceptor> interceptor in interceptors) {
+        if (![interceptor respondsToSelector:@selector(interceptRequest:error:)]) {
+            [self taskWithDelegateAsynchronously:delegate];
+            return;
+        }
+    }
+    
+    // 拦截器均为同步实现时直接在调用线程上签名并发起请求，不创建中间TOSTask，也不切换执行器
+    delegate.metrics.interceptStartTime = [TOSRequestMetrics now];
+    for (id<TOSNetworkingRequestInterceptor> interceptor in interceptors) {
+        NSError *error = nil;
+        if (![interceptor interceptRequest:delegate.internalRequest error:&error]) {
+            delegate.taskCompletionSource.error = [self finishMetrics:delegate error:error];
+            return;
+        }
+    }
+    delegate.metrics.interceptEndTime = [TOSRequestMetrics now];
+    [self resumeSessionTaskWithDelegate:delegate];
+}
+
+- (void)taskWithDelegateAsynchronously:(TOSNetworkingRequestDelegate *)delegate {
     [[[[TOSTask taskWithResult:nil] continueWithExecutor:self.taskExecutor withBlock:^id _Nullable(TOSTask * _Nonnull task) {
+        delegate.metrics.interceptStartTime = [TOSRequestMetrics now];
         for (id<TOSNetworkingRequestInterceptor> interceptor in self->_configuration.requestInterceptors) {
             task = [interceptor interceptRequest:delegate.internalRequest];
             if (task.error) {
                 return task;
             }
         }
+        delegate.metrics.interceptEndTime = [TOSRequestMetrics now];
         return task;
     }] continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
-        // 普通请求
-        NSURLSessionDataTask * sessionDataTask = nil;
-        // 流式上传
-        NSURLSessionUploadTask *sessionUploadTask = nil;
-        if (self.configuration.timeoutIntervalForRequest > 0) {
-            delegate.internalRequest.timeoutInterval = self.configuration.timeoutIntervalForRequest;
-        }
-        
-        if (delegate.uploadingFileURL) {
-            sessionDataTask = [self.session uploadTaskWithRequest:delegate.internalRequest fromFile:delegate.uploadingFileURL];
-        } else if (delegate.uploadingData) {
-            sessionDataTask = [self.session uploadTaskWithRequest:delegate.internalRequest fromData:delegate.uploadingData];
-        } else if (delegate.inputStream) {
-            sessionUploadTask = [self.session uploadTaskWithStreamedRequest:delegate.internalRequest];
-        } else {
-            sessionDataTask = [self.session dataTaskWithRequest:delegate.internalRequest];
-        }
-        if (sessionDataTask) {
-            [self.sessionDelagateManager setObject:delegate forKey:@(sessionDataTask.taskIdentifier)];
-            // 启动Task
-            [sessionDataTask resume];
-        } else {
-            [self.sessionDelagateManager setObject:delegate forKey:@(sessionUploadTask.taskIdentifier)];
-            // 启动Task
-            [sessionUploadTask resume];
-        }
-        
+        [self resumeSessionTaskWithDelegate:delegate];
         return task;
     }] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
         if (task.error) {
-            NSError *error = task.error;
+            NSError *error = [self finishMetrics:delegate error:task.error];
             delegate.taskCompletionSource.error = error;
         }
         return nil;
     }];
 }
 
+- (void)resumeSessionTaskWithDelegate:(TOSNetworkingRequestDelegate *)delegate {
+    // 普通请求
+    NSURLSessionDataTask * sessionDataTask = nil;
+    // 流式上传
+    NSURLSessionUploadTask *sessionUploadTask = nil;
+    if (self.configuration.timeoutIntervalForRequest > 0) {
+        delegate.internalRequest.timeoutInterval = self.configuration.timeoutIntervalForRequest;
+    }
+    
+    NSURLSession *session = self.session;
+    if (!session) {
+        NSError *error = [NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: networking transport is invalidated"}];
+        delegate.taskCompletionSource.error = [self finishMetrics:delegate error:error];
+        return;
+    }
+    if (delegate.uploadingFileURL) {
+        sessionDataTask = [session uploadTaskWithRequest:delegate.internalRequest fromFile:delegate.uploadingFileURL];
+    } else if (delegate.uploadingData) {
+        sessionDataTask = [session uploadTaskWithRequest:delegate.internalRequest fromData:delegate.uploadingData];
+    } else if (delegate.inputStream) {
+        sessionUploadTask = [session uploadTaskWithStreamedRequest:delegate.internalRequest];
+    } else {
+        sessionDataTask = [session dataTaskWithRequest:delegate.internalRequest];
+    }
+    delegate.metrics.resumeTime = [TOSRequestMetrics now];
+    NSURLSessionTask *sessionTask = sessionDataTask ?: sessionUploadTask;
+    [self setRequestDelegate:delegate forTask:sessionTask];
+    delegate.responseParser.sessionTask = sessionTask;
+    // 取消时直接cancel在途的Task，及时释放连接和缓冲区，didCompleteWithError中注销
+    TOSCancellationToken *cancellationToken = delegate.cancellationToken;
+    if (cancellationToken) {
+        __weak NSURLSessionTask *weakSessionTask = sessionTask;
+        delegate.cancellationRegistration = [cancellationToken registerCancellationObserverWithBlock:^{
+            [weakSessionTask cancel];
+        }];
+    }
+    // 启动Task
+    [sessionTask resume];
+    // 注册前已取消的情况
+    if (cancellationToken.cancellationRequested) {
+        [sessionTask cancel];
+    }
+}
+
+- (NSError *)cancelledError {
+    return [NSError errorWithDomain:TOSClientErrorDomain
+                               code:TOSClientErrorCodeTaskCancelled
+                           userInfo:@{TOSErrorMessageTOKEN: @"tos: request cancelled"}];
+}
+
+// 记录指标并导出，返回附带指标的error
+- (NSError *)finishMetrics:(TOSNetworkingRequestDelegate *)delegate error:(NSError *)error {
+    TOSRequestMetrics *metrics = delegate.metrics;
+    if (!metrics) {
+        return error;
+    }
+    metrics.retryCount = delegate.currentRetryCount;
+    [_operationStatistics recordMetrics:metrics error:error];
+    if (delegate.span) {
+        delegate.span.endTime = [TOSRequestMetrics now];
+        delegate.span.metrics = metrics;
+        [_configuration.tracer spanDidEnd:delegate.span error:error];
+    }
+    [_configuration.metricsSink didFinishRequestWithMetrics:metrics error:error];
+    if (!error) {
+        return nil;
+    }
+    NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithDictionary:error.userInfo];
+    [userInfo setObject:metrics forKey:TOSErrorMetricsTOKEN];
+    return [NSError errorWithDomain:error.domain code:error.code userInfo:userInfo];
+}
+
+- (void)setRequestDelegate:(TOSNetworkingRequestDelegate *)delegate forTask:(NSURLSessionTask *)task {
+    // 代理直接挂在NSURLSessionTask上，回调中无需再按taskIdentifier查表
+    objc_setAssociatedObject(task, &TOSSessionTaskRequestDelegateKey, delegate, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    // 请求结束前保持TOSNetworking存活
+    objc_setAssociatedObject(task, &TOSSessionTaskNetworkingKey, self, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    [self.sessionDelagateManager setObject:delegate forKey:@(task.taskIdentifier)];
+}
+
+- (TOSNetworkingRequestDelegate *)requestDelegateForTask:(NSURLSessionTask *)task {
+    return objc_getAssociatedObject(task, &TOSSessionTaskRequestDelegateKey);
+}
+
+- (void)removeRequestDelegateForTask:(NSURLSessionTask *)task {
+    objc_setAssociatedObject(task, &TOSSessionTaskRequestDelegateKey, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    objc_setAssociatedObject(task, &TOSSessionTaskNetworkingKey, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    [self.sessionDelagateManager removeObjectForKey:@(task.taskIdentifier)];
+}
+
++ (TOSNetworking *)networkingForTask:(NSURLSessionTask *)task {
+    return objc_getAssociatedObject(task, &TOSSessionTaskNetworkingKey);
+}
+
 #pragma mark - NSURLSessionTaskDelegate
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)sessionTask needNewBodyStream:(void (^)(NSInputStream * _Nullable))completionHandler {
-    TOSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:@(sessionTask.taskIdentifier)];
+    TOSNetworkingRequestDelegate * delegate = [self requestDelegateForTask:sessionTask];
     if (!delegate) {
         return;
     }
     completionHandler(delegate.inputStream);
 }
 
-#pragma mark - NSURLSessionDelegate
-
-- (void)URLSession:(NSURLSession *)session didBecomeInvalidWithError:(NSError *)error {
-    if (session == self.session) {
-        self.isSessionValid = NO;
-        self.session = nil;
-    }
-}
-
 #pragma mark - NSURLSessionTaskDelegate
 
 /**
@@ -275,83 +410,107 @@ static NSMutableArray *_globalUserAgentPrefixes = nil;
     
     NSHTTPURLResponse *HTTPResponse = (NSHTTPURLResponse *) sessionTask.response;
     
-    TOSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:@(sessionTask.taskIdentifier)];
+    TOSNetworkingRequestDelegate * delegate = [self requestDelegateForTask:sessionTask];
     
     if (!delegate) {
         return;
     }
+    delegate.metrics.completeTime = [TOSRequestMetrics now];
+    delegate.metrics.statusCode = HTTPResponse.statusCode;
     
-    [self.sessionDelagateManager removeObjectForKey:@(sessionTask.taskIdentifier)];
+    [self removeRequestDelegateForTask:sessionTask];
+    [delegate.cancellationRegistration dispose];
+    delegate.cancellationRegistration = nil;
+    // 结束前补发尚未上报的进度
+    [delegate.progressAggregator flush];
+    
+    NSError *taskError = [self errorForDelegate:delegate response:HTTPResponse error:error];
+    if (taskError) {
+        [delegate.responseParser discardDownload];
+        [delegate.taskCompletionSource setError:[self finishMetrics:delegate error:taskError]];
+        return;
+    }
     
-    [[[[TOSTask taskWithResult: nil] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
-        if (!delegate.error) {
-            delegate.error = error;
+    NSError *parseError = nil;
+    id output = [delegate.responseParser buildOutputObject:&parseError];
+    delegate.metrics.parseEndTime = [TOSRequestMetrics now];
+    if (parseError) {
+        [delegate.taskCompletionSource setError:[self finishMetrics:delegate error:parseError]];
+    } else {
+        if ([output isKindOfClass:[TOSOutput class]]) {
+            ((TOSOutput *)output).tosMetrics = delegate.metrics;
         }
-        if (delegate.error) {
-            if ([delegate.error.domain isEqualToString:NSURLErrorDomain] && delegate.error.code == NSURLErrorCancelled) {
-                return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:TOSClientErrorCodeTaskCancelled userInfo:[error userInfo]]];
-            } else {
-                NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithDictionary:[error userInfo]];
-                [userInfo setObject:[NSString stringWithFormat:@"%ld", (long)error.code] forKey:@"OriginErrorCode"];
-                return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:TOSClientErrorCodeNetworkError userInfo:userInfo]];
-            }
+        [self finishMetrics:delegate error:nil];
+        [delegate.taskCompletionSource setResult:output];
+    }
+}
+
+// 将网络错误或非2xx响应转换为SDK错误，请求成功时返回nil
+- (NSError *)errorForDelegate:(TOSNetworkingRequestDelegate *)delegate response:(NSHTTPURLResponse *)HTTPResponse error:(NSError *)error {
+    if (!delegate.error) {
+        delegate.error = error;
+    }
+    if (delegate.error) {
+        // 接收数据时的本地错误（写文件失败、超出目标缓冲区等）会主动取消请求，返回原始错误而不是取消错误
+        if (![delegate.error.domain isEqualToString:NSURLErrorDomain]) {
+            return delegate.error;
         }
-        return task;
-    }] continueWithSuccessBlock:^id _Nullable(TOSTask * _Nonnull task) {
-        if (delegate.isHttpRequestNotSuccessResponse) {
-            if (HTTPResponse.statusCode == 0) {
-                return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:TOSNetworkingErrorWithResponseCode0 userInfo:@{@"ErrorMessage" : @"Request failed, response code 0"}]];
-            }
-            NSDictionary *dict = [NSJSONSerialization JSONObjectWithData:delegate.httpRequestNotSuccessResponseBody options:0 error:NULL];
-            return [TOSTask taskWithError:[NSError errorWithDomain:TOSServerErrorDomain code:HTTPResponse.statusCode userInfo:dict]];
-            
+        if (delegate.error.code == NSURLErrorCancelled) {
+            return [NSError errorWithDomain:TOSClientErrorDomain code:TOSClientErrorCodeTaskCancelled userInfo:[delegate.error userInfo]];
         }
-        return task;
-    }] continueWithBlock:^id _Nullable(TOSTask * _Nonnull task) {
-        if (task.error) {
-            [delegate.taskCompletionSource setError: task.error];
-            return nil;
-        } else {
-            NSError *error = nil;
-            id output = [delegate.responseParser buildOutputObject:&error];
-            if (error) {
-                [delegate.taskCompletionSource setError:error];
-            } else {
-                [delegate.taskCompletionSource setResult:output];
-            }
+        NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithDictionary:[delegate.error userInfo]];
+        [userInfo setObject:[NSString stringWithFormat:@"%ld", (long)delegate.error.code] forKey:@"OriginErrorCode"];
+        return [NSError errorWithDomain:TOSClientErrorDomain code:TOSClientErrorCodeNetworkError userInfo:userInfo];
+    }
+    if (delegate.isHttpRequestNotSuccessResponse) {
+        if (HTTPResponse.statusCode == 0) {
+            return [NSError errorWithDomain:TOSClientErrorDomain code:TOSNetworkingErrorWithResponseCode0 userInfo:@{@"ErrorMessage" : @"Request failed, response code 0"}];
         }
-        return nil;
-    }];
+        NSDictionary *dict = [NSJSONSerialization JSONObjectWithData:delegate.httpRequestNotSuccessResponseBody options:0 error:NULL];
+        return [NSError errorWithDomain:TOSServerErrorDomain code:HTTPResponse.statusCode userInfo:dict];
+    }
+    return nil;
 }
 
 
 // 上传任务
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
     
-    TOSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:@(task.taskIdentifier)];
+    TOSNetworkingRequestDelegate * delegate = [self requestDelegateForTask:task];
     
     if (!delegate) {
         return;
     }
     
-    if (delegate.uploadProgress) {
-        delegate.uploadProgress(bytesSent, totalBytesSent, totalBytesExpectedToSend);
+    delegate.metrics.bytesSent = totalBytesSent;
+    TOSProgressAggregator *progress = delegate.progressAggregator;
+    if (progress) {
+        if (progress.totalBytesExpected != totalBytesExpectedToSend) {
+            progress.totalBytesExpected = totalBytesExpectedToSend;
+        }
+        [progress addBytes:bytesSent];
     }
 }
 
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics API_AVAILABLE(ios(10.0)) {
+    TOSNetworkingRequestDelegate * delegate = [self requestDelegateForTask:task];
+    delegate.metrics.taskMetrics = metrics;
+}
+
 #pragma mark - NSURLSessionDataDelegate
 
 // 收到请求头时的回调
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response
  completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler {
     /* background upload task will not call back didRecieveResponse */
-    // 从sessionDelagateManager中取出taskIdentifier对应的代理请求requestDelegate
-    TOSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:@(dataTask.taskIdentifier)];
+    // 取出挂在dataTask上的代理请求requestDelegate
+    TOSNetworkingRequestDelegate * delegate = [self requestDelegateForTask:dataTask];
     
     if (!delegate) {
         return;
     }
     
+    delegate.metrics.responseTime = [TOSRequestMetrics now];
     NSHTTPURLResponse * httpResponse = (NSHTTPURLResponse *)response;
     if (httpResponse.statusCode >= 200 && httpResponse.statusCode < 300) {
         [delegate.responseParser consumeNetworkingResponse:httpResponse];
@@ -362,12 +521,13 @@ static NSMutableArray *_globalUserAgentPrefixes = nil;
 }
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
-    TOSNetworkingRequestDelegate * delegate = [self.sessionDelagateManager objectForKey:@(dataTask.taskIdentifier)];
+    TOSNetworkingRequestDelegate * delegate = [self requestDelegateForTask:dataTask];
     
     if (!delegate) {
         return;
     }
     
+    delegate.metrics.bytesReceived += [data length];
     if (delegate.isHttpRequestNotSuccessResponse) {
         [delegate.httpRequestNotSuccessResponseBody appendData:data];
     } else {
@@ -383,11 +543,13 @@ static NSMutableArray *_globalUserAgentPrefixes = nil;
         }
     }
     // 下载进度条
-    if (delegate.downloadProgress) {
-        int64_t bytesWritten = [data length];
-        delegate.payloadTotalBytesWritten += bytesWritten;
+    TOSProgressAggregator *progress = delegate.progressAggregator;
+    if (progress) {
         int64_t totalBytesExpectedToWrite = dataTask.response.expectedContentLength;
-        delegate.downloadProgress(bytesWritten, delegate.payloadTotalBytesWritten, totalBytesExpectedToWrite);
+        if (progress.totalBytesExpected != totalBytesExpectedToWrite) {
+            progress.totalBytesExpected = totalBytesExpectedToWrite;
+        }
+        [progress addBytes:[data length]];
     }
 }
 
@@ -18,9 +18,15 @@
 #define TOSNetworkingHeader_h
 
 #import "TOSNetworking.h"
+#import "TOSNetworkingTransport.h"
 #import "TOSEndpoint.h"
 #import "TOSNetworkingRequestDelegate.h"
 #import "TOSNetworkingResponseParser.h"
 #import "TOSURLRequestRetryHandler.h"
+#import "TOSFileSink.h"
+#import "TOSProgressAggregator.h"
+#import "TOSRequestMetrics.h"
+#import "TOSOperationStatistics.h"
+#import "TOSTracer.h"
 
 #endif /* TOSNetworkingHeader_h */
@@ -18,6 +18,9 @@
 #import <VeTOSiOSSDK/TOSBolts.h>
 #import <VeTOSiOSSDK/TOSConstants.h>
 #import <VeTOSiOSSDK/TOSNetworkingResponseParser.h>
+#import <VeTOSiOSSDK/TOSProgressAggregator.h>
+#import <VeTOSiOSSDK/TOSRequestMetrics.h>
+#import <VeTOSiOSSDK/TOSTracer.h>
 
 @class TOSURLRequestRetryHandler;
 
@@ -41,6 +44,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong) NSInputStream *inputStream;
 @property (nonatomic, strong) NSURL *downloadingFileURL;
 @property (nonatomic, copy) NSString *downloadingFilePath;
+@property (nonatomic, assign) TOSFileSyncPolicy fileSyncPolicy;
 
 @property (nonatomic, assign) uint32_t currentRetryCount;
 @property (nonatomic, strong) NSError *error;
@@ -65,9 +69,19 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, copy) NSNumber *partNumber;
 
+@property (nonatomic, assign) BOOL discontiguousContent;
+@property (nonatomic, assign, nullable) void *receivingBuffer;
+@property (nonatomic, assign) NSUInteger receivingBufferCapacity;
+
 @property (nonatomic, copy) TOSNetworkingUploadProgressBlock uploadProgress;
 @property (nonatomic, copy) TOSNetworkingDownloadProgressBlock downloadProgress;
 @property (nonatomic, copy) TOSNetworkingOnRecieveDataBlock onRecieveData;
+@property (nonatomic, strong, nullable) TOSProgressAggregator *progressAggregator;
+@property (nonatomic, strong) TOSRequestMetrics *metrics;
+@property (nonatomic, strong, nullable) TOSSpan *span;
+// 取消时立即cancel对应的NSURLSessionTask
+@property (nonatomic, strong, nullable) TOSCancellationToken *cancellationToken;
+@property (nonatomic, strong, nullable) TOSCancellationTokenRegistration *cancellationRegistration;
 
 @end
 
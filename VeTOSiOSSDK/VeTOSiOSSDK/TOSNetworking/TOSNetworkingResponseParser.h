@@ -30,8 +30,20 @@ typedef void (^TOSNetworkingOnRecieveDataBlock) (NSData * data);
 
 @property (nonatomic, copy) NSURL *downloadingFileURL;
 
+@property (nonatomic, assign) TOSFileSyncPolicy fileSyncPolicy;
+
 @property (nonatomic, copy) NSNumber *partNumber;
 
+// 以dispatch_data链的形式保留响应体分片，不做拼接
+@property (nonatomic, assign) BOOL keepsDiscontiguousData;
+
+// 响应体直接写入调用方提供的缓冲区
+@property (nonatomic, assign, nullable) void *destinationBuffer;
+@property (nonatomic, assign) NSUInteger destinationBufferCapacity;
+
+// 承载本次响应的Task，写文件的待写缓冲区达到上限时暂停该Task，写出后恢复
+@property (nonatomic, weak, nullable) NSURLSessionTask *sessionTask;
+
 
 - (instancetype)initWithOperationType: (TOSOperationType)requestOperationType;
 
@@ -39,6 +51,11 @@ typedef void (^TOSNetworkingOnRecieveDataBlock) (NSData * data);
 - (void)consumeNetworkingResponse: (NSHTTPURLResponse *)response;
 - (nullable id)buildOutputObject: (NSError **)error;
 
+/**
+ 请求失败时关闭并删除已创建的下载文件
+ */
+- (void)discardDownload;
+
 @end
 
 NS_ASSUME_NONNULL_END
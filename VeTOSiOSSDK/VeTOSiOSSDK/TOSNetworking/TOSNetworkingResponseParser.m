@@ -15,23 +15,32 @@
  */
 
 #import "TOSNetworkingResponseParser.h"
-
-@interface TOSNetworkingResponseParser()
-@property(nonatomic, strong) NSLock *lock;
-@end
+#import "TOSBufferPool.h"
+#import "TOSFileSink.h"
 
 @implementation TOSNetworkingResponseParser
 {
     TOSOperationType _operationType;
-    NSFileHandle * _fileHandle;
-    NSMutableData * _receivedData;
+    TOSFileSink * _fileSink;
+    NSData * _receivedData;
+    NSMutableData * _receivingData;
+    // 按Content-Length从缓冲池预分配的接收缓冲区
+    void * _bodyBuffer;
+    NSUInteger _bodyBufferCapacity;
+    NSUInteger _bodyBufferLength;
+    dispatch_data_t _receivedChain;
+    NSUInteger _destinationLength;
     NSHTTPURLResponse * _response;
 //    NSDictionary * _requestHeader;
 }
 
 - (void)reset {
+    [self releaseBodyBuffer];
     _receivedData = nil;
-    _fileHandle = nil;
+    _receivingData = nil;
+    _receivedChain = nil;
+    _destinationLength = 0;
+    _fileSink = nil;
     _response = nil;
 //    _requestHeader = nil;
 }
@@ -39,58 +48,175 @@
 - (instancetype)initWithOperationType: (TOSOperationType)requestOperationType {
     if (self = [super init]) {
         _operationType = requestOperationType;
-        _lock = [[NSLock alloc] init];
     }
     return self;
 }
 
+- (void)dealloc {
+    [self releaseBodyBuffer];
+}
+
+- (void)releaseBodyBuffer {
+    if (_bodyBuffer) {
+        [[TOSBufferPool sharedPool] recycleBuffer:_bodyBuffer capacity:_bodyBufferCapacity];
+        _bodyBuffer = NULL;
+        _bodyBufferCapacity = 0;
+        _bodyBufferLength = 0;
+    }
+}
+
+- (void)appendReceivedData: (NSData *)data {
+    if (_bodyBuffer) {
+        if (_bodyBufferLength + data.length <= _bodyBufferCapacity) {
+            [data enumerateByteRangesUsingBlock:^(const void * _Nonnull bytes, NSRange byteRange, BOOL * _Nonnull stop) {
+                memcpy((uint8_t *)self->_bodyBuffer + self->_bodyBufferLength, bytes, byteRange.length);
+                self->_bodyBufferLength += byteRange.length;
+            }];
+            return;
+        }
+        // 实际数据超出Content-Length（如压缩传输），退化为NSMutableData
+        _receivingData = [[NSMutableData alloc] initWithCapacity:_bodyBufferLength + data.length];
+        [_receivingData appendBytes:_bodyBuffer length:_bodyBufferLength];
+        [self releaseBodyBuffer];
+    }
+    if (!_receivingData) {
+        _receivingData = [[NSMutableData alloc] initWithData:data];
+    } else {
+        [_receivingData appendData:data];
+    }
+}
+
+- (void)appendDiscontiguousData: (NSData *)data {
+    dispatch_data_t chunk;
+    if ([data conformsToProtocol:@protocol(OS_dispatch_data)]) {
+        chunk = (dispatch_data_t)data;
+    } else {
+        // 持有原始NSData，不拷贝字节
+        chunk = dispatch_data_create(data.bytes, data.length, NULL, ^{
+            (void)data;
+        });
+    }
+    _receivedChain = _receivedChain ? dispatch_data_create_concat(_receivedChain, chunk) : chunk;
+}
+
+- (TOSTask *)copyToDestinationBuffer: (NSData *)data {
+    if (_destinationLength + data.length > self.destinationBufferCapacity) {
+        return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:400 userInfo:@{TOSErrorMessageTOKEN: @"tos: object content exceeds buffer capacity"}]];
+    }
+    [data enumerateByteRangesUsingBlock:^(const void * _Nonnull bytes, NSRange byteRange, BOOL * _Nonnull stop) {
+        memcpy((uint8_t *)self.destinationBuffer + self->_destinationLength, bytes, byteRange.length);
+        self->_destinationLength += byteRange.length;
+    }];
+    return [TOSTask taskWithResult:nil];
+}
+
+- (void)finishReceivedData {
+    if (self.destinationBuffer) {
+        _receivedData = [NSData dataWithBytesNoCopy:self.destinationBuffer length:_destinationLength freeWhenDone:NO];
+    } else if (_receivedChain) {
+        _receivedData = (NSData *)_receivedChain;
+        _receivedChain = nil;
+    } else if (_bodyBuffer) {
+        if (_bodyBufferLength > 0) {
+            _receivedData = [[TOSBufferPool sharedPool] dataWithBuffer:_bodyBuffer length:_bodyBufferLength capacity:_bodyBufferCapacity];
+            _bodyBuffer = NULL;
+            _bodyBufferCapacity = 0;
+            _bodyBufferLength = 0;
+        } else {
+            [self releaseBodyBuffer];
+        }
+    } else if (_receivingData) {
+        _receivedData = _receivingData;
+        _receivingData = nil;
+    }
+}
+
+- (nullable NSError *)openFileSink {
+    NSError *error;
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *dirName = [[self.downloadingFileURL path] stringByDeletingLastPathComponent];
+    if (![fileManager fileExistsAtPath:dirName]) {
+        [fileManager createDirectoryAtPath:dirName withIntermediateDirectories:YES attributes:nil error:&error];
+    }
+    if (![fileManager fileExistsAtPath:dirName] || error) {
+        return [NSError errorWithDomain:TOSClientErrorDomain code:0 userInfo:@{@"ErrorMessage":[NSString stringWithFormat:@"Can't create dir at %@", dirName]}];
+    }
+    _fileSink = [[TOSFileSink alloc] initWithPath:[self.downloadingFileURL path] syncPolicy:self.fileSyncPolicy error:&error];
+    if (!_fileSink) {
+        return error;
+    }
+    long long contentLength = _response.expectedContentLength;
+    if (contentLength > 0) {
+        [_fileSink preallocateLength:(uint64_t)contentLength];
+    }
+    // 存储慢于网络时只暂停本次传输，不阻塞会话共享的回调队列
+    __weak NSURLSessionTask *weakSessionTask = self.sessionTask;
+    if (weakSessionTask) {
+        _fileSink.backPressureHandler = ^(BOOL paused) {
+            if (paused) {
+                [weakSessionTask suspend];
+            } else {
+                [weakSessionTask resume];
+            }
+        };
+    }
+    return nil;
+}
+
+- (void)discardDownload {
+    [_fileSink discard];
+    _fileSink = nil;
+}
+
 - (TOSTask *)consumeNetworkingResponseBody: (NSData *)data {
     if (self.onReceiveBlock) {
         self.onReceiveBlock(data);
         return [TOSTask taskWithResult:nil];
     }
-    NSError *error;
     if (self.downloadingFileURL) {
-        if (!_fileHandle) {
-            NSFileManager *fileManager = [NSFileManager defaultManager];
-            NSString *dirName = [[self.downloadingFileURL path] stringByDeletingLastPathComponent];
-            if (![fileManager fileExistsAtPath:dirName]) {
-                [fileManager createDirectoryAtPath:dirName withIntermediateDirectories:YES attributes:nil error:&error];
-            }
-            if (![fileManager fileExistsAtPath:dirName] || error) {
-                return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:0 userInfo:@{@"ErrorMessage":[NSString stringWithFormat:@"Can't create dir at %@", dirName]}]];
-            }
-            [fileManager createFileAtPath:[self.downloadingFileURL path] contents:nil attributes:nil];
-            if (![fileManager fileExistsAtPath:[self.downloadingFileURL path]]) {
-                return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:0 userInfo:@{@"ErrorMessage":[NSString stringWithFormat:@"Can't create file at %@", [self.downloadingFileURL path]]}]];
-            }
-            _fileHandle = [NSFileHandle fileHandleForWritingToURL:self.downloadingFileURL error:&error];
-            if (error) {
-                return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:0 userInfo:[error userInfo]]];
-            }
-            [_fileHandle writeData:data];
-        } else {
-            @try {
-                [_fileHandle writeData:data];
-            }
-            @catch (NSException *exception) {
-                return [TOSTask taskWithError:[NSError errorWithDomain:TOSClientErrorDomain code:0 userInfo:@{@"ErrorMessage":[exception description]}]];
+        if (!_fileSink) {
+            NSError *openError = [self openFileSink];
+            if (openError) {
+                return [TOSTask taskWithError:openError];
             }
         }
-    } else {
-        if (!_receivedData) {
-            _receivedData = [[NSMutableData alloc] initWithData:data];
-        } else {
-            [_lock lock];
-            [_receivedData appendData:data];
-            [_lock unlock];
+        // 写入在I/O队列异步完成，这里只返回此前的写入错误
+        NSError *error = [_fileSink appendData:data];
+        if (error) {
+            return [TOSTask taskWithError:error];
         }
+    } else if (self.destinationBuffer) {
+        return [self copyToDestinationBuffer:data];
+    } else if (self.keepsDiscontiguousData) {
+        [self appendDiscontiguousData:data];
+    } else {
+        // 会话代理回调为串行队列，这里无需加锁
+        [self appendReceivedData:data];
     }
     return [TOSTask taskWithResult:nil];
 }
 
 - (void)consumeNetworkingResponse: (NSHTTPURLResponse *)response {
     _response = response;
+    if (self.onReceiveBlock || self.downloadingFileURL || self.destinationBuffer || self.keepsDiscontiguousData) {
+        return;
+    }
+    if (_operationType == TOSOperationTypeHeadBucket || _operationType == TOSOperationTypeHeadObject) {
+        return;
+    }
+    long long contentLength = response.expectedContentLength;
+    if (contentLength <= 0 || (unsigned long long)contentLength > NSUIntegerMax) {
+        return;
+    }
+    // 按Content-Length预分配，避免接收过程中反复扩容拷贝
+    [self releaseBodyBuffer];
+    _receivingData = nil;
+    if ((NSUInteger)contentLength >= TOSBufferPoolMinimumCapacity) {
+        _bodyBuffer = [[TOSBufferPool sharedPool] acquireBufferWithCapacity:(NSUInteger)contentLength actualCapacity:&_bodyBufferCapacity];
+        _bodyBufferLength = 0;
+    } else {
+        _receivingData = [[NSMutableData alloc] initWithCapacity:(NSUInteger)contentLength];
+    }
 }
 
 - (void)parseNetworkingResponseCommonHeader: (NSHTTPURLResponse *)response toOutputObject: (TOSOutput *)output {
@@ -110,6 +236,7 @@
     if (self.onReceiveBlock) {
         return nil;
     }
+    [self finishReceivedData];
     NSDateFormatter *formater = [[NSDateFormatter alloc] init];
     [formater setDateFormat:@"EEE, dd MM yyyy HH:mm:ss 'GMT'"];
     switch (_operationType) {
@@ -293,6 +420,19 @@
         }
         case TOSOperationTypeGetObjectToFile: {
             // 下载对象
+            if (self.downloadingFileURL) {
+                NSError *sinkError = _fileSink ? nil : [self openFileSink];
+                if (!sinkError) {
+                    [_fileSink closeWithError:&sinkError];
+                }
+                if (sinkError) {
+                    [self discardDownload];
+                    if (error) {
+                        *error = sinkError;
+                    }
+                    return nil;
+                }
+            }
             TOSGetObjectToFileOutput *output = [TOSGetObjectToFileOutput new];
             
             if (_response) {
@@ -855,6 +995,8 @@
                     NSString *kk = [(NSString *)key lowercaseString];
                     if ([kk isEqualToString:@"x-tos-copy-source-version-id"]) {
                         output.tosCopySourceVersionID = obj;
+                    } else if ([kk isEqualToString:@"x-tos-hash-crc64ecma"]) {
+                        output.tosHashCrc64ecma = strtoull([obj UTF8String], NULL, 0);
                     }
                 }];
             }
@@ -0,0 +1,49 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TOSNetworkingConfiguration;
+
+/**
+ 网络传输：持有NSURLSession及其代理队列，即连接池所在的位置。
+ 多个TOSClient通过TOSNetworkingConfiguration.transport共享同一传输时复用到相同域名的连接，
+ 签名、重试、拦截器、统计和追踪仍由各Client的TOSNetworking按自己的配置处理。
+ 会话回调按请求转发给发起请求的TOSNetworking。
+ */
+@interface TOSNetworkingTransport : NSObject <NSURLSessionDelegate, NSURLSessionDataDelegate>
+
+/**
+ invalidate后为nil
+ */
+@property (nonatomic, strong, readonly, nullable) NSURLSession *session;
+
+/**
+ 使用configuration中的会话级设置创建会话：超时、HTTPMaximumConnectionsPerHost、allowsCellularAccess、
+ sharedContainerIdentifier和protocolClasses；共享时各Client配置中的这些设置不再生效（timeoutIntervalForRequest除外，按请求设置）
+ */
+- (instancetype)initWithConfiguration:(TOSNetworkingConfiguration *)configuration;
+
+/**
+ 在途请求结束后使会话失效，之后经过该传输的请求返回错误
+ */
+- (void)invalidate;
+
+@end
+
+NS_ASSUME_NONNULL_END
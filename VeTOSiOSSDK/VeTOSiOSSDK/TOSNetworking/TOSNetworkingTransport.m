@@ -0,0 +1,119 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSNetworkingTransport.h"
+#import "TOSNetworking.h"
+
+@implementation TOSNetworkingTransport
+
+- (instancetype)initWithConfiguration:(TOSNetworkingConfiguration *)configuration {
+    if (self = [super init]) {
+        NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
+        sessionConfiguration.URLCache = nil;
+        if (configuration.timeoutIntervalForRequest > 0) {
+            sessionConfiguration.timeoutIntervalForRequest = configuration.timeoutIntervalForRequest;
+        }
+        if (configuration.timeoutIntervalForResource > 0) {
+            sessionConfiguration.timeoutIntervalForResource = configuration.timeoutIntervalForResource;
+        }
+        if (configuration.HTTPMaximumConnectionsPerHost > 0) {
+            sessionConfiguration.HTTPMaximumConnectionsPerHost = configuration.HTTPMaximumConnectionsPerHost;
+        }
+        sessionConfiguration.allowsCellularAccess = configuration.allowsCellularAccess;
+        sessionConfiguration.sharedContainerIdentifier = configuration.sharedContainerIdentifier;
+        if (configuration.protocolClasses.count > 0) {
+            sessionConfiguration.protocolClasses = [configuration.protocolClasses arrayByAddingObjectsFromArray:sessionConfiguration.protocolClasses ?: @[]];
+        }
+        
+        NSOperationQueue * sessionQueue = [NSOperationQueue new];
+        // 代理回调串行执行，响应体解析无需加锁
+        sessionQueue.maxConcurrentOperationCount = 1;
+        _session = [NSURLSession sessionWithConfiguration: sessionConfiguration
+                                                 delegate: self
+                                            delegateQueue: sessionQueue];
+    }
+    return self;
+}
+
+- (NSURLSession *)session {
+    @synchronized (self) {
+        return _session;
+    }
+}
+
+- (void)invalidate {
+    [self.session finishTasksAndInvalidate];
+}
+
+#pragma mark - NSURLSessionDelegate
+
+- (void)URLSession:(NSURLSession *)session didBecomeInvalidWithError:(NSError *)error {
+    @synchronized (self) {
+        if (session == _session) {
+            _session = nil;
+        }
+    }
+}
+
+#pragma mark - NSURLSessionTaskDelegate
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task needNewBodyStream:(void (^)(NSInputStream * _Nullable))completionHandler {
+    TOSNetworking *networking = [TOSNetworking networkingForTask:task];
+    if (!networking) {
+        completionHandler(nil);
+        return;
+    }
+    [networking URLSession:session task:task needNewBodyStream:completionHandler];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    [[TOSNetworking networkingForTask:task] URLSession:session task:task didCompleteWithError:error];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
+    [[TOSNetworking networkingForTask:task] URLSession:session task:task didSendBodyData:bytesSent totalBytesSent:totalBytesSent totalBytesExpectedToSend:totalBytesExpectedToSend];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics API_AVAILABLE(ios(10.0)) {
+    [[TOSNetworking networkingForTask:task] URLSession:session task:task didFinishCollectingMetrics:metrics];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didReceiveChallenge:(NSURLAuthenticationChallenge *)challenge completionHandler:(void (^)(NSURLSessionAuthChallengeDisposition disposition, NSURLCredential * __nullable credential))completionHandler {
+    TOSNetworking *networking = [TOSNetworking networkingForTask:task];
+    if (!networking) {
+        completionHandler(NSURLSessionAuthChallengePerformDefaultHandling, nil);
+        return;
+    }
+    [networking URLSession:session task:task didReceiveChallenge:challenge completionHandler:completionHandler];
+}
+
+#pragma mark - NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response
+ completionHandler:(void (^)(NSURLSessionResponseDisposition disposition))completionHandler {
+    TOSNetworking *networking = [TOSNetworking networkingForTask:dataTask];
+    if (!networking) {
+        completionHandler(NSURLSessionResponseAllow);
+        return;
+    }
+    [networking URLSession:session dataTask:dataTask didReceiveResponse:response completionHandler:completionHandler];
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    [[TOSNetworking networkingForTask:dataTask] URLSession:session dataTask:dataTask didReceiveData:data];
+}
+
+@end
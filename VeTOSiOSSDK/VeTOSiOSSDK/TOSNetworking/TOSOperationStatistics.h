@@ -0,0 +1,74 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSConstants.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TOSRequestMetrics;
+
+/**
+ 单个操作类型的统计快照
+ */
+@interface TOSOperationStatisticsSnapshot : NSObject
+
+@property (nonatomic, assign, readonly) TOSOperationType operationType;
+@property (nonatomic, assign, readonly) int64_t requestCount;
+@property (nonatomic, assign, readonly) int64_t errorCount;
+@property (nonatomic, assign, readonly) int64_t retryCount;
+@property (nonatomic, assign, readonly) int64_t bytesSent;
+@property (nonatomic, assign, readonly) int64_t bytesReceived;
+// 失败请求按HTTP状态码计数，客户端/网络错误记为0
+@property (nonatomic, copy, readonly) NSDictionary<NSNumber *, NSNumber *> *errorCountByStatusCode;
+
+// 延迟分位数，单位为秒，精度约6%
+@property (nonatomic, assign, readonly) NSTimeInterval p50;
+@property (nonatomic, assign, readonly) NSTimeInterval p99;
+@property (nonatomic, assign, readonly) NSTimeInterval p999;
+@property (nonatomic, assign, readonly) NSTimeInterval maxLatency;
+@property (nonatomic, assign, readonly) NSTimeInterval meanLatency;
+
+- (NSTimeInterval)latencyAtPercentile:(double)percentile;
+
+@end
+
+/**
+ 按操作类型聚合的延迟直方图（对数线性分桶）与吞吐计数。
+ 记录只使用原子加，不加锁；快照与重置期间的并发记录可能被计入前后任一快照。
+ */
+@interface TOSOperationStatistics : NSObject
+
+- (void)recordMetrics:(TOSRequestMetrics *)metrics error:(nullable NSError *)error;
+
+- (void)recordOperationType:(TOSOperationType)operationType
+                    latency:(NSTimeInterval)latency
+                  bytesSent:(int64_t)bytesSent
+              bytesReceived:(int64_t)bytesReceived
+                 statusCode:(NSInteger)statusCode
+                     failed:(BOOL)failed
+                 retryCount:(uint32_t)retryCount;
+
+/**
+ 返回有请求记录的操作类型的快照，reset为YES时同时清零
+ */
+- (NSDictionary<NSNumber *, TOSOperationStatisticsSnapshot *> *)snapshotAndReset:(BOOL)reset;
+
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
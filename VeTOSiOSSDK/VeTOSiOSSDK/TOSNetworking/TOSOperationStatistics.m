@@ -0,0 +1,261 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSOperationStatistics.h"
+#import "TOSRequestMetrics.h"
+#include <libkern/OSAtomic.h>
+
+// TOSOperationType为连续取值，新增类型时需同步修改
+#define TOSOperationTypeCount           (TOSOperationTypeDeleteBucketCustomDomain + 1)
+
+// 延迟以微秒计：小于16为线性桶，其后每个2的幂区间再分16个子桶
+#define TOSHistogramSubBucketBits       4
+#define TOSHistogramSubBucketCount      (1 << TOSHistogramSubBucketBits)
+#define TOSHistogramMaxExponent         40
+#define TOSHistogramBucketCount         (TOSHistogramSubBucketCount * (TOSHistogramMaxExponent - TOSHistogramSubBucketBits + 2))
+
+// 状态码计数：0为客户端/网络错误，1-599为HTTP状态码
+#define TOSStatusCodeSlotCount          600
+
+typedef struct {
+    volatile int64_t requestCount;
+    volatile int64_t errorCount;
+    volatile int64_t retryCount;
+    volatile int64_t bytesSent;
+    volatile int64_t bytesReceived;
+    volatile int64_t latencySum;
+    volatile int64_t latencyMax;
+    volatile int64_t histogram[TOSHistogramBucketCount];
+    volatile int64_t statusCodes[TOSStatusCodeSlotCount];
+} TOSOperationCounters;
+
+static inline int TOSHistogramIndex(uint64_t value) {
+    if (value < TOSHistogramSubBucketCount) {
+        return (int)value;
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    if (exponent > TOSHistogramMaxExponent) {
+        return TOSHistogramBucketCount - 1;
+    }
+    int shift = exponent - TOSHistogramSubBucketBits;
+    int subBucket = (int)(value >> shift) - TOSHistogramSubBucketCount;
+    return TOSHistogramSubBucketCount + shift * TOSHistogramSubBucketCount + subBucket;
+}
+
+// 桶内最大值（微秒）
+static inline uint64_t TOSHistogramValue(int index) {
+    if (index < TOSHistogramSubBucketCount) {
+        return (uint64_t)index;
+    }
+    int shift = (index - TOSHistogramSubBucketCount) / TOSHistogramSubBucketCount;
+    int subBucket = (index - TOSHistogramSubBucketCount) % TOSHistogramSubBucketCount;
+    return (((uint64_t)(TOSHistogramSubBucketCount + subBucket + 1)) << shift) - 1;
+}
+
+static inline int64_t TOSAtomicExchange64(volatile int64_t *value, int64_t newValue) {
+    int64_t old;
+    do {
+        old = *value;
+    } while (!OSAtomicCompareAndSwap64(old, newValue, value));
+    return old;
+}
+
+@interface TOSOperationStatisticsSnapshot ()
+
+@property (nonatomic, assign, readwrite) TOSOperationType operationType;
+@property (nonatomic, assign, readwrite) int64_t requestCount;
+@property (nonatomic, assign, readwrite) int64_t errorCount;
+@property (nonatomic, assign, readwrite) int64_t retryCount;
+@property (nonatomic, assign, readwrite) int64_t bytesSent;
+@property (nonatomic, assign, readwrite) int64_t bytesReceived;
+@property (nonatomic, copy, readwrite) NSDictionary<NSNumber *, NSNumber *> *errorCountByStatusCode;
+@property (nonatomic, assign, readwrite) NSTimeInterval maxLatency;
+@property (nonatomic, assign, readwrite) NSTimeInterval meanLatency;
+@property (nonatomic, assign) int64_t histogramCount;
+
+- (int64_t *)histogramBuffer;
+
+@end
+
+@implementation TOSOperationStatisticsSnapshot
+{
+    int64_t _histogram[TOSHistogramBucketCount];
+}
+
+- (int64_t *)histogramBuffer {
+    return _histogram;
+}
+
+- (NSTimeInterval)latencyAtPercentile:(double)percentile {
+    if (_histogramCount == 0) {
+        return 0;
+    }
+    int64_t target = (int64_t)ceil(_histogramCount * MIN(MAX(percentile, 0), 100) / 100.0);
+    int64_t seen = 0;
+    for (int i = 0; i < TOSHistogramBucketCount; i++) {
+        seen += _histogram[i];
+        if (seen >= MAX(target, 1)) {
+            return TOSHistogramValue(i) / 1e6;
+        }
+    }
+    return _maxLatency;
+}
+
+- (NSTimeInterval)p50 {
+    return [self latencyAtPercentile:50];
+}
+
+- (NSTimeInterval)p99 {
+    return [self latencyAtPercentile:99];
+}
+
+- (NSTimeInterval)p999 {
+    return [self latencyAtPercentile:99.9];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"TOSOperationStatisticsSnapshot<%p> : {operation: %ld, requests: %lld, errors: %lld, retries: %lld, sent: %lld, received: %lld, p50: %.3fms, p99: %.3fms, p999: %.3fms, max: %.3fms}",
+            self, (long)_operationType, _requestCount, _errorCount, _retryCount, _bytesSent, _bytesReceived,
+            self.p50 * 1000, self.p99 * 1000, self.p999 * 1000, _maxLatency * 1000];
+}
+
+@end
+
+@implementation TOSOperationStatistics
+{
+    // 按需分配，避免未使用的操作类型占用内存
+    TOSOperationCounters * volatile _counters[TOSOperationTypeCount];
+}
+
+- (void)dealloc {
+    for (int i = 0; i < TOSOperationTypeCount; i++) {
+        free(_counters[i]);
+    }
+}
+
+- (TOSOperationCounters *)countersForOperationType:(TOSOperationType)operationType create:(BOOL)create {
+    if (operationType < 0 || operationType >= TOSOperationTypeCount) {
+        return NULL;
+    }
+    TOSOperationCounters *counters = _counters[operationType];
+    if (counters || !create) {
+        return counters;
+    }
+    counters = calloc(1, sizeof(TOSOperationCounters));
+    if (!OSAtomicCompareAndSwapPtrBarrier(NULL, counters, (void * volatile *)&_counters[operationType])) {
+        free(counters);
+        counters = _counters[operationType];
+    }
+    return counters;
+}
+
+- (void)recordMetrics:(TOSRequestMetrics *)metrics error:(NSError *)error {
+    BOOL failed = error != nil || metrics.statusCode >= 300;
+    [self recordOperationType:metrics.operationType
+                      latency:metrics.totalDuration
+                    bytesSent:metrics.bytesSent
+                bytesReceived:metrics.bytesReceived
+                   statusCode:metrics.statusCode
+                       failed:failed
+                   retryCount:metrics.retryCount];
+}
+
+- (void)recordOperationType:(TOSOperationType)operationType
+                    latency:(NSTimeInterval)latency
+                  bytesSent:(int64_t)bytesSent
+              bytesReceived:(int64_t)bytesReceived
+                 statusCode:(NSInteger)statusCode
+                     failed:(BOOL)failed
+                 retryCount:(uint32_t)retryCount {
+    TOSOperationCounters *counters = [self countersForOperationType:operationType create:YES];
+    if (!counters) {
+        return;
+    }
+    int64_t micros = latency > 0 ? (int64_t)(latency * 1e6) : 0;
+    OSAtomicIncrement64(&counters->requestCount);
+    OSAtomicIncrement64(&counters->histogram[TOSHistogramIndex((uint64_t)micros)]);
+    OSAtomicAdd64(micros, &counters->latencySum);
+    int64_t max = counters->latencyMax;
+    while (micros > max && !OSAtomicCompareAndSwap64(max, micros, &counters->latencyMax)) {
+        max = counters->latencyMax;
+    }
+    if (bytesSent > 0) {
+        OSAtomicAdd64(bytesSent, &counters->bytesSent);
+    }
+    if (bytesReceived > 0) {
+        OSAtomicAdd64(bytesReceived, &counters->bytesReceived);
+    }
+    if (retryCount > 0) {
+        OSAtomicAdd64(retryCount, &counters->retryCount);
+    }
+    if (failed) {
+        OSAtomicIncrement64(&counters->errorCount);
+        NSInteger slot = (statusCode >= 300 && statusCode < TOSStatusCodeSlotCount) ? statusCode : 0;
+        OSAtomicIncrement64(&counters->statusCodes[slot]);
+    }
+}
+
+- (NSDictionary<NSNumber *, TOSOperationStatisticsSnapshot *> *)snapshotAndReset:(BOOL)reset {
+    NSMutableDictionary<NSNumber *, TOSOperationStatisticsSnapshot *> *result = [NSMutableDictionary dictionary];
+    for (NSInteger type = 0; type < TOSOperationTypeCount; type++) {
+        TOSOperationCounters *counters = [self countersForOperationType:type create:NO];
+        if (!counters) {
+            continue;
+        }
+        int64_t (^take)(volatile int64_t *) = ^int64_t(volatile int64_t *value) {
+            return reset ? TOSAtomicExchange64(value, 0) : *value;
+        };
+        TOSOperationStatisticsSnapshot *snapshot = [TOSOperationStatisticsSnapshot new];
+        snapshot.operationType = type;
+        snapshot.requestCount = take(&counters->requestCount);
+        if (snapshot.requestCount == 0) {
+            continue;
+        }
+        snapshot.errorCount = take(&counters->errorCount);
+        snapshot.retryCount = take(&counters->retryCount);
+        snapshot.bytesSent = take(&counters->bytesSent);
+        snapshot.bytesReceived = take(&counters->bytesReceived);
+        int64_t latencySum = take(&counters->latencySum);
+        snapshot.maxLatency = take(&counters->latencyMax) / 1e6;
+        
+        int64_t histogramCount = 0;
+        int64_t *histogram = [snapshot histogramBuffer];
+        for (int i = 0; i < TOSHistogramBucketCount; i++) {
+            int64_t n = take(&counters->histogram[i]);
+            histogram[i] = n;
+            histogramCount += n;
+        }
+        snapshot.histogramCount = histogramCount;
+        snapshot.meanLatency = histogramCount > 0 ? latencySum / 1e6 / histogramCount : 0;
+        
+        NSMutableDictionary<NSNumber *, NSNumber *> *statusCodes = [NSMutableDictionary dictionary];
+        for (int i = 0; i < TOSStatusCodeSlotCount; i++) {
+            int64_t n = take(&counters->statusCodes[i]);
+            if (n > 0) {
+                statusCodes[@(i)] = @(n);
+            }
+        }
+        snapshot.errorCountByStatusCode = statusCodes;
+        result[@(type)] = snapshot;
+    }
+    return result;
+}
+
+- (void)reset {
+    [self snapshotAndReset:YES];
+}
+
+@end
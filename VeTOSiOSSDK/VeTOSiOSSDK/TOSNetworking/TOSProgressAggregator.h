@@ -0,0 +1,67 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSExecutor.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^TOSProgressAggregatorBlock) (int64_t bytes, int64_t totalBytes, int64_t totalBytesExpected);
+
+/**
+ 传输进度聚合器：多个分片/请求并发累加字节数（原子计数），按时间间隔或字节粒度合并后回调。
+ 同一聚合器的回调串行执行，回调中的bytes为距上次回调新增的字节数。
+ */
+@interface TOSProgressAggregator : NSObject
+
+/**
+ 两次回调的最小时间间隔，为0时仅按字节粒度合并；与minimumBytes均为0时每次更新都回调
+ */
+@property (nonatomic, assign, readonly) NSTimeInterval minimumInterval;
+
+/**
+ 累计新增达到该字节数时立即回调，为0时仅按时间间隔合并
+ */
+@property (nonatomic, assign, readonly) int64_t minimumBytes;
+
+/**
+ 回调执行器，为nil时在更新进度的线程上直接执行
+ */
+@property (nonatomic, strong, readonly, nullable) TOSExecutor *executor;
+
+@property (atomic, assign) int64_t totalBytesExpected;
+@property (atomic, assign, readonly) int64_t totalBytes;
+
+- (instancetype)initWithBlock:(TOSProgressAggregatorBlock)block
+              minimumInterval:(NSTimeInterval)minimumInterval
+                 minimumBytes:(int64_t)minimumBytes
+                     executor:(nullable TOSExecutor *)executor NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ 累加字节数，可在任意线程调用；bytes可为负数（如分片失败回退）
+ */
+- (void)addBytes:(int64_t)bytes;
+
+/**
+ 立即回调尚未上报的进度，传输结束时调用
+ */
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,129 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSProgressAggregator.h"
+#include <libkern/OSAtomic.h>
+#include <mach/mach_time.h>
+
+static uint64_t TOSProgressNowNanoseconds(void) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+}
+
+@implementation TOSProgressAggregator
+{
+    TOSProgressAggregatorBlock _block;
+    int64_t _intervalNanoseconds;
+    volatile int64_t _totalBytes;
+    volatile int64_t _totalBytesExpected;
+    // 最近一次发起回调时的字节数和时间
+    volatile int64_t _scheduledBytes;
+    volatile int64_t _scheduledTime;
+    // 已回调给用户的字节数
+    int64_t _deliveredBytes;
+}
+
+- (instancetype)initWithBlock:(TOSProgressAggregatorBlock)block
+              minimumInterval:(NSTimeInterval)minimumInterval
+                 minimumBytes:(int64_t)minimumBytes
+                     executor:(TOSExecutor *)executor {
+    if (self = [super init]) {
+        _block = [block copy];
+        _minimumInterval = MAX(0, minimumInterval);
+        _minimumBytes = MAX(0, minimumBytes);
+        _executor = executor;
+        _intervalNanoseconds = (int64_t)(_minimumInterval * NSEC_PER_SEC);
+    }
+    return self;
+}
+
+- (int64_t)totalBytes {
+    return OSAtomicAdd64Barrier(0, &_totalBytes);
+}
+
+- (int64_t)totalBytesExpected {
+    return OSAtomicAdd64Barrier(0, &_totalBytesExpected);
+}
+
+- (void)setTotalBytesExpected:(int64_t)totalBytesExpected {
+    int64_t old;
+    do {
+        old = _totalBytesExpected;
+    } while (!OSAtomicCompareAndSwap64Barrier(old, totalBytesExpected, &_totalBytesExpected));
+}
+
+- (void)addBytes:(int64_t)bytes {
+    if (bytes == 0) {
+        return;
+    }
+    int64_t total = OSAtomicAdd64Barrier(bytes, &_totalBytes);
+    int64_t expected = _totalBytesExpected;
+    int64_t scheduled = _scheduledBytes;
+    int64_t now = (int64_t)TOSProgressNowNanoseconds();
+    
+    // 两个阈值均为0时每次更新都回调，否则只按已设置的阈值合并
+    BOOL due = (_minimumBytes == 0 && _intervalNanoseconds == 0)
+        || (expected > 0 && total >= expected)
+        || (_minimumBytes > 0 && total - scheduled >= _minimumBytes)
+        || (_intervalNanoseconds > 0 && now - _scheduledTime >= _intervalNanoseconds);
+    if (!due) {
+        return;
+    }
+    // 只有抢到本轮的线程发起回调
+    if (!OSAtomicCompareAndSwap64Barrier(scheduled, total, &_scheduledBytes)) {
+        return;
+    }
+    _scheduledTime = now;
+    [self deliver];
+}
+
+- (void)flush {
+    int64_t total = self.totalBytes;
+    int64_t scheduled;
+    do {
+        scheduled = _scheduledBytes;
+    } while (!OSAtomicCompareAndSwap64Barrier(scheduled, total, &_scheduledBytes));
+    [self deliver];
+}
+
+- (void)deliver {
+    if (self.executor) {
+        [self.executor execute:^{
+            [self deliverLatest];
+        }];
+    } else {
+        [self deliverLatest];
+    }
+}
+
+// 回调时读取最新的计数，保证串行、累计值单调且不重复
+- (void)deliverLatest {
+    @synchronized (self) {
+        int64_t total = self.totalBytes;
+        if (total == _deliveredBytes) {
+            return;
+        }
+        int64_t bytes = total - _deliveredBytes;
+        _deliveredBytes = total;
+        _block(bytes, total, self.totalBytesExpected);
+    }
+}
+
+@end
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSConstants.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ 单次请求的耗时统计。SDK阶段时间戳取自系统启动后的单调时间（NSProcessInfo.systemUptime），单位为秒，未经过的阶段为0
+ */
+@interface TOSRequestMetrics : NSObject
+
+@property (nonatomic, assign) TOSOperationType operationType;
+@property (nonatomic, copy, nullable) NSString *HTTPMethod;
+@property (nonatomic, copy, nullable) NSString *bucket;
+@property (nonatomic, copy, nullable) NSString *object;
+@property (nonatomic, assign) NSInteger statusCode;
+@property (nonatomic, assign) uint32_t retryCount;
+@property (nonatomic, assign) int64_t bytesSent;
+@property (nonatomic, assign) int64_t bytesReceived;
+
+// 请求创建（invokeRequest）
+@property (nonatomic, assign) NSTimeInterval startTime;
+// 执行器开始执行拦截器（含签名）
+@property (nonatomic, assign) NSTimeInterval interceptStartTime;
+// 拦截器执行完毕
+@property (nonatomic, assign) NSTimeInterval interceptEndTime;
+// NSURLSessionTask resume
+@property (nonatomic, assign) NSTimeInterval resumeTime;
+// 收到响应头
+@property (nonatomic, assign) NSTimeInterval responseTime;
+// 会话任务完成
+@property (nonatomic, assign) NSTimeInterval completeTime;
+// 响应解析完成
+@property (nonatomic, assign) NSTimeInterval parseEndTime;
+
+/**
+ 系统采集的网络层指标，iOS 10以下为nil
+ */
+@property (nonatomic, strong, nullable) NSURLSessionTaskMetrics *taskMetrics API_AVAILABLE(ios(10.0));
+
+// 执行器排队耗时
+@property (nonatomic, assign, readonly) NSTimeInterval queueDuration;
+// 拦截器（签名）耗时
+@property (nonatomic, assign, readonly) NSTimeInterval interceptDuration;
+// resume到收到响应头
+@property (nonatomic, assign, readonly) NSTimeInterval waitingDuration;
+// 收到响应头到会话任务完成
+@property (nonatomic, assign, readonly) NSTimeInterval transferDuration;
+// 响应解析耗时
+@property (nonatomic, assign, readonly) NSTimeInterval parseDuration;
+// 总耗时
+@property (nonatomic, assign, readonly) NSTimeInterval totalDuration;
+
+// 以下取自taskMetrics中最后一次网络事务，连接复用时DNS/连接/TLS耗时为0
+@property (nonatomic, assign, readonly) NSTimeInterval domainLookupDuration;
+@property (nonatomic, assign, readonly) NSTimeInterval connectDuration;
+@property (nonatomic, assign, readonly) NSTimeInterval secureConnectionDuration;
+@property (nonatomic, assign, readonly) NSTimeInterval timeToFirstByte;
+@property (nonatomic, assign, readonly) BOOL reusedConnection;
+
++ (NSTimeInterval)now;
+
+@end
+
+/**
+ 请求指标导出接口，每个请求结束后（生成结果之前）在会话回调线程上调用，实现需尽快返回
+ */
+@protocol TOSMetricsSink <NSObject>
+
+- (void)didFinishRequestWithMetrics:(TOSRequestMetrics *)metrics error:(nullable NSError *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
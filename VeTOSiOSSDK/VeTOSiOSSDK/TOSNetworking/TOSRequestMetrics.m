@@ -0,0 +1,116 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSRequestMetrics.h"
+
+static NSTimeInterval TOSMetricsInterval(NSTimeInterval from, NSTimeInterval to) {
+    return (from > 0 && to >= from) ? to - from : 0;
+}
+
+static NSTimeInterval TOSMetricsDateInterval(NSDate *from, NSDate *to) {
+    return (from && to) ? MAX(0, [to timeIntervalSinceDate:from]) : 0;
+}
+
+@implementation TOSRequestMetrics
+
+- (instancetype)init {
+    if (self = [super init]) {
+        // 未经TOSClient发起的请求不归入任何操作类型
+        _operationType = (TOSOperationType)-1;
+    }
+    return self;
+}
+
++ (NSTimeInterval)now {
+    return [[NSProcessInfo processInfo] systemUptime];
+}
+
+- (NSTimeInterval)queueDuration {
+    return TOSMetricsInterval(_startTime, _interceptStartTime);
+}
+
+- (NSTimeInterval)interceptDuration {
+    return TOSMetricsInterval(_interceptStartTime, _interceptEndTime);
+}
+
+- (NSTimeInterval)waitingDuration {
+    return TOSMetricsInterval(_resumeTime, _responseTime);
+}
+
+- (NSTimeInterval)transferDuration {
+    return TOSMetricsInterval(_responseTime, _completeTime);
+}
+
+- (NSTimeInterval)parseDuration {
+    return TOSMetricsInterval(_completeTime, _parseEndTime);
+}
+
+- (NSTimeInterval)totalDuration {
+    return TOSMetricsInterval(_startTime, _parseEndTime > 0 ? _parseEndTime : _completeTime);
+}
+
+- (NSURLSessionTaskTransactionMetrics *)lastTransactionMetrics API_AVAILABLE(ios(10.0)) {
+    return self.taskMetrics.transactionMetrics.lastObject;
+}
+
+- (NSTimeInterval)domainLookupDuration {
+    if (@available(iOS 10.0, *)) {
+        NSURLSessionTaskTransactionMetrics *m = [self lastTransactionMetrics];
+        return TOSMetricsDateInterval(m.domainLookupStartDate, m.domainLookupEndDate);
+    }
+    return 0;
+}
+
+- (NSTimeInterval)connectDuration {
+    if (@available(iOS 10.0, *)) {
+        NSURLSessionTaskTransactionMetrics *m = [self lastTransactionMetrics];
+        return TOSMetricsDateInterval(m.connectStartDate, m.connectEndDate);
+    }
+    return 0;
+}
+
+- (NSTimeInterval)secureConnectionDuration {
+    if (@available(iOS 10.0, *)) {
+        NSURLSessionTaskTransactionMetrics *m = [self lastTransactionMetrics];
+        return TOSMetricsDateInterval(m.secureConnectionStartDate, m.secureConnectionEndDate);
+    }
+    return 0;
+}
+
+- (NSTimeInterval)timeToFirstByte {
+    if (@available(iOS 10.0, *)) {
+        NSURLSessionTaskTransactionMetrics *m = [self lastTransactionMetrics];
+        return TOSMetricsDateInterval(m.requestStartDate, m.responseStartDate);
+    }
+    return 0;
+}
+
+- (BOOL)reusedConnection {
+    if (@available(iOS 10.0, *)) {
+        return [self lastTransactionMetrics].isReusedConnection;
+    }
+    return NO;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"TOSRequestMetrics<%p> : {operation: %ld, status: %ld, queue: %.3fms, intercept: %.3fms, waiting: %.3fms, transfer: %.3fms, parse: %.3fms, total: %.3fms, sent: %lld, received: %lld}",
+            self, (long)_operationType, (long)_statusCode,
+            self.queueDuration * 1000, self.interceptDuration * 1000, self.waitingDuration * 1000,
+            self.transferDuration * 1000, self.parseDuration * 1000, self.totalDuration * 1000,
+            _bytesSent, _bytesReceived];
+}
+
+@end
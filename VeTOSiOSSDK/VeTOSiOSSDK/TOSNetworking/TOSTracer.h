@@ -0,0 +1,70 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import <VeTOSiOSSDK/TOSConstants.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class TOSRequestMetrics;
+
+/**
+ 链路追踪中的一个操作区间。单个请求对应一个Span，uploadFile等组合操作的子请求以其为父Span
+ */
+@interface TOSSpan : NSObject
+
+@property (nonatomic, assign, readonly) uint64_t traceID;
+@property (nonatomic, assign, readonly) uint64_t spanID;
+// 根Span为0
+@property (nonatomic, assign, readonly) uint64_t parentSpanID;
+@property (nonatomic, copy, readonly) NSString *name;
+// 非单个请求的Span为-1
+@property (nonatomic, assign, readonly) TOSOperationType operationType;
+@property (nonatomic, assign, readonly) NSTimeInterval startTime;
+@property (nonatomic, assign) NSTimeInterval endTime;
+// 单个请求的耗时统计，在结束时设置
+@property (nonatomic, strong, nullable) TOSRequestMetrics *metrics;
+
+- (instancetype)initWithName:(NSString *)name
+               operationType:(TOSOperationType)operationType
+                      parent:(nullable TOSSpan *)parent NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ 当前线程上的父Span，在此期间发起的请求自动成为其子Span
+ */
++ (nullable TOSSpan *)currentSpan;
+
+/**
+ 在block执行期间将span设置为当前线程的父Span，span为nil时直接执行block
+ */
++ (nullable id)performWithSpan:(nullable TOSSpan *)span block:(id _Nullable (^)(void))block;
+
+@end
+
+/**
+ 追踪器接口，回调在发起/完成请求的线程上同步执行，实现需尽快返回。
+ 未设置追踪器时SDK不创建任何Span
+ */
+@protocol TOSTracer <NSObject>
+
+- (void)spanDidBegin:(TOSSpan *)span;
+- (void)spanDidEnd:(TOSSpan *)span error:(nullable NSError *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
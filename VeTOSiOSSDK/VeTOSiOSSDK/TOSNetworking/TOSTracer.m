@@ -0,0 +1,70 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSTracer.h"
+
+static NSString *const TOSCurrentSpanKey = @"com.volces.tos.currentSpan";
+
+static uint64_t TOSRandomID(void) {
+    uint64_t value = 0;
+    while (value == 0) {
+        arc4random_buf(&value, sizeof(value));
+    }
+    return value;
+}
+
+@implementation TOSSpan
+
+- (instancetype)initWithName:(NSString *)name
+               operationType:(TOSOperationType)operationType
+                      parent:(TOSSpan *)parent {
+    if (self = [super init]) {
+        _name = [name copy];
+        _operationType = operationType;
+        _traceID = parent ? parent.traceID : TOSRandomID();
+        _spanID = TOSRandomID();
+        _parentSpanID = parent.spanID;
+        _startTime = [[NSProcessInfo processInfo] systemUptime];
+    }
+    return self;
+}
+
++ (TOSSpan *)currentSpan {
+    return [[NSThread currentThread] threadDictionary][TOSCurrentSpanKey];
+}
+
++ (id)performWithSpan:(TOSSpan *)span block:(id _Nullable (^)(void))block {
+    if (!span) {
+        return block();
+    }
+    NSMutableDictionary *threadDictionary = [[NSThread currentThread] threadDictionary];
+    TOSSpan *previous = threadDictionary[TOSCurrentSpanKey];
+    threadDictionary[TOSCurrentSpanKey] = span;
+    id result = block();
+    if (previous) {
+        threadDictionary[TOSCurrentSpanKey] = previous;
+    } else {
+        [threadDictionary removeObjectForKey:TOSCurrentSpanKey];
+    }
+    return result;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"TOSSpan<%p> : {name: %@, trace: %016llx, span: %016llx, parent: %016llx, duration: %.3fms}",
+            self, _name, _traceID, _spanID, _parentSpanID, _endTime > 0 ? (_endTime - _startTime) * 1000 : 0];
+}
+
+@end
@@ -65,7 +65,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)notifyDelegate {
     @synchronized(self.lock) {
-        [self throwIfDisposed];
+        // The token copies its registrations before notifying, so one may be disposed
+        // concurrently (e.g. when its request completes); that is not an error.
+        if (self.disposed) {
+            return;
+        }
         self.cancellationObserverBlock();
     }
 }
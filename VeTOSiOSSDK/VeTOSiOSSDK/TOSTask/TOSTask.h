@@ -31,6 +31,21 @@ extern NSInteger const kTOSMultipleErrorsError;
  */
 extern NSString *const TOSTaskMultipleErrorsUserInfoKey;
 
+/*!
+ Options for <TOSTask taskForParallelMapOfEnumerator:maxConcurrency:options:cancellationToken:block:>.
+ */
+typedef NS_OPTIONS(NSUInteger, TOSTaskMapOptions) {
+    /*! Results are returned in enumeration order, and the first failure completes the task. */
+    TOSTaskMapOptionsNone = 0,
+    /*! Results are returned in completion order instead of enumeration order. */
+    TOSTaskMapOptionsUnordered = 1 << 0,
+    /*!
+     Keep starting work after a failure and complete once everything has finished,
+     reporting every error the same way as <TOSTask taskForCompletionOfAllTasks:>.
+     */
+    TOSTaskMapOptionsCollectErrors = 1 << 1,
+};
+
 @class TOSExecutor;
 @class TOSTask;
 
@@ -86,6 +101,29 @@ typedef __nullable id(^TOSContinuationBlock)(TOSTask<ResultType> *t);
  */
 + (instancetype)taskForCompletionOfAnyTask:(nullable NSArray<TOSTask *> *)tasks;
 
+/*!
+ Lazily maps the objects of an enumerator to tasks, keeping at most `maxConcurrency` of them running.
+ The next object is only pulled from the enumerator (and `block` only called) when a running task completes,
+ so work is started in enumeration order and never all at once.
+
+ The returned task's result is an `NSArray` of the mapped results, `NSNull` standing in for `nil`.
+ Unless `TOSTaskMapOptionsCollectErrors` is set, the first faulted or cancelled task completes the returned
+ task with that outcome and no further work is started; tasks already running are left to finish.
+ Cancelling `cancellationToken` stops starting new work and cancels the returned task immediately.
+
+ @param enumerator The objects to map. It is only accessed by one thread at a time.
+ @param maxConcurrency The maximum number of tasks running at once; `0` is treated as `1`.
+ @param options See `TOSTaskMapOptions`.
+ @param cancellationToken The cancellation token (optional).
+ @param block Starts the work for `object`, which is the `index`th object of the enumerator.
+ It may return a `TOSTask`, or `nil` for work that has nothing to wait on.
+ */
++ (TOSTask<NSArray *> *)taskForParallelMapOfEnumerator:(NSEnumerator *)enumerator
+                                        maxConcurrency:(NSUInteger)maxConcurrency
+                                               options:(TOSTaskMapOptions)options
+                                     cancellationToken:(nullable TOSCancellationToken *)cancellationToken
+                                                 block:(TOSTask * _Nullable (^)(id object, NSUInteger index))block;
+
 /*!
  Returns a task that will be completed a certain amount of time in the future.
  @param millis The approximate number of milliseconds to wait before the
@@ -26,18 +26,241 @@ NSInteger const kTOSMultipleErrorsError = 80175001;
 
 NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
 
+// Task state word. A completing thread first claims the task (Pending -> Completing),
+// publishes `_result`/`_error`, then stores one of the final states with a barrier,
+// so readers only need a barrier-ordered load of `_state`.
+typedef NS_ENUM(int32_t, TOSTaskState) {
+    TOSTaskStatePending = 0,
+    TOSTaskStateCompleting,
+    TOSTaskStateSucceeded,
+    TOSTaskStateFaulted,
+    TOSTaskStateCancelled,
+};
+
 @interface TOSTask () {
     id _result;
     NSError *_error;
+    volatile int32_t _state;
+
+    // Guarded by @synchronized(self); both are created on demand since most tasks
+    // complete before anyone continues on or waits for them.
+    NSMutableArray *_callbacks;
+    NSCondition *_condition;
 }
 
-@property (nonatomic, assign, readwrite, getter=isCancelled) BOOL cancelled;
-@property (nonatomic, assign, readwrite, getter=isFaulted) BOOL faulted;
-@property (nonatomic, assign, readwrite, getter=isCompleted) BOOL completed;
+- (void)notifyCompletionWithExecutor:(TOSExecutor *)executor block:(dispatch_block_t)block;
+
+@end
+
+// State of one +taskForParallelMapOfEnumerator:... call; mutable state is guarded by @synchronized(self).
+@interface TOSTaskParallelMap : NSObject {
+    NSEnumerator *_enumerator;
+    NSUInteger _maxConcurrency;
+    TOSTaskMapOptions _options;
+    TOSCancellationToken *_cancellationToken;
+    TOSCancellationTokenRegistration *_registration;
+    TOSTask * _Nullable (^_block)(id object, NSUInteger index);
 
-@property (nonatomic, strong) NSObject *lock;
-@property (nonatomic, strong) NSCondition *condition;
-@property (nonatomic, strong) NSMutableArray *callbacks;
+    NSUInteger _nextIndex;
+    NSUInteger _running;
+    BOOL _exhausted;
+    BOOL _finished;
+    BOOL _cancelled;
+    NSMutableArray *_results;
+    NSMutableArray<NSError *> *_errors;
+
+    // Number of pending -pump requests, so only one thread launches work at a time and
+    // tasks completing synchronously inside `_block` don't recurse.
+    volatile int32_t _pumpRequests;
+}
+
+@property (nonatomic, strong, readonly) TOSTaskCompletionSource *source;
+
+@end
+
+@implementation TOSTaskParallelMap
+
+- (instancetype)initWithEnumerator:(NSEnumerator *)enumerator
+                    maxConcurrency:(NSUInteger)maxConcurrency
+                           options:(TOSTaskMapOptions)options
+                 cancellationToken:(nullable TOSCancellationToken *)cancellationToken
+                             block:(TOSTask * _Nullable (^)(id object, NSUInteger index))block {
+    self = [super init];
+    if (!self) return self;
+
+    _enumerator = enumerator;
+    _maxConcurrency = MAX(maxConcurrency, 1);
+    _options = options;
+    _cancellationToken = cancellationToken;
+    _block = [block copy];
+    _results = [NSMutableArray array];
+    _errors = [NSMutableArray array];
+    _source = [TOSTaskCompletionSource taskCompletionSource];
+
+    return self;
+}
+
+- (void)start {
+    if (_cancellationToken) {
+        __weak typeof(self) weakSelf = self;
+        TOSCancellationTokenRegistration *registration = [_cancellationToken registerCancellationObserverWithBlock:^{
+            [weakSelf cancel];
+        }];
+        BOOL finished;
+        @synchronized(self) {
+            finished = _finished;
+            if (!finished) {
+                _registration = registration;
+            }
+        }
+        if (finished) {
+            [registration dispose];
+        }
+    }
+    [self pump];
+}
+
+- (void)pump {
+    if (OSAtomicIncrement32Barrier(&_pumpRequests) != 1) {
+        return;
+    }
+    do {
+        [self launchAvailable];
+    } while (OSAtomicDecrement32Barrier(&_pumpRequests) != 0);
+}
+
+- (void)launchAvailable {
+    while (YES) {
+        id object = nil;
+        NSUInteger index = 0;
+        TOSTask * _Nullable (^block)(id object, NSUInteger index);
+        BOOL finished = NO;
+        @synchronized(self) {
+            if (_finished || _exhausted || _running >= _maxConcurrency) {
+                return;
+            }
+            if (_cancellationToken.cancellationRequested) {
+                finished = [self markCancelled];
+            } else {
+                object = [_enumerator nextObject];
+                if (!object) {
+                    _exhausted = YES;
+                    _enumerator = nil;
+                    finished = _running == 0 && [self markFinished];
+                } else {
+                    index = _nextIndex++;
+                    _running++;
+                    block = _block;
+                    if (!(_options & TOSTaskMapOptionsUnordered)) {
+                        [_results addObject:[NSNull null]];
+                    }
+                }
+            }
+        }
+        if (!object) {
+            if (finished) {
+                [self complete];
+            }
+            return;
+        }
+
+        TOSTask *task = block(object, index) ?: [TOSTask taskWithResult:nil];
+        [task notifyCompletionWithExecutor:[TOSExecutor immediateExecutor] block:^{
+            [self task:task didCompleteAtIndex:index];
+            [self pump];
+        }];
+    }
+}
+
+- (void)task:(TOSTask *)task didCompleteAtIndex:(NSUInteger)index {
+    BOOL finished = NO;
+    @synchronized(self) {
+        _running--;
+        if (_finished) {
+            return;
+        }
+
+        BOOL failFast = (_options & TOSTaskMapOptionsCollectErrors) == 0;
+        NSError *error = task.error;
+        if (error) {
+            [_errors addObject:error];
+            finished = failFast && [self markFinished];
+        } else if (task.cancelled) {
+            _cancelled = YES;
+            finished = failFast && [self markFinished];
+        } else {
+            id result = task.result ?: [NSNull null];
+            if (_options & TOSTaskMapOptionsUnordered) {
+                [_results addObject:result];
+            } else {
+                [_results replaceObjectAtIndex:index withObject:result];
+            }
+        }
+
+        if (!finished && _exhausted && _running == 0) {
+            finished = [self markFinished];
+        }
+    }
+    if (finished) {
+        [self complete];
+    }
+}
+
+- (void)cancel {
+    BOOL finished;
+    @synchronized(self) {
+        finished = [self markCancelled];
+    }
+    if (finished) {
+        [self complete];
+    }
+}
+
+// -markCancelled and -markFinished are called with the lock held and return YES for the caller
+// that must call -complete once the lock is released; the outcome is immutable from then on.
+- (BOOL)markCancelled {
+    if (_finished) {
+        return NO;
+    }
+    _cancelled = YES;
+    [_errors removeAllObjects];
+    return [self markFinished];
+}
+
+- (BOOL)markFinished {
+    if (_finished) {
+        return NO;
+    }
+    _finished = YES;
+    _enumerator = nil;
+    _block = nil;
+    return YES;
+}
+
+// Runs outside the lock: disposing the registration takes the token's locks, and completing
+// the source runs continuations inline.
+- (void)complete {
+    TOSCancellationTokenRegistration *registration;
+    @synchronized(self) {
+        registration = _registration;
+        _registration = nil;
+    }
+    [registration dispose];
+
+    if (_errors.count > 0) {
+        if (_errors.count == 1) {
+            [_source trySetError:_errors.firstObject];
+        } else {
+            [_source trySetError:[NSError errorWithDomain:TOSTaskErrorDomain
+                                                     code:kTOSMultipleErrorsError
+                                                 userInfo:@{ TOSTaskMultipleErrorsUserInfoKey: [_errors copy] }]];
+        }
+    } else if (_cancelled) {
+        [_source trySetCancelled];
+    } else {
+        [_source trySetResult:[_results copy]];
+    }
+}
 
 @end
 
@@ -49,9 +272,7 @@ NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
     self = [super init];
     if (!self) return self;
 
-    _lock = [[NSObject alloc] init];
-    _condition = [[NSCondition alloc] init];
-    _callbacks = [NSMutableArray array];
+    _state = TOSTaskStatePending;
 
     return self;
 }
@@ -103,39 +324,45 @@ NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
         return [self taskWithResult:nil];
     }
 
-    __block int32_t cancelled = 0;
-    NSObject *lock = [[NSObject alloc] init];
-    NSMutableArray *errors = [NSMutableArray array];
-
+    // Only the atomic counter is touched per completion; errors are gathered once, by the
+    // last completion, when every task's state is final.
+    tasks = [tasks copy];
     TOSTaskCompletionSource *tcs = [TOSTaskCompletionSource taskCompletionSource];
-    for (TOSTask *task in tasks) {
-        [task continueWithBlock:^id(TOSTask *t) {
-            if (t.error) {
-                @synchronized (lock) {
-                    [errors addObject:t.error];
+    dispatch_block_t onCompletion = ^{
+        if (OSAtomicDecrement32Barrier(&total) != 0) {
+            return;
+        }
+        NSMutableArray *errors = nil;
+        BOOL cancelled = NO;
+        for (TOSTask *t in tasks) {
+            NSError *error = t.error;
+            if (error) {
+                if (!errors) {
+                    errors = [NSMutableArray array];
                 }
+                [errors addObject:error];
             } else if (t.cancelled) {
-                OSAtomicIncrement32Barrier(&cancelled);
+                cancelled = YES;
             }
+        }
 
-            if (OSAtomicDecrement32Barrier(&total) == 0) {
-                if (errors.count > 0) {
-                    if (errors.count == 1) {
-                        tcs.error = [errors firstObject];
-                    } else {
-                        NSError *error = [NSError errorWithDomain:TOSTaskErrorDomain
-                                                             code:kTOSMultipleErrorsError
-                                                         userInfo:@{ TOSTaskMultipleErrorsUserInfoKey: errors }];
-                        tcs.error = error;
-                    }
-                } else if (cancelled > 0) {
-                    [tcs cancel];
-                } else {
-                    tcs.result = nil;
-                }
+        if (errors.count > 0) {
+            if (errors.count == 1) {
+                tcs.error = [errors firstObject];
+            } else {
+                NSError *error = [NSError errorWithDomain:TOSTaskErrorDomain
+                                                     code:kTOSMultipleErrorsError
+                                                 userInfo:@{ TOSTaskMultipleErrorsUserInfoKey: errors }];
+                tcs.error = error;
             }
-            return nil;
-        }];
+        } else if (cancelled) {
+            [tcs cancel];
+        } else {
+            tcs.result = nil;
+        }
+    };
+    for (TOSTask *task in tasks) {
+        [task notifyCompletionWithExecutor:[TOSExecutor defaultExecutor] block:onCompletion];
     }
     return tcs.task;
 }
@@ -146,6 +373,24 @@ NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
     }];
 }
 
++ (TOSTask<NSArray *> *)taskForParallelMapOfEnumerator:(NSEnumerator *)enumerator
+                                        maxConcurrency:(NSUInteger)maxConcurrency
+                                               options:(TOSTaskMapOptions)options
+                                     cancellationToken:(nullable TOSCancellationToken *)cancellationToken
+                                                 block:(TOSTask * _Nullable (^)(id object, NSUInteger index))block {
+    if (cancellationToken.cancellationRequested) {
+        return [TOSTask cancelledTask];
+    }
+
+    TOSTaskParallelMap *map = [[TOSTaskParallelMap alloc] initWithEnumerator:enumerator
+                                                              maxConcurrency:maxConcurrency
+                                                                     options:options
+                                                           cancellationToken:cancellationToken
+                                                                       block:block];
+    [map start];
+    return map.source.task;
+}
+
 + (instancetype)taskForCompletionOfAnyTask:(nullable NSArray<TOSTask *> *)tasks
 {
     __block int32_t total = (int32_t)tasks.count;
@@ -153,30 +398,32 @@ NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
         return [self taskWithResult:nil];
     }
     
-    __block int completed = 0;
-    __block int32_t cancelled = 0;
-    
-    NSObject *lock = [NSObject new];
-    NSMutableArray<NSError *> *errors = [NSMutableArray new];
-    
+    __block int32_t completed = 0;
+
+    tasks = [tasks copy];
     TOSTaskCompletionSource *source = [TOSTaskCompletionSource taskCompletionSource];
     for (TOSTask *task in tasks) {
-        [task continueWithBlock:^id(TOSTask *t) {
-            if (t.error != nil) {
-                @synchronized(lock) {
-                    [errors addObject:t.error];
-                }
-            } else if (t.cancelled) {
-                OSAtomicIncrement32Barrier(&cancelled);
-            } else {
-                if(OSAtomicCompareAndSwap32Barrier(0, 1, &completed)) {
-                    [source setResult:t.result];
+        [task notifyCompletionWithExecutor:[TOSExecutor defaultExecutor] block:^{
+            if (!task.faulted && !task.cancelled) {
+                if (OSAtomicCompareAndSwap32Barrier(0, 1, &completed)) {
+                    [source setResult:task.result];
                 }
             }
-            
+
             if (OSAtomicDecrement32Barrier(&total) == 0 &&
                 OSAtomicCompareAndSwap32Barrier(0, 1, &completed)) {
-                if (cancelled > 0) {
+                // No task succeeded; every state is final now, so collect the failures in one pass.
+                NSMutableArray<NSError *> *errors = [NSMutableArray new];
+                BOOL cancelled = NO;
+                for (TOSTask *t in tasks) {
+                    NSError *error = t.error;
+                    if (error != nil) {
+                        [errors addObject:error];
+                    } else if (t.cancelled) {
+                        cancelled = YES;
+                    }
+                }
+                if (cancelled) {
                     [source cancel];
                 } else if (errors.count > 0) {
                     if (errors.count == 1) {
@@ -189,8 +436,6 @@ NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
                     }
                 }
             }
-            // Abort execution of per tasks continuations
-            return nil;
         }];
     }
     return source.task;
@@ -231,83 +476,103 @@ NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
 
 #pragma mark - Custom Setters/Getters
 
+- (TOSTaskState)state {
+    TOSTaskState state = _state;
+    // Pairs with the barrier in -completeWithState:, so `_result`/`_error` are visible
+    // to any reader that observes a final state.
+    OSMemoryBarrier();
+    return state;
+}
+
+- (BOOL)tryClaimCompletion {
+    return OSAtomicCompareAndSwap32Barrier(TOSTaskStatePending, TOSTaskStateCompleting, &_state);
+}
+
 - (nullable id)result {
-    @synchronized(self.lock) {
-        return _result;
-    }
+    return [self state] == TOSTaskStateSucceeded ? _result : nil;
 }
 
 - (BOOL)trySetResult:(nullable id)result {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        _result = result;
-        [self runContinuations];
-        return YES;
+    if (![self tryClaimCompletion]) {
+        return NO;
     }
+    _result = result;
+    [self completeWithState:TOSTaskStateSucceeded];
+    return YES;
 }
 
 - (nullable NSError *)error {
-    @synchronized(self.lock) {
-        return _error;
-    }
+    return [self state] == TOSTaskStateFaulted ? _error : nil;
 }
 
 - (BOOL)trySetError:(NSError *)error {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.faulted = YES;
-        _error = error;
-        [self runContinuations];
-        return YES;
+    if (![self tryClaimCompletion]) {
+        return NO;
     }
+    _error = error;
+    [self completeWithState:TOSTaskStateFaulted];
+    return YES;
 }
 
 - (BOOL)isCancelled {
-    @synchronized(self.lock) {
-        return _cancelled;
-    }
+    return [self state] == TOSTaskStateCancelled;
 }
 
 - (BOOL)isFaulted {
-    @synchronized(self.lock) {
-        return _faulted;
-    }
+    return [self state] == TOSTaskStateFaulted;
 }
 
 - (BOOL)trySetCancelled {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.cancelled = YES;
-        [self runContinuations];
-        return YES;
+    if (![self tryClaimCompletion]) {
+        return NO;
     }
+    [self completeWithState:TOSTaskStateCancelled];
+    return YES;
 }
 
 - (BOOL)isCompleted {
-    @synchronized(self.lock) {
-        return _completed;
+    return [self state] >= TOSTaskStateSucceeded;
+}
+
+- (void)completeWithState:(TOSTaskState)state {
+    NSArray *callbacks;
+    NSCondition *condition;
+    // Publishing the final state and detaching the callbacks happen under the same lock that
+    // -notifyCompletionWithExecutor:block: registers under, so no callback can be missed.
+    @synchronized(self) {
+        OSMemoryBarrier();
+        _state = state;
+        OSMemoryBarrier();
+        callbacks = _callbacks;
+        _callbacks = nil;
+        condition = _condition;
+    }
+    if (condition) {
+        [condition lock];
+        [condition broadcast];
+        [condition unlock];
+    }
+    for (void (^callback)(void) in callbacks) {
+        callback();
     }
 }
 
-- (void)runContinuations {
-    @synchronized(self.lock) {
-        [self.condition lock];
-        [self.condition broadcast];
-        [self.condition unlock];
-        for (void (^callback)(void) in self.callbacks) {
-            callback();
+// Runs `block` on `executor` once the task has completed, without allocating a continuation task.
+- (void)notifyCompletionWithExecutor:(TOSExecutor *)executor block:(dispatch_block_t)block {
+    if (!self.completed) {
+        @synchronized(self) {
+            if (!self.completed) {
+                if (!_callbacks) {
+                    _callbacks = [NSMutableArray array];
+                }
+                [_callbacks addObject:[^{
+                    [executor execute:block];
+                } copy]];
+                return;
+            }
         }
-        [self.callbacks removeAllObjects];
     }
+    [executor execute:block];
 }
 
 #pragma mark - Chaining methods
@@ -355,18 +620,7 @@ NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
         }
     };
 
-    BOOL completed;
-    @synchronized(self.lock) {
-        completed = self.completed;
-        if (!completed) {
-            [self.callbacks addObject:[^{
-                [executor execute:executionBlock];
-            } copy]];
-        }
-    }
-    if (completed) {
-        [executor execute:executionBlock];
-    }
+    [self notifyCompletionWithExecutor:executor block:executionBlock];
 
     return tcs.task;
 }
@@ -419,35 +673,39 @@ NSString *const TOSTaskMultipleErrorsUserInfoKey = @"errors";
         [self warnOperationOnMainThread];
     }
 
-    @synchronized(self.lock) {
+    if (self.completed) {
+        return;
+    }
+
+    // The condition is only created for tasks that are actually waited on. It is locked before
+    // leaving the @synchronized block, so a concurrent -completeWithState: cannot broadcast
+    // until this thread is waiting.
+    NSCondition *condition;
+    @synchronized(self) {
         if (self.completed) {
             return;
         }
-        [self.condition lock];
+        if (!_condition) {
+            _condition = [[NSCondition alloc] init];
+        }
+        condition = _condition;
+        [condition lock];
     }
-    // TODO: (nlutsenko) Restructure this to use Bolts-Swift thread access synchronization architecture
-    // In the meantime, it's absolutely safe to get `_completed` aka an ivar, as long as it's a `BOOL` aka less than word size.
-    while (!_completed) {
-        [self.condition wait];
+    while (!self.completed) {
+        [condition wait];
     }
-    [self.condition unlock];
+    [condition unlock];
 }
 
 #pragma mark - NSObject
 
 - (NSString *)description {
-    // Acquire the data from the locked properties
-    BOOL completed;
-    BOOL cancelled;
-    BOOL faulted;
-    NSString *resultDescription = nil;
-
-    @synchronized(self.lock) {
-        completed = self.completed;
-        cancelled = self.cancelled;
-        faulted = self.faulted;
-        resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
-    }
+    // Take a single snapshot of the state word
+    TOSTaskState state = [self state];
+    BOOL completed = state >= TOSTaskStateSucceeded;
+    BOOL cancelled = state == TOSTaskStateCancelled;
+    BOOL faulted = state == TOSTaskStateFaulted;
+    NSString *resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
 
     // Description string includes status information and, if available, the
     // result since in some ways this is what a promise actually "is".
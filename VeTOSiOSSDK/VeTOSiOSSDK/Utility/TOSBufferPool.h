@@ -0,0 +1,72 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ 低于该大小的响应体不走缓冲池，直接使用预分配的NSMutableData
+ */
+extern const NSUInteger TOSBufferPoolMinimumCapacity;
+
+/**
+ 分级的响应体缓冲池，用于复用大对象下载时的接收缓冲区；级别为64KiB~64MiB间每个2的幂区间等分8级，取整浪费不超过1/8。
+ 通过dataWithBuffer:length:capacity:交给调用方的NSData释放时，缓冲区自动归还到池中。
+ */
+@interface TOSBufferPool : NSObject
+
+/**
+ 池中空闲缓冲区的总字节上限，超出部分直接释放，默认64MiB
+ */
+@property (atomic, assign) NSUInteger maxPooledBytes;
+
+/**
+ 实际向系统申请内存的次数
+ */
+@property (atomic, assign, readonly) int64_t allocationCount;
+
+/**
+ 命中池中空闲缓冲区的次数
+ */
+@property (atomic, assign, readonly) int64_t reuseCount;
+
++ (instancetype)sharedPool;
+
+/**
+ 获取容量不小于capacity的缓冲区，实际容量（按级别向上取整）通过actualCapacity返回
+ */
+- (void *)acquireBufferWithCapacity:(NSUInteger)capacity actualCapacity:(NSUInteger *)actualCapacity;
+
+/**
+ 归还通过acquireBufferWithCapacity:actualCapacity:获取的缓冲区
+ */
+- (void)recycleBuffer:(void *)buffer capacity:(NSUInteger)capacity;
+
+/**
+ 将缓冲区包装为NSData（不拷贝），NSData释放时缓冲区归还到池中；
+ length比capacity小1/8以上时改为拷贝出精确大小的NSData并立即归还缓冲区
+ */
+- (NSData *)dataWithBuffer:(void *)buffer length:(NSUInteger)length capacity:(NSUInteger)capacity;
+
+/**
+ 释放池中所有空闲缓冲区，可在内存告警时调用
+ */
+- (void)drain;
+
+@end
+
+NS_ASSUME_NONNULL_END
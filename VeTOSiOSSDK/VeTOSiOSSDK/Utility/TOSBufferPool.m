@@ -0,0 +1,158 @@
+/**
+ * Copyright 2023 Beijing Volcano Engine Technology Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "TOSBufferPool.h"
+
+const NSUInteger TOSBufferPoolMinimumCapacity = 64 * 1024;
+
+static const NSUInteger TOSBufferPoolDefaultMaxPooledBytes = 64 * 1024 * 1024;
+// 每个2的幂区间再等分为8级：64KiB, 72KiB, 80KiB ... 56MiB, 64MiB，按级别取整浪费不超过1/8
+static const NSUInteger TOSBufferPoolStepsPerOctave = 8;
+static const NSUInteger TOSBufferPoolClassCount = 10 * TOSBufferPoolStepsPerOctave + 1;
+
+@implementation TOSBufferPool
+{
+    NSMutableArray<NSValue *> * _freeLists[TOSBufferPoolClassCount];
+    NSUInteger _pooledBytes;
+    int64_t _allocationCount;
+    int64_t _reuseCount;
+}
+
++ (instancetype)sharedPool {
+    static TOSBufferPool *_sharedPool = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _sharedPool = [TOSBufferPool new];
+    });
+    return _sharedPool;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _maxPooledBytes = TOSBufferPoolDefaultMaxPooledBytes;
+        for (NSUInteger i = 0; i < TOSBufferPoolClassCount; i++) {
+            _freeLists[i] = [NSMutableArray array];
+        }
+    }
+    return self;
+}
+
+- (int64_t)allocationCount {
+    @synchronized (self) {
+        return _allocationCount;
+    }
+}
+
+- (int64_t)reuseCount {
+    @synchronized (self) {
+        return _reuseCount;
+    }
+}
+
+- (void)dealloc {
+    [self drain];
+}
+
++ (NSUInteger)capacityOfClass:(NSUInteger)index {
+    NSUInteger octave = TOSBufferPoolMinimumCapacity << (index / TOSBufferPoolStepsPerOctave);
+    return octave / TOSBufferPoolStepsPerOctave * (TOSBufferPoolStepsPerOctave + index % TOSBufferPoolStepsPerOctave);
+}
+
+// 返回容量所属的级别，超出最大级别返回NSNotFound
++ (NSUInteger)classIndexForCapacity:(NSUInteger)capacity {
+    for (NSUInteger i = 0; i < TOSBufferPoolClassCount; i++) {
+        if (capacity <= [self capacityOfClass:i]) {
+            return i;
+        }
+    }
+    return NSNotFound;
+}
+
+- (void *)acquireBufferWithCapacity:(NSUInteger)capacity actualCapacity:(NSUInteger *)actualCapacity {
+    NSUInteger index = [TOSBufferPool classIndexForCapacity:capacity];
+    if (index == NSNotFound) {
+        // 超大对象不入池，按实际大小申请
+        *actualCapacity = capacity;
+        @synchronized (self) {
+            _allocationCount++;
+        }
+        return malloc(capacity);
+    }
+    NSUInteger classCapacity = [TOSBufferPool capacityOfClass:index];
+    *actualCapacity = classCapacity;
+    @synchronized (self) {
+        NSValue *value = [_freeLists[index] lastObject];
+        if (value) {
+            [_freeLists[index] removeLastObject];
+            _pooledBytes -= classCapacity;
+            _reuseCount++;
+            return [value pointerValue];
+        }
+        _allocationCount++;
+    }
+    return malloc(classCapacity);
+}
+
+- (void)recycleBuffer:(void *)buffer capacity:(NSUInteger)capacity {
+    if (!buffer) {
+        return;
+    }
+    NSUInteger index = [TOSBufferPool classIndexForCapacity:capacity];
+    if (index == NSNotFound || [TOSBufferPool capacityOfClass:index] != capacity) {
+        free(buffer);
+        return;
+    }
+    @synchronized (self) {
+        if (_pooledBytes + capacity <= _maxPooledBytes) {
+            [_freeLists[index] addObject:[NSValue valueWithPointer:buffer]];
+            _pooledBytes += capacity;
+            return;
+        }
+    }
+    free(buffer);
+}
+
+- (NSData *)dataWithBuffer:(void *)buffer length:(NSUInteger)length capacity:(NSUInteger)capacity {
+    if (capacity - length > capacity / TOSBufferPoolStepsPerOctave) {
+        // 实际长度远小于容量（如响应体短于Content-Length），拷贝为精确大小，缓冲区立即归还，避免调用方持有多余内存
+        NSData *data = [NSData dataWithBytes:buffer length:length];
+        [self recycleBuffer:buffer capacity:capacity];
+        return data;
+    }
+    __weak TOSBufferPool *weakPool = self;
+    return [[NSData alloc] initWithBytesNoCopy:buffer length:length deallocator:^(void * _Nonnull bytes, NSUInteger len) {
+        TOSBufferPool *pool = weakPool;
+        if (pool) {
+            [pool recycleBuffer:bytes capacity:capacity];
+        } else {
+            free(bytes);
+        }
+    }];
+}
+
+- (void)drain {
+    @synchronized (self) {
+        for (NSUInteger i = 0; i < TOSBufferPoolClassCount; i++) {
+            for (NSValue *value in _freeLists[i]) {
+                free([value pointerValue]);
+            }
+            [_freeLists[i] removeAllObjects];
+        }
+        _pooledBytes = 0;
+    }
+}
+
+@end
@@ -24,6 +24,8 @@ extern const int64_t TOSMaxPartSize;
 extern const int TOSMinTaskNum;
 extern const int TOSMaxTaskNum;
 extern const uint64_t TOSMaxPartCount;
+extern const int64_t TOSDefaultCopyThreshold;
+extern const int64_t TOSDefaultRangeMergeGap;
 
 typedef NSString TOSStorageClassType;
 typedef NSString TOSACLType;
@@ -189,6 +191,12 @@ typedef NS_ENUM(NSInteger, TOSClientErrorCode) {
     TOSClientErrorCodeNetworkError
 };
 
+typedef NS_ENUM(NSInteger, TOSFileSyncPolicy) {
+    TOSFileSyncPolicyNone,          // 不主动fsync，由系统决定落盘时机
+    TOSFileSyncPolicyOnClose,       // 下载完成时fsync一次
+    TOSFileSyncPolicyEveryWrite     // 每次合并写入后fsync
+};
+
 typedef NS_ENUM(NSInteger, TOSNetworkingRetryType) {
     TOSNetworkingRetryTypeUnknown,
     TOSNetworkingRetryTypeShouldNotRetry,
@@ -201,6 +209,7 @@ typedef NS_ENUM(NSInteger, TOSNetworkingRetryType) {
 #define TOSClientErrorDomain                    @"com.volces.tos.clientError"
 #define TOSServerErrorDomain                    @"com.volces.tos.serverError"
 #define TOSErrorMessageTOKEN                    @"ErrorMessage"
+#define TOSErrorMetricsTOKEN                    @"RequestMetrics"
 
 
 NS_ASSUME_NONNULL_END
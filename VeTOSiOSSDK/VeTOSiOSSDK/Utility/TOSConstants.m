@@ -22,6 +22,8 @@ const int64_t TOSMaxPartSize = (int64_t)5 * 1024 * 1024 * 1024;
 const int TOSMinTaskNum = 1;
 const int TOSMaxTaskNum = 5;
 const uint64_t TOSMaxPartCount = 10000;
+const int64_t TOSDefaultCopyThreshold = (int64_t)64 * 1024 * 1024;
+const int64_t TOSDefaultRangeMergeGap = (int64_t)64 * 1024;
 
 TOSStorageClassType * const TOSStorageClassStandard = @"STANDARD";
 TOSStorageClassType * const TOSStorageClassIa = @"IA";
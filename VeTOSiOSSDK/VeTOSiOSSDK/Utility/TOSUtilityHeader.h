@@ -20,6 +20,7 @@
 #import "NSDate+TOS.h"
 #import "NSString+TOS.h"
 #import "TOSSynchronizedMutableDictionary.h"
+#import "TOSBufferPool.h"
 #import "TOSUtil.h"
 #import "TOSConstants.h"
 